@@ -0,0 +1,304 @@
+/***-------------------------------------------------------------------------------------------------------------
+***
+*** File: Bannedlist.cpp
+***
+*** Banned functions and macros and their perfect hash, see Bannedlist.h.
+***
+***-------------------------------------------------------------------------------------------------------------*/
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <unordered_set>
+#include "Bannedlist.h"
+
+
+/*
+ * Macros
+ */
+#define MAX_BANNED_LINE 1024
+#define BANNED_SEEDS    16      /* Seeds tried before the build fails */
+
+
+
+CBannedList::CBannedList ()
+   : m_seed(0)
+{
+}
+
+/***----------------------------------------------------------------
+***
+*** Routine: CBannedList::load
+***
+*** Parameters:
+*** ===========
+***
+*** Action  Name                      Type                Use
+*** ------  ----                      ----                ---
+*** I       banned_file               const char *        List of banned names
+*** O       error                     std::string *       Reason for failure, may be NULL
+***
+*** Return value:
+*** bool            false if the file cannot be read
+***
+*** Description:
+*** ============
+***
+*** Reads the names, see Bannedlist.h for the format, and builds the hash.
+*** A name listed twice keeps its first reason.
+***
+***----------------------------------------------------------------*/
+bool CBannedList::load (const char* banned_file, std::string* error)
+{
+   FILE* fp = fopen(banned_file, "r");
+   std::vector<banned_name> names;
+   char line[MAX_BANNED_LINE];
+
+   if (fp == NULL)
+   {
+      if (error != NULL)
+      {
+         *error = std::string("Unable to open ") + banned_file;
+      }
+      return false;
+   }
+
+   while (fgets(line, sizeof(line), fp) != NULL)
+   {
+      std::string_view text(line, strcspn(line, "\r\n"));
+      struct banned_name entry;
+      size_t end;
+
+      text.remove_prefix(std::min(text.size(), text.find_first_not_of(" \t")));
+      if (text.empty() || text[0] == '#')
+      {
+         continue;
+      }
+
+      end = std::min(text.size(), text.find_first_of(" \t"));
+      entry.name = text.substr(0, end);
+      text.remove_prefix(end);
+      text.remove_prefix(std::min(text.size(), text.find_first_not_of(" \t")));
+      text.remove_suffix(text.size() - (text.find_last_not_of(" \t") + 1));
+      entry.reason = text;
+      names.push_back(entry);
+   }
+   fclose(fp);
+
+   if (!build(names))
+   {
+      if (error != NULL)
+      {
+         *error = std::string("Unable to hash the names of ") + banned_file;
+      }
+      return false;
+   }
+   return true;
+} /* End of CBannedList::load */
+
+/***----------------------------------------------------------------
+***
+*** Routine: CBannedList::build
+***
+*** Parameters:
+*** ===========
+***
+*** Action  Name                      Type                          Use
+*** ------  ----                      ----                          ---
+*** IO      names                     std::vector<banned_name> &    Names to ban, emptied
+***
+*** Return value:
+*** bool            false if no seed gives a perfect hash, the list is
+***                 then empty
+***
+*** Description:
+*** ============
+***
+*** Hash and displace. The names are put in buckets by the top half of
+*** their hash, then the buckets are placed largest first: for each the
+*** displacements 0, 1, 2 ... are tried until all its names fall in free
+*** slots, distinct from each other. The large buckets are placed while
+*** most slots are free, so by the time the single names are reached a
+*** free slot is found within about slots / free tries.
+***
+*** Should a bucket not be placed (two names with the same hash) the
+*** whole build is tried again with another seed.
+***
+***----------------------------------------------------------------*/
+bool CBannedList::build (std::vector<banned_name>& names)
+{
+   std::unordered_set<std::string> seen;
+   std::vector<banned_name> unique;
+
+   for (struct banned_name& entry : names)
+   {
+      if (!entry.name.empty() && seen.insert(entry.name).second)
+      {
+         unique.push_back(std::move(entry));
+      }
+   }
+   names.clear();
+   m_names.clear();
+   m_displacements.clear();
+
+   const size_t count = unique.size();
+   const size_t bucket_count = (count + BANNED_BUCKET_SIZE - 1) / BANNED_BUCKET_SIZE;
+   std::vector<uint64_t> hashes(count);
+   std::vector<std::vector<uint32_t> > buckets(bucket_count);
+   std::vector<uint32_t> order(bucket_count);
+   std::vector<uint32_t> slots(count);
+   std::vector<bool> taken(count);
+   std::vector<uint32_t> placed;
+
+   if (count == 0)
+   {
+      return true;
+   }
+
+   for (int attempt = 0; attempt < BANNED_SEEDS; attempt++)
+   {
+      bool built = true;
+
+      m_seed = 0x9E3779B97F4A7C15ull * (uint64_t) (attempt + 1);
+      m_displacements.assign(bucket_count, 0);
+      taken.assign(count, false);
+      for (std::vector<uint32_t>& bucket : buckets)
+      {
+         bucket.clear();
+      }
+      for (size_t index = 0; index < count; index++)
+      {
+         hashes[index] = hash(unique[index].name);
+         buckets[(hashes[index] >> 32) % bucket_count].push_back((uint32_t) index);
+      }
+      for (size_t bucket = 0; bucket < bucket_count; bucket++)
+      {
+         order[bucket] = (uint32_t) bucket;
+      }
+      std::stable_sort(order.begin(), order.end(), [&buckets](uint32_t a, uint32_t b)
+                       { return buckets[a].size() > buckets[b].size(); });
+
+      for (size_t next = 0; next < bucket_count && built; next++)
+      {
+         const std::vector<uint32_t>& bucket = buckets[order[next]];
+         uint32_t displacement = 0;
+
+         if (bucket.empty())
+         {
+            break; /* And so are the rest */
+         }
+         for ( ; displacement < BANNED_MAX_ATTEMPTS; displacement++)
+         {
+            placed.clear();
+            for (uint32_t member : bucket)
+            {
+               const uint32_t at = slot(hashes[member], displacement, count);
+               if (taken[at] || std::find(placed.begin(), placed.end(), at) != placed.end())
+               {
+                  break;
+               }
+               placed.push_back(at);
+            }
+            if (placed.size() == bucket.size())
+            {
+               break;
+            }
+         }
+         if (displacement == BANNED_MAX_ATTEMPTS)
+         {
+            built = false;
+            break;
+         }
+
+         m_displacements[order[next]] = displacement;
+         for (size_t member = 0; member < bucket.size(); member++)
+         {
+            taken[placed[member]] = true;
+            slots[bucket[member]] = placed[member];
+         }
+      }
+
+      if (built)
+      {
+         m_names.resize(count);
+         for (size_t index = 0; index < count; index++)
+         {
+            m_names[slots[index]] = std::move(unique[index]);
+         }
+         return true;
+      }
+   }
+
+   m_displacements.clear();
+   return false;
+} /* End of CBannedList::build */
+
+/***----------------------------------------------------------------
+***
+*** Routine: CBannedList::find
+***
+*** Parameters:
+*** ===========
+***
+*** Action  Name                      Type                Use
+*** ------  ----                      ----                ---
+*** I       identifier                std::string_view    Identifier of the source
+***
+*** Return value:
+*** const struct banned_name *       The name banned, NULL if not banned
+***
+*** Description:
+*** ============
+***
+*** Every identifier hashes to exactly one slot, the name there is the
+*** only one it can be.
+***
+***----------------------------------------------------------------*/
+const struct banned_name* CBannedList::find (std::string_view identifier) const
+{
+   if (m_names.empty())
+   {
+      return NULL;
+   }
+
+   const uint64_t name_hash = hash(identifier);
+   const uint32_t displacement = m_displacements[(name_hash >> 32) % m_displacements.size()];
+   const struct banned_name& entry = m_names[slot(name_hash, displacement, m_names.size())];
+
+   return (entry.name == identifier) ? &entry : NULL;
+} /* End of CBannedList::find */
+
+/***----------------------------------------------------------------
+***
+*** Routine: CBannedList::hash
+***
+*** FNV-1a of the name, from the seed of the build
+***
+***----------------------------------------------------------------*/
+uint64_t CBannedList::hash (std::string_view name) const
+{
+   uint64_t value = 0xCBF29CE484222325ull ^ m_seed;
+
+   for (const char c : name)
+   {
+      value = (value ^ (unsigned char) c) * 0x100000001B3ull;
+   }
+   return value;
+} /* End of CBannedList::hash */
+
+/***----------------------------------------------------------------
+***
+*** Routine: CBannedList::slot
+***
+*** Slot of a name for a displacement of its bucket, the hash displaced
+*** and mixed again so that each displacement gives an unrelated slot
+***
+***----------------------------------------------------------------*/
+uint32_t CBannedList::slot (uint64_t name_hash, uint32_t displacement, size_t slots)
+{
+   uint64_t value = name_hash + 0x9E3779B97F4A7C15ull * (displacement + 1);
+
+   value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+   value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+   value = value ^ (value >> 31);
+   return (uint32_t) (value % slots);
+} /* End of CBannedList::slot */
@@ -0,0 +1,77 @@
+/***-------------------------------------------------------------------------------------------------------------
+***
+*** File: Bannedlist.h
+***
+*** Functions and macros banned from use, 16 Z (see Banned Identifiers in
+*** Combinedstandards.cpp).
+***
+*** The list is read once, from a file of one name per line, optionally
+*** followed by the reason or the alternative to use:
+***     # comment
+***     strcpy      use strncpy or a bounded copy
+***     gets
+***
+*** A minimal perfect hash of the names is built as the list is loaded (hash
+*** and displace): each name hashes to a bucket, and each bucket keeps the
+*** displacement that puts all of its names in free slots of a table of
+*** exactly one slot per name. Finding an identifier is then one hash, one
+*** slot and one compare, whatever the length of the list:
+***
+***     CBannedList banned;
+***     if (banned.load("Banned.dat"))
+***     {
+***        const struct banned_name* found = banned.find("strcpy");
+***     }
+***
+***-------------------------------------------------------------------------------------------------------------*/
+#ifndef BANNEDLIST_H
+#define BANNEDLIST_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+/*
+ * Macros
+ */
+#define BANNED_BUCKET_SIZE   4          /* Names per bucket, on average */
+#define BANNED_MAX_ATTEMPTS  (1u << 20) /* Displacements tried per bucket before another seed */
+
+
+/*
+ * struct banned_name
+ */
+struct banned_name
+{
+   std::string name;
+   std::string reason;        /* Empty if the list gives none */
+};
+
+/*
+ * class CBannedList
+ * Once loaded, find() may be called from any number of threads.
+ */
+class CBannedList
+{
+public:
+   CBannedList ();
+
+   bool load (const char* banned_file, std::string* error = NULL);
+   bool build (std::vector<banned_name>& names);
+   size_t size () const { return m_names.size(); }
+
+   /* NULL if the identifier is not banned */
+   const struct banned_name* find (std::string_view identifier) const;
+
+private:
+   uint64_t hash (std::string_view name) const;
+   static uint32_t slot (uint64_t name_hash, uint32_t displacement, size_t slots);
+
+   std::vector<banned_name> m_names;            /* In slot order */
+   std::vector<uint32_t> m_displacements;       /* One per bucket */
+   uint64_t m_seed;
+};
+
+#endif /* BANNEDLIST_H */
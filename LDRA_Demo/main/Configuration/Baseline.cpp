@@ -0,0 +1,351 @@
+/***-------------------------------------------------------------------------------------------------------------
+***
+*** File: Baseline.cpp
+***
+*** Fingerprints of violations and the mapped baseline file, see Baseline.h.
+***
+***-------------------------------------------------------------------------------------------------------------*/
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <unordered_map>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#include "Baseline.h"
+
+
+/*
+ * Macros
+ */
+#define FNV_OFFSET 0xCBF29CE484222325ull
+#define FNV_PRIME  0x100000001B3ull
+
+
+/*
+ * Prototypes
+ */
+static uint64_t hash_bytes (uint64_t hash, std::string_view text, bool skip_space, bool same_numbers);
+
+
+
+CBaseline::CBaseline ()
+   : m_pMapping(NULL),
+     m_size(0),
+#ifdef _WIN32
+     m_hFile(NULL),
+     m_hMapping(NULL),
+#endif
+     m_pFingerprints(NULL),
+     m_count(0)
+{
+}
+
+CBaseline::~CBaseline ()
+{
+   close();
+}
+
+/***----------------------------------------------------------------
+***
+*** Routine: CBaseline::open
+***
+*** Parameters:
+*** ===========
+***
+*** Action  Name                      Type            Use
+*** ------  ----                      ----            ---
+*** I       file_name                 const char *    Baseline file
+*** O       error                     std::string *   Reason for failure, may be NULL
+***
+*** Return value:
+*** bool            false if the file cannot be mapped or is not a baseline
+***
+*** Description:
+*** ============
+***
+*** Maps the baseline read only, the fingerprints are used in place.
+***
+***----------------------------------------------------------------*/
+bool CBaseline::open (const char* file_name, std::string* error)
+{
+   std::string reason;
+
+   close();
+
+#ifdef _WIN32
+   m_hFile = CreateFileA(file_name, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, NULL,
+                         OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+   if (m_hFile == INVALID_HANDLE_VALUE)
+   {
+      m_hFile = NULL;
+      reason = "Unable to open ";
+   }
+   else
+   {
+      LARGE_INTEGER size;
+      GetFileSizeEx(m_hFile, &size);
+      m_size = (size_t) size.QuadPart;
+      m_hMapping = (m_size > 0) ? CreateFileMappingA(m_hFile, NULL, PAGE_READONLY, 0, 0, NULL) : NULL;
+      m_pMapping = (m_hMapping != NULL) ? MapViewOfFile(m_hMapping, FILE_MAP_READ, 0, 0, 0) : NULL;
+      if (m_pMapping == NULL)
+      {
+         reason = "Unable to map ";
+      }
+   }
+#else
+   int fd = ::open(file_name, O_RDONLY);
+   struct stat file_stat;
+
+   if (fd < 0 || fstat(fd, &file_stat) != 0)
+   {
+      reason = "Unable to open ";
+   }
+   else
+   {
+      m_size = (size_t) file_stat.st_size;
+      m_pMapping = (m_size > 0) ? mmap(NULL, m_size, PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+      if (m_pMapping == MAP_FAILED)
+      {
+         m_pMapping = NULL;
+         reason = "Unable to map ";
+      }
+   }
+   if (fd >= 0)
+   {
+      ::close(fd);
+   }
+#endif
+
+   if (reason.empty())
+   {
+      const struct baseline_header* header = (const struct baseline_header*) m_pMapping;
+
+      if (m_size < sizeof(struct baseline_header) || memcmp(header->magic, BASELINE_MAGIC, 8) != 0)
+      {
+         reason = "Not a baseline: ";
+      }
+      else if (header->version != BASELINE_VERSION)
+      {
+         reason = "Baseline is of another version, write it again: ";
+      }
+      else if (header->count != (m_size - sizeof(struct baseline_header)) / sizeof(uint64_t)
+               || (m_size - sizeof(struct baseline_header)) % sizeof(uint64_t) != 0)
+      {
+         reason = "Baseline is damaged: ";
+      }
+      else
+      {
+         m_pFingerprints = (const uint64_t*) (header + 1);
+         m_count = (size_t) header->count;
+      }
+   }
+
+   if (!reason.empty())
+   {
+      close();
+      if (error != NULL)
+      {
+         *error = reason + file_name;
+      }
+      return false;
+   }
+   return true;
+} /* End of CBaseline::open */
+
+void CBaseline::close ()
+{
+#ifdef _WIN32
+   if (m_pMapping != NULL) UnmapViewOfFile(m_pMapping);
+   if (m_hMapping != NULL) CloseHandle(m_hMapping);
+   if (m_hFile != NULL) CloseHandle(m_hFile);
+   m_hMapping = NULL;
+   m_hFile = NULL;
+#else
+   if (m_pMapping != NULL) munmap(m_pMapping, m_size);
+#endif
+   m_pMapping = NULL;
+   m_size = 0;
+   m_pFingerprints = NULL;
+   m_count = 0;
+} /* End of CBaseline::close */
+
+/* Fingerprint is in the baseline */
+bool CBaseline::contains (uint64_t fingerprint) const
+{
+   return m_pFingerprints != NULL
+          && std::binary_search(m_pFingerprints, m_pFingerprints + m_count, fingerprint);
+} /* End of CBaseline::contains */
+
+/***----------------------------------------------------------------
+***
+*** Routine: baseline_fingerprints
+***
+*** Parameters:
+*** ===========
+***
+*** Action  Name                Type                                  Use
+*** ------  ----                ----                                  ---
+*** I       source_name         std::string_view                      Full source file name
+*** I       source              std::string_view                      Source text
+*** I       violations          const std::vector<violation_info> &   Violations of the File
+*** O       fingerprints        std::vector<uint64_t> *               One per violation
+***
+*** Return value:
+*** void
+***
+*** Description:
+*** ============
+***
+*** See Baseline.h for what makes up a fingerprint. The line of a Z
+*** violation is found through an index of the line starts, built once.
+***
+***----------------------------------------------------------------*/
+void baseline_fingerprints (std::string_view source_name, std::string_view source,
+                            const std::vector<violation_info>& violations,
+                            std::vector<uint64_t>* fingerprints)
+{
+   const size_t slash = source_name.find_last_of("\\:/");
+   const std::string_view base_name = (slash == std::string_view::npos) ? source_name
+                                                                        : source_name.substr(slash + 1);
+   std::unordered_map<uint64_t, int> occurrences;
+   std::vector<size_t> line_starts;
+
+   fingerprints->clear();
+   fingerprints->reserve(violations.size());
+
+   line_starts.push_back(0);
+   for (size_t pos = source.find('\n'); pos != std::string_view::npos; pos = source.find('\n', pos + 1))
+   {
+      line_starts.push_back(pos + 1);
+   }
+
+   for (const struct violation_info& violation : violations)
+   {
+      const bool z_standard = (violation.std_letter == ZSTANDARD);
+      char standard[16];
+      uint64_t hash = FNV_OFFSET;
+
+      snprintf(standard, sizeof(standard), "\t%d%c\t", violation.std_num, violation.std_letter);
+      hash = hash_bytes(hash, base_name, false, false);
+      hash = hash_bytes(hash, standard, false, false);
+      hash = hash_bytes(hash, violation.text, false, z_standard);
+
+      if (z_standard && violation.line > 0 && (size_t) violation.line <= line_starts.size())
+      {
+         const size_t start = line_starts[violation.line - 1];
+         const size_t end = std::min(source.find('\n', start), source.size());
+         hash = hash_bytes(hash, "\t", false, false);
+         hash = hash_bytes(hash, source.substr(start, end - start), true, false);
+      }
+
+      /* The same violation again, e.g. a copied line */
+      const int occurrence = occurrences[hash]++;
+      hash = (hash ^ (uint64_t) occurrence) * FNV_PRIME;
+
+      fingerprints->push_back(hash);
+   }
+} /* End of baseline_fingerprints */
+
+/***----------------------------------------------------------------
+***
+*** Routine: write_baseline
+***
+*** Parameters:
+*** ===========
+***
+*** Action  Name                Type                        Use
+*** ------  ----                ----                        ---
+*** IO      fingerprints        std::vector<uint64_t> *     Sorted, duplicates removed
+*** I       file_name           const char *                Baseline file
+*** O       error               std::string *               Reason for failure
+***
+*** Return value:
+*** bool            false if the baseline cannot be written
+***
+*** Description:
+*** ============
+***
+*** Written to a temporary file which is renamed over the baseline, so
+*** generators mapping the old baseline are not disturbed.
+***
+***----------------------------------------------------------------*/
+bool write_baseline (std::vector<uint64_t>* fingerprints, const char* file_name, std::string* error)
+{
+   const std::string temp_name = std::string(file_name) + ".tmp";
+   struct baseline_header header;
+   FILE* fp;
+   bool written;
+
+   std::sort(fingerprints->begin(), fingerprints->end());
+   fingerprints->erase(std::unique(fingerprints->begin(), fingerprints->end()), fingerprints->end());
+
+   memset(&header, 0, sizeof(header));
+   memcpy(header.magic, BASELINE_MAGIC, 8);
+   header.version = BASELINE_VERSION;
+   header.count = fingerprints->size();
+
+   fp = fopen(temp_name.c_str(), "wb");
+   if (fp == NULL)
+   {
+      *error = "Unable to write " + temp_name;
+      return false;
+   }
+   written = (fwrite(&header, sizeof(header), 1, fp) == 1)
+             &&
+             (fingerprints->empty()
+              || fwrite(fingerprints->data(), sizeof(uint64_t), fingerprints->size(), fp) == fingerprints->size());
+   written = (fclose(fp) == 0) && written;
+
+#ifdef _WIN32
+   if (!written || !MoveFileExA(temp_name.c_str(), file_name, MOVEFILE_REPLACE_EXISTING))
+#else
+   if (!written || rename(temp_name.c_str(), file_name) != 0)
+#endif
+   {
+      remove(temp_name.c_str());
+      *error = std::string("Unable to replace ") + file_name;
+      return false;
+   }
+
+   return true;
+} /* End of write_baseline */
+
+/***----------------------------------------------------------------
+***
+*** Routine: hash_bytes
+***
+*** FNV-1a of the text, continued from hash. skip_space leaves out white
+*** space, same_numbers hashes each run of digits as a single '#'
+***
+***----------------------------------------------------------------*/
+static uint64_t hash_bytes (uint64_t hash, std::string_view text, bool skip_space, bool same_numbers)
+{
+   bool in_number = false;
+
+   for (const char c : text)
+   {
+      if (skip_space && isspace((unsigned char) c))
+      {
+         continue;
+      }
+      if (same_numbers && isdigit((unsigned char) c))
+      {
+         if (!in_number)
+         {
+            hash = (hash ^ (unsigned char) '#') * FNV_PRIME;
+         }
+         in_number = true;
+         continue;
+      }
+      in_number = false;
+      hash = (hash ^ (unsigned char) c) * FNV_PRIME;
+   }
+   return hash;
+} /* End of hash_bytes */
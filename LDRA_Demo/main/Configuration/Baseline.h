@@ -0,0 +1,105 @@
+/***-------------------------------------------------------------------------------------------------------------
+***
+*** File: Baseline.h
+***
+*** Baseline of accepted violations (see Baseline in Combinedstandards.cpp).
+***
+*** Each violation has a 64 bit fingerprint which does not depend on its line
+*** number, so a violation keeps its fingerprint when the code around it
+*** moves. It is taken over:
+***   - the name of the File, without its directory
+***   - the standard, number and letter
+***   - the violation text, for a Z Standard with each number in it made
+***     the same (limits and line numbers change, the violation does not)
+***   - for a Z Standard, the source line, without any white space
+***   - how many violations of the File before it have the same fingerprint,
+***     so that a second copy of an accepted violation is still new
+***
+*** A baseline file is the sorted fingerprints of all the violations
+*** accepted, written by Stdbaseline from the fingerprints the generator
+*** records, and mapped read only. Looking up a violation is a binary search
+*** of the mapped array, 20 compares for a million fingerprints:
+***
+***     CBaseline baseline;
+***     if (baseline.open("Baseline.dat"))
+***     {
+***        baseline_fingerprints(source_name, source, violations, &fingerprints);
+***        bool accepted = baseline.contains(fingerprints[0]);
+***     }
+***
+*** File layout, little endian:
+***   baseline_header
+***   uint64_t [count]          sorted, no duplicates
+***
+***-------------------------------------------------------------------------------------------------------------*/
+#ifndef BASELINE_H
+#define BASELINE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Standardsengine.h"
+
+
+/*
+ * Macros
+ */
+#define BASELINE_MAGIC    "LDRABASE"  /* 8 bytes, without the '\0' */
+#define BASELINE_VERSION  1
+
+
+/*
+ * struct baseline_header
+ */
+struct baseline_header
+{
+   char magic[8];
+   uint32_t version;
+   uint32_t reserved;
+   uint64_t count;
+};
+
+/*
+ * class CBaseline
+ * A baseline file mapped read only. contains() may be called from any
+ * number of threads.
+ */
+class CBaseline
+{
+public:
+   CBaseline ();
+   ~CBaseline ();
+
+   bool open (const char* file_name, std::string* error = NULL);
+   void close ();
+   bool is_open () const { return m_pFingerprints != NULL; }
+   size_t size () const { return m_count; }
+
+   bool contains (uint64_t fingerprint) const;
+
+private:
+   void* m_pMapping;
+   size_t m_size;
+#ifdef _WIN32
+   void* m_hFile;
+   void* m_hMapping;
+#endif
+   const uint64_t* m_pFingerprints;
+   size_t m_count;
+
+   CBaseline (const CBaseline&);
+   CBaseline& operator= (const CBaseline&);
+};
+
+
+/* Fingerprints of the violations of a File, in the same order */
+void baseline_fingerprints (std::string_view source_name, std::string_view source,
+                            const std::vector<violation_info>& violations,
+                            std::vector<uint64_t>* fingerprints);
+
+/* Sorts the fingerprints, removes duplicates and writes the baseline file */
+bool write_baseline (std::vector<uint64_t>* fingerprints, const char* file_name, std::string* error);
+
+#endif /* BASELINE_H */
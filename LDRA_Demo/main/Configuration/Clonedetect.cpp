@@ -0,0 +1,891 @@
+/***-------------------------------------------------------------------------------------------------------------
+***
+*** File: Clonedetect.cpp
+***
+*** Duplicated code across the set, see Clonedetect.h.
+***
+***-------------------------------------------------------------------------------------------------------------*/
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <windows.h>
+#endif
+#include "Clonedetect.h"
+
+
+/*
+ * Macros
+ */
+#define MAX_CLONES_LINE 4096
+#define HASH_BASE 1000003ull    /* Rolling hash multiplier */
+
+
+/*
+ * struct clone_token
+ */
+struct clone_token
+{
+   uint64_t id;               /* Hash of the normalised token */
+   uint32_t line;
+};
+
+/*
+ * struct clone_match
+ * Fingerprints of equal hash, in file and other_file.
+ */
+struct clone_match
+{
+   int file;
+   int other_file;
+   int64_t offset;            /* Token of other_file less token of file */
+   uint32_t fingerprint;      /* Indexes in the files' fingerprints */
+   uint32_t other_fingerprint;
+};
+
+/* Kept as themselves, all other identifiers are one token */
+static const char* const keywords[] =
+{
+   "auto", "bool", "break", "case", "catch", "char", "class", "const", "continue", "default",
+   "delete", "do", "double", "else", "enum", "extern", "float", "for", "goto", "if", "inline",
+   "int", "long", "namespace", "new", "operator", "private", "protected", "public", "register",
+   "return", "short", "signed", "sizeof", "static", "struct", "switch", "template", "this",
+   "throw", "try", "typedef", "union", "unsigned", "using", "virtual", "void", "volatile", "while"
+};
+
+
+/*
+ * Prototypes
+ */
+static void tokenise_source (std::string_view source, std::vector<clone_token>* tokens);
+
+static uint64_t token_hash (std::string_view text);
+
+static bool read_tokens (const struct clone_file& file, std::vector<clone_token>* tokens);
+
+static void write_file_records (FILE* fp, const struct clone_file& file);
+
+
+
+/***----------------------------------------------------------------
+***
+*** Routine: fingerprint_source
+***
+*** Parameters:
+*** ===========
+***
+*** Action  Name                Type                                Use
+*** ------  ----                ----                                ---
+*** I       source              std::string_view                    Source text
+*** I       window              int                                 Hashes winnowed together
+*** O       fingerprints        std::vector<clone_fingerprint> *    Winnowed hashes
+***
+*** Description:
+*** ============
+***
+*** The smallest hash of each window, the rightmost if several, each
+*** recorded once. A source shorter than one window has none, it cannot
+*** hold a duplicate of the length looked for.
+***
+***----------------------------------------------------------------*/
+void fingerprint_source (std::string_view source, int window, std::vector<clone_fingerprint>* fingerprints)
+{
+   std::vector<clone_token> tokens;
+   std::vector<uint64_t> hashes;
+   std::deque<size_t> minimum;     /* Window positions of increasing hash */
+   uint64_t power = 1;             /* HASH_BASE ^ (CLONE_KGRAM - 1) */
+   uint64_t hash = 0;
+
+   fingerprints->clear();
+   tokenise_source(source, &tokens);
+   if (tokens.size() < (size_t) CLONE_KGRAM + window - 1)
+   {
+      return;
+   }
+
+   /* Rabin-Karp hash of each CLONE_KGRAM tokens */
+   for (int token = 0; token < CLONE_KGRAM - 1; token++)
+   {
+      power *= HASH_BASE;
+   }
+   hashes.reserve(tokens.size() - CLONE_KGRAM + 1);
+   for (size_t token = 0; token < tokens.size(); token++)
+   {
+      if (token >= (size_t) CLONE_KGRAM)
+      {
+         hash -= tokens[token - CLONE_KGRAM].id * power;
+      }
+      hash = hash * HASH_BASE + tokens[token].id;
+      if (token + 1 >= (size_t) CLONE_KGRAM)
+      {
+         hashes.push_back(hash);
+      }
+   }
+
+   /* Winnowing */
+   size_t recorded = hashes.size();
+   for (size_t position = 0; position < hashes.size(); position++)
+   {
+      while (!minimum.empty() && hashes[minimum.back()] >= hashes[position])
+      {
+         minimum.pop_back();
+      }
+      minimum.push_back(position);
+      if (minimum.front() + window <= position)
+      {
+         minimum.pop_front();
+      }
+
+      if (position + 1 >= (size_t) window && minimum.front() != recorded)
+      {
+         struct clone_fingerprint fingerprint;
+
+         recorded = minimum.front();
+         fingerprint.hash = hashes[recorded];
+         fingerprint.token = (uint32_t) recorded;
+         fingerprint.first_line = tokens[recorded].line;
+         fingerprint.last_line = tokens[recorded + CLONE_KGRAM - 1].line;
+         fingerprints->push_back(fingerprint);
+      }
+   }
+} /* End of fingerprint_source */
+
+/***----------------------------------------------------------------
+***
+*** Routine: tokenise_source
+***
+*** Parameters:
+*** ===========
+***
+*** Action  Name                Type                            Use
+*** ------  ----                ----                            ---
+*** I       source              std::string_view                Source text
+*** O       tokens              std::vector<clone_token> *      Normalised tokens
+***
+*** Description:
+*** ============
+***
+*** Comments and preprocessor lines are skipped. Keywords and punctuation
+*** are tokens of their own, identifiers are all "I" and numbers, strings
+*** and character constants are all "L".
+***
+***----------------------------------------------------------------*/
+static void tokenise_source (std::string_view source, std::vector<clone_token>* tokens)
+{
+   static const uint64_t identifier = token_hash("I");
+   static const uint64_t literal = token_hash("L");
+   static const std::unordered_map<std::string_view, uint64_t> keyword_ids = [] {
+      std::unordered_map<std::string_view, uint64_t> ids;
+      for (const char* keyword : keywords)
+      {
+         ids[keyword] = token_hash(keyword);
+      }
+      return ids;
+   }();
+   uint32_t line = 1;
+   bool line_start = true;
+   size_t pos = 0;
+
+   tokens->clear();
+   tokens->reserve(source.size() / 4);
+
+   while (pos < source.size())
+   {
+      const char c = source[pos];
+      struct clone_token token;
+
+      if (c == '\n')
+      {
+         line++;
+         line_start = true;
+         pos++;
+         continue;
+      }
+      if (isspace((unsigned char) c))
+      {
+         pos++;
+         continue;
+      }
+
+      /* Comments */
+      if (c == '/' && pos + 1 < source.size() && (source[pos + 1] == '*' || source[pos + 1] == '/'))
+      {
+         const bool block = (source[pos + 1] == '*');
+         size_t end = block ? source.find("*/", pos + 2) : source.find('\n', pos + 2);
+
+         end = (end == std::string_view::npos) ? source.size() : end + (block ? 2 : 0);
+         line += (uint32_t) std::count(source.begin() + pos, source.begin() + end, '\n');
+         pos = end;
+         continue;
+      }
+
+      /* Preprocessor lines, with any continuation */
+      if (c == '#' && line_start)
+      {
+         while (pos < source.size() && source[pos] != '\n')
+         {
+            if (source[pos] == '\\' && pos + 1 < source.size() && source[pos + 1] == '\n')
+            {
+               line++;
+               pos++;
+            }
+            pos++;
+         }
+         continue;
+      }
+      line_start = false;
+      token.line = line;
+
+      if (c == '"' || c == '\'')
+      {
+         pos++;
+         while (pos < source.size() && source[pos] != c && source[pos] != '\n')
+         {
+            pos += (source[pos] == '\\' && pos + 1 < source.size()) ? 2 : 1;
+         }
+         pos++;
+         token.id = literal;
+      }
+      else if (isalpha((unsigned char) c) || c == '_')
+      {
+         size_t end = pos;
+         while (end < source.size() && (isalnum((unsigned char) source[end]) || source[end] == '_'))
+         {
+            end++;
+         }
+         std::unordered_map<std::string_view, uint64_t>::const_iterator keyword =
+            keyword_ids.find(source.substr(pos, end - pos));
+         token.id = (keyword != keyword_ids.end()) ? keyword->second : identifier;
+         pos = end;
+      }
+      else if (isdigit((unsigned char) c))
+      {
+         while (pos < source.size() && (isalnum((unsigned char) source[pos]) || source[pos] == '.' || source[pos] == '_'))
+         {
+            pos++;
+         }
+         token.id = literal;
+      }
+      else
+      {
+         token.id = token_hash(source.substr(pos, 1));
+         pos++;
+      }
+      tokens->push_back(token);
+   }
+} /* End of tokenise_source */
+
+/***----------------------------------------------------------------
+***
+*** Routine: token_hash
+*** FNV-1a hash of a token's text
+***
+***----------------------------------------------------------------*/
+static uint64_t token_hash (std::string_view text)
+{
+   uint64_t hash = 14695981039346656037ull;
+
+   for (char c : text)
+   {
+      hash = (hash ^ (unsigned char) c) * 1099511628211ull;
+   }
+   return hash;
+} /* End of token_hash */
+
+/***----------------------------------------------------------------
+***
+*** Routine: read_tokens
+***
+*** Parameters:
+*** ===========
+***
+*** Action  Name                Type                            Use
+*** ------  ----                ----                            ---
+*** I       file                const struct clone_file &       File of the index
+*** O       tokens              std::vector<clone_token> *      Its normalised tokens
+***
+*** Return value:
+*** bool            false if the file cannot be read, or has changed
+***                 since it was fingerprinted
+***
+***----------------------------------------------------------------*/
+static bool read_tokens (const struct clone_file& file, std::vector<clone_token>* tokens)
+{
+   FILE* fp = fopen(file.path.c_str(), "rb");
+   struct stat status;
+   std::string text;
+   char buffer[65536];
+   size_t length;
+
+   tokens->clear();
+   if (fp == NULL)
+   {
+      return false;
+   }
+   if (fstat(fileno(fp), &status) != 0 || status.st_mtime != file.mtime)
+   {
+      fclose(fp);
+      return false;
+   }
+   while ((length = fread(buffer, 1, sizeof(buffer), fp)) > 0)
+   {
+      text.append(buffer, length);
+   }
+   fclose(fp);
+
+   tokenise_source(text, tokens);
+   return true;
+} /* End of read_tokens */
+
+CCloneIndex::CCloneIndex (int min_tokens)
+   : m_minTokens(std::max(min_tokens, CLONE_KGRAM)), m_modified(false), m_synced(false), m_replaced(0)
+{
+}
+
+int CCloneIndex::window () const
+{
+   return m_minTokens - CLONE_KGRAM + 1;
+}
+
+/***----------------------------------------------------------------
+***
+*** Routine: CCloneIndex::load
+***
+*** Parameters:
+*** ===========
+***
+*** Action  Name                      Type                Use
+*** ------  ----                      ----                ---
+*** I       cache_file                const char *        Cache of an earlier run
+***
+*** Return value:
+*** bool            false if there is no cache, it is not valid, or it is
+***                 for another min_tokens; the index is then empty
+***
+***----------------------------------------------------------------*/
+bool CCloneIndex::load (const char* cache_file)
+{
+   FILE* fp = fopen(cache_file, "r");
+   char line[MAX_CLONES_LINE];
+   bool valid = false;
+
+   int current = -1;              /* File of the last F record */
+
+   m_files.clear();
+   m_index.clear();
+   m_modified = false;
+   m_synced = false;
+   m_pending.clear();
+   m_replaced = 0;
+
+   if (fp == NULL)
+   {
+      return false;
+   }
+
+   if (fgets(line, sizeof(line), fp) != NULL
+       && strncmp(line, CLONES_MAGIC "\t", strlen(CLONES_MAGIC) + 1) == 0)
+   {
+      char* field = line + strlen(CLONES_MAGIC) + 1;
+      const long version = strtol(field, &field, 10);
+
+      valid = (version == CLONES_VERSION && strtol(field, &field, 10) == m_minTokens);
+      while (valid && fgets(line, sizeof(line), fp) != NULL)
+      {
+         field = line + 2;
+         line[strcspn(line, "\r\n")] = '\0';
+         if (line[0] == 'F' && line[1] == '\t')
+         {
+            const time_t mtime = (time_t) strtoll(field, &field, 10);
+            const std::string path = (*field == '\t') ? field + 1 : "";
+
+            valid = !path.empty();
+            if (valid)
+            {
+               /* A file found again replaces its earlier records */
+               const std::pair<std::unordered_map<std::string, int>::iterator, bool> added =
+                  m_index.emplace(path, (int) m_files.size());
+
+               current = added.first->second;
+               if (added.second)
+               {
+                  m_files.push_back(clone_file());
+                  m_files.back().path = path;
+               }
+               m_replaced += m_files[current].fingerprints.size();
+               m_files[current].mtime = mtime;
+               m_files[current].fingerprints.clear();
+            }
+         }
+         else if (line[0] == 'P' && line[1] == '\t' && current >= 0)
+         {
+            struct clone_fingerprint fingerprint;
+
+            fingerprint.hash = strtoull(field, &field, 16);
+            fingerprint.token = (uint32_t) strtoul(field, &field, 10);
+            fingerprint.first_line = (uint32_t) strtoul(field, &field, 10);
+            fingerprint.last_line = (uint32_t) strtoul(field, &field, 10);
+            m_files[current].fingerprints.push_back(fingerprint);
+         }
+         else
+         {
+            valid = false;
+         }
+      }
+   }
+
+   fclose(fp);
+   if (!valid)
+   {
+      m_files.clear();
+      m_index.clear();
+      m_replaced = 0;
+   }
+   m_synced = valid;
+   return valid;
+} /* End of CCloneIndex::load */
+
+/***----------------------------------------------------------------
+***
+*** Routine: CCloneIndex::save
+***
+*** Parameters:
+*** ===========
+***
+*** Action  Name                      Type                Use
+*** ------  ----                      ----                ---
+*** I       cache_file                const char *        Cache for the next run
+*** O       error                     std::string *       Reason for failure
+***
+*** Return value:
+*** bool            false if the cache cannot be written
+***
+*** Description:
+*** ============
+***
+*** Written to a temporary file which is renamed over the cache.
+***
+***----------------------------------------------------------------*/
+bool CCloneIndex::save (const char* cache_file, std::string* error)
+{
+   const std::string temp_name = std::string(cache_file) + ".tmp";
+   FILE* fp = fopen(temp_name.c_str(), "w");
+   bool written;
+
+   if (fp == NULL)
+   {
+      *error = "Unable to write " + temp_name;
+      return false;
+   }
+
+   fprintf(fp, "%s\t%d\t%d\n", CLONES_MAGIC, CLONES_VERSION, m_minTokens);
+   for (const struct clone_file& file : m_files)
+   {
+      write_file_records(fp, file);
+   }
+   written = (ferror(fp) == 0);
+   written = (fclose(fp) == 0) && written;
+
+#ifdef _WIN32
+   if (!written || !MoveFileExA(temp_name.c_str(), cache_file, MOVEFILE_REPLACE_EXISTING))
+#else
+   if (!written || rename(temp_name.c_str(), cache_file) != 0)
+#endif
+   {
+      remove(temp_name.c_str());
+      *error = std::string("Unable to replace ") + cache_file;
+      return false;
+   }
+
+   m_modified = false;
+   m_synced = true;
+   m_pending.clear();
+   m_replaced = 0;
+   return true;
+} /* End of CCloneIndex::save */
+
+/***----------------------------------------------------------------
+***
+*** Routine: CCloneIndex::update
+***
+*** Parameters:
+*** ===========
+***
+*** Action  Name                      Type                Use
+*** ------  ----                      ----                ---
+*** I       cache_file                const char *        Cache loaded, for the next run
+*** O       error                     std::string *       Reason for failure
+***
+*** Return value:
+*** bool            false if the cache cannot be written
+***
+*** Description:
+*** ============
+***
+*** Appends the records of the files set since the cache was loaded or
+*** saved. The cache is saved in full instead when it was not loaded, or
+*** when more of its fingerprint records have been replaced than are in
+*** use. Between loading and updating, the cache must not be written by
+*** another process.
+***
+***----------------------------------------------------------------*/
+bool CCloneIndex::update (const char* cache_file, std::string* error)
+{
+   size_t in_use = 0;
+
+   for (const struct clone_file& file : m_files)
+   {
+      in_use += file.fingerprints.size();
+   }
+   if (!m_synced || m_replaced > in_use)
+   {
+      return save(cache_file, error);
+   }
+
+   FILE* fp = fopen(cache_file, "a");
+   bool written;
+
+   if (fp == NULL)
+   {
+      *error = std::string("Unable to write ") + cache_file;
+      return false;
+   }
+   for (const int file : m_pending)
+   {
+      write_file_records(fp, m_files[file]);
+   }
+   written = (ferror(fp) == 0);
+   written = (fclose(fp) == 0) && written;
+   if (!written)
+   {
+      *error = std::string("Unable to write ") + cache_file;
+      m_synced = false;
+      return false;
+   }
+
+   m_modified = false;
+   m_pending.clear();
+   return true;
+} /* End of CCloneIndex::update */
+
+/***----------------------------------------------------------------
+***
+*** Routine: write_file_records
+*** The F record of a file and a P record for each of its fingerprints
+***
+***----------------------------------------------------------------*/
+static void write_file_records (FILE* fp, const struct clone_file& file)
+{
+   fprintf(fp, "F\t%lld\t%s\n", (long long) file.mtime, file.path.c_str());
+   for (const struct clone_fingerprint& fingerprint : file.fingerprints)
+   {
+      fprintf(fp, "P\t%016llx\t%u\t%u\t%u\n", (unsigned long long) fingerprint.hash,
+              (unsigned) fingerprint.token, (unsigned) fingerprint.first_line,
+              (unsigned) fingerprint.last_line);
+   }
+} /* End of write_file_records */
+
+/***----------------------------------------------------------------
+***
+*** Routine: CCloneIndex::set_file
+***
+*** Parameters:
+*** ===========
+***
+*** Action  Name                Type                                Use
+*** ------  ----                ----                                ---
+*** I       path                std::string_view                    Full file name
+*** I       mtime               time_t                              Modification time of the source read
+*** IO      fingerprints        std::vector<clone_fingerprint> &    Taken by the index
+***
+*** Return value:
+*** int             Index of the file
+***
+***----------------------------------------------------------------*/
+int CCloneIndex::set_file (std::string_view path, time_t mtime, std::vector<clone_fingerprint>& fingerprints)
+{
+   const std::pair<std::unordered_map<std::string, int>::iterator, bool> added =
+      m_index.emplace(std::string(path), (int) m_files.size());
+   const int index = added.first->second;
+
+   if (added.second)
+   {
+      m_files.push_back(clone_file());
+      m_files.back().path = std::string(path);
+   }
+   else
+   {
+      m_replaced += m_files[index].fingerprints.size();
+   }
+
+   m_files[index].mtime = mtime;
+   m_files[index].fingerprints.swap(fingerprints);
+   m_modified = true;
+   if (std::find(m_pending.begin(), m_pending.end(), index) == m_pending.end())
+   {
+      m_pending.push_back(index);
+   }
+   return index;
+} /* End of CCloneIndex::set_file */
+
+int CCloneIndex::find_file (std::string_view path) const
+{
+   std::unordered_map<std::string, int>::const_iterator found = m_index.find(std::string(path));
+   return (found != m_index.end()) ? found->second : -1;
+}
+
+/***----------------------------------------------------------------
+***
+*** Routine: CCloneIndex::find_clones
+***
+*** Parameters:
+*** ===========
+***
+*** Action  Name                Type                            Use
+*** ------  ----                ----                            ---
+*** I       file                int                             File to report, -1 for all
+*** I       threads             unsigned int                    Threads of the join, 0 for one per core
+*** O       clones              std::vector<clone_region> *     Duplicates, by file then line
+***
+*** Description:
+*** ============
+***
+*** The join: the hashes are split into one partition per thread, each
+*** thread maps the fingerprints of its partition by hash and pairs those
+*** of equal hash. Then, for each two files and offset between them, the
+*** tokens of both files are read again and each match extended back and
+*** forward to where they differ, and regions of at least min_tokens
+*** reported. A shared fingerprint only shows that a duplicate is there,
+*** the fingerprints of a duplicate of min_tokens may be no more than
+*** CLONE_KGRAM tokens apart. Where a file cannot be read, or has changed
+*** since it was fingerprinted, matches no more than a window apart are
+*** chained into a region instead. For a file given the region is
+*** reported from that file, otherwise once for each pair of files.
+***
+***----------------------------------------------------------------*/
+void CCloneIndex::find_clones (int file, unsigned int threads, std::vector<clone_region>* clones) const
+{
+   const unsigned int partitions = (threads > 0) ? threads : std::max(1u, std::thread::hardware_concurrency());
+   std::vector<std::vector<clone_match> > partition_matches(partitions);
+   std::vector<std::thread> workers;
+
+   clones->clear();
+
+   for (unsigned int partition = 0; partition < partitions; partition++)
+   {
+      workers.emplace_back([this, file, partition, partitions, &partition_matches] {
+         std::unordered_map<uint64_t, std::vector<std::pair<int, uint32_t> > > by_hash;
+         std::vector<clone_match>& matches = partition_matches[partition];
+
+         for (int index = 0; index < (int) m_files.size(); index++)
+         {
+            const std::vector<clone_fingerprint>& fingerprints = m_files[index].fingerprints;
+            for (uint32_t fingerprint = 0; fingerprint < fingerprints.size(); fingerprint++)
+            {
+               if ((fingerprints[fingerprint].hash >> 32) % partitions == partition)
+               {
+                  by_hash[fingerprints[fingerprint].hash].push_back(std::make_pair(index, fingerprint));
+               }
+            }
+         }
+
+         for (const auto& entry : by_hash)
+         {
+            const std::vector<std::pair<int, uint32_t> >& found = entry.second;
+
+            if (found.size() < 2 || found.size() > CLONE_MAX_OCCURRENCES)
+            {
+               continue;
+            }
+            for (size_t first = 0; first < found.size(); first++)
+            {
+               for (size_t second = first + 1; second < found.size(); second++)
+               {
+                  std::pair<int, uint32_t> a = found[first];
+                  std::pair<int, uint32_t> b = found[second];
+
+                  /* Reported from file, or from the first of the two */
+                  if ((file >= 0) ? (a.first != file) : (a.first > b.first))
+                  {
+                     std::swap(a, b);
+                  }
+                  if (file >= 0 && a.first != file)
+                  {
+                     continue;
+                  }
+                  if (a.first == b.first
+                      && m_files[a.first].fingerprints[a.second].token > m_files[b.first].fingerprints[b.second].token)
+                  {
+                     std::swap(a, b);
+                  }
+
+                  struct clone_match match;
+                  match.file = a.first;
+                  match.other_file = b.first;
+                  match.fingerprint = a.second;
+                  match.other_fingerprint = b.second;
+                  match.offset = (int64_t) m_files[b.first].fingerprints[b.second].token
+                                 - (int64_t) m_files[a.first].fingerprints[a.second].token;
+
+                  /* Not code overlapping itself, e.g. a table of similar lines */
+                  if (a.first != b.first || match.offset >= CLONE_KGRAM)
+                  {
+                     matches.push_back(match);
+                  }
+               }
+            }
+         }
+      });
+   }
+   for (std::thread& worker : workers)
+   {
+      worker.join();
+   }
+
+   std::vector<clone_match> matches;
+   for (std::vector<clone_match>& found : partition_matches)
+   {
+      matches.insert(matches.end(), found.begin(), found.end());
+      std::vector<clone_match>().swap(found);
+   }
+   std::sort(matches.begin(), matches.end(), [](const clone_match& a, const clone_match& b)
+             { return (a.file != b.file) ? a.file < b.file
+                    : (a.other_file != b.other_file) ? a.other_file < b.other_file
+                    : (a.offset != b.offset) ? a.offset < b.offset
+                    : a.fingerprint < b.fingerprint; });
+
+   /* The tokens of the files with matches, read when first needed */
+   std::unordered_map<int, std::unique_ptr<std::vector<clone_token> > > file_tokens;
+   auto tokens_of = [this, &file_tokens](int index) -> const std::vector<clone_token>* {
+      std::unique_ptr<std::vector<clone_token> >& tokens = file_tokens[index];
+      if (!tokens)
+      {
+         tokens.reset(new std::vector<clone_token>());
+         if (!read_tokens(m_files[index], tokens.get()))
+         {
+            tokens->clear();
+         }
+      }
+      return tokens->empty() ? NULL : tokens.get();
+   };
+
+   /* The matches of each two files and offset, in token order */
+   for (size_t first = 0; first < matches.size(); )
+   {
+      const std::vector<clone_fingerprint>& fingerprints = m_files[matches[first].file].fingerprints;
+      const std::vector<clone_fingerprint>& other = m_files[matches[first].other_file].fingerprints;
+      const int64_t offset = matches[first].offset;
+      size_t end = first + 1;
+
+      while (end < matches.size()
+             && matches[end].file == matches[first].file
+             && matches[end].other_file == matches[first].other_file
+             && matches[end].offset == offset)
+      {
+         end++;
+      }
+
+      const std::vector<clone_token>* tokens = tokens_of(matches[first].file);
+      const std::vector<clone_token>* other_tokens = tokens_of(matches[first].other_file);
+
+      if (tokens != NULL && other_tokens != NULL)
+      {
+         /*
+          * A shared fingerprint is only known to lie somewhere in the
+          * duplicate, so each is extended token by token, back and forward,
+          * to where the two files differ. A copy in the same file does not
+          * run into itself.
+          */
+         const int64_t size = (int64_t) tokens->size();
+         const int64_t other_size = (int64_t) other_tokens->size();
+         const bool same_file = (matches[first].file == matches[first].other_file);
+         int64_t covered = 0;     /* Tokens of file already in a region */
+
+         for (size_t match = first; match < end; match++)
+         {
+            int64_t start = (int64_t) fingerprints[matches[match].fingerprint].token;
+            int64_t stop = start;
+
+            if (start < covered || start + offset < 0)
+            {
+               continue;
+            }
+            while (stop < size && stop + offset < other_size
+                   && (!same_file || stop < start + offset)
+                   && (*tokens)[stop].id == (*other_tokens)[stop + offset].id)
+            {
+               stop++;
+            }
+            if (stop - start < CLONE_KGRAM)
+            {
+               continue; /* The files have changed, or the hashes collide */
+            }
+            while (start > covered && start + offset > 0
+                   && (!same_file || start - 1 + offset >= stop)
+                   && (*tokens)[start - 1].id == (*other_tokens)[start - 1 + offset].id)
+            {
+               start--;
+            }
+            covered = stop;
+
+            if (stop - start >= m_minTokens)
+            {
+               struct clone_region region;
+
+               region.file = matches[first].file;
+               region.first_line = (int) (*tokens)[start].line;
+               region.last_line = (int) (*tokens)[stop - 1].line;
+               region.other_file = matches[first].other_file;
+               region.other_first_line = (int) (*other_tokens)[start + offset].line;
+               region.other_last_line = (int) (*other_tokens)[stop - 1 + offset].line;
+               region.tokens = (int) (stop - start);
+               clones->push_back(region);
+            }
+         }
+         first = end;
+         continue;
+      }
+
+      /* A file not found, matches no more than a window apart are chained into a region */
+      while (first < end)
+      {
+         size_t last = first;
+
+         while (last + 1 < end
+                && fingerprints[matches[last + 1].fingerprint].token
+                   <= fingerprints[matches[last].fingerprint].token + (uint32_t) window())
+         {
+            last++;
+         }
+
+         const int span = (int) (fingerprints[matches[last].fingerprint].token
+                                 - fingerprints[matches[first].fingerprint].token) + CLONE_KGRAM;
+         if (span >= m_minTokens)
+         {
+            struct clone_region region;
+
+            region.file = matches[first].file;
+            region.first_line = (int) fingerprints[matches[first].fingerprint].first_line;
+            region.last_line = (int) fingerprints[matches[last].fingerprint].last_line;
+            region.other_file = matches[first].other_file;
+            region.other_first_line = (int) other[matches[first].other_fingerprint].first_line;
+            region.other_last_line = (int) other[matches[last].other_fingerprint].last_line;
+            region.tokens = span;
+            clones->push_back(region);
+         }
+         first = last + 1;
+      }
+   }
+
+   std::sort(clones->begin(), clones->end(), [](const clone_region& a, const clone_region& b)
+             { return (a.file != b.file) ? a.file < b.file
+                    : (a.first_line != b.first_line) ? a.first_line < b.first_line
+                    : (a.other_file != b.other_file) ? a.other_file < b.other_file
+                    : a.other_first_line < b.other_first_line; });
+} /* End of CCloneIndex::find_clones */
@@ -0,0 +1,136 @@
+/***-------------------------------------------------------------------------------------------------------------
+***
+*** File: Clonedetect.h
+***
+*** Duplicated code across the set, by fingerprints of normalised tokens.
+***
+*** Each source is tokenised once, skipping comments and preprocessor lines,
+*** with every identifier and every literal made the same token, so code
+*** copied and then renamed still matches. A Rabin-Karp rolling hash is taken
+*** over each run of CLONE_KGRAM tokens and the hashes are winnowed: of each
+*** window of consecutive hashes only the smallest is kept. Any duplicate of
+*** at least min_tokens tokens then shares a fingerprint, while a file keeps
+*** only about 2 / (window + 1) of its hashes.
+***
+***     CCloneIndex index(min_tokens);
+***     std::vector<clone_fingerprint> fingerprints;
+***     fingerprint_source(source, index.window(), &fingerprints);
+***     int file = index.set_file(source_name, mtime, fingerprints);
+***     index.find_clones(file, threads, &clones);
+***
+*** find_clones() joins the fingerprints by hash, each thread taking the
+*** hashes of one partition. Each match of a pair of files is then
+*** extended token by token over the two sources, read again, to the
+*** true extent of the duplicate.
+***
+*** The index can be kept between runs in a cache file, one record per
+*** line, tab separated:
+***     LDRACLONES <version> <min tokens>
+***     F <mtime> <full file name>
+***     P <hash> <token> <first line> <last line>     a fingerprint of the last F
+***
+*** update() appends the F and P records of the files set since the cache
+*** was loaded, so a run checking one file writes only that file. A file
+*** found again replaces its earlier records. Once more of the records are
+*** replaced than are in use the cache is written again in full.
+***
+***-------------------------------------------------------------------------------------------------------------*/
+#ifndef CLONEDETECT_H
+#define CLONEDETECT_H
+
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+
+/*
+ * Macros
+ */
+#define CLONE_KGRAM            16     /* Tokens hashed together */
+#define CLONE_MAX_OCCURRENCES  64     /* Hashes found more often are boiler plate, not copies */
+#define CLONES_MAGIC           "LDRACLONES"
+#define CLONES_VERSION         1
+
+
+/*
+ * struct clone_fingerprint
+ * A winnowed hash of the CLONE_KGRAM tokens from token.
+ */
+struct clone_fingerprint
+{
+   uint64_t hash;
+   uint32_t token;            /* Index of the first token in the file */
+   uint32_t first_line;       /* Source lines of the first and last token */
+   uint32_t last_line;
+};
+
+/*
+ * struct clone_file
+ */
+struct clone_file
+{
+   std::string path;
+   time_t mtime;
+   std::vector<clone_fingerprint> fingerprints;   /* In token order */
+};
+
+/*
+ * struct clone_region
+ * Code of one file duplicated in another, or in itself.
+ */
+struct clone_region
+{
+   int file;
+   int first_line;
+   int last_line;
+   int other_file;
+   int other_first_line;
+   int other_last_line;
+   int tokens;                /* Tokens duplicated, at least this if a source could not be read */
+};
+
+/*
+ * class CCloneIndex
+ * Fingerprints of the files of the set. Not thread safe, find_clones() uses
+ * threads of its own.
+ */
+class CCloneIndex
+{
+public:
+   explicit CCloneIndex (int min_tokens);
+
+   int min_tokens () const { return m_minTokens; }
+   int window () const;
+
+   bool load (const char* cache_file);
+   bool save (const char* cache_file, std::string* error);
+   bool update (const char* cache_file, std::string* error);
+   bool is_modified () const { return m_modified; }
+
+   /* Adds or replaces the fingerprints of the file */
+   int set_file (std::string_view path, time_t mtime, std::vector<clone_fingerprint>& fingerprints);
+   int find_file (std::string_view path) const;
+   int file_count () const { return (int) m_files.size(); }
+   const struct clone_file& file (int index) const { return m_files[index]; }
+
+   /* Duplicates of at least min_tokens, only those of file unless -1 */
+   void find_clones (int file, unsigned int threads, std::vector<clone_region>* clones) const;
+
+private:
+   int m_minTokens;
+   std::vector<clone_file> m_files;
+   std::unordered_map<std::string, int> m_index;    /* Path to file */
+   bool m_modified;
+   bool m_synced;                 /* The cache holds the index, but for the files pending */
+   std::vector<int> m_pending;    /* Files set since the cache was loaded or saved */
+   size_t m_replaced;             /* Fingerprint records of the cache replaced by later ones */
+};
+
+
+/* Winnowed fingerprints of a C/C++ source */
+void fingerprint_source (std::string_view source, int window, std::vector<clone_fingerprint>* fingerprints);
+
+#endif /* CLONEDETECT_H */
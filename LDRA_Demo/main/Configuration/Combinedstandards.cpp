@@ -24,6 +24,176 @@
 ***  PLEASE NOTE: AS PER TBGLHAPI DOCUMENTATION, THE EXECUTABLE MUST BE RUN FROM THE LDRA INSTALLATION DIRECTORY
 ***
 ***
+*** Daemon Mode
+*** -----------
+***  Each analysis normally starts the generator from scratch, connecting to the
+***  GLH API and loading the GLH again. Instead a resident daemon can be started
+***  once, from the LDRA installation directory:
+***
+***     Userstandards_combined.exe --daemon C:\LDRA_Workarea\stdchk.sock
+***
+***  and STDCHK_SOCKET=C:\LDRA_Workarea\stdchk.sock set in the environment of
+***  contestbed. The generator run by contestbed then only forwards its four
+***  arguments to the daemon and waits for the result. If the daemon cannot be
+***  reached the checks are run in-process as before.
+***
+***  The daemon keeps the GLH API connection, the loaded GLH and the symbols of
+***  each File between requests, and serves several clients at once: one per
+***  processor, each on a worker thread that keeps its checker and arena warm
+***  from one request to the next. Further clients wait their turn.
+***
+***  The settings of the checks are those of the daemon's environment, read
+***  at its first request: STDCHK_TABLE, CSTANDARDS_MODEL, STDCHK_METPEN,
+***  STDCHK_SYSEARCH, STDCHK_INCLUDE_GRAPH, STDCHK_CLONES, STDCHK_BANNED,
+***  STDCHK_BASELINE and STDCHK_BASELINE_RECORD. The generator sends its own
+***  with each File, and one whose settings differ from the daemon's is
+***  refused and runs the checks in-process with its own. STDCHK_DIFF is
+***  sent with the File and applies to it alone.
+***  It is stopped with:
+***
+***     Userstandards_combined.exe --stop C:\LDRA_Workarea\stdchk.sock
+***
+***
+*** Watch Mode (Linux)
+*** ------------------
+***  For local development the standards can be re-checked each time a source
+***  is saved, rather than after a full analysis:
+***
+***     Userstandards_combined --watch watch.lst
+***
+***  watch.lst has one line per File, the tab separated fields being those given
+***  to the generator by contestbed: <full source name> <module number> <glh path>
+***  The symbols for the H Standards come from the GLH, as left by the last
+***  analysis, and are only read again when the GLH changes. Each time a File
+***  is written the violations that appeared (+) or went (-) are printed.
+***  Z Standard lines are source lines, H Standard lines reformatted lines.
+***
+***
+*** Changed Lines Only
+*** ------------------
+***  For pull request checks, set STDCHK_DIFF to a file describing the changes:
+***  either a unified diff (git diff -U0 is enough), or lines of
+***  <source>:<first>[-<last>]. Only the changed lines are then scanned and only
+***  violations on those lines (and those of the File as a whole) are written.
+***  Sources are matched to the diff by the end of their path, a File the diff
+***  does not mention has no changed lines.
+***
+***
+*** Standards Model
+*** ---------------
+***  The H and Z Standards checked can follow <lang>pen.dat and the Programming
+***  Standards Model of <lang>report.dat, through the standards table compiled
+***  from them (see Stdtable.h):
+***
+***     Stdtablegen.exe Cpen.dat Creport.dat Cstandards.tbl
+***
+***  Cstandards.tbl is read from the current (LDRA installation) directory, or
+***  from STDCHK_TABLE. A standard marked not used for the language is not
+***  checked, and when CSTANDARDS_MODEL is set neither is one outside that model.
+***  Standards missing from the table are checked as before, as are all of them
+***  when there is no table.
+***
+***
+*** Procedure Metrics
+*** -----------------
+***  7 Z to 10 Z check the metrics of each procedure as the source is scanned,
+***  without waiting for the complexity analysis. The limits are those of the
+***  Procedure metrics switched on in Metpen.dat, read from the current
+***  directory or from STDCHK_METPEN: Cyclomatic Complexity, Executable
+***  reformatted Lines, Comments in Headers and Total Comments. The parameter
+***  limit is the *** value of 18 S in the model, 6 if there is no table. The
+***  metrics are calculated on the source as written, so can differ slightly
+***  from those of the full analysis.
+***
+***
+*** Include Resolution
+*** ------------------
+***  When STDCHK_SYSEARCH names the sysearch.dat of the project, every
+***  "name" and <name> include is resolved through its search directories
+***  (see Includeresolver.h) and one not found is reported by 11 Z. Includes
+***  sysearch.dat says are not searched for (type 300/301) are not reported.
+***  The .naming report gives the file each include resolves to. The files of
+***  the search directories are indexed once, when the daemon or watch mode
+***  starts, so an include added later needs a restart to be found.
+***
+***
+*** Include Graph
+*** -------------
+***  With STDCHK_SYSEARCH set the includes also form the include graph of the
+***  set, kept between runs in Includegraph.dat of the work area (or the file
+***  STDCHK_INCLUDE_GRAPH names). Each run updates the File and reads only the
+***  headers changed since the graph was saved, then reports on the includes
+***  of the File:
+***     12 Z an include which is part of an include cycle
+***     13 Z an include pulling in more than *** files, 100 by default
+***     14 Z an include already included, directly or through another
+***  Generators checking Files at the same time take turns with the graph,
+***  through a lock on Includegraph.dat.lock beside it.
+***  Stdincludes.exe reports the cycles of the whole set and ranks the
+***  headers costing the most compile time (see Stdincludes.cpp).
+***
+***
+*** Duplicated Code
+*** ---------------
+***  15 Z reports code of the File duplicated in the File or in another File
+***  of the set, of at least *** tokens (100 by default), once identifiers
+***  and literals are ignored (see Clonedetect.h). Each run fingerprints the
+***  File and keeps the fingerprints of the set in Clonefingerprints.dat of
+***  the work area, or the file STDCHK_CLONES names, so a duplicate is found
+***  once both Files have been checked. A run adds the records of its File
+***  to the end of the cache, through a lock on Clonefingerprints.dat.lock
+***  beside it. Stdclones.exe finds the duplicates of a whole set of sources
+***  in one pass.
+***
+***
+*** Banned Identifiers
+*** ------------------
+***  16 Z reports each use of a function or macro of the banned list, read
+***  from Banned.dat of the current directory or the file STDCHK_BANNED
+***  names: one name per line, optionally followed by the reason or what to
+***  use instead, which is added to the violation text. Only whole
+***  identifiers of the code are matched, not those in comments or strings,
+***  and each is reported on its own line. The list is hashed once, when
+***  the generator or the daemon starts (see Bannedlist.h), so a list of
+***  any length costs the same per identifier.
+***
+***
+*** Suppressions
+*** ------------
+***  A violation can be justified where it is, rather than by taking the
+***  standard out of the model, with a comment giving the standards and the
+***  reason (see Suppressions.h):
+***     x = 0x1F;   // STDCHK-SUPPRESS 5Z: register layout from the data sheet
+***     // STDCHK-SUPPRESS-BEGIN 5Z, 6Z: generated tables
+***     // STDCHK-SUPPRESS-END 5Z, 6Z
+***     // STDCHK-SUPPRESS-FILE 2Z: name fixed by the vendor
+***  Any H or Z Standard can be suppressed, H Standards on the reformatted
+***  lines of the source lines suppressed. Suppressed violations are not
+***  written to the SIF file, the .naming report lists each with its reason
+***  and ends with the number of suppressions and of violations suppressed
+***  in the File, so Files relying on them can be found.
+***
+***
+*** Baseline
+*** --------
+***  Violations already accepted, e.g. those of legacy code, can be left out
+***  so that only new violations are written. First record the violations of
+***  the set, with STDCHK_BASELINE_RECORD naming a file the generator adds
+***  the fingerprint of each violation to, and analyse the set. Then write
+***  the baseline from it (see Stdbaseline.cpp):
+***
+***     Stdbaseline.exe Baseline.rec Baseline.dat
+***
+***  With STDCHK_BASELINE naming the baseline, later runs write only the
+***  violations not in it. A violation is matched by its File, standard,
+***  text and source line content, not by its line number, so it is still
+***  matched once the code has moved (see Baseline.h). A change to the line
+***  itself makes it a new violation. The baseline is mapped once per
+***  session and each violation is a binary search of it, so a baseline of
+***  millions of violations costs no more than reading the File. The .naming
+***  report gives the number of violations of the File in the baseline.
+***
+***
 *** Enabling H Standards Checking
 *** -----------------------------
 ***     Ensure your <lang>pen.dat contains the H Standard References as below.
@@ -61,12 +231,26 @@
 ***     820 00 1    0    4 Z Source does not match layout template.
 ***     821 00 1    0    5 Z Hexadecimal number found.
 ***     822 00 1    0    6 Z Forbidden word found.
+***     845 00 1   25    7 Z Cyclomatic complexity greater than ***.
+***     846 00 1  200    8 Z Procedure exceeds *** executable lines.
+***     847 00 1    2    9 Z Procedure has fewer than *** comments.
+***     848 00 1    6   10 Z More than *** parameters in procedure.
+***     849 00 1    0   11 Z Include file not found.
+***     850 00 1    0   12 Z Include cycle found.
+***     851 00 1  100   13 Z Include pulls in more than *** files.
+***     852 00 1    0   14 Z Redundant include.
+***     853 00 1  100   15 Z Duplicated code of more than *** tokens.
+***     854 00 1    0   16 Z Banned function or macro used.
 ***
 ***
 *** Editing this File
 *** -----------------
 *** The arguments passed to this program are fixed (see main below).
 ***
+*** The standards themselves are in Standardsengine.cpp, which is also built as
+*** the libstandardsengine.a library (see makefile). This file loads the
+*** symbols from the GLH API, runs the engine and writes its results.
+***
 *** Standards violations are in the form of LDRA SIF 101 records.
 ***
 *** Any 101 records generated must be of valid format, especially with
@@ -75,19 +259,92 @@
 ***
 ***-------------------------------------------------------------------------------------------------------------*/
 #include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cerrno>
+#include <climits>
+#include <condition_variable>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <chrono>
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <winsock2.h>
+#include <afunix.h>
+#else
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#endif
 #include <common_class_holder.hpp>
 #include <glhwrapper_interface.h>
 #include <tblinemapper_interface.h>
+#include "Standardsengine.h"
+#include "Stdtable.h"
+#include "Includegraph.h"
+#include "Clonedetect.h"
+#include "Baseline.h"
 
 
 /*
  * Macros
  */
 #define MAXSTR 520 /* Max String Size */
-#define MESSAGE_SIZE 200
 #define REPORT     /* Produces a .naming File in the workarea detailing any Standards that are violated */
-#define HSTANDARD 'H'
-#define ZSTANDARD 'Z'
+#define SYMBOL_CACHE_MAX 1024   /* Files whose symbols the daemon keeps */
+#define MAX_REQUEST_SIZE 65536  /* Largest daemon request accepted */
+#define MIN_DAEMON_WORKERS 2    /* Threads serving daemon requests, at least */
+#define DAEMON_RECEIVE_TIMEOUT 60  /* Seconds a client may take to send its request */
+#define DAEMON_ACCEPT_BACKOFF 100  /* Milliseconds to wait before accepting again after a failure */
+#define SOCKET_ENV "STDCHK_SOCKET"
+#define DIFF_ENV   "STDCHK_DIFF"
+#define WATCH_SETTLE_MS  200    /* Quiet period that ends a burst of writes */
+#define TABLE_ENV  "STDCHK_TABLE"
+#define MODEL_ENV  "CSTANDARDS_MODEL"
+#define DEFAULT_TABLE "Cstandards.tbl"
+#define METPEN_ENV "STDCHK_METPEN"
+#define DEFAULT_METPEN "Metpen.dat"
+#define DEFAULT_MAX_PARAMETERS 6   /* *** of 18 S, when the table does not give it */
+#define SYSEARCH_ENV "STDCHK_SYSEARCH"
+#define INCLUDE_GRAPH_ENV "STDCHK_INCLUDE_GRAPH"
+#define DEFAULT_INCLUDE_GRAPH "Includegraph.dat"
+#define DEFAULT_MAX_INCLUDE_CLOSURE 100   /* *** of 13 Z, when the table does not give it */
+#define CLONES_ENV "STDCHK_CLONES"
+#define DEFAULT_CLONES "Clonefingerprints.dat"
+#define DEFAULT_MIN_CLONE_TOKENS 100      /* *** of 15 Z, when the table does not give it */
+#define BANNED_ENV "STDCHK_BANNED"
+#define DEFAULT_BANNED "Banned.dat"
+#define BASELINE_ENV "STDCHK_BASELINE"
+#define BASELINE_RECORD_ENV "STDCHK_BASELINE_RECORD"
+#define DAEMON_REFUSED "refused"  /* Reply of the daemon to a request it does not run */
+
+#ifdef _WIN32
+typedef SOCKET socket_t;
+#define close_socket closesocket
+#define SHUT_WR SD_SEND
+#define SHUT_RDWR SD_BOTH
+#else
+typedef int socket_t;
+#define INVALID_SOCKET (-1)
+#define close_socket close
+#endif
 
 /*
  * Enumeration
@@ -113,6 +370,7 @@ struct input_data
   char* glh_path;
   char* phases_string;
   char* workdir;
+  char* diff_file;      /* NULL, or only check the lines it changes */
 };
 
 /*
@@ -131,78 +389,172 @@ struct sif_101_info
                                  or additional information such as the file name */
 };
 
+/*
+ * struct cached_symbols
+ * Symbol table of a File, with the GLH it was loaded from.
+ */
+struct cached_symbols
+{
+   time_t glh_mtime;
+   struct symbol_table symbols;
+};
+
+/*
+ * struct cache_stamp
+ * The cache file as last loaded or saved, another generator saving it
+ * changes the stamp.
+ */
+struct cache_stamp
+{
+   time_t mtime = 0;
+   long long size = -1;       /* -1 when there is no cache file */
+   unsigned long long inode = 0;
+};
+
+/*
+ * class CCacheLock
+ * Advisory lock on <cache>.lock, held from loading a cache shared by the
+ * generators of the set to saving it, so that generators running at the
+ * same time do not overwrite each other's updates. Where the lock file
+ * cannot be created the cache is used without it.
+ */
+class CCacheLock
+{
+public:
+   explicit CCacheLock (const std::string & cache_file);
+   ~CCacheLock ();
+
+private:
+#ifdef _WIN32
+   HANDLE m_handle;
+#else
+   int m_fd;
+#endif
+
+   CCacheLock (const CCacheLock&);
+   CCacheLock& operator= (const CCacheLock&);
+};
+
+/*
+ * struct glh_session
+ * Connection to the GLH API. A single run of the generator has its own,
+ * in daemon mode one is shared by every request so the connection, the
+ * loaded GLH and the symbol tables stay warm. The GLH API is not
+ * re-entrant, all use of it is under mutex.
+ */
+struct glh_session
+{
+   CGLHWrapperClass wrapper;
+   IToolSuiteInterface* iObj = NULL;
+   std::string loaded_glh;
+   time_t loaded_mtime = 0;
+   std::mutex mutex;
+   std::map<std::string, std::shared_ptr<struct cached_symbols> > symbol_cache;
+   bool rules_selected = false;             /* Rules read from the standards table */
+   unsigned int h_rules = DEFAULT_H_RULES;
+   unsigned int z_rules = DEFAULT_Z_RULES;
+   struct metric_limits metrics;            /* Procedure metric limits, from Metpen.dat */
+   CIncludeResolver includes;               /* Search directories of sysearch.dat */
+   int max_include_closure = DEFAULT_MAX_INCLUDE_CLOSURE;
+   std::mutex include_graph_mutex;          /* Held while the graph is used */
+   CIncludeGraph include_graph;
+   std::string include_graph_file;          /* Cache the graph was loaded from */
+   struct cache_stamp include_graph_stamp;  /* and its stamp */
+   int min_clone_tokens = DEFAULT_MIN_CLONE_TOKENS;
+   std::mutex clone_mutex;                  /* Held while the fingerprints are used */
+   std::unique_ptr<CCloneIndex> clones;     /* Fingerprints of the set */
+   std::string clones_file;                 /* Cache they were loaded from */
+   struct cache_stamp clones_stamp;         /* and its stamp */
+   CBannedList banned;                      /* Banned functions and macros, 16 Z */
+   CBaseline baseline;                      /* Violations accepted */
+   std::string baseline_record;             /* Fingerprints of the violations go here */
+   std::mutex baseline_mutex;               /* Held while the record is written */
+};
+
 
 /*
- * H Standard - User Editable Prototypes
+ * struct set_violation
+ * A violation of a set level standard, see check_include_graph and
+ * check_duplicate_code.
  */
-void append_standards_violations (const struct input_data* data, IToolSuiteInterface * iObj);
-
-/* Check Globals 1 H */
-void check_globals(const struct input_data * data,
-                   FILE * fp,
-                   IToolSuiteInterface * iObj);
-
-/* Check Class Members 2 H */
-void check_class_members (const struct input_data * data,
-                          FILE * fp,
-                          IToolSuiteInterface * iObj);
-
-/* Check Enums 3 H, 7 H */
-void check_enums(const struct input_data * data,
-                 FILE * fp,
-                 IToolSuiteInterface * iObj);
-
-/* Check Classes 4 H */
-void check_classes(const struct input_data * data,
-                   FILE * fp,
-                   IToolSuiteInterface * iObj);
-
-/* Check Namespaces 5 H */
-void check_namespaces(const struct input_data * data,
-                      FILE * fp,
-                      IToolSuiteInterface * iObj);
-
-/* Check Pointer Parameters 6 H */
-void check_pointers(const struct input_data * data,
-                    FILE * fp,
-                    IToolSuiteInterface * iObj);
-
-/* Check Global Functions 8 H */
-void check_global_functions(const struct input_data * data,
-                            FILE * fp,
-                            IToolSuiteInterface * iObj);
-
-/* Check Global Vars 9 H */
-void check_global_vars(const struct input_data * data,
-                            FILE * fp,
-                            IToolSuiteInterface * iObj);
-
-/* Check Null Terminated String 10 H */
-void check_null_terminated_strings(const struct input_data * data,
-                            FILE * fp,
-                            IToolSuiteInterface * iObj);
+struct set_violation
+{
+   int std_num;
+   int line;                  /* Source line */
+   std::string text;
+};
 
 
 /*
- * Z Standard - User Editable Prototypes
+ * Prototypes
  */
-/* 1 Z: File exceeds required size. */
-void check_file_size (const struct input_data* data, FILE* fp);
+int run_standards_check (struct glh_session * session, char* const args[], int arg_count,
+                         std::string * messages);
 
-/* 2 Z: Checks filename size is <= 8 characters */
-void check_filename_size (const struct input_data* data, FILE* fp);
+void append_standards_violations (const struct input_data* data,
+                                  struct glh_session * session,
+                                  const struct symbol_table * symbols,
+                                  std::string * messages);
 
-/* 3 Z: Checks include filename is the same as the source filename */
-void check_includename (const struct input_data* data, FILE* fp, char * line1);
+/* H and Z Standards to check, from the standards table */
+void select_rules (struct glh_session * session, struct check_request * request,
+                   std::string * messages);
 
-/* 4 Z: Checks that layout templates are met */
-void check_templates (const struct input_data* data, FILE* fp, char * line);
+/* Stamp of a cache file, to find whether it has been saved since */
+struct cache_stamp read_cache_stamp (const std::string & cache_file);
 
-/* 5 Z: Checks that there is no use of hexadecimal radix */
-void check_radix (const struct input_data* data, FILE* fp, char * line);
+bool same_cache_stamp (const struct cache_stamp & a, const struct cache_stamp & b);
 
-/* 6 Z: Checks that there is no use of forbidden words */
-void check_forbidden_words (const struct input_data* data, FILE* fp, char * line, int linenum);
+/* 12 Z - 14 Z: Set level include standards, from the include graph */
+void check_include_graph (const struct input_data* data,
+                          struct glh_session * session,
+                          const struct check_request & request,
+                          const struct check_result & result,
+                          std::vector<struct set_violation> * violations,
+                          std::string * messages);
+
+/* 15 Z: Set level duplicated code, from the fingerprints of the set */
+void check_duplicate_code (const struct input_data* data,
+                           struct glh_session * session,
+                           const struct check_request & request,
+                           std::vector<struct set_violation> * violations,
+                           std::string * messages);
+
+/* Adds the fingerprints of the violations written to the baseline record */
+void record_baseline (struct glh_session * session, const std::vector<uint64_t> & fingerprints,
+                      std::string * messages);
+
+/* Suppressions of the File, on the lines of the violations they cover */
+void index_suppressions (const struct input_data* data,
+                         struct glh_session * session,
+                         const struct check_result & result,
+                         CSuppressionIndex * index);
+
+/* Procedure metric limits from <lang>Metpen.dat */
+int read_metric_limits (const char* metpen_file, struct metric_limits* limits);
+
+/* Symbol table for a File, from the session cache or the GLH API */
+std::shared_ptr<const struct symbol_table> get_symbol_table (struct glh_session * session,
+                                                             const struct input_data * data);
+
+/* Load the per-file symbol table from the GLH API */
+void load_symbol_table (const struct input_data * data,
+                        IToolSuiteInterface * iObj,
+                        struct symbol_table * symbols);
+
+/* Read the whole source file */
+int read_source_file (const char* source_name, std::string* text);
+
+/* Lines of the source changed by the diff */
+int read_changed_lines (const char* diff_file, const char* source_name,
+                        std::vector<line_range>* ranges);
+
+/* Daemon Mode */
+int run_daemon (const char* socket_path);
+bool forward_to_daemon (const char* socket_path, char* const args[], int arg_count, int* return_code);
+
+/* Watch Mode */
+int run_watch (const char* watch_list);
 
 
 /*
@@ -211,7 +563,7 @@ void check_forbidden_words (const struct input_data* data, FILE* fp, char * line
 void append_violation (const struct input_data* data,
                        FILE* fp,
                        const int std_num,
-                       const char *message,
+                       std::string_view message,
                        const int linenumber,
                        const char std_letter);
 
@@ -223,18 +575,11 @@ void split_directory_path (const char *file_name,char *reduced_name,
 
 void print_101_struct (FILE* fp, const struct sif_101_info* std, const char std_letter);
 
-void process_naming_conformance (const struct input_data * data,
-                                  FILE * fp,
-                                  const char* type,
-                                  const char* style,
-                                  const char* name,
-                                  const int conforms,
-                                  const int linenumber,
-                                  const int std_num);
+FILE* open_report (const struct input_data* data);
 
-void  print_to_report (const char* message, const int linenumber, const struct input_data* data);
+void  print_to_report (FILE* fpRep, std::string_view message, const int linenumber);
 
-long fsize (const char *infile);
+void  close_report (FILE* fpRep);
 
 
 
@@ -263,74 +608,74 @@ int main(int argc, char* argv[])
 {
   int return_code = 0;
   const int VALID_ARGC = 5;
-  char filename[MAXSTR] = {0};
-  char workfilesdir[MAXSTR] = {0};
-  struct input_data input_d;
 
-  try
+  /* Daemon Mode, see the File header */
+  if (argc == 3 && strcmp(argv[1], "--daemon") == 0)
   {
-     /* Check the correct number of arguments are provided */
-      if (argc == VALID_ARGC)
-      {
-         /* Full Source File Path */
-         input_d.source_name = argv[1];
-         /* Source File Module Number as int */
-         input_d.module_id = atoi(argv[2]);
-         /* Full GLH File Path */
-         input_d.glh_path = argv[3];
-         /* Phases Executed */
-         input_d.phases_string = argv[4];
-
-         /* Extract the workfiles directory from the GLH Path */
-         split_directory_path(input_d.glh_path, filename, workfilesdir);
-         /* Source LDRA Workfiles Directory */
-         input_d.workdir = workfilesdir;
-
-
-          /* Connect to the GLH API */
-          CGLHWrapperClass wrapperInterface;
-          IToolSuiteInterface * interfaceObj = wrapperInterface.getCreatedIEntityTool();
-
-         /* If a connection is made, load the Results for the GLH File */
-          if (interfaceObj != (IToolSuiteInterface*)(0))
-          {
-              if (!interfaceObj->loadResults(input_d.glh_path))
-              {
-                  throw "Failed to load GLH File";
-              }
-
-              /* Begin checking for H/Z Standard Violations now the GLH API is initialised */
-              append_standards_violations (&input_d, interfaceObj);
-          }
-          else
-          {
-              throw "Failed to load GLH Interface Object, are you running from the LDRA Toolsuite directory?";
-          }
-      }
-      else
-      {
-         printf ("Invalid number of arguments\n"\
-                 "Arguments are: <full source name> <module number> <glh path> <phases run - MSA CMP...>\n");
-         return_code = 1;
-      }
+     return run_daemon(argv[2]);
   }
-  catch(const char * msg)
+  if (argc == 3 && strcmp(argv[1], "--watch") == 0)
   {
-      printf("%s\n", msg);
-      return_code = 1;
+     return run_watch(argv[2]);
   }
-  catch(...)
+  if (argc == 3 && strcmp(argv[1], "--stop") == 0)
   {
-      printf("Unknown Error Occurred\n");
-      return_code = 1;
+     char* stop_args[] = { (char*) "--stop" };
+     if (!forward_to_daemon(argv[2], stop_args, 1, &return_code))
+     {
+        printf("No daemon listening on %s\n", argv[2]);
+        return_code = 1;
+     }
+     return return_code;
   }
 
+  /* Check the correct number of arguments are provided */
+  if (argc == VALID_ARGC)
+  {
+     std::string messages;
+     const char* socket_path = getenv(SOCKET_ENV);
+     char* diff_file = getenv(DIFF_ENV);
+#ifdef _WIN32
+     char diff_path[_MAX_PATH];
+#else
+     char diff_path[PATH_MAX];
+#endif
 
-#ifdef REPORT
-  void close_report ();
-  close_report ();
+     /* The daemon has a working directory of its own, so it is given the full diff path */
+     if (diff_file != NULL && *diff_file != '\0'
+#ifdef _WIN32
+         && _fullpath(diff_path, diff_file, sizeof(diff_path)) != NULL)
+#else
+         && realpath(diff_file, diff_path) != NULL)
 #endif
+     {
+        diff_file = diff_path;
+     }
+
+     char* args[VALID_ARGC] = { argv[1], argv[2], argv[3], argv[4], diff_file };
+     const int arg_count = (diff_file != NULL && *diff_file != '\0') ? VALID_ARGC : VALID_ARGC - 1;
+
+     /* Hand the File to a running daemon, if there is one */
+     if (socket_path != NULL && *socket_path != '\0'
+         &&
+         forward_to_daemon(socket_path, args, arg_count, &return_code))
+     {
+        return return_code;
+     }
 
+     struct glh_session session;
+     return_code = run_standards_check(&session, args, arg_count, &messages);
+     printf("%s", messages.c_str());
+  }
+  else
+  {
+     printf ("Invalid number of arguments\n"\
+             "Arguments are: <full source name> <module number> <glh path> <phases run - MSA CMP...>\n"\
+             "           or: --daemon <socket path>\n"\
+             "           or: --stop <socket path>\n"\
+             "           or: --watch <watch list>\n");
+     return_code = 1;
+  }
 
   return return_code;
 } /* End of main */
@@ -339,1167 +684,1246 @@ int main(int argc, char* argv[])
 
 /***----------------------------------------------------------------
 ***
-*** Routine: append_standards_violations
+*** Routine: run_standards_check
 ***
 *** Parameters:
 *** ===========
 ***
-*** Action  Name                      Type            Use
-*** ------  ----                      ----            ---
-*** I       data                      const struct input_data *
+*** Action  Name                      Type                      Use
+*** ------  ----                      ----                      ---
+*** I       session                   struct glh_session *      GLH API Connection
+*** I       args                      char * const []           The four LDRA arguments, then
+***                                                                 optionally the diff file
+*** I       arg_count                 int                       4 or 5
+*** O       messages                  std::string *             Messages for the user
+***
+*** Return value:
+*** int             0 on success, 1 on failure (process return code)
 ***
 *** Description:
 *** ============
 ***
-*** Shows example of how to determine the appropriate SIF sub file
-*** (e.g .sf1 for main static analysis) and append a 101 record to it.
-***
-*** Each of the functions to check the appropriate H Standards are called
-*** from this function.
+*** Checks one File, as requested by the LDRA Application. Used by both
+*** a normal run and the daemon, which shares one session between
+*** requests.
 ***
 ***----------------------------------------------------------------*/
-void append_standards_violations (const struct input_data* data, IToolSuiteInterface * iObj)
+int run_standards_check (struct glh_session * session, char* const args[], int arg_count,
+                         std::string * messages)
 {
-   FILE * fp = NULL;
-   char sfn_name[MAXSTR] = {0};
-
-   /* Check that Main Static Analysis has been completed for this File */
-   if (strstr (data->phases_string, "MSA") != NULL)
-   {
-      /*
-      * Main Static Analysis has been run,
-      * Generate any standards associated with this phase
-      */
-      get_sif_sub_file_name (data, Msa, sfn_name);
-
-      /* Open the SIF File */
-      fp = fopen(sfn_name,"a");
-
-      if (fp)
-      {
-         /* Start H Standards Checking *******************************************/
-         /* Check Globals 1 H */
-         check_globals(data, fp, iObj);
-
-         /* Check Class Members 2 H */
-         check_class_members(data, fp, iObj);
-
-         /* Check Enums 3 H, 7 H */
-         check_enums(data, fp, iObj);
-
-         /* Check Classes 4 H */
-         check_classes(data, fp, iObj);
-
-         /* Check Namespaces 5 H */
-         check_namespaces(data, fp, iObj);
-
-         /* Check Pointer Parameters 6 H */
-         check_pointers(data, fp, iObj);
-
-         /* Check Global Function Names 8 H */
-         check_global_functions(data, fp, iObj);
-
-         /* Check Global Var Names 9 H */
-         check_global_vars(data, fp, iObj);
-
-         /* Check Global Function Names 10 H */
-//         check_null_terminated_strings(data, fp, iObj);
-         /* End H Standards Checking *********************************************/
-
-
-         /* Start Z Standards Checking *******************************************/
-         /* Check File Size 1 Z */
-         check_file_size(data, fp);
-
-         /* 2 Z: Checks filename size is <= 8 characters */
-         check_filename_size (data, fp);
-
-         /* The following checks are performed on the source, line by line */
-         char line[MAXSTR];
-         FILE *source_fp = fopen(data->source_name, "r");
-         if (source_fp == NULL)
-         {
-            printf("Source file %s not found\n", data->source_name);
-         }
-         else
-         {
-            int end = 0;
-            int linenum = 1;
-            while( !end )
-            {
-               memset(line, 0, sizeof(line));
-
-               if (fgets(line, MAXSTR, source_fp) != NULL )
-               { /* remove newline from end of string */
-                  line[strlen(line)-1] = '\0';
-
-                  /* 3 Z: Checks include filename is the same as the source filename */
-                  check_includename (data, fp, line);
-
-                  /* 4 Z: Checks that layout templates are met */
-                  check_templates (data, fp, line);
-
-                  /* 5 Z: Checks that there is no use of hexadecimal radix */
-                  check_radix (data, fp, line);
-
-                  /* 6 Z: Checks that there is no use of forbidden words */
-                  check_forbidden_words (data, fp, line, linenum);
-                  linenum++;
-               }
-               else
-               {
-                  end = 1;
-               }
-            }
-         }
-         fclose(source_fp);
-         /* End Z Standards Checking *********************************************/
-
-
-         fclose(fp);
-      }
-   }
-} /* End of append_standards_violations */
+  int return_code = 0;
+  char filename[MAXSTR] = {0};
+  char workfilesdir[MAXSTR] = {0};
+  struct input_data input_d;
 
+  try
+  {
+     /* Full Source File Path */
+     input_d.source_name = args[0];
+     /* Source File Module Number as int */
+     input_d.module_id = atoi(args[1]);
+     /* Full GLH File Path */
+     input_d.glh_path = args[2];
+     /* Phases Executed */
+     input_d.phases_string = args[3];
+     /* Diff File, only check the lines changed */
+     input_d.diff_file = (arg_count > 4) ? args[4] : NULL;
+
+     /* Extract the workfiles directory from the GLH Path */
+     split_directory_path(input_d.glh_path, filename, workfilesdir);
+     /* Source LDRA Workfiles Directory */
+     input_d.workdir = workfilesdir;
+
+     /* Check that Main Static Analysis has been completed for this File */
+     if (strstr (input_d.phases_string, "MSA") != NULL)
+     {
+        /* Connect to the GLH API and read the symbols for this File */
+        std::shared_ptr<const struct symbol_table> symbols = get_symbol_table(session, &input_d);
 
+        /* Begin checking for H/Z Standard Violations now the GLH API is initialised */
+        append_standards_violations (&input_d, session, symbols.get(), messages);
+     }
+  }
+  catch(const char * msg)
+  {
+      messages->append(msg).append("\n");
+      return_code = 1;
+  }
+  catch(...)
+  {
+      messages->append("Unknown Error Occurred\n");
+      return_code = 1;
+  }
 
+  return return_code;
+} /* End of run_standards_check */
 
 
-/***----------------------------------------------------------------
-***
-*** Start of Standards
-***
-***----------------------------------------------------------------*/
 
 /***----------------------------------------------------------------
 ***
-*** Routine: check_globals
+*** Routine: get_symbol_table
 ***
 *** Parameters:
 *** ===========
 ***
-*** Action  Name             Type                           Use
-*** ------  ----             ----                           ---
-*** I       data             const struct input_data *      Argument Data
-*** I       fp               FILE *                         SIF File pointer
-*** I       iObj             IToolSuiteInterface *          GLH API Interface
+*** Action  Name                      Type                      Use
+*** ------  ----                      ----                      ---
+*** I       session                   struct glh_session *      GLH API Connection
+*** I       data                      const struct input_data * Argument Data
+***
+*** Return value:
+*** Symbol table for the File, shared with the session cache
 ***
 *** Description:
 *** ============
 ***
-*** Checks that global variables in a File conform to H Standard g_<name>
-***
-*** Standards:
-*** ==========
+*** The symbols of a File are only read from the GLH API when the GLH has
+*** changed since they were last read, and the GLH is only loaded when it
+*** is not the one already loaded. Both are keyed on the GLH modification
+*** time. Throws if the GLH API is not available or the GLH cannot be loaded.
 ***
-*** 1 H Global Variable does not conform to style g_<name>
-***
-***-----------------------------------------------------------------*/
-void check_globals(const struct input_data * data,
-                   FILE * fp,
-                   IToolSuiteInterface * iObj)
+***----------------------------------------------------------------*/
+std::shared_ptr<const struct symbol_table> get_symbol_table (struct glh_session * session,
+                                                             const struct input_data * data)
 {
-   NLDRAAnalysis::CVariableTypeDeclaration globalVariableHolder;
+   std::lock_guard<std::mutex> lock(session->mutex);
+   struct stat glh_stat;
+   const time_t glh_mtime = (stat(data->glh_path, &glh_stat) == 0) ? glh_stat.st_mtime : 0;
+   char module_key[32];
 
-   /* Load Global Variable results for File */
-   iObj->loadGlobalComponent(data->source_name, GLOBAL_VARS, FileResults);
+   sprintf(module_key, "|%d", data->module_id);
+   const std::string key = std::string(data->glh_path) + module_key;
 
+   std::shared_ptr<struct cached_symbols>& cached = session->symbol_cache[key];
+   if (cached && cached->glh_mtime == glh_mtime && glh_mtime != 0)
+   {
+      return std::shared_ptr<const struct symbol_table>(cached, &cached->symbols);
+   }
 
-   /* Loop through each global variable found and check conformation with the Penalty */
-   while(iObj->readGlobalComponent(globalVariableHolder))
+   /* Connect to the GLH API */
+   if (session->iObj == NULL)
    {
-      char globalVariableName[MAXSTR] = {0};
-      int conforms = 1;
-      const int globalVariableLineNumber = globalVariableHolder.getRefStartLine();
-      strcpy (globalVariableName, globalVariableHolder.getName());
+      session->iObj = session->wrapper.getCreatedIEntityTool();
+      if (session->iObj == (IToolSuiteInterface*)(0))
+      {
+         session->symbol_cache.erase(key);
+         throw "Failed to load GLH Interface Object, are you running from the LDRA Toolsuite directory?";
+      }
+   }
 
-      /* Perform the check */
-      if(globalVariableName[0] != 'g' || globalVariableName[1] != '_')
+   /* If a connection is made, load the Results for the GLH File */
+   if (session->loaded_glh != data->glh_path || session->loaded_mtime != glh_mtime || glh_mtime == 0)
+   {
+      session->loaded_glh.clear();
+      if (!session->iObj->loadResults(data->glh_path))
       {
-         conforms = 0;
+         session->symbol_cache.erase(key);
+         throw "Failed to load GLH File";
       }
+      session->loaded_glh = data->glh_path;
+      session->loaded_mtime = glh_mtime;
+   }
 
-      /* Record the Result */
-      process_naming_conformance (data, fp,
-                                   "Global",
-                                   "g_<name>",
-                                   globalVariableName, conforms, globalVariableLineNumber,
-                                   1);
+   /* Tables still in use by another request stay alive through their shared_ptr */
+   if (session->symbol_cache.size() > SYMBOL_CACHE_MAX)
+   {
+      session->symbol_cache.clear();
    }
-} /* End of check_globals */
 
+   std::shared_ptr<struct cached_symbols> fresh = std::make_shared<struct cached_symbols>();
+   fresh->glh_mtime = glh_mtime;
+   load_symbol_table(data, session->iObj, &fresh->symbols);
+   session->symbol_cache[key] = fresh;
+
+   return std::shared_ptr<const struct symbol_table>(fresh, &fresh->symbols);
+} /* End of get_symbol_table */
 
-/*
- * fullName = "C:\LDRA\LDRA_Demos\TICCS50_Workspace\TICCS50_TMS320F28335_Dice\dice.c"
- * return just the name ex: "dice"
- */
-void getFileName( char* aName, const char* fullName ) {
-	int dot_pos=0;
-	int slash_pos=0;
-
-	/* Find the last position of the dot and slash */
-	int iter=0;
-	while ( iter < strlen(fullName) ) {
-		if ( fullName[iter] == '.' ) {
-			dot_pos = iter;
-		}
-		if ( (fullName[iter] == '//') || (fullName[iter] == '\\') ) {
-			slash_pos = iter;
-		}
-		iter++;
-	}
-	/* Return name */
-	if ( dot_pos > slash_pos ) {
-		strncpy ( aName, &fullName[slash_pos+1], dot_pos-slash_pos-1); 
-	}
-}
 
 
 /***----------------------------------------------------------------
 ***
-*** Routine: check_global_vars
+*** Routine: select_rules
 ***
 *** Parameters:
 *** ===========
 ***
-*** Action  Name             Type                           Use
-*** ------  ----             ----                           ---
-*** I       data             const struct input_data *      Argument Data
-*** I       fp               FILE *                         SIF File pointer
-*** I       iObj             IToolSuiteInterface *          GLH API Interface
+*** Action  Name                      Type                      Use
+*** ------  ----                      ----                      ---
+*** IO      session                   struct glh_session *      Holds the rules once read
+*** O       request                   struct check_request *    Rules to check
+*** O       messages                  std::string *             Messages for the user, may be NULL
 ***
 *** Description:
 *** ============
 ***
-*** Checks that global variables in a File conform to H Standard <file>_<name>
-***
-*** Standards:
-*** ==========
+*** The table is mapped once per session and the rules kept, so a daemon
+*** reads it only at its first request. See Standards Model in the File
+*** header.
 ***
-*** 9 H Global Var does not conform to style <file>_<name>
-***
-***-----------------------------------------------------------------*/
+***----------------------------------------------------------------*/
+void select_rules (struct glh_session * session, struct check_request * request,
+                   std::string * messages)
+{
+   std::lock_guard<std::mutex> lock(session->mutex);
+
+   if (!session->rules_selected)
+   {
+      const char* table_name = getenv(TABLE_ENV);
+      const char* model_name = getenv(MODEL_ENV);
+      const char* metpen_name = getenv(METPEN_ENV);
+      const char* sysearch_name = getenv(SYSEARCH_ENV);
+      const char* banned_name = getenv(BANNED_ENV);
+      const char* baseline_name = getenv(BASELINE_ENV);
+      const char* record_name = getenv(BASELINE_RECORD_ENV);
+      CStandardsTable table;
+      std::string error;
+
+      session->rules_selected = true;
+      session->metrics.max_parameters = DEFAULT_MAX_PARAMETERS;
+      if (!read_metric_limits((metpen_name != NULL) ? metpen_name : DEFAULT_METPEN, &session->metrics)
+          && metpen_name != NULL && messages != NULL)
+      {
+         messages->append("Cannot read metrics file ").append(metpen_name).append("\n");
+      }
+
+      if (sysearch_name != NULL && *sysearch_name != '\0'
+          && !session->includes.load(sysearch_name, &error) && messages != NULL)
+      {
+         messages->append(error).append("\n");
+      }
 
-void check_global_vars (const struct input_data * data, FILE * fp, IToolSuiteInterface * iObj) {
-   NLDRAAnalysis::CVariableTypeDeclaration globalVariableHolder;
-   char expectedName[MAXSTR] = {0};
+      if (!session->banned.load((banned_name != NULL) ? banned_name : DEFAULT_BANNED, &error)
+          && banned_name != NULL && messages != NULL)
+      {
+         messages->append(error).append("\n");
+      }
 
-   /* Load Global Variable results for File */
-   iObj->loadGlobalComponent(data->source_name, GLOBAL_VARS, FileResults);
+      if (baseline_name != NULL && *baseline_name != '\0'
+          && !session->baseline.open(baseline_name, &error) && messages != NULL)
+      {
+         messages->append(error).append("\n");
+      }
+      session->baseline_record = (record_name != NULL) ? record_name : "";
 
-   /* Get the expected name for all global variables in this file */
-   getFileName (expectedName, data->source_name);
-   strcat (expectedName, "_");
- 
-   /* Loop through each global variable found and check conformation with the Penalty */
-   while (iObj->readGlobalComponent(globalVariableHolder)) {
-      char globalVariableName[MAXSTR] = {0};
+      if (table.open((table_name != NULL) ? table_name : DEFAULT_TABLE, &error))
+      {
+         int model = -1;
 
-      /* Only find the variables that are not static */
-	  if (globalVariableHolder.getStaticField() == false) {
-		  int conforms = 1;
-		  const int globalVariableLineNumber = globalVariableHolder.getRefStartLine();
-		  strcpy (globalVariableName, globalVariableHolder.getName());
+         if (model_name != NULL && *model_name != '\0')
+         {
+            model = table.find_model(model_name);
+            if (model < 0 && messages != NULL)
+            {
+               messages->append("Standards model ").append(model_name).append(" not in the standards table\n");
+            }
+         }
 
-		  /* This is a global var, so check that it conforms to <file>_<name> */
-		  conforms = !strncmp (expectedName, globalVariableHolder.getName(), strlen(expectedName) );
+         for (int index = 0; index < table.standard_count(); index++)
+         {
+            const struct stdtable_standard& standard = table.standard(index);
+            unsigned int* rules = (standard.letter == HSTANDARD) ? &session->h_rules
+                                : (standard.letter == ZSTANDARD) ? &session->z_rules : NULL;
 
-		  /* Record the Result */
-		  process_naming_conformance (data, fp, "Global var", "<file>_<name>",
-									  globalVariableName, conforms, globalVariableLineNumber, 9);
-	  }
-   }
-} /* End of check_global_vars */
+            if (rules != NULL && standard.number < 32
+                &&
+                (!table.enabled(-1, index) || (model >= 0 && !table.enabled(model, index))))
+            {
+               *rules &= ~RULE_BIT(standard.number);
+            }
+         }
 
+         /* Metpen.dat has no parameter count, 10 Z follows 18 S of the model */
+         const int parameters = table.find_standard(18, 'S');
+         if (parameters >= 0 && table.limit(model, parameters) > 0)
+         {
+            session->metrics.max_parameters = table.limit(model, parameters);
+         }
+         const int include_closure = table.find_standard(13, 'Z');
+         if (include_closure >= 0 && table.limit(model, include_closure) > 0)
+         {
+            session->max_include_closure = table.limit(model, include_closure);
+         }
+         const int clone_tokens = table.find_standard(15, 'Z');
+         if (clone_tokens >= 0 && table.limit(model, clone_tokens) > 0)
+         {
+            session->min_clone_tokens = table.limit(model, clone_tokens);
+         }
+      }
+      else if (table_name != NULL && messages != NULL)
+      {
+         /* Only a table asked for is missed */
+         messages->append(error).append("\n");
+      }
+   }
 
+   request->h_rules = session->h_rules;
+   request->z_rules = session->z_rules;
+   request->metrics = &session->metrics;
+   request->includes = session->includes.is_loaded() ? &session->includes : NULL;
+   request->banned = (session->banned.size() > 0) ? &session->banned : NULL;
+} /* End of select_rules */
 
 /***----------------------------------------------------------------
 ***
-*** Routine: check_class_members
+*** Routine: read_metric_limits
 ***
 *** Parameters:
 *** ===========
 ***
-*** Action  Name            Type                            Use
-*** ------  ----            ----                            ---
-*** I       data            const struct input_data *       Argument Data
-*** I       fp              FILE *                          SIF File Pointer
-*** I       iObj            IToolSuiteInterface *           GLH API Interface
+*** Action  Name                      Type                      Use
+*** ------  ----                      ----                      ---
+*** I       metpen_file               const char *              <lang>Metpen.dat
+*** O       limits                    struct metric_limits *    Limits of the metrics switched on
+***
+*** Return value:
+*** int             0 if the file cannot be read
 ***
 *** Description:
 *** ============
 ***
-*** Checks that Class Member variables conform to H Standard m_<name>
-***
-*** Standards:
-*** ==========
+*** Reads the Procedure limits of the metrics the generator calculates:
+***   3 Cyclomatic Complexity         maximum, 7 Z
+***   29 Executable reformatted Lines maximum, 8 Z
+***   6 Comments in Headers           minimum, 9 Z
+***   5 Total Comments                minimum, 9 Z
+*** A metric switched off (first column 0) is not checked.
 ***
-*** 2 H Class Member does not conform to style m_<name>
-***
-***-----------------------------------------------------------------*/
-void check_class_members (const struct input_data * data,
-                          FILE * fp,
-                          IToolSuiteInterface * iObj)
+***----------------------------------------------------------------*/
+int read_metric_limits (const char* metpen_file, struct metric_limits* limits)
 {
-   /* Load Class Information from GLH API Interface */
-   if (iObj->loadAllClasses(false) > 0) /* Set Parameter to true to include Child Classes */
-   {
-      NLDRAAnalysis::CClassDeclaration classDeclarationHolder;
-      /* Loop through classes available */
-      while(iObj->readAllClassList(classDeclarationHolder))
-      {
-         NLDRAAnalysis::CMemberVariableDeclaration classMemberHolder;
-         /* Load class member variables from API */
-         iObj->loadClassMemberVariables(classDeclarationHolder);
+   FILE* fp = fopen(metpen_file, "r");
+   char line[MAXSTR];
 
-         while(iObj->readMemberVariableList(classMemberHolder))
-         {
-            if (classMemberHolder.sourceFile().getModuleNumber() == data->module_id)
-            {
-               char classMemberVariableName[MAXSTR] = {0};
-               int conforms = 1;
-               const int classMemberLineNumber = classMemberHolder.getRefStartLine();
-               strcpy(classMemberVariableName, classMemberHolder.getName());
+   if (fp == NULL)
+   {
+      return 0;
+   }
 
-               /* Perform the check */
-               if(classMemberVariableName[0] != 'm' || classMemberVariableName[1] != '_')
-               {
-                  conforms = 0;
-               }
+   while (fgets(line, sizeof(line), fp) != NULL)
+   {
+      int on = 0;
+      int id = 0;
+      char scope = ' ';
+      char type = ' ';
+      int min = 0;
+      int max = 0;
+
+      if (line[0] == '#'
+          ||
+          sscanf(line, "%d %d %c %c %d %d", &on, &id, &scope, &type, &min, &max) != 6
+          ||
+          on != 1 || scope != 'P')
+      {
+         continue;
+      }
 
-               /* Record the Result */
-               process_naming_conformance (data,
-                                              fp,
-                                              "Member",
-                                              "m_<name>",
-                                              classMemberVariableName,
-                                              conforms,
-                                              classMemberLineNumber,
-                                              2);
-            }
-         }
+      switch (id)
+      {
+         case 3:  limits->max_cyclomatic = max;       break;
+         case 29: limits->max_executable_lines = max; break;
+         case 6:  limits->min_header_comments = min;  break;
+         case 5:  limits->min_comments = min;         break;
+         default: break;
       }
    }
-} /* End of check_class_members */
+
+   fclose(fp);
+   return 1;
+} /* End of read_metric_limits */
 
 
 
 /***----------------------------------------------------------------
 ***
-*** Routine: check_enums
+*** Routine: append_standards_violations
 ***
 *** Parameters:
 *** ===========
 ***
-*** Action  Name          Type                          Use
-*** ------  ----          ----                          ---
-*** I       data          const struct input_data *     Argument Data
-*** I       fp            FILE *                        SIF File Pointer
-*** I       iObj          IToolSuiteInterface *         GLH API Interface
+*** Action  Name                      Type                        Use
+*** ------  ----                      ----                        ---
+*** I       data                      const struct input_data *
+*** I       session                   struct glh_session *        GLH API Connection
+*** I       symbols                   const struct symbol_table * Symbols for the File
+*** O       messages                  std::string *               Messages for the user
 ***
 *** Description:
 *** ============
 ***
-*** Checks the Enum Name conforms to style E<name>.
-*** It then checks all the elements of the enum that they conform to style e_<name>
-***
-*** Standards:
-*** ==========
+*** Shows example of how to determine the appropriate SIF sub file
+*** (e.g .sf1 for main static analysis) and append a 101 record to it.
 ***
-*** 3 H Enum Element does not conform to style e_<name>
-*** 7 H Enum Name does not conform to style E<name>
+*** The symbols for the File are loaded from the GLH API and the source is
+*** read into memory, then the standards engine checks both. Z Standard
+*** line numbers from the engine are source lines, these are converted to
+*** the reformatted code line numbers before being stored.
 ***
-***-----------------------------------------------------------------*/
-void check_enums(const struct input_data * data,
-                 FILE * fp,
-                 IToolSuiteInterface * iObj)
+***----------------------------------------------------------------*/
+void append_standards_violations (const struct input_data* data,
+                                  struct glh_session * session,
+                                  const struct symbol_table * symbols,
+                                  std::string * messages)
 {
-   NLDRAAnalysis::CVariableListDeclaration enumListHolder;
-
-   /* Load Global Enum component results for File */
-   iObj->loadGlobalComponent(data->source_name, GLOBAL_ENUMS, FileResults);
+   /* One per thread, as the daemon checks several Files at once; its
+    * worker threads keep theirs warm from one request to the next */
+   static thread_local std::string source_text;
+   static thread_local CStandardsChecker checker;
+   FILE * fp = NULL;
+   char sfn_name[MAXSTR] = {0};
 
+   /*
+   * Main Static Analysis has been run,
+   * Generate any standards associated with this phase
+   */
+   get_sif_sub_file_name (data, Msa, sfn_name);
 
-   while(iObj->readGlobalComponentList(enumListHolder))
+   /* Open the SIF File */
+   fp = fopen(sfn_name,"a");
+
+   if (fp)
    {
-      /* Check Penalty 7 H - Conformance of the Enum Name*/
-      char enumName[MAXSTR] = {0};
-      int conforms = 1;
-      const int enumNameLineNumber = enumListHolder.getRefStartLine();
-      strcpy(enumName, enumListHolder.getName());
+      struct check_request request;
+      std::vector<line_range> source_lines;
+      std::vector<line_range> symbol_lines;
+
+      /* The Z rules work from the source text */
+      if (!read_source_file(data->source_name, &source_text))
+      {
+         messages->append("Source file ").append(data->source_name).append(" not found\n");
+      }
+
+      request.source_name = data->source_name;
+      request.source = source_text;
+      request.symbols = symbols;
+      select_rules(session, &request, messages);
+#ifdef REPORT
+      request.report = true;
+#endif
+
+      /* Limit the check to the changed lines, as source lines for the Z
+       * Standards and as reformatted lines for the H Standards */
+      if (data->diff_file != NULL)
+      {
+         if (!read_changed_lines(data->diff_file, data->source_name, &source_lines))
+         {
+            messages->append("Diff file ").append(data->diff_file).append(" not found\n");
+         }
+
+         std::lock_guard<std::mutex> lock(session->mutex);
+         for (const line_range & range : source_lines)
+         {
+            line_range mapped = range;
+            int next_first = 0;
+
+            tblinemapper_get_ref_line_num(range.first, data->source_name, data->module_id,
+                                          data->source_name, data->workdir, &mapped.first);
+            tblinemapper_get_ref_line_num(range.last, data->source_name, data->module_id,
+                                          data->source_name, data->workdir, &mapped.last);
+            /* A source line may be reformatted into several lines */
+            tblinemapper_get_ref_line_num(range.last + 1, data->source_name, data->module_id,
+                                          data->source_name, data->workdir, &next_first);
+            if (next_first - 1 > mapped.last)
+            {
+               mapped.last = next_first - 1;
+            }
+            if (mapped.first > 0 && mapped.last >= mapped.first)
+            {
+               symbol_lines.push_back(mapped);
+            }
+         }
+         merge_line_ranges(&symbol_lines);
 
-      /* Perform the check */
-      if(enumName[0] != 'E')
+         request.source_lines = &source_lines;
+         request.symbol_lines = &symbol_lines;
+      }
+
+      const struct check_result& result = checker.check(request);
+      std::vector<struct violation_info> violations(result.violations);
+      std::vector<struct set_violation> set_violations;
+      std::vector<struct set_violation> suppressed_report;
+
+      /* The set level standards follow those of the File, the includes
+       * found are only those of the lines scanned */
+      check_include_graph(data, session, request, result, &set_violations, messages);
+      check_duplicate_code(data, session, request, &set_violations, messages);
+      for (const struct set_violation & violation : set_violations)
       {
-         conforms = 0;
+         struct violation_info info;
+         info.std_letter = ZSTANDARD;
+         info.std_num = violation.std_num;
+         info.line = violation.line;
+         info.text = violation.text;
+         violations.push_back(info);
       }
 
-      /* Record the Result */
-      process_naming_conformance (data, fp,
-                                       "Enum name",
-                                       "E<name>",
-                                       enumName, conforms, enumNameLineNumber,
-                                       7);
+      /* Suppressed violations only go to the report */
+      CSuppressionIndex suppressions;
+      int suppressed = 0;
 
+      index_suppressions(data, session, result, &suppressions);
 
+      /* Violations in the baseline are not written, those written are recorded */
+      std::vector<uint64_t> fingerprints;
+      std::vector<uint64_t> recorded;
+      int baselined = 0;
 
-      /* Check Penalty 3 H - Conformance of the Enum Elements*/
-       NLDRAAnalysis::CVariableTypeDeclaration enumElementHolder;
+      if (session->baseline.is_open() || !session->baseline_record.empty())
+      {
+         baseline_fingerprints(data->source_name, source_text, violations, &fingerprints);
+      }
 
-       while (iObj->readGlobalComponentSubList(enumElementHolder))
-       {
-           char enumElementName[MAXSTR] = {0};
-           int conforms = 1;
-           const int enumElementLineNumber = enumElementHolder.getRefStartLine();
-           strcpy(enumElementName, enumElementHolder.getName());
+      for (size_t index = 0; index < violations.size(); index++)
+      {
+         const struct violation_info & violation = violations[index];
+         int linenumber = violation.line;
+         const int suppression = suppressions.find(violation.std_letter, violation.std_num, violation.line);
 
-           /* Perform the check */
-           if(enumElementName[0] != 'e' && enumElementName[1] != '_')
-           {
-              conforms = 0;
-           }
+         if (suppression >= 0)
+         {
+#ifdef REPORT
+            const std::string_view reason = result.suppressions[suppression].reason;
+            suppressed_report.push_back({violation.std_num, violation.line,
+                                         std::to_string(violation.std_num) + " " + violation.std_letter
+                                         + " suppressed, " + std::string(reason)});
+#endif
+            suppressed++;
+            continue;
+         }
 
-           /* Record the Result */
-           process_naming_conformance (data, fp,
-                                       "Enum element",
-                                       "e_<name>",
-                                       enumElementName, conforms, enumElementLineNumber,
-                                       3);
-       }
-   }
-} /* End of check_enums */
+         if (!session->baseline_record.empty())
+         {
+            recorded.push_back(fingerprints[index]);
+         }
+         if (session->baseline.is_open() && session->baseline.contains(fingerprints[index]))
+         {
+            baselined++;
+            continue;
+         }
+
+         /* 5 Z is stored against line 5 of the reformatted code, unmapped */
+         if (violation.std_letter == ZSTANDARD && violation.std_num != 5 && linenumber > 0)
+         {
+            /*
+             * Line number at this point is the actual source line number, before
+             * storing the line number, we need to convert it to the reformatted code
+             * line number.
+             */
+            std::lock_guard<std::mutex> lock(session->mutex);
+            tblinemapper_get_ref_line_num(violation.line,
+                                          data->source_name,
+                                          data->module_id,
+                                          data->source_name,
+                                          data->workdir,
+                                          &linenumber);
+         }
+
+         append_violation(data, fp, violation.std_num, violation.text,
+                          linenumber, violation.std_letter);
+      }
+      record_baseline(session, recorded, messages);
+
+#ifdef REPORT
+      FILE* fpRep = NULL;
+      for (const struct report_entry & entry : result.report)
+      {
+         if (fpRep == NULL)
+         {
+            fpRep = open_report (data);
+         }
+         print_to_report (fpRep, entry.text, entry.line);
+      }
+      for (const struct set_violation & entry : suppressed_report)
+      {
+         if (fpRep == NULL)
+         {
+            fpRep = open_report (data);
+         }
+         print_to_report (fpRep, entry.text, entry.line);
+      }
+      if (!result.suppressions.empty())
+      {
+         char summary[MAXSTR];
+
+         if (fpRep == NULL)
+         {
+            fpRep = open_report (data);
+         }
+         snprintf(summary, sizeof(summary), "Suppressions : %u, violations suppressed : %d",
+                  (unsigned) result.suppressions.size(), suppressed);
+         print_to_report (fpRep, summary, 0);
+      }
+      if (session->baseline.is_open())
+      {
+         char summary[MAXSTR];
 
+         if (fpRep == NULL)
+         {
+            fpRep = open_report (data);
+         }
+         snprintf(summary, sizeof(summary), "Violations in the baseline : %d", baselined);
+         print_to_report (fpRep, summary, 0);
+      }
+      close_report (fpRep);
+#endif
+
+      fclose(fp);
+   }
+} /* End of append_standards_violations */
 
 /***----------------------------------------------------------------
 ***
-*** Routine: check_null_terminated_strings
+*** Routine: CCacheLock::CCacheLock
 ***
 *** Parameters:
 *** ===========
 ***
-*** Action  Name          Type                          Use
-*** ------  ----          ----                          ---
-*** I       data          const struct input_data *     Argument Data
-*** I       fp            FILE *                        SIF File Pointer
-*** I       iObj          IToolSuiteInterface *         GLH API Interface
+*** Action  Name                      Type                  Use
+*** ------  ----                      ----                  ---
+*** I       cache_file                const std::string &   Cache to lock
 ***
 *** Description:
 *** ============
 ***
-*** Checks the Name of a null terminated string conforms to style sz_<name>.
-***
-*** Standards:
-*** ==========
+*** Waits for the lock on <cache>.lock, created if need be.
 ***
-*** 10 H Null Terminated String Name does not conform to style sz_<name>
-***
-***-----------------------------------------------------------------*/
-void check_null_terminated_strings(const struct input_data * data,
-                 FILE * fp,
-                 IToolSuiteInterface * iObj)
+***----------------------------------------------------------------*/
+CCacheLock::CCacheLock (const std::string & cache_file)
 {
-   NLDRAAnalysis::CVariableTypeDeclaration parameterHolder;
-   NLDRAAnalysis::CFunctionDeclaration functionDeclarationHolder;
-   NLDRAAnalysis::CVariableTypeDeclaration globalVariableHolder;
-   
-   /* Load Function data for Source File from GLH API */
-   iObj->loadFunctions(data->source_name, FileResults);
-
-   /* Load Global Variables component results for File */
-   iObj->loadGlobalComponent(data->source_name, GLOBAL_VARS, FileResults);
+   const std::string lock_file = cache_file + ".lock";
 
-   /* Loop through each global variable found and check conformation with the Penalty */
-   while(iObj->readGlobalComponent(globalVariableHolder))
+#ifdef _WIN32
+   m_handle = CreateFileA(lock_file.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE,
+                          NULL, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+   if (m_handle != INVALID_HANDLE_VALUE)
    {
-      char globalVariableName[MAXSTR] = {0};
-      int conforms = 1;
-      const int globalVariableLineNumber = globalVariableHolder.getRefStartLine();
-      strcpy (globalVariableName, globalVariableHolder.getName());
-
-      /* Check if the global is a null terminated string */
-
-      /* Perform the check */
-      if( (globalVariableName[0] != 's') || (globalVariableName[1] != 'z') || (globalVariableName[2] != '_') )
+      OVERLAPPED overlapped = {};
+      if (!LockFileEx(m_handle, LOCKFILE_EXCLUSIVE_LOCK, 0, 1, 0, &overlapped))
       {
-         conforms = 0;
+         CloseHandle(m_handle);
+         m_handle = INVALID_HANDLE_VALUE;
       }
-
-      /* Record the Result */
-      process_naming_conformance (data, fp,
-                                   "Null Terminated String",
-                                   "sz_<name>",
-                                   globalVariableName, conforms, globalVariableLineNumber,
-                                   10);
    }
-} /* End of check_null_terminated_strings */
-
-
+#else
+   m_fd = open(lock_file.c_str(), O_RDWR | O_CREAT, 0666);
+   if (m_fd >= 0)
+   {
+      while (flock(m_fd, LOCK_EX) != 0 && errno == EINTR)
+      {
+      }
+   }
+#endif
+} /* End of CCacheLock::CCacheLock */
 
 /***----------------------------------------------------------------
 ***
-*** Routine: check_classes
-***
-*** Parameters:
-*** ===========
-***
-*** Action  Name          Type                          Use
-*** ------  ----          ----                          ---
-*** I       data          const struct input_data *     Argument Data
-*** I       fp            FILE *                        SIF File Pointer
-*** I       iObj          IToolSuiteInterface *         GLH API Interface
+*** Routine: CCacheLock::~CCacheLock
 ***
 *** Description:
 *** ============
 ***
-*** Checks Class Names conform to H Standard C<name>
-***
-*** Standards:
-*** ==========
-***
-*** 4 H Class Name does not conform to style C<name>
+*** Releases the lock, closing the lock file releases it.
 ***
-***-----------------------------------------------------------------*/
-
-void check_classes(const struct input_data * data,
-                   FILE * fp,
-                   IToolSuiteInterface * iObj)
+***----------------------------------------------------------------*/
+CCacheLock::~CCacheLock ()
 {
-   /* Load Class Information from GLH API Interface */
-   if (iObj->loadAllClasses(false) > 0) /* Set Parameter to true to include Child Classes */
+#ifdef _WIN32
+   if (m_handle != INVALID_HANDLE_VALUE)
    {
-      NLDRAAnalysis::CClassDeclaration classDeclarationHolder;
-      /* Loop through classes available */
-      while(iObj->readAllClassList(classDeclarationHolder))
-      {
-         if (classDeclarationHolder.sourceFile().getModuleNumber() == data->module_id)
-         {
-            char fullClassName[MAXSTR] = {0};
-            char className[MAXSTR] = {0};
-
-            int conforms = 1;
-            const int classLineNumber = classDeclarationHolder.getRefStartLine();
-            strcpy(fullClassName, classDeclarationHolder.getName());
-
-            /* Class name is fully qualified, to validate it we need to get just the class name. */
-            int pos = strlen(fullClassName);
-            pos = (strlen(fullClassName)-1);
-            if(pos > -1)
-            {
-               while(pos > -1
-                     &&
-                     fullClassName[pos] != ':')
-               {
-                  pos--;
-               }
-               strcpy(className, &fullClassName[pos+1]);
-
-               /* Perform the check */
-               if(className[0] != 'C')
-               {
-                  conforms = 0;
-               }
-
-               /* Record the Result */
-               process_naming_conformance (data, fp,
-                                           "Class Name",
-                                           "C<name>",
-                                           className, conforms, classLineNumber,
-                                           4);
-            }
-         }
-      }
+      CloseHandle(m_handle);
    }
-} /* End of check_classes */
-
-
+#else
+   if (m_fd >= 0)
+   {
+      close(m_fd);
+   }
+#endif
+} /* End of CCacheLock::~CCacheLock */
 
 /***----------------------------------------------------------------
 ***
-*** Routine: check_namespaces
+*** Routine: read_cache_stamp
 ***
 *** Parameters:
 *** ===========
 ***
-*** Action  Name          Type                          Use
-*** ------  ----          ----                          ---
-*** I       data          const struct input_data *     Argument Data
-*** I       fp            FILE *                        SIF File Pointer
-*** I       iObj          IToolSuiteInterface *         GLH API Interface
-***
-*** Description:
-*** ============
-***
-*** Checks Namespace names conform to H Standard N<name>
-***
-*** Standards:
-*** ==========
+*** Action  Name                      Type                  Use
+*** ------  ----                      ----                  ---
+*** I       cache_file                const std::string &   Cache file
 ***
-*** 5 H Namespace Name does not conform to style N<name>
+*** Return value:
+*** struct cache_stamp       Its modification time, size and inode
 ***
-***-----------------------------------------------------------------*/
-void check_namespaces(const struct input_data * data,
-                      FILE * fp,
-                      IToolSuiteInterface * iObj)
+***----------------------------------------------------------------*/
+struct cache_stamp read_cache_stamp (const std::string & cache_file)
 {
-   /* Load Namespace Information from GLH API Interface */
-   if (iObj->loadAllNamespaces() > 0)
-   {
-      NLDRAAnalysis::CNamespaceDeclaration namespaceHolder;
+   struct cache_stamp stamp;
+   struct stat status;
 
-      /* Loop through Namespaces available */
-      while(iObj->readAllNamespaceList(namespaceHolder))
-      {
-         char namespaceName[MAXSTR] = {0};
-         int conforms = 1;
-         strcpy(namespaceName, namespaceHolder.getName());
-
-         /* Perform the check */
-         if(namespaceName[0] != 'N')
-         {
-            conforms = 0;
-         }
-
-         /* Record the Result */
-         process_naming_conformance (data, fp,
-                                      "Namespace Name",
-                                      "N<name>",
-                                      namespaceName, conforms, -1,
-                                      5);
-      }
+   if (stat(cache_file.c_str(), &status) == 0)
+   {
+      stamp.mtime = status.st_mtime;
+      stamp.size = (long long) status.st_size;
+      stamp.inode = (unsigned long long) status.st_ino;
    }
-} /* End of check_namespaces */
-
+   return stamp;
+} /* End of read_cache_stamp */
 
+/***----------------------------------------------------------------
+***
+*** Routine: same_cache_stamp
+***
+*** Return value:
+*** bool            true if a and b are the same save of the cache
+***
+***----------------------------------------------------------------*/
+bool same_cache_stamp (const struct cache_stamp & a, const struct cache_stamp & b)
+{
+   return a.mtime == b.mtime && a.size == b.size && a.inode == b.inode;
+} /* End of same_cache_stamp */
 
 /***----------------------------------------------------------------
 ***
-*** Routine: check_pointers
+*** Routine: check_include_graph
 ***
 *** Parameters:
 *** ===========
 ***
-*** Action  Name          Type                          Use
-*** ------  ----          ----                          ---
-*** I       data          const struct input_data *     Argument Data
-*** I       fp            FILE *                        SIF File Pointer
-*** I       iObj          IToolSuiteInterface *         GLH API Interface
+*** Action  Name                      Type                          Use
+*** ------  ----                      ----                          ---
+*** I       data                      const struct input_data *
+*** IO      session                   struct glh_session *          Holds the include graph
+*** I       request                   const struct check_request &  Check of the File
+*** I       result                    const struct check_result &   Its includes
+*** O       violations                std::vector<set_violation> *
+*** O       messages                  std::string *                 Messages for the user
 ***
 *** Description:
 *** ============
 ***
-*** Checks that Pointer Parameters conform to the style rule.
-*** The same principle can be applied for Local variables etc.
+*** The set level include standards. The node of the File is updated with
+*** the includes the engine found (read again by the graph when only the
+*** changed lines were scanned), the headers changed since the last run
+*** are read, and the includes of the File are checked:
+***   12 Z an include in an include cycle, once per cycle
+***   13 Z an include pulling in more than *** files
+***   14 Z an include already included, or reached through another
+*** The graph is saved for the next run, see Include Graph in the File
+*** header. It is locked from loading to saving (see CCacheLock), and a
+*** daemon reloads it once another generator has saved it.
 ***
-*** Standards:
-*** ==========
-***
-*** 6 H Pointer does not conform to style p_<name>
-***
-***-----------------------------------------------------------------*/
-void check_pointers(const struct input_data * data,
-                    FILE * fp,
-                    IToolSuiteInterface * iObj)
+***----------------------------------------------------------------*/
+void check_include_graph (const struct input_data* data,
+                          struct glh_session * session,
+                          const struct check_request & request,
+                          const struct check_result & result,
+                          std::vector<struct set_violation> * violations,
+                          std::string * messages)
 {
-   NLDRAAnalysis::CVariableTypeDeclaration parameterHolder;
-   NLDRAAnalysis::CFunctionDeclaration functionDeclarationHolder;
+   const unsigned int z_rules = request.z_rules;
+   const char* graph_name = getenv(INCLUDE_GRAPH_ENV);
+   const std::string cache_file = (graph_name != NULL) ? std::string(graph_name)
+                                  : std::string(data->workdir) + "\\" + DEFAULT_INCLUDE_GRAPH;
+   CIncludeGraph & graph = session->include_graph;
 
-   /* Load Function data for Source File from GLH API */
-   iObj->loadFunctions(data->source_name, FileResults);
+   if (request.includes == NULL || !(z_rules & (RULE_BIT(12) | RULE_BIT(13) | RULE_BIT(14))))
+   {
+      return;
+   }
 
+   std::lock_guard<std::mutex> lock(session->include_graph_mutex);
+   CCacheLock cache_lock(cache_file);
+
+   /* A daemon keeps the graph until another generator saves it, a single run reads the last one saved */
+   const struct cache_stamp stamp = read_cache_stamp(cache_file);
+   if (session->include_graph_file != cache_file || !same_cache_stamp(stamp, session->include_graph_stamp))
+   {
+      graph.load(cache_file.c_str());
+      session->include_graph_file = cache_file;
+      session->include_graph_stamp = stamp;
+   }
 
-   /* Loop over each function in the file */
-   while(iObj->readFunctionList(functionDeclarationHolder))
+   const int source = graph.add_file(data->source_name);
+   if (request.source_lines == NULL)
    {
-      /* Load the Parameter information for the function from the GLH API */
-      iObj->loadComponents(functionDeclarationHolder,
-         PARAMETERS,
-         FunctionResults,
-         data->source_name);
+      std::vector<int> includes;
+      struct stat status;
 
-      /* Loop over each parameter for the function */
-      while(iObj->readParameterComponent(parameterHolder))
+      for (const struct include_entry & include : result.includes)
       {
-         /* Check if the parameter is a pointer */
-         if(parameterHolder.getIsPointer())
+         if (include.status == IncludeFound)
          {
-            char pointerParameterName[MAXSTR] = {0};
-            int conforms = 1;
-            int parameterLineNumber = parameterHolder.getRefStartLine();
-            strcpy(pointerParameterName, parameterHolder.getName());
+            includes.push_back(graph.add_file(include.path));
+         }
+      }
+      graph.set_includes(source, (stat(data->source_name, &status) == 0) ? status.st_mtime : 0, includes);
+   }
+   graph.update(source, *request.includes);
+   graph.analyse(source);
 
-            /* Check if the Line Number for the Parameter is provided, fallback to the function if not */
-            if (parameterLineNumber < 1)
+   std::vector<int> nodes;
+   std::vector<int> cycles_reported;
+
+   for (const struct include_entry & include : result.includes)
+   {
+      nodes.push_back((include.status == IncludeFound) ? graph.add_file(include.path) : -1);
+   }
+
+   for (size_t entry = 0; entry < nodes.size(); entry++)
+   {
+      const int node = nodes[entry];
+      const std::string_view name = result.includes[entry].name;
+      const int line = result.includes[entry].line;
+
+      if (node < 0)
+      {
+         continue;
+      }
+
+      /* 12 Z: include cycle, the files of the cycle by name */
+      if ((z_rules & RULE_BIT(12)) && graph.in_cycle(node)
+          && std::find(cycles_reported.begin(), cycles_reported.end(), graph.component(node)) == cycles_reported.end())
+      {
+         std::string text = "Include cycle :";
+
+         cycles_reported.push_back(graph.component(node));
+         for (int member : graph.component_members(node))
+         {
+            const std::string & path = graph.node(member).path;
+            text.append(" ").append(path, path.find_last_of("/\\") + 1, std::string::npos);
+         }
+         violations->push_back({12, line, text});
+      }
+
+      /* 13 Z: include pulls in too many files */
+      const int closure = graph.closure_size(node);
+      if ((z_rules & RULE_BIT(13)) && session->max_include_closure > 0 && closure > session->max_include_closure)
+      {
+         char text[MAXSTR];
+         snprintf(text, sizeof(text), "Include pulls in more than %d files : %.*s (%d)",
+                  session->max_include_closure, (int) name.size(), name.data(), closure);
+         violations->push_back({13, line, text});
+      }
+
+      /* 14 Z: include already included, directly or through another include */
+      if (z_rules & RULE_BIT(14))
+      {
+         std::string through;
+
+         for (size_t other = 0; other < nodes.size() && through.empty(); other++)
+         {
+            if (other == entry || nodes[other] < 0)
             {
-               parameterLineNumber = functionDeclarationHolder.getRefStartLine();
+               continue;
             }
-
-            /* Perform the check */
-            if(pointerParameterName[0] != 'p' || pointerParameterName[1] != '_')
+            if (nodes[other] == node)
             {
-               conforms = 0;
+               through = (other < entry) ? "included twice" : "";
             }
-
-            /* Record the Result */
-            process_naming_conformance (data, fp,
-               "Pointer",
-               "p_<name>",
-               pointerParameterName, conforms, parameterLineNumber,
-               6);
+            else if (graph.component(nodes[other]) != graph.component(node) && graph.reaches(nodes[other], node))
+            {
+               through = std::string("also through ") + std::string(result.includes[other].name);
+            }
+         }
+         if (!through.empty())
+         {
+            violations->push_back({14, line, "Redundant include : " + std::string(name) + " (" + through + ")"});
          }
       }
    }
-} /* End of check_pointers */
 
+   if (graph.is_modified())
+   {
+      std::string error;
+      if (!graph.save(cache_file.c_str(), &error))
+      {
+         messages->append(error).append("\n");
+      }
+      session->include_graph_stamp = read_cache_stamp(cache_file);
+   }
+} /* End of check_include_graph */
 
 /***----------------------------------------------------------------
 ***
-*** Routine: check_global_functions
+*** Routine: check_duplicate_code
 ***
 *** Parameters:
 *** ===========
 ***
-*** Action  Name          Type                          Use
-*** ------  ----          ----                          ---
-*** I       data          const struct input_data *     Argument Data
-*** I       fp            FILE *                        SIF File Pointer
-*** I       iObj          IToolSuiteInterface *         GLH API Interface
+*** Action  Name                      Type                          Use
+*** ------  ----                      ----                          ---
+*** I       data                      const struct input_data *
+*** IO      session                   struct glh_session *          Holds the fingerprints of the set
+*** I       request                   const struct check_request &  Check of the File
+*** O       violations                std::vector<set_violation> *
+*** O       messages                  std::string *                 Messages for the user
 ***
 *** Description:
 *** ============
 ***
-*** Checks that each Global Function conform to the style rule.
-*** The same principle can be applied for Local variables etc.
-***
-*** Standards:
-*** ==========
+*** 15 Z, code of the File duplicated in the File or in another of the set.
+*** The File is fingerprinted (see Clonedetect.h), replacing its entry in
+*** the fingerprints of the set, and joined with all of them. When checking
+*** changed lines only, duplicates on those lines are reported. Files no
+*** longer found are dropped rather than reported. The fingerprints are
+*** locked from loading to updating (see CCacheLock), and only those of the
+*** File are added to the cache (see CCloneIndex::update).
 ***
-*** 8 H Global Function Name does not conform to style <file>_<name>
-***
-***-----------------------------------------------------------------*/
-void check_global_functions(const struct input_data * data, FILE * fp, IToolSuiteInterface * iObj)
+***----------------------------------------------------------------*/
+void check_duplicate_code (const struct input_data* data,
+                           struct glh_session * session,
+                           const struct check_request & request,
+                           std::vector<struct set_violation> * violations,
+                           std::string * messages)
 {
-   NLDRAAnalysis::CFunctionDeclaration functionDeclarationHolder;
+   const char* clones_name = getenv(CLONES_ENV);
+   const std::string cache_file = (clones_name != NULL) ? std::string(clones_name)
+                                  : std::string(data->workdir) + "\\" + DEFAULT_CLONES;
+   std::vector<clone_fingerprint> fingerprints;
+   std::vector<clone_region> clones;
+   struct stat status;
+
+   if (!(request.z_rules & RULE_BIT(15)) || request.source.empty())
+   {
+      return;
+   }
+
+   std::lock_guard<std::mutex> lock(session->clone_mutex);
+   CCacheLock cache_lock(cache_file);
 
-   /* Load Function data for Source File from GLH API */
-   iObj->loadFunctions(data->source_name, FileResults);
+   /* A daemon keeps the fingerprints until another generator saves them, a single run reads the last saved */
+   const struct cache_stamp stamp = read_cache_stamp(cache_file);
+   if (!session->clones || session->clones_file != cache_file || !same_cache_stamp(stamp, session->clones_stamp))
+   {
+      session->clones.reset(new CCloneIndex(session->min_clone_tokens));
+      session->clones->load(cache_file.c_str());
+      session->clones_file = cache_file;
+      session->clones_stamp = stamp;
+   }
 
-   /* Loop over each function in the file */
-   while (iObj->readFunctionList(functionDeclarationHolder))
+   fingerprint_source(request.source, session->clones->window(), &fingerprints);
+   const int file = session->clones->set_file(data->source_name,
+                                              (stat(data->source_name, &status) == 0) ? status.st_mtime : 0,
+                                              fingerprints);
+   session->clones->find_clones(file, 1, &clones);
+
+   for (const struct clone_region & clone : clones)
    {
-      if (strcmp(functionDeclarationHolder.sourceFile().getLanguage(), "C") == 0)
+      const std::string & other = session->clones->file(clone.other_file).path;
+      char text[MAXSTR];
+
+      if (request.source_lines != NULL
+          &&
+          std::none_of(request.source_lines->begin(), request.source_lines->end(),
+                       [&clone](const line_range& range)
+                       { return range.first <= clone.last_line && range.last >= clone.first_line; }))
+      {
+         continue;
+      }
+      if (clone.other_file != file && stat(other.c_str(), &status) != 0)
       {
-         int conforms = 1;
-         int functionLineNumber = functionDeclarationHolder.getRefStartLine();
-         char expectedName[MAXSTR] = {0};
+         continue;
+      }
 
-         strcpy (expectedName, functionDeclarationHolder.getDeclarativeStem ());
-         /* And finally add the _ */
-         strcat (expectedName, "_");
+      snprintf(text, sizeof(text), "Duplicated code : lines %d-%d and %s lines %d-%d (%d tokens)",
+               clone.first_line, clone.last_line,
+               other.c_str() + other.find_last_of("/\\") + 1,
+               clone.other_first_line, clone.other_last_line, clone.tokens);
+      violations->push_back({15, clone.first_line, text});
+   }
 
-         if (!functionDeclarationHolder.isStaticLinkage ()
-             &&
-             !functionDeclarationHolder.isMain ())
-         {
-            /* This is a global function so check that it conforms to <file>_<name> */
-            conforms = !strncmp (expectedName, functionDeclarationHolder.getName(), strlen(expectedName) );
-            /* Record the Result */
-            process_naming_conformance (data, fp, "Global Function", "<file>_<name>", functionDeclarationHolder.getName(), conforms, functionDeclarationHolder.getRefStartLine(), 8);
-         }
+   if (session->clones->is_modified())
+   {
+      std::string error;
+      if (!session->clones->update(cache_file.c_str(), &error))
+      {
+         messages->append(error).append("\n");
       }
-  }
-} /* End of check_global_functions */
+      session->clones_stamp = read_cache_stamp(cache_file);
+   }
+} /* End of check_duplicate_code */
 
 /***----------------------------------------------------------------
 ***
-*** Routine: check_file_size
-*** This is an example of checking for a user-defined standard:
-***
-*** 1 Z File exceeds 30000 bytes in size
+*** Routine: index_suppressions
 ***
 *** Parameters:
 *** ===========
 ***
-*** Action  Name                      Type            Use
-*** ------  ----                      ----            ---
+*** Action  Name                      Type                          Use
+*** ------  ----                      ----                          ---
 *** I       data                      const struct input_data *
-*** I       fp                        FILE *
+*** I       session                   struct glh_session *          GLH API Connection
+*** I       result                    const struct check_result &   Suppressions of the File
+*** O       index                     CSuppressionIndex *           In the order of the result
 ***
+*** Description:
+*** ============
 ***
-*** Return value:
-*** void
+*** Z violations are on source lines, as are the suppressions. H
+*** violations are on reformatted lines, so for the H Standards the lines
+*** suppressed are mapped, a source line to each reformatted line it
+*** became.
 ***
 ***----------------------------------------------------------------*/
-void check_file_size (const struct input_data* data, FILE* fp)
+void index_suppressions (const struct input_data* data,
+                         struct glh_session * session,
+                         const struct check_result & result,
+                         CSuppressionIndex * index)
 {
-   char message[MESSAGE_SIZE] = {0};
-   long src_size;
-   const long PEN_1Z_LIMIT = 30000L;
-
-   src_size = fsize (data->source_name);
+   index->clear();
 
-   if (src_size > PEN_1Z_LIMIT)
+   for (const struct suppression & entry : result.suppressions)
    {
-      sprintf (message,"File exceeds %d bytes in size : %s (%ld)",
-         PEN_1Z_LIMIT, data->source_name, src_size);
+      struct suppression mapped = entry;
 
-      append_violation(data, fp, 1, message, 0, ZSTANDARD);
-   }
-} /* End of check_file_size */
+      if (entry.std_letter == HSTANDARD && entry.kind != SuppressFile)
+      {
+         std::lock_guard<std::mutex> lock(session->mutex);
+         int next_first = 0;
 
+         tblinemapper_get_ref_line_num(entry.first, data->source_name, data->module_id,
+                                       data->source_name, data->workdir, &mapped.first);
+         if (entry.last != SUPPRESS_LAST_LINE)
+         {
+            tblinemapper_get_ref_line_num(entry.last, data->source_name, data->module_id,
+                                          data->source_name, data->workdir, &mapped.last);
+            /* A source line may be reformatted into several lines */
+            tblinemapper_get_ref_line_num(entry.last + 1, data->source_name, data->module_id,
+                                          data->source_name, data->workdir, &next_first);
+            if (next_first - 1 > mapped.last)
+            {
+               mapped.last = next_first - 1;
+            }
+         }
+      }
+      index->add(mapped);
+   }
 
+   index->build();
+} /* End of index_suppressions */
 
 /***----------------------------------------------------------------
 ***
-*** Routine: check_filename_size
-***
-*** 2 Z Filename exceeds 8 characters
-***  8 characters refers to the number of characters before the "."
-***  (Currently assumes that extension is .c or .h)
+*** Routine: record_baseline
 ***
 *** Parameters:
 *** ===========
 ***
-*** Action  Name                      Type            Use
-*** ------  ----                      ----            ---
-*** I       data                      const struct input_data *
-*** I       fp                        FILE *
-***
-***
-*** Return value:
-*** void
-***
-***
-*** Calls:
-*** ======
+*** Action  Name                      Type                            Use
+*** ------  ----                      ----                            ---
+*** I       session                   struct glh_session *            Holds the record name
+*** I       fingerprints              const std::vector<uint64_t> &   Of the violations written
+*** O       messages                  std::string *                   Messages for the user
 ***
-*** Name                      Location
-*** ----                      --------
-*** split_directory_path     This File
-*** append_violation          This File
-*** strlen                    System
-*** sprintf                   System
+*** Description:
+*** ============
 ***
+*** Appends the fingerprints to the record, one in hex per line, for
+*** Stdbaseline to write the baseline from. The File's lines are written
+*** at once, so Files checked by several generators at the same time do
+*** not mix their lines.
 ***
 ***----------------------------------------------------------------*/
-void check_filename_size (const struct input_data* data, FILE* fp)
+void record_baseline (struct glh_session * session, const std::vector<uint64_t> & fingerprints,
+                      std::string * messages)
 {
-   const int NAME_LIMIT = 8; /* excludes .c or .h */
-   char short_name[MAXSTR] = {'\0'};
-   char message[MESSAGE_SIZE] = {0};
+   std::string lines;
+   char line[32];
 
-   split_directory_path (data->source_name, short_name, (char*) NULL);
+   if (session->baseline_record.empty() || fingerprints.empty())
+   {
+      return;
+   }
 
-   if (strlen(short_name) > (NAME_LIMIT+2))  /* includes .c or .h */
+   for (const uint64_t fingerprint : fingerprints)
    {
-      sprintf (message,"Filename exceeds %d characters : %s (%d)",
-               NAME_LIMIT, short_name, strlen(short_name));
+      snprintf(line, sizeof(line), "%016llx\n", (unsigned long long) fingerprint);
+      lines.append(line);
+   }
 
-      append_violation(data, fp, 2, message, 0, ZSTANDARD);
+   std::lock_guard<std::mutex> lock(session->baseline_mutex);
+   FILE* fp = fopen(session->baseline_record.c_str(), "ab");
+   if (fp != NULL)
+   {
+      setvbuf(fp, NULL, _IONBF, 0); /* A single write */
    }
-} /* End of check_filename_size */
+   if (fp == NULL || fwrite(lines.data(), 1, lines.size(), fp) != lines.size())
+   {
+      messages->append("Unable to write baseline record ").append(session->baseline_record).append("\n");
+   }
+   if (fp != NULL)
+   {
+      fclose(fp);
+   }
+} /* End of record_baseline */
+
+
 
 
 
 /***----------------------------------------------------------------
 ***
-*** Routine: check_includename
-***
-*** 3 Z Include name does not match source file name.
-***  Checks that the  #include filaname is the same as the source filename
+*** Routine: load_symbol_table
 ***
 *** Parameters:
 *** ===========
 ***
-*** Action  Name                Type            Use
-*** ------  ----                ----            ---
-*** I       data                const struct input_data *
-*** I       fp                  FILE *
-*** I       line                char *      line of source text
+*** Action  Name             Type                           Use
+*** ------  ----             ----                           ---
+*** I       data             const struct input_data *      Argument Data
+*** I       iObj             IToolSuiteInterface *          GLH API Interface
+*** O       symbols          struct symbol_table *          Symbols for the File
 ***
+*** Description:
+*** ============
 ***
-*** Return value:
-*** void
+*** Reads every symbol used by the H Standards from the GLH API in a
+*** single pass and stores it in the symbol table. Names are copied once
+*** into the table's arena; the rules then only read views of them, so a
+*** name of any length is safe.
 ***
+*** The table is reset at the start, so it holds the current File only.
 ***
-*** Calls:
-*** ======
-***
-*** Name                      Location
-*** ----                      --------
-*** split_directory_path     This File
-*** append_violation          This File
-*** strtok                    System
-*** strcmp                    System
-*** sprintf                   System
-***
-***
-***----------------------------------------------------------------*/
-void check_includename (const struct input_data* data, FILE* fp, char * line1)
+***-----------------------------------------------------------------*/
+void load_symbol_table (const struct input_data * data,
+                        IToolSuiteInterface * iObj,
+                        struct symbol_table * symbols)
 {
-   char message[MESSAGE_SIZE] = {0};
-   char line[MAXSTR] = {0};
-   char *include_tok;
-
-   strcpy(line, line1);
+   symbols->entries.clear();
+   symbols->arena.reset();
 
-   include_tok = strtok(line, " ");
-   if ( (include_tok != NULL) && (!strcmp(include_tok, "#include")) )
+   /* Global Variables */
    {
-     char short_name[MAXSTR] = {'\0'};
-     char c_source[MAXSTR] = {'\0'};
-     char h_source[MAXSTR] = {'\0'};
-     char *source_name;
-     char *include_name;
+      NLDRAAnalysis::CVariableTypeDeclaration globalVariableHolder;
 
-     include_name = strtok(NULL, " <\""); /*excludes "" or < > */
-     strcpy(h_source, include_name);
-     include_name = strtok(include_name, ".");
-
-     split_directory_path (data->source_name, short_name, (char*) NULL);
-     strcpy(c_source, short_name);
-     source_name = strtok(short_name, ".");
-
-
-     if (strcmp(source_name, include_name))
-     {
-       sprintf(message,"Include name does not match source file name : %s %s",
-               c_source, h_source);
-       append_violation(data, fp, 3, message, 0, ZSTANDARD);
-     }
+      iObj->loadGlobalComponent(data->source_name, GLOBAL_VARS, FileResults);
+      while (iObj->readGlobalComponent(globalVariableHolder))
+      {
+         struct symbol_entry entry = {};
+         entry.kind = SymGlobalVar;
+         entry.name = symbols->arena.intern(globalVariableHolder.getName());
+         entry.line = globalVariableHolder.getRefStartLine();
+         entry.flags = globalVariableHolder.getStaticField() ? SYM_STATIC : 0;
+         symbols->entries.push_back(entry);
+      }
    }
-} /* End of check_includename */
-
 
+   /* Enum Names and their Elements */
+   {
+      NLDRAAnalysis::CVariableListDeclaration enumListHolder;
+      NLDRAAnalysis::CVariableTypeDeclaration enumElementHolder;
 
+      iObj->loadGlobalComponent(data->source_name, GLOBAL_ENUMS, FileResults);
+      while (iObj->readGlobalComponentList(enumListHolder))
+      {
+         struct symbol_entry entry = {};
+         entry.kind = SymEnumName;
+         entry.name = symbols->arena.intern(enumListHolder.getName());
+         entry.line = enumListHolder.getRefStartLine();
+         symbols->entries.push_back(entry);
 
-
-/***----------------------------------------------------------------
-***
-*** Routine: match_template
-***
-*** Returns the index value of a template if found
-*** Other wise returns -1
-***
-*** Parameters:
-*** ===========
-***
-*** Action  Name                Type            Use
-*** ------  ----                ----            ---
-*** I       line                char *          line of source text
-*** I       current_template    int             position in template list
-***
-*** Return value:
-*** int
-***
-***
-*** Calls:
-*** ======
-***
-*** Name                      Location
-*** ----                      --------
-*** strncmp                   System
-*** strlen                    System
-***
-***----------------------------------------------------------------*/
-#define TEMPLATE_MAX 11
-static char * usertemplate[TEMPLATE_MAX] =
-{/* 0 */ "/*******************************************",
- /* 1 */ " * Copyright statement",
- /* 2 */ " *******************************************/",
- /* 3 */ "/*******************************************",
- /* 4 */ " * Filename:",
- /* 5 */ " * Author:",
- /* 6 */ " * Date:",
- /* 7 */ " * Purpose:",
- /* 8 */ " * Revision:",
- /* 9 */ " *******************************************/",
- /* 10 */ " /* Include Section */"
-};
-
-int match_template(char *line, int current_template)
-{
-  int template_no;
-  for (template_no = current_template+1; template_no < TEMPLATE_MAX; template_no++)
-  {
-    /* Check to see whether template matches start of line */
-    if ( !strncmp(usertemplate[template_no], line, strlen(usertemplate[template_no])) )
-    {
-      break;
-    }
-  }
-  return  ( template_no == TEMPLATE_MAX ? -1 : template_no ) ;
-} /* End of match_template */
-
-/***----------------------------------------------------------------
-***
-*** Routine: check_templates
-***
-*** 4 Z Source does not match layout template.
-***  Check to see whether any templates have been skipped.
-***
-*** Parameters:
-*** ===========
-***
-*** Action  Name                Type            Use
-*** ------  ----                ----            ---
-*** I       data                const struct input_data *
-*** I       fp                  FILE *
-*** I       line                char *    current source line
-***
-*** Return value:
-*** void
-***
-***
-*** Calls:
-*** ======
-***
-*** Name                      Location
-*** ----                      --------
-*** append_violation          This File
-*** match_template            This File
-*** sprintf                   System
-***
-***
-***----------------------------------------------------------------*/
-void check_templates (const struct input_data* data, FILE* fp, char * line)
-{
-   char message[MESSAGE_SIZE] = {0};
-   static int current_template = -1;
-
-   if ( current_template+1 < TEMPLATE_MAX )
-   { /* In template section */
-     int template_no = match_template(line, current_template);
-
-     if ( template_no != -1 )
-     {  /* template match found */
-       if ( template_no != current_template+1 )
-       {
-           sprintf (message, "Source does not match layout template : %s",
-                            usertemplate[current_template+1]);
-           append_violation(data, fp, 4, message, 0, ZSTANDARD);
-       }
-       current_template = template_no;
-     }
+         while (iObj->readGlobalComponentSubList(enumElementHolder))
+         {
+            struct symbol_entry element = {};
+            element.kind = SymEnumElement;
+            element.name = symbols->arena.intern(enumElementHolder.getName());
+            element.line = enumElementHolder.getRefStartLine();
+            symbols->entries.push_back(element);
+         }
+      }
    }
-} /* End of check_templates */
 
+   /* Classes and Class Members declared in this File */
+   if (iObj->loadAllClasses(false) > 0) /* Set Parameter to true to include Child Classes */
+   {
+      NLDRAAnalysis::CClassDeclaration classDeclarationHolder;
+      NLDRAAnalysis::CMemberVariableDeclaration classMemberHolder;
 
+      while (iObj->readAllClassList(classDeclarationHolder))
+      {
+         if (classDeclarationHolder.sourceFile().getModuleNumber() == data->module_id)
+         {
+            struct symbol_entry entry = {};
+            entry.kind = SymClass;
+            entry.name = symbols->arena.intern(classDeclarationHolder.getName());
+            entry.line = classDeclarationHolder.getRefStartLine();
+            symbols->entries.push_back(entry);
+         }
 
-/***----------------------------------------------------------------
-***
-*** Routine: check_radix
-***
-*** 5 Z Hexadecimal number found.
-***  Checks that  there is no use of hexadecimal radix
-***
-*** Parameters:
-*** ===========
-***
-*** Action  Name                Type            Use
-*** ------  ----                ----            ---
-*** I       data                const struct input_data *
-*** I       fp                  FILE *
-*** I       line                char *          line of source text
-***
-***
-*** Return value:
-*** void
-***
-***
-*** Calls:
-*** ======
-***
-*** Name                      Location
-*** ----                      --------
-*** append_violation          This File
-*** strstr                    System
-*** sprintf                   System
-***
-***
-***----------------------------------------------------------------*/
-void check_radix (const struct input_data* data, FILE* fp, char * line)
-{
-   char message[MESSAGE_SIZE] = {0};
-   char *s = strstr(line, "0x");
-   if (s == NULL)
-   {
-     s = strstr(line, "0X");
+         iObj->loadClassMemberVariables(classDeclarationHolder);
+         while (iObj->readMemberVariableList(classMemberHolder))
+         {
+            if (classMemberHolder.sourceFile().getModuleNumber() == data->module_id)
+            {
+               struct symbol_entry member = {};
+               member.kind = SymClassMember;
+               member.name = symbols->arena.intern(classMemberHolder.getName());
+               member.line = classMemberHolder.getRefStartLine();
+               symbols->entries.push_back(member);
+            }
+         }
+      }
    }
-   if (s != NULL)
+
+   /* Namespaces */
+   if (iObj->loadAllNamespaces() > 0)
    {
-     sprintf(message,"Hexadecimal number found : %s", s );
-     append_violation(data, fp, 5, message, 5, ZSTANDARD);
-   }
-} /* End of check_radix */
+      NLDRAAnalysis::CNamespaceDeclaration namespaceHolder;
 
-/***----------------------------------------------------------------
-***
-*** Routine: check_forbidden_words
-***
-*** 6 Z Forbidden word found.
-***  Checks that there is no use of forbidden words
-***
-*** Parameters:
-*** ===========
-***
-*** Action  Name                Type            Use
-*** ------  ----                ----            ---
-*** I       data                const struct input_data *
-*** I       fp                  FILE *
-*** I       line                char *          line of source text
-*** I       linenum             int             line number of text
-***
-***
-*** Return value:
-*** void
-***
-***
-*** Calls:
-*** ======
-***
-*** Name                      Location
-*** ----                      --------
-*** append_violation          This File
-*** strstr                    System
-*** sprintf                   System
-***
-***----------------------------------------------------------------*/
-void check_forbidden_words (const struct input_data* data, FILE* fp, char * line, int linenum)
-{
-   char message[MESSAGE_SIZE] = {0};
-   const int WORDS = 3;
-   const char WORD_LIST[WORDS][32] = {"TODO", "TEMPORARY", "REMOVE" };
+      while (iObj->readAllNamespaceList(namespaceHolder))
+      {
+         struct symbol_entry entry = {};
+         entry.kind = SymNamespace;
+         entry.name = symbols->arena.intern(namespaceHolder.getName());
+         entry.line = -1;
+         symbols->entries.push_back(entry);
+      }
+   }
 
-   for ( int i = 0; i < WORDS; i++ )
+   /* Functions and their Parameters */
    {
-      char *s = strstr(line, WORD_LIST[i]);
-      if (s != NULL)
-      {
-         sprintf(message,"Forbidden word found : %s", WORD_LIST[i] );
+      NLDRAAnalysis::CFunctionDeclaration functionDeclarationHolder;
+      NLDRAAnalysis::CVariableTypeDeclaration parameterHolder;
 
-         /*
-          * Line number at this point is the actual source line number, before
-          * storing the line number, we need to convert it to the reformatted code
-          * line number.
-          */
-         int ref_linenum = linenum;
-         tblinemapper_get_ref_line_num(linenum,
-                                       data->source_name,
-                                       data->module_id,
-                                       data->source_name,
-                                       data->workdir,
-                                       &ref_linenum);
+      iObj->loadFunctions(data->source_name, FileResults);
+      while (iObj->readFunctionList(functionDeclarationHolder))
+      {
+         struct symbol_entry entry = {};
+         entry.kind = SymFunction;
+         const int functionLineNumber = functionDeclarationHolder.getRefStartLine();
+
+         entry.name = symbols->arena.intern(functionDeclarationHolder.getName());
+         entry.stem = symbols->arena.intern(functionDeclarationHolder.getDeclarativeStem());
+         entry.line = functionLineNumber;
+         entry.flags = (functionDeclarationHolder.isStaticLinkage() ? SYM_STATIC : 0)
+                     | (functionDeclarationHolder.isMain() ? SYM_MAIN : 0)
+                     | (strcmp(functionDeclarationHolder.sourceFile().getLanguage(), "C") == 0 ? SYM_LANG_C : 0);
+         symbols->entries.push_back(entry);
+
+         iObj->loadComponents(functionDeclarationHolder,
+            PARAMETERS,
+            FunctionResults,
+            data->source_name);
+
+         while (iObj->readParameterComponent(parameterHolder))
+         {
+            struct symbol_entry parameter = {};
+            parameter.kind = SymParameter;
+            parameter.name = symbols->arena.intern(parameterHolder.getName());
+            parameter.line = parameterHolder.getRefStartLine();
+            parameter.flags = parameterHolder.getIsPointer() ? SYM_POINTER : 0;
 
-         append_violation(data, fp, 6, message, ref_linenum, ZSTANDARD);
+            /* Check if the Line Number for the Parameter is provided, fallback to the function if not */
+            if (parameter.line < 1)
+            {
+               parameter.line = functionLineNumber;
+            }
+            symbols->entries.push_back(parameter);
+         }
       }
    }
-} /* End of check_forbidden_words */
-
-/***----------------------------------------------------------------
-***
-*** End of Standards
-***
-***----------------------------------------------------------------*/
+} /* End of load_symbol_table */
 
 
 
@@ -1512,59 +1936,6 @@ void check_forbidden_words (const struct input_data* data, FILE* fp, char * line
 ***
 ***----------------------------------------------------------------*/
 
-/***-------------------------------------------------------------------------------------------------------------
-***
-*** Routine: process_naming_conformance
-***
-*** Parameters:
-*** ===========
-***
-*** Action  Name            Type                          Use
-*** ------  ----            ----                          ---
-*** I       data            const struct input_data *     Argument Data
-*** I       fp              FILE *                        SIF File Pointer
-*** I       type            const char *                  Variable Type
-*** I       style           const char *                  Conformance Style
-*** I       name            const char *                  Variable Name
-*** I       conforms        int                           Whether or not variable conforms to style
-*** I       linenumber      int                           Line number of variable declaration
-*** I       std_num         int                           Number for H Standard
-***
-*** Description:
-*** ===========
-*** If a variable does not conform to standards, adds it to the violation SIF file.
-*** Also adds an entry to the naming report if reports are enabled
-***
-***-------------------------------------------------------------------------------------------------------------*/
-void process_naming_conformance (const struct input_data * data,
-                                  FILE * fp,
-                                  const char* type,
-                                  const char* style,
-                                  const char* name,
-                                  const int conforms,
-                                  const int linenumber,
-                                  const int std_num)
-{
-   char message[MAXSTR] = {0};
-
-   /* If variable does not conform to standard, add it to the violations SIF file */
-   if(!conforms)
-   {
-      append_violation (data, fp, std_num, name, linenumber, HSTANDARD);
-#ifdef REPORT
-      sprintf(message, "%s does not conform to style '%s': %s", type, style, name);
-      print_to_report (message, linenumber, data);
-#endif
-   }
-#ifdef REPORT
-   else
-   {
-      sprintf(message, "%s conforms to style '%s': %s", type, style, name);
-      print_to_report (message, linenumber, data);
-   }
-#endif
-}
-
 /***----------------------------------------------------------------
 ***
 *** Routine: append_violation
@@ -1577,18 +1948,19 @@ void process_naming_conformance (const struct input_data * data,
 *** I       data        const struct input_data *  source file information
 *** I       fp                   FILE *            sif file
 *** I       std_num              int               5th column in pen file
-*** I       message              char *            message to be added to sif file
+*** I       message              std::string_view  message to be added to sif file
 ***
 *** Description:
 *** ============
 ***
 *** Append a violation to the sif file (fp)
+*** Messages longer than the 101 record text are truncated.
 ***
 ***----------------------------------------------------------------*/
 void append_violation (const struct input_data* data,
                        FILE* fp,
                        const int std_num,
-                       const char *message,
+                       std::string_view message,
                        const int linenumber,
                        const char std_letter)
 {
@@ -1601,7 +1973,8 @@ void append_violation (const struct input_data* data,
       std.ref_code_line_number = linenumber;
    }
 
-   sprintf(std.standard_text, message);
+   snprintf(std.standard_text, sizeof(std.standard_text), "%.*s",
+            (int) message.size(), message.data());
 
    std.user_standard_number = std_num; /* This number must match column 5 in <lang>pen.dat */
 
@@ -1774,128 +2147,1134 @@ void split_directory_path (const char *file_name,
 
 /***----------------------------------------------------------------
 ***
-*** End of LDRA Functions to write Violation
-***
-***----------------------------------------------------------------*/
-
-
-
-
-
-/***----------------------------------------------------------------
-***
-*** Start of LDRA Functions to write .naming Report
-***
-***----------------------------------------------------------------*/
-#ifdef REPORT
-
-FILE* fpRep = NULL;
-
-/***-------------------------------------------------------------------------------------------------------------
-***
-*** Routine: print_to_report
+*** Routine: read_source_file
+*** Reads the whole of a source file into text, in binary mode so the
+*** size matches the file on disk.
 ***
 *** Parameters:
-*** ===========
 ***
-*** Action  Name            Type                          Use
-*** ------  ----            ----                          ---
-*** I       message         const char *                  Message to write in report
-*** I       linenumber      int                           Line Number of variable declaration
-*** I       data            const struct input_data *     Argument Data
+*** Action  Name                      Type              Use
+*** ------  ----                      ----              ---
+*** I       source_name               const char *      Full source file name
+*** O       text                      std::string *     Contents, empty on failure
 ***
-*** Description:
-*** ===========
-*** Writes the given message to the naming report file
+*** Return value:
+*** int             1 if the file was read, 0 otherwise
 ***
-***-------------------------------------------------------------------------------------------------------------*/
-void  print_to_report (const char* message, const int linenumber, const struct input_data* data)
+***----------------------------------------------------------------*/
+int read_source_file (const char* source_name, std::string* text)
 {
-   if (fpRep == NULL)
-   {
-      char rep_name[MAXSTR];
-      char short_name[MAXSTR] = {'\0'};
-      char* nptr;
-      char* extension = "";
-      split_directory_path (data->source_name, short_name, (char*) NULL);
-      nptr = strrchr (short_name, '.');
-      if (nptr != NULL)
-      {
-         *nptr = '\0';
-      }
-      sprintf (rep_name, "%s\\%s_%d.naming", data->workdir,
-                                             short_name,
-                                             data->module_id);
+   FILE *source_fp = fopen(source_name, "rb");
+   int read_ok = 0;
 
-      fpRep = fopen ( rep_name, "w");
-   }
-   if (fpRep != NULL)
+   text->clear();
+   if (source_fp != NULL)
    {
-      fprintf (fpRep, "%-6d %s\n", linenumber, message);
-   }
-}
+      char buffer[65536];
+      size_t count;
 
-/***-------------------------------------------------------------------------------------------------------------
-***
-*** Routine: close_report
-***
-*** Description:
-*** ===========
-*** Closes the file pointer for the report
-***
-***-------------------------------------------------------------------------------------------------------------*/
-void close_report ()
-{
-   if (fpRep != NULL)
-   {
-      fclose (fpRep);
+      while ((count = fread(buffer, 1, sizeof(buffer), source_fp)) > 0)
+      {
+         text->append(buffer, count);
+      }
+      read_ok = !ferror(source_fp);
+      fclose(source_fp);
    }
-}
-#endif
+   return read_ok;
+} /* end of read_source_file */
 
 /***----------------------------------------------------------------
 ***
-*** End of LDRA Functions to write .naming Report
+*** Routine: diff_names_source
+*** Whether a path named in a diff is the source file. Diff paths are
+*** usually relative (and prefixed a/ or b/ by git), so the source only
+*** has to end with the path, at a directory boundary.
 ***
 ***----------------------------------------------------------------*/
+static bool diff_names_source (std::string_view diff_path, const std::string& source)
+{
+   std::string path(diff_path);
 
+   std::replace(path.begin(), path.end(), '\\', '/');
+   if (path.compare(0, 2, "b/") == 0 || path.compare(0, 2, "a/") == 0)
+   {
+      if (source.size() < path.size() || source.compare(source.size() - path.size(), path.size(), path) != 0)
+      {
+         path.erase(0, 2);
+      }
+   }
+   if (path.empty() || path.size() > source.size())
+   {
+      return false;
+   }
 
+   const size_t start = source.size() - path.size();
+   return source.compare(start, path.size(), path) == 0
+          &&
+          (start == 0 || source[start - 1] == '/' || source[start - 1] == ':');
+} /* End of diff_names_source */
 
 /***----------------------------------------------------------------
 ***
-*** Routine: fsize
-*** Uses standard C library routines to determine size in bytes of
-*** a file.
+*** Routine: read_changed_lines
 ***
 *** Parameters:
-*** Action  Name                      Type            Use
-*** ------  ----                      ----            ---
-*** I       infile                    const char *    Name of file
+*** ===========
 ***
+*** Action  Name                      Type                       Use
+*** ------  ----                      ----                       ---
+*** I       diff_file                 const char *               Unified diff or line list
+*** I       source_name               const char *               Full source file name
+*** O       ranges                    std::vector<line_range> *  Changed source lines
 ***
 *** Return value:
-*** Type            Meaning
-*** ----            -------
-*** long           Size in bytes of the input file, 0 if
-***                file not opened
-*** Calls:
-*** Name                      Location
-*** ----                      --------
-*** fclose                    System
-*** fopen                     System
-*** fseek                     System
-*** ftell                     System
+*** int             0 if the diff file cannot be read
+***
+*** Description:
+*** ============
+***
+*** From a unified diff, the lines added to the source are changed lines,
+*** and where lines were only removed the line that follows them is.
+*** Otherwise each line of the file is <source>:<first>[-<last>].
+***
 ***----------------------------------------------------------------*/
-long fsize (const char *infile)
- {
-   FILE *fd ;
-   long size = 0L;
-   fd = fopen(infile,"r") ;
-   if (fd != NULL)
+int read_changed_lines (const char* diff_file, const char* source_name,
+                        std::vector<line_range>* ranges)
+{
+   std::string text;
+   std::string source(source_name);
+   bool this_file = false;
+   int new_line = 0;
+
+   ranges->clear();
+   if (!read_source_file(diff_file, &text))
    {
-      fseek(fd,0L,2) ;
-      size = ftell(fd) ;
-      fclose(fd) ;
+      return 0;
    }
-   return(size) ;
- } /* end of fsize */
+   std::replace(source.begin(), source.end(), '\\', '/');
+
+   std::string_view rest = text;
+   while (!rest.empty())
+   {
+      size_t eol = rest.find('\n');
+      std::string_view line = rest.substr(0, eol);
+      rest = (eol == std::string_view::npos) ? std::string_view() : rest.substr(eol + 1);
+
+      if (!line.empty() && line.back() == '\r')
+      {
+         line.remove_suffix(1);
+      }
+
+      if (line.compare(0, 4, "+++ ") == 0)
+      {
+         /* New file name, up to any tab and timestamp */
+         std::string_view path = line.substr(4);
+         this_file = diff_names_source(path.substr(0, path.find('\t')), source);
+         new_line = 0;
+      }
+      else if (line.compare(0, 4, "--- ") == 0 || line.compare(0, 5, "diff ") == 0)
+      {
+         new_line = 0;
+      }
+      else if (line.compare(0, 3, "@@ ") == 0)
+      {
+         /* @@ -a[,b] +c[,d] @@ */
+         size_t plus = line.find(" +");
+         new_line = (plus == std::string_view::npos) ? 0 : atoi(std::string(line.substr(plus + 2, 12)).c_str());
+      }
+      else if (new_line > 0)
+      {
+         if (!line.empty() && line[0] == '\\')
+         {
+            continue; /* \ No newline at end of file */
+         }
+         if (this_file && !line.empty() && (line[0] == '+' || line[0] == '-'))
+         {
+            ranges->push_back({new_line, new_line});
+         }
+         if (line.empty() || line[0] != '-')
+         {
+            new_line++;
+         }
+      }
+      else
+      {
+         /* <source>:<first>[-<last>] */
+         size_t colon = line.rfind(':');
+         if (colon != std::string_view::npos && colon + 1 < line.size()
+             &&
+             isdigit((unsigned char) line[colon + 1])
+             &&
+             diff_names_source(line.substr(0, colon), source))
+         {
+            const std::string numbers(line.substr(colon + 1));
+            const char* dash = strchr(numbers.c_str(), '-');
+            line_range range;
+
+            range.first = atoi(numbers.c_str());
+            range.last = (dash != NULL) ? atoi(dash + 1) : range.first;
+            if (range.first > 0 && range.last >= range.first)
+            {
+               ranges->push_back(range);
+            }
+         }
+      }
+   }
+
+   merge_line_ranges(ranges);
+   return 1;
+} /* End of read_changed_lines */
+
+
+/***----------------------------------------------------------------
+***
+*** End of LDRA Functions to write Violation
+***
+***----------------------------------------------------------------*/
+
+
+
+
+
+/***----------------------------------------------------------------
+***
+*** Start of LDRA Functions to write .naming Report
+***
+***----------------------------------------------------------------*/
+#ifdef REPORT
+
+/***-------------------------------------------------------------------------------------------------------------
+***
+*** Routine: open_report
+***
+*** Parameters:
+*** ===========
+***
+*** Action  Name            Type                          Use
+*** ------  ----            ----                          ---
+*** I       data            const struct input_data *     Argument Data
+***
+*** Description:
+*** ===========
+*** Creates the naming report file for the File, NULL if it cannot be opened
+***
+***-------------------------------------------------------------------------------------------------------------*/
+FILE* open_report (const struct input_data* data)
+{
+   char rep_name[MAXSTR + 32];
+   char short_name[MAXSTR] = {'\0'};
+   char* nptr;
+
+   split_directory_path (data->source_name, short_name, (char*) NULL);
+   nptr = strrchr (short_name, '.');
+   if (nptr != NULL)
+   {
+      *nptr = '\0';
+   }
+   snprintf (rep_name, sizeof(rep_name), "%s\\%s_%d.naming", data->workdir,
+                                                             short_name,
+                                                             data->module_id);
+
+   return fopen ( rep_name, "w");
+}
+
+/***-------------------------------------------------------------------------------------------------------------
+***
+*** Routine: print_to_report
+***
+*** Parameters:
+*** ===========
+***
+*** Action  Name            Type                          Use
+*** ------  ----            ----                          ---
+*** I       fpRep           FILE *                        Report File Pointer
+*** I       message         std::string_view              Message to write in report
+*** I       linenumber      int                           Line Number of variable declaration
+***
+*** Description:
+*** ===========
+*** Writes the given message to the naming report file
+***
+***-------------------------------------------------------------------------------------------------------------*/
+void  print_to_report (FILE* fpRep, std::string_view message, const int linenumber)
+{
+   if (fpRep != NULL)
+   {
+      fprintf (fpRep, "%-6d %.*s\n", linenumber, (int) message.size(), message.data());
+   }
+}
+
+/***-------------------------------------------------------------------------------------------------------------
+***
+*** Routine: close_report
+***
+*** Description:
+*** ===========
+*** Closes the file pointer for the report
+***
+***-------------------------------------------------------------------------------------------------------------*/
+void close_report (FILE* fpRep)
+{
+   if (fpRep != NULL)
+   {
+      fclose (fpRep);
+   }
+}
+#endif
+
+/***----------------------------------------------------------------
+***
+*** End of LDRA Functions to write .naming Report
+***
+***----------------------------------------------------------------*/
+
+
+
+/***----------------------------------------------------------------
+***
+*** Start of Daemon Mode
+***
+*** Protocol, one request per connection:
+***   request  - the settings, "<name>=<value>" for each of SETTINGS_ENV,
+***              then an empty field, then the arguments, each field
+***              terminated by '\0', then the client shuts down its side
+***              of the connection
+***   response - "<return code>\n" followed by any messages, or
+***              "refused\n" followed by the reason when the settings are
+***              not the daemon's
+*** A request of the single argument "--stop" stops the daemon.
+***
+***----------------------------------------------------------------*/
+
+/* Environment the checks of a session follow, the daemon's must be the client's */
+static const char* const SETTINGS_ENV[] =
+{
+   TABLE_ENV, MODEL_ENV, METPEN_ENV, SYSEARCH_ENV, INCLUDE_GRAPH_ENV,
+   CLONES_ENV, BANNED_ENV, BASELINE_ENV, BASELINE_RECORD_ENV
+};
+
+/*
+ * struct daemon_state
+ * Shared between the accept loop and the worker threads.
+ */
+struct daemon_state
+{
+   struct glh_session session;
+   socket_t listen_socket = INVALID_SOCKET;
+   std::atomic<bool> stopping{false};
+   std::mutex mutex;
+   std::condition_variable work;            /* A client is waiting, or stopping */
+   std::deque<socket_t> clients;            /* Accepted, not yet served */
+};
+
+/***----------------------------------------------------------------
+***
+*** Routine: connect_socket
+***
+*** Parameters:
+*** ===========
+***
+*** Action  Name                      Type            Use
+*** ------  ----                      ----            ---
+*** I       socket_path               const char *    Unix domain socket path
+*** I       listen                    bool            true to bind and listen instead of connecting
+***
+*** Return value:
+*** The connected or listening socket, INVALID_SOCKET on failure
+***
+*** Description:
+*** ============
+***
+*** A listening socket is created accessible to its owner alone, as any
+*** client may have Files read and results written in the daemon's name.
+***
+***----------------------------------------------------------------*/
+static socket_t connect_socket (const char* socket_path, bool listen_on)
+{
+   struct sockaddr_un address;
+   socket_t sock;
+
+#ifdef _WIN32
+   static bool started = false;
+   if (!started)
+   {
+      WSADATA wsa_data;
+      if (WSAStartup(MAKEWORD(2, 2), &wsa_data) != 0)
+      {
+         return INVALID_SOCKET;
+      }
+      started = true;
+   }
+#endif
+
+   if (strlen(socket_path) >= sizeof(address.sun_path))
+   {
+      return INVALID_SOCKET;
+   }
+
+   memset(&address, 0, sizeof(address));
+   address.sun_family = AF_UNIX;
+   strcpy(address.sun_path, socket_path);
+
+   sock = socket(AF_UNIX, SOCK_STREAM, 0);
+   if (sock == INVALID_SOCKET)
+   {
+      return INVALID_SOCKET;
+   }
+
+   if (listen_on)
+   {
+      /* A socket left behind by a daemon that did not stop cleanly */
+      remove(socket_path);
+
+#ifndef _WIN32
+      const mode_t old_mask = umask(077);
+#endif
+      const bool bound = bind(sock, (struct sockaddr*) &address, sizeof(address)) == 0;
+#ifndef _WIN32
+      umask(old_mask);
+#endif
+
+      if (!bound || listen(sock, SOMAXCONN) != 0)
+      {
+         close_socket(sock);
+         return INVALID_SOCKET;
+      }
+   }
+   else if (connect(sock, (struct sockaddr*) &address, sizeof(address)) != 0)
+   {
+      close_socket(sock);
+      return INVALID_SOCKET;
+   }
+
+   return sock;
+} /* End of connect_socket */
+
+/***----------------------------------------------------------------
+***
+*** Routine: send_all / receive_all
+***
+*** Description:
+*** ============
+***
+*** Sends the whole buffer, or receives until the peer shuts down its
+*** side of the connection (at most max_size bytes, std::string::npos for
+*** no limit).
+***
+***----------------------------------------------------------------*/
+static bool send_all (socket_t sock, const std::string& buffer)
+{
+   size_t sent = 0;
+
+   while (sent < buffer.size())
+   {
+      int count = send(sock, buffer.data() + sent, (int) (buffer.size() - sent), 0);
+      if (count <= 0)
+      {
+         return false;
+      }
+      sent += count;
+   }
+   return true;
+}
+
+static bool receive_all (socket_t sock, std::string* buffer, size_t max_size)
+{
+   char chunk[4096];
+   int count;
+
+   buffer->clear();
+   while ((count = recv(sock, chunk, sizeof(chunk), 0)) > 0)
+   {
+      buffer->append(chunk, count);
+      if (buffer->size() > max_size)
+      {
+         return false;
+      }
+   }
+   return count == 0;
+} /* End of receive_all */
+
+/***----------------------------------------------------------------
+***
+*** Routine: forward_to_daemon
+***
+*** Parameters:
+*** ===========
+***
+*** Action  Name                      Type            Use
+*** ------  ----                      ----            ---
+*** I       socket_path               const char *    Unix domain socket path
+*** I       args                      char * const [] Arguments to forward
+*** I       arg_count                 int             Number of arguments
+*** O       return_code               int *           Return code of the daemon request
+***
+*** Return value:
+*** bool            false if the daemon could not be reached, or refused
+***                 the request as its settings are not the daemon's
+***
+*** Description:
+*** ============
+***
+*** Sends the arguments to the daemon and prints the messages it returns.
+*** Once the request is sent the daemon may have written the SIF records,
+*** so a reply that is lost is a failure of the request (return code 1),
+*** not a reason to run the check again.
+***
+***----------------------------------------------------------------*/
+bool forward_to_daemon (const char* socket_path, char* const args[], int arg_count, int* return_code)
+{
+   std::string request;
+   std::string response;
+   socket_t sock = connect_socket(socket_path, false);
+
+   if (sock == INVALID_SOCKET)
+   {
+      return false;
+   }
+
+   for (const char* name : SETTINGS_ENV)
+   {
+      const char* value = getenv(name);
+      request.append(name).append("=").append((value != NULL) ? value : "").push_back('\0');
+   }
+   request.push_back('\0');
+   for (int arg = 0; arg < arg_count; arg++)
+   {
+      request.append(args[arg]).push_back('\0');
+   }
+
+   if (!send_all(sock, request))
+   {
+      /* The daemon went away before it had the request, the caller runs the check itself */
+      close_socket(sock);
+      return false;
+   }
+
+   bool ok = shutdown(sock, SHUT_WR) == 0
+             &&
+             receive_all(sock, &response, std::string::npos);
+   close_socket(sock);
+
+   size_t eol = response.find('\n');
+   if (!ok || eol == std::string::npos)
+   {
+      printf("The daemon on %s did not reply in full, the request may have been carried out\n", socket_path);
+      *return_code = 1;
+      return true;
+   }
+   if (response.compare(0, eol, DAEMON_REFUSED) == 0)
+   {
+      /* The daemon did nothing, the caller runs the check with its own settings */
+      printf("%s", response.c_str() + eol + 1);
+      return false;
+   }
+
+   *return_code = atoi(response.c_str());
+   printf("%s", response.c_str() + eol + 1);
+
+   return true;
+} /* End of forward_to_daemon */
+
+/***----------------------------------------------------------------
+***
+*** Routine: serve_client
+***
+*** Parameters:
+*** ===========
+***
+*** Action  Name                      Type                    Use
+*** ------  ----                      ----                    ---
+*** I       state                     struct daemon_state *   Daemon
+*** I       sock                      socket_t                Client connection
+***
+*** Description:
+*** ============
+***
+*** Runs one request on a worker thread, then closes the connection.
+***
+***----------------------------------------------------------------*/
+static void serve_client (struct daemon_state * state, socket_t sock)
+{
+   std::string request;
+   std::string messages;
+   std::string refused;
+   std::vector<char*> args;
+   int return_code = 1;
+#ifdef _WIN32
+   DWORD timeout = DAEMON_RECEIVE_TIMEOUT * 1000;
+#else
+   struct timeval timeout = { DAEMON_RECEIVE_TIMEOUT, 0 };
+#endif
+
+   /* A client that never ends its request must not hold the worker */
+   setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, (const char*) &timeout, sizeof(timeout));
+
+   /* A request cut short, the client gone before its last '\0', is not run */
+   if (receive_all(sock, &request, MAX_REQUEST_SIZE) && !request.empty() && request.back() == '\0')
+   {
+      size_t pos = 0;
+
+      /* The settings of the client, up to the empty field */
+      for (; pos < request.size() && request[pos] != '\0'; pos += strlen(&request[pos]) + 1)
+      {
+         const char* setting = &request[pos];
+         const char* equals = strchr(setting, '=');
+         const std::string name(setting, (equals != NULL) ? equals - setting : strlen(setting));
+         const char* value = getenv(name.c_str());
+
+         if (equals == NULL || strcmp(equals + 1, (value != NULL) ? value : "") != 0)
+         {
+            refused.append(refused.empty() ? "" : ", ").append(name);
+         }
+      }
+      for (pos++; pos < request.size(); pos += strlen(&request[pos]) + 1)
+      {
+         args.push_back(&request[pos]);
+      }
+   }
+
+   if (args.size() == 1 && strcmp(args[0], "--stop") == 0)
+   {
+      state->stopping = true;
+      /* Wakes the accept loop */
+      shutdown(state->listen_socket, SHUT_RDWR);
+      return_code = 0;
+   }
+   else if ((args.size() == 4 || args.size() == 5) && !refused.empty())
+   {
+      send_all(sock, std::string(DAEMON_REFUSED) + "\nThe daemon was started with other " + refused
+                     + ", the File is checked without the daemon\n");
+      close_socket(sock);
+      return;
+   }
+   else if (args.size() == 4 || args.size() == 5)
+   {
+      return_code = run_standards_check(&state->session, args.data(), (int) args.size(), &messages);
+   }
+   else
+   {
+      messages = "Invalid daemon request\n";
+   }
+
+   send_all(sock, std::to_string(return_code) + "\n" + messages);
+   close_socket(sock);
+} /* End of serve_client */
+
+/***----------------------------------------------------------------
+***
+*** Routine: run_worker
+***
+*** Parameters:
+*** ===========
+***
+*** Action  Name                      Type                    Use
+*** ------  ----                      ----                    ---
+*** I       state                     struct daemon_state *   Daemon
+***
+*** Description:
+*** ============
+***
+*** A worker thread of the daemon, it lives as long as the daemon so its
+*** checker (see append_standards_violations) is reused by every request
+*** it serves. Clients already accepted are served before it stops.
+***
+***----------------------------------------------------------------*/
+static void run_worker (struct daemon_state * state)
+{
+   for (;;)
+   {
+      socket_t sock;
+      {
+         std::unique_lock<std::mutex> lock(state->mutex);
+         state->work.wait(lock, [state] { return state->stopping || !state->clients.empty(); });
+         if (state->clients.empty())
+         {
+            return;
+         }
+         sock = state->clients.front();
+         state->clients.pop_front();
+      }
+      serve_client(state, sock);
+   }
+} /* End of run_worker */
+
+/***----------------------------------------------------------------
+***
+*** Routine: run_daemon
+***
+*** Parameters:
+*** ===========
+***
+*** Action  Name                      Type            Use
+*** ------  ----                      ----            ---
+*** I       socket_path               const char *    Unix domain socket path
+***
+*** Return value:
+*** int             process return code
+***
+*** Description:
+*** ============
+***
+*** Listens on socket_path until a "--stop" request, checking each File
+*** requested on one of a fixed set of worker threads. Requests already
+*** accepted when the daemon is stopped are completed first.
+***
+***----------------------------------------------------------------*/
+int run_daemon (const char* socket_path)
+{
+   struct daemon_state state;
+
+   state.listen_socket = connect_socket(socket_path, true);
+   if (state.listen_socket == INVALID_SOCKET)
+   {
+      printf("Unable to listen on %s\n", socket_path);
+      return 1;
+   }
+
+#ifndef _WIN32
+   /* A client that goes away must not stop the daemon */
+   signal(SIGPIPE, SIG_IGN);
+#endif
+
+   const unsigned int worker_count = std::max<unsigned int>(std::thread::hardware_concurrency(),
+                                                            MIN_DAEMON_WORKERS);
+   std::vector<std::thread> workers;
+   for (unsigned int worker = 0; worker < worker_count; worker++)
+   {
+      workers.emplace_back(run_worker, &state);
+   }
+
+   printf("Listening on %s\n", socket_path);
+   fflush(stdout);
+
+   while (!state.stopping)
+   {
+      socket_t client = accept(state.listen_socket, NULL, NULL);
+
+      if (client == INVALID_SOCKET)
+      {
+         if (state.stopping)
+         {
+            break;
+         }
+         /* Aborted connections and short lived lack of descriptors or buffers pass */
+         if (errno != EINTR)
+         {
+            std::this_thread::sleep_for(std::chrono::milliseconds(DAEMON_ACCEPT_BACKOFF));
+         }
+         continue;
+      }
+
+      std::lock_guard<std::mutex> lock(state.mutex);
+      state.clients.push_back(client);
+      state.work.notify_one();
+   }
+
+   /* Let the accepted requests complete before the session goes */
+   {
+      std::lock_guard<std::mutex> lock(state.mutex);
+      state.stopping = true;
+      state.work.notify_all();
+   }
+   for (std::thread& worker : workers)
+   {
+      worker.join();
+   }
+
+   close_socket(state.listen_socket);
+   remove(socket_path);
+
+   return 0;
+} /* End of run_daemon */
+
+/***----------------------------------------------------------------
+***
+*** End of Daemon Mode
+***
+***----------------------------------------------------------------*/
+
+
+
+/***----------------------------------------------------------------
+***
+*** Start of Watch Mode
+***
+***----------------------------------------------------------------*/
+
+/*
+ * struct watch_violation
+ * A violation kept from the last check of a File.
+ */
+struct watch_violation
+{
+   char std_letter;
+   int std_num;
+   int line;
+   std::string text;
+};
+
+/*
+ * struct watched_file
+ * A File of the watch list, with its source and last results.
+ */
+struct watched_file
+{
+   std::string source_name;
+   int module_id;
+   std::string glh_path;
+   std::string workdir;
+   std::string source_text;
+   std::vector<struct watch_violation> violations;
+};
+
+/* Order of violations for comparison, the line is only a tie break */
+static bool violation_order (const struct watch_violation& a, const struct watch_violation& b)
+{
+   if (a.std_letter != b.std_letter) return a.std_letter < b.std_letter;
+   if (a.std_num != b.std_num) return a.std_num < b.std_num;
+   if (a.text != b.text) return a.text < b.text;
+   return a.line < b.line;
+}
+
+static bool same_violation (const struct watch_violation& a, const struct watch_violation& b)
+{
+   return a.std_letter == b.std_letter && a.std_num == b.std_num && a.text == b.text;
+}
+
+/***----------------------------------------------------------------
+***
+*** Routine: read_watch_list
+***
+*** Parameters:
+*** ===========
+***
+*** Action  Name                      Type                           Use
+*** ------  ----                      ----                           ---
+*** I       watch_list                const char *                   Watch list file name
+*** O       files                     std::vector<watched_file> *    Files to watch
+***
+*** Return value:
+*** int             0 if the watch list cannot be read
+***
+*** Description:
+*** ============
+***
+*** Reads lines of <source> TAB <module> TAB <glh>. Blank lines and lines
+*** starting '#' are ignored.
+***
+***----------------------------------------------------------------*/
+static int read_watch_list (const char* watch_list, std::vector<struct watched_file>* files)
+{
+   std::string text;
+
+   if (!read_source_file(watch_list, &text))
+   {
+      return 0;
+   }
+
+   std::string_view rest = text;
+   while (!rest.empty())
+   {
+      size_t eol = rest.find('\n');
+      std::string_view line = rest.substr(0, eol);
+      rest = (eol == std::string_view::npos) ? std::string_view() : rest.substr(eol + 1);
+
+      if (!line.empty() && line.back() == '\r')
+      {
+         line.remove_suffix(1);
+      }
+      size_t tab1 = line.find('\t');
+      size_t tab2 = (tab1 == std::string_view::npos) ? tab1 : line.find('\t', tab1 + 1);
+
+      if (line.empty() || line[0] == '#')
+      {
+         continue;
+      }
+      if (tab2 == std::string_view::npos)
+      {
+         printf("%s: expected <source>\t<module>\t<glh>: %.*s\n", watch_list,
+                (int) line.size(), line.data());
+         continue;
+      }
+
+      struct watched_file file;
+      char workdir[MAXSTR] = {0};
+
+      file.source_name = line.substr(0, tab1);
+      file.module_id = atoi(std::string(line.substr(tab1 + 1, tab2 - tab1 - 1)).c_str());
+      file.glh_path = line.substr(tab2 + 1);
+      if (file.glh_path.size() < MAXSTR)
+      {
+         split_directory_path(file.glh_path.c_str(), NULL, workdir);
+      }
+      file.workdir = workdir;
+      files->push_back(file);
+   }
+
+   return 1;
+} /* End of read_watch_list */
+
+/***----------------------------------------------------------------
+***
+*** Routine: recheck_file
+***
+*** Parameters:
+*** ===========
+***
+*** Action  Name                      Type                      Use
+*** ------  ----                      ----                      ---
+*** I       session                   struct glh_session *      GLH API Connection
+*** I       checker                   CStandardsChecker *       Checker
+*** IO      file                      struct watched_file *     File to check
+*** I       show_changes              bool                      Print the differences
+***
+*** Description:
+*** ============
+***
+*** Checks the File again and prints the violations that differ from its
+*** last check. A violation that has only moved line is not a difference.
+***
+***----------------------------------------------------------------*/
+static void recheck_file (struct glh_session * session,
+                          CStandardsChecker * checker,
+                          struct watched_file * file,
+                          bool show_changes)
+{
+   std::shared_ptr<const struct symbol_table> symbols;
+   std::vector<struct watch_violation> current;
+   struct input_data data;
+   struct check_request request;
+
+   data.source_name = &file->source_name[0];
+   data.module_id = file->module_id;
+   data.glh_path = &file->glh_path[0];
+   data.phases_string = (char*) "MSA";
+   data.workdir = &file->workdir[0];
+   data.diff_file = NULL;
+
+   /* Without the GLH only the Z Standards can be checked */
+   try
+   {
+      symbols = get_symbol_table(session, &data);
+   }
+   catch(const char * msg)
+   {
+      printf("%s: %s\n", file->source_name.c_str(), msg);
+   }
+
+   if (!read_source_file(data.source_name, &file->source_text))
+   {
+      printf("Source file %s not found\n", data.source_name);
+      return;
+   }
+
+   request.source_name = data.source_name;
+   request.source = file->source_text;
+   request.symbols = symbols.get();
+   select_rules(session, &request, NULL);
+
+   const struct check_result& result = checker->check(request);
+   CSuppressionIndex suppressions;
+   std::vector<uint64_t> fingerprints;
+
+   index_suppressions(&data, session, result, &suppressions);
+   if (session->baseline.is_open())
+   {
+      baseline_fingerprints(data.source_name, file->source_text, result.violations, &fingerprints);
+   }
+   for (size_t index = 0; index < result.violations.size(); index++)
+   {
+      const struct violation_info & violation = result.violations[index];
+
+      if (suppressions.find(violation.std_letter, violation.std_num, violation.line) >= 0
+          ||
+          (!fingerprints.empty() && session->baseline.contains(fingerprints[index])))
+      {
+         continue;
+      }
+      current.push_back({violation.std_letter, violation.std_num, violation.line,
+                         std::string(violation.text)});
+   }
+   std::sort(current.begin(), current.end(), violation_order);
+
+   /* Both lists are sorted, so a merge gives the differences */
+   size_t old_index = 0;
+   size_t new_index = 0;
+   const std::vector<struct watch_violation>& previous = file->violations;
+
+   while (show_changes && (old_index < previous.size() || new_index < current.size()))
+   {
+      if (new_index < current.size() && old_index < previous.size()
+          &&
+          same_violation(previous[old_index], current[new_index]))
+      {
+         old_index++;
+         new_index++;
+      }
+      else if (new_index == current.size()
+               ||
+               (old_index < previous.size() && violation_order(previous[old_index], current[new_index])))
+      {
+         const struct watch_violation& gone = previous[old_index++];
+         printf("- %s:%d: %d %c %s\n", file->source_name.c_str(), gone.line,
+                gone.std_num, gone.std_letter, gone.text.c_str());
+      }
+      else
+      {
+         const struct watch_violation& added = current[new_index++];
+         printf("+ %s:%d: %d %c %s\n", file->source_name.c_str(), added.line,
+                added.std_num, added.std_letter, added.text.c_str());
+      }
+   }
+   fflush(stdout);
+
+   file->violations.swap(current);
+} /* End of recheck_file */
+
+/***----------------------------------------------------------------
+***
+*** Routine: run_watch
+***
+*** Parameters:
+*** ===========
+***
+*** Action  Name                      Type            Use
+*** ------  ----                      ----            ---
+*** I       watch_list                const char *    Watch list file name
+***
+*** Return value:
+*** int             process return code
+***
+*** Description:
+*** ============
+***
+*** Checks every File of the watch list, then re-checks a File each time it
+*** is written. The directories are watched rather than the Files, so one
+*** watch serves every File in a directory and editors that save by
+*** renaming a new file over the old are seen. Events are collected until
+*** WATCH_SETTLE_MS pass without any, so a burst of writes to a File gives
+*** a single re-check.
+***
+***----------------------------------------------------------------*/
+#ifdef __linux__
+int run_watch (const char* watch_list)
+{
+   struct glh_session session;
+   CStandardsChecker checker;
+   std::vector<struct watched_file> files;
+   std::map<std::string, int> directory_watch;
+   std::map<int, std::string> watch_directory;
+   std::map<std::string, size_t> file_index;
+   int inotify_fd;
+
+   if (!read_watch_list(watch_list, &files) || files.empty())
+   {
+      printf("No Files to watch in %s\n", watch_list);
+      return 1;
+   }
+
+   inotify_fd = inotify_init1(IN_CLOEXEC);
+   if (inotify_fd < 0)
+   {
+      printf("Unable to start watching: %s\n", strerror(errno));
+      return 1;
+   }
+
+   for (size_t index = 0; index < files.size(); index++)
+   {
+      const std::string& name = files[index].source_name;
+      size_t slash = name.find_last_of('/');
+      std::string directory = (slash == std::string::npos) ? "." : name.substr(0, slash);
+      std::string base = (slash == std::string::npos) ? name : name.substr(slash + 1);
+
+      if (directory_watch.find(directory) == directory_watch.end())
+      {
+         int wd = inotify_add_watch(inotify_fd, directory.c_str(),
+                                    IN_CLOSE_WRITE | IN_MOVED_TO | IN_MODIFY);
+         if (wd < 0)
+         {
+            printf("Unable to watch %s: %s\n", directory.c_str(), strerror(errno));
+            continue;
+         }
+         directory_watch[directory] = wd;
+         watch_directory[wd] = directory;
+      }
+      file_index[directory + "/" + base] = index;
+
+      recheck_file(&session, &checker, &files[index], false);
+   }
+
+   printf("Watching %u Files in %u directories\n",
+          (unsigned) files.size(), (unsigned) directory_watch.size());
+   fflush(stdout);
+
+   for (;;)
+   {
+      std::vector<bool> changed(files.size(), false);
+      bool any_changed = false;
+      int timeout = -1;
+      struct pollfd poll_fd = { inotify_fd, POLLIN, 0 };
+
+      /* Wait for the first event, then until the burst is over */
+      while (poll(&poll_fd, 1, timeout) > 0)
+      {
+         alignas(struct inotify_event) char events[16384];
+         ssize_t length = read(inotify_fd, events, sizeof(events));
+
+         for (ssize_t offset = 0; offset < length; )
+         {
+            const struct inotify_event* event = (const struct inotify_event*) &events[offset];
+            offset += sizeof(struct inotify_event) + event->len;
+
+            if (event->mask & IN_Q_OVERFLOW)
+            {
+               /* Events were lost, check everything */
+               changed.assign(files.size(), true);
+               any_changed = true;
+            }
+            else if (event->len > 0)
+            {
+               std::map<std::string, size_t>::const_iterator found =
+                  file_index.find(watch_directory[event->wd] + "/" + event->name);
+               if (found != file_index.end())
+               {
+                  changed[found->second] = true;
+                  any_changed = true;
+               }
+            }
+         }
+         timeout = any_changed ? WATCH_SETTLE_MS : -1;
+      }
+
+      if (!any_changed && errno != EINTR)
+      {
+         printf("Watch failed: %s\n", strerror(errno));
+         break;
+      }
+
+      for (size_t index = 0; index < files.size(); index++)
+      {
+         if (changed[index])
+         {
+            recheck_file(&session, &checker, &files[index], true);
+         }
+      }
+   }
+
+   close(inotify_fd);
+   return 1;
+} /* End of run_watch */
+#else
+int run_watch (const char* watch_list)
+{
+   printf("Watch mode needs inotify and is only available on Linux\n");
+   return 1;
+}
+#endif
+
+/***----------------------------------------------------------------
+***
+*** End of Watch Mode
+***
+***----------------------------------------------------------------*/
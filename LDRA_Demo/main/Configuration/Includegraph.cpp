@@ -0,0 +1,477 @@
+/***-------------------------------------------------------------------------------------------------------------
+***
+*** File: Includegraph.cpp
+***
+*** The cached include graph of the set, see Includegraph.h.
+***
+***-------------------------------------------------------------------------------------------------------------*/
+#include <algorithm>
+#include <bitset>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <windows.h>
+#endif
+#include "Includegraph.h"
+
+
+/*
+ * Macros
+ */
+#define MAX_GRAPH_LINE 4096
+
+
+CIncludeGraph::CIncludeGraph ()
+   : m_modified(false), m_words(0)
+{
+}
+
+/***----------------------------------------------------------------
+***
+*** Routine: CIncludeGraph::load
+***
+*** Parameters:
+*** ===========
+***
+*** Action  Name                      Type                Use
+*** ------  ----                      ----                ---
+*** I       cache_file                const char *        Cache of an earlier run
+***
+*** Return value:
+*** bool            false if there is no cache, or it is not valid, the
+***                 graph is then empty
+***
+***----------------------------------------------------------------*/
+bool CIncludeGraph::load (const char* cache_file)
+{
+   FILE* fp = fopen(cache_file, "r");
+   char line[MAX_GRAPH_LINE];
+   bool valid = false;
+
+   m_nodes.clear();
+   m_index.clear();
+   m_component.clear();
+   m_modified = false;
+
+   if (fp == NULL)
+   {
+      return false;
+   }
+
+   if (fgets(line, sizeof(line), fp) != NULL
+       && strncmp(line, INCLUDEGRAPH_MAGIC "\t", strlen(INCLUDEGRAPH_MAGIC) + 1) == 0
+       && atoi(line + strlen(INCLUDEGRAPH_MAGIC) + 1) == INCLUDEGRAPH_VERSION)
+   {
+      std::vector<int> edges;   /* Checked once every node is known */
+
+      valid = true;
+      while (valid && fgets(line, sizeof(line), fp) != NULL)
+      {
+         char* field = line + 2;
+
+         line[strcspn(line, "\r\n")] = '\0';
+         if (line[0] == 'F' && line[1] == '\t')
+         {
+            const time_t mtime = (time_t) strtoll(field, &field, 10);
+            struct include_node node;
+
+            node.path = (*field == '\t') ? field + 1 : "";
+            node.mtime = mtime;
+            valid = !node.path.empty() && m_index.emplace(include_key(node.path), (int) m_nodes.size()).second;
+            m_nodes.push_back(node);
+         }
+         else if (line[0] == 'I' && line[1] == '\t' && !m_nodes.empty())
+         {
+            const int include = atoi(field);
+            m_nodes.back().includes.push_back(include);
+            edges.push_back(include);
+         }
+         else
+         {
+            valid = false;
+         }
+      }
+
+      for (int include : edges)
+      {
+         valid = valid && include >= 0 && include < (int) m_nodes.size();
+      }
+   }
+
+   fclose(fp);
+   if (!valid)
+   {
+      m_nodes.clear();
+      m_index.clear();
+   }
+   return valid;
+} /* End of CIncludeGraph::load */
+
+/***----------------------------------------------------------------
+***
+*** Routine: CIncludeGraph::save
+***
+*** Parameters:
+*** ===========
+***
+*** Action  Name                      Type                Use
+*** ------  ----                      ----                ---
+*** I       cache_file                const char *        Cache for the next run
+*** O       error                     std::string *       Reason for failure
+***
+*** Return value:
+*** bool            false if the cache cannot be written
+***
+*** Description:
+*** ============
+***
+*** Written to a temporary file which is renamed over the cache, so a
+*** run reading the cache at the same time sees the old or new graph.
+***
+***----------------------------------------------------------------*/
+bool CIncludeGraph::save (const char* cache_file, std::string* error) const
+{
+   const std::string temp_name = std::string(cache_file) + ".tmp";
+   FILE* fp = fopen(temp_name.c_str(), "w");
+   bool written;
+
+   if (fp == NULL)
+   {
+      *error = "Unable to write " + temp_name;
+      return false;
+   }
+
+   fprintf(fp, "%s\t%d\n", INCLUDEGRAPH_MAGIC, INCLUDEGRAPH_VERSION);
+   for (const struct include_node& node : m_nodes)
+   {
+      fprintf(fp, "F\t%lld\t%s\n", (long long) node.mtime, node.path.c_str());
+      for (int include : node.includes)
+      {
+         fprintf(fp, "I\t%d\n", include);
+      }
+   }
+   written = (ferror(fp) == 0);
+   written = (fclose(fp) == 0) && written;
+
+#ifdef _WIN32
+   if (!written || !MoveFileExA(temp_name.c_str(), cache_file, MOVEFILE_REPLACE_EXISTING))
+#else
+   if (!written || rename(temp_name.c_str(), cache_file) != 0)
+#endif
+   {
+      remove(temp_name.c_str());
+      *error = std::string("Unable to replace ") + cache_file;
+      return false;
+   }
+
+   return true;
+} /* End of CIncludeGraph::save */
+
+/***----------------------------------------------------------------
+***
+*** Routine: CIncludeGraph::add_file
+*** Node of the file, added if not already in the graph
+***
+***----------------------------------------------------------------*/
+int CIncludeGraph::add_file (std::string_view path)
+{
+   const std::pair<std::unordered_map<std::string, int>::iterator, bool> added =
+      m_index.emplace(include_key(path), (int) m_nodes.size());
+
+   if (added.second)
+   {
+      struct include_node node;
+      node.path = std::string(path);
+      node.mtime = 0;
+      m_nodes.push_back(node);
+      m_modified = true;
+   }
+   return added.first->second;
+} /* End of CIncludeGraph::add_file */
+
+/***----------------------------------------------------------------
+***
+*** Routine: CIncludeGraph::set_includes
+***
+*** Parameters:
+*** ===========
+***
+*** Action  Name                      Type                        Use
+*** ------  ----                      ----                        ---
+*** I       node                      int                         File
+*** I       mtime                     time_t                      Modification time of the file read
+*** I       includes                  const std::vector<int> &    Nodes it includes
+***
+***----------------------------------------------------------------*/
+void CIncludeGraph::set_includes (int node, time_t mtime, const std::vector<int>& includes)
+{
+   if (m_nodes[node].mtime != mtime || m_nodes[node].includes != includes)
+   {
+      m_nodes[node].mtime = mtime;
+      m_nodes[node].includes = includes;
+      m_modified = true;
+   }
+} /* End of CIncludeGraph::set_includes */
+
+/***----------------------------------------------------------------
+***
+*** Routine: CIncludeGraph::update
+***
+*** Parameters:
+*** ===========
+***
+*** Action  Name                      Type                        Use
+*** ------  ----                      ----                        ---
+*** I       node                      int                         File checked
+*** I       resolver                  const CIncludeResolver &    sysearch.dat search directories
+***
+*** Description:
+*** ============
+***
+*** Follows the includes from the node. A file whose modification time is
+*** not that cached is read again, its #include lines resolved the way the
+*** source's are. Files not changed are not opened.
+***
+***----------------------------------------------------------------*/
+void CIncludeGraph::update (int node, const CIncludeResolver& resolver)
+{
+   std::vector<bool> visited(m_nodes.size(), false);
+   std::vector<int> pending(1, node);
+
+   visited[node] = true;
+   while (!pending.empty())
+   {
+      const int current = pending.back();
+      struct stat status;
+      const time_t mtime = (stat(m_nodes[current].path.c_str(), &status) == 0) ? status.st_mtime : 0;
+
+      pending.pop_back();
+      if (mtime != m_nodes[current].mtime)
+      {
+         /* Copied, as add_file may move the nodes */
+         const std::string path = m_nodes[current].path;
+         FILE* fp = (mtime != 0) ? fopen(path.c_str(), "r") : NULL;
+         std::vector<int> includes;
+         char line[MAX_GRAPH_LINE];
+
+         while (fp != NULL && fgets(line, sizeof(line), fp) != NULL)
+         {
+            std::string_view name;
+            bool quoted = false;
+
+            if (parse_include(line, &name, &quoted))
+            {
+               const struct include_resolution resolution = resolver.resolve(name, path, quoted);
+               if (resolution.status == IncludeFound)
+               {
+                  includes.push_back(add_file(resolution.path));
+               }
+            }
+         }
+         if (fp != NULL)
+         {
+            fclose(fp);
+         }
+         set_includes(current, mtime, includes);
+         visited.resize(m_nodes.size(), false);
+      }
+
+      for (int include : m_nodes[current].includes)
+      {
+         if (!visited[include])
+         {
+            visited[include] = true;
+            pending.push_back(include);
+         }
+      }
+   }
+} /* End of CIncludeGraph::update */
+
+/***----------------------------------------------------------------
+***
+*** Routine: CIncludeGraph::analyse
+***
+*** Parameters:
+*** ===========
+***
+*** Action  Name                      Type                Use
+*** ------  ----                      ----                ---
+*** I       node                      int                 File to analyse from, -1 for all
+***
+*** Description:
+*** ============
+***
+*** Tarjan's algorithm, without recursion as include chains can be deep.
+*** A component is complete only once every component it reaches is, so
+*** its closure is the union of its members' includes and their closures,
+*** one pass over the edges in all.
+***
+***----------------------------------------------------------------*/
+void CIncludeGraph::analyse (int node)
+{
+   struct frame
+   {
+      int node;
+      size_t edge;
+   };
+   const int count = (int) m_nodes.size();
+   std::vector<int> order(count, -1);
+   std::vector<int> low(count, 0);
+   std::vector<bool> on_stack(count, false);
+   std::vector<int> stack;
+   std::vector<struct frame> calls;
+   int next_order = 0;
+
+   m_words = ((size_t) count + 63) / 64;
+   m_component.assign(count, -1);
+   m_componentSize.clear();
+   m_selfInclude.clear();
+   m_closures.clear();
+   m_fanIn.clear();
+
+   for (int start = (node < 0) ? 0 : node; start < ((node < 0) ? count : node + 1); start++)
+   {
+      if (order[start] >= 0)
+      {
+         continue;
+      }
+
+      order[start] = low[start] = next_order++;
+      stack.push_back(start);
+      on_stack[start] = true;
+      calls.push_back({start, 0});
+
+      while (!calls.empty())
+      {
+         const int current = calls.back().node;
+         const std::vector<int>& includes = m_nodes[current].includes;
+
+         if (calls.back().edge < includes.size())
+         {
+            const int include = includes[calls.back().edge++];
+
+            if (order[include] < 0)
+            {
+               order[include] = low[include] = next_order++;
+               stack.push_back(include);
+               on_stack[include] = true;
+               calls.push_back({include, 0});
+            }
+            else if (on_stack[include])
+            {
+               low[current] = std::min(low[current], order[include]);
+            }
+            continue;
+         }
+
+         calls.pop_back();
+         if (!calls.empty())
+         {
+            low[calls.back().node] = std::min(low[calls.back().node], low[current]);
+         }
+         if (low[current] != order[current])
+         {
+            continue;
+         }
+
+         /* current is the root of a component, its members are on the stack */
+         const int component = (int) m_componentSize.size();
+         const size_t first_member = std::find(stack.begin(), stack.end(), current) - stack.begin();
+         bool self_include = false;
+
+         m_closures.resize(m_closures.size() + m_words, 0);
+         uint64_t* bits = &m_closures[(size_t) component * m_words];
+
+         for (size_t member = first_member; member < stack.size(); member++)
+         {
+            m_component[stack[member]] = component;
+            on_stack[stack[member]] = false;
+         }
+         for (size_t member = first_member; member < stack.size(); member++)
+         {
+            for (int include : m_nodes[stack[member]].includes)
+            {
+               bits[include / 64] |= (uint64_t) 1 << (include % 64);
+               self_include = self_include || include == stack[member];
+               if (m_component[include] != component)
+               {
+                  const uint64_t* reached = closure(m_component[include]);
+                  for (size_t word = 0; word < m_words; word++)
+                  {
+                     bits[word] |= reached[word];
+                  }
+               }
+            }
+         }
+
+         m_componentSize.push_back((int) (stack.size() - first_member));
+         m_selfInclude.push_back(self_include);
+         stack.resize(first_member);
+      }
+   }
+
+   /* Files including each file, once the whole set is known */
+   if (node < 0)
+   {
+      m_fanIn.assign(count, 0);
+      for (int includer = 0; includer < count; includer++)
+      {
+         const uint64_t* reached = closure(m_component[includer]);
+         for (size_t word = 0; word < m_words; word++)
+         {
+            for (uint64_t bits = reached[word]; bits != 0; bits &= bits - 1)
+            {
+               const int included = (int) (word * 64) + (int) std::bitset<64>((bits & (~bits + 1)) - 1).count();
+               if (included != includer)
+               {
+                  m_fanIn[included]++;
+               }
+            }
+         }
+      }
+   }
+} /* End of CIncludeGraph::analyse */
+
+bool CIncludeGraph::in_cycle (int node) const
+{
+   const int component = m_component[node];
+   return component >= 0 && (m_componentSize[component] > 1 || m_selfInclude[component]);
+}
+
+std::vector<int> CIncludeGraph::component_members (int node) const
+{
+   std::vector<int> members;
+
+   for (int member = 0; member < (int) m_component.size(); member++)
+   {
+      if (m_component[member] == m_component[node])
+      {
+         members.push_back(member);
+      }
+   }
+   return members;
+}
+
+int CIncludeGraph::closure_size (int node) const
+{
+   const uint64_t* reached = closure(m_component[node]);
+   int size = 0;
+
+   for (size_t word = 0; word < m_words; word++)
+   {
+      size += (int) std::bitset<64>(reached[word]).count();
+   }
+   return size - (reaches(node, node) ? 1 : 0);
+}
+
+bool CIncludeGraph::reaches (int from, int to) const
+{
+   return (closure(m_component[from])[to / 64] >> (to % 64)) & 1;
+}
+
+int CIncludeGraph::fan_in (int node) const
+{
+   return m_fanIn.empty() ? 0 : m_fanIn[node];
+}
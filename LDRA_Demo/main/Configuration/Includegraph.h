@@ -0,0 +1,108 @@
+/***-------------------------------------------------------------------------------------------------------------
+***
+*** File: Includegraph.h
+***
+*** The include graph of the set: each source and header, and the files it
+*** includes, resolved through sysearch.dat (see Includeresolver.h).
+***
+*** The graph is kept between runs in a cache file. A run updates the node
+*** of the source it checks, from the includes the Z scanner found, then
+*** reads only the headers changed since they were cached:
+***
+***     CIncludeGraph graph;
+***     graph.load("Includegraph.dat");
+***     int node = graph.add_file(source_name);
+***     graph.set_includes(node, mtime, includes);
+***     graph.update(node, resolver);
+***     graph.analyse(node);
+***     graph.save("Includegraph.dat", &error);
+***
+*** analyse() finds the strongly connected components (include cycles) and
+*** the transitive closure of each file reachable from the node given, or of
+*** every file for -1 (see Stdincludes.cpp).
+***
+*** Cache file, one record per line, tab separated:
+***     LDRAINCGRAPH <version>
+***     F <mtime> <full file name>          a file, the nth F line is node n
+***     I <node>                            an include of the last F line
+***
+***-------------------------------------------------------------------------------------------------------------*/
+#ifndef INCLUDEGRAPH_H
+#define INCLUDEGRAPH_H
+
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Includeresolver.h"
+
+
+/*
+ * Macros
+ */
+#define INCLUDEGRAPH_MAGIC   "LDRAINCGRAPH"
+#define INCLUDEGRAPH_VERSION 1
+
+
+/*
+ * struct include_node
+ * A source or header of the graph.
+ */
+struct include_node
+{
+   std::string path;              /* Full file name */
+   time_t mtime;                  /* When its includes were read, 0 if never */
+   std::vector<int> includes;     /* Nodes it includes, in line order */
+};
+
+/*
+ * class CIncludeGraph
+ * Not thread safe, callers sharing a graph must hold a lock.
+ */
+class CIncludeGraph
+{
+public:
+   CIncludeGraph ();
+
+   bool load (const char* cache_file);
+   bool save (const char* cache_file, std::string* error) const;
+   bool is_modified () const { return m_modified; }
+
+   int add_file (std::string_view path);
+   int node_count () const { return (int) m_nodes.size(); }
+   const struct include_node& node (int index) const { return m_nodes[index]; }
+
+   /* Includes of a file, as found by the caller */
+   void set_includes (int node, time_t mtime, const std::vector<int>& includes);
+   /* Reads the includes of the files reachable from node changed since cached */
+   void update (int node, const CIncludeResolver& resolver);
+
+   /* Components and closures of the files reachable from node, -1 for all */
+   void analyse (int node);
+   int component (int node) const { return m_component[node]; }
+   bool in_cycle (int node) const;
+   std::vector<int> component_members (int node) const;
+   /* Files node includes directly or through others, not itself */
+   int closure_size (int node) const;
+   bool reaches (int from, int to) const;
+   /* Files including node directly or through others, after analyse(-1) */
+   int fan_in (int node) const;
+
+private:
+   const uint64_t* closure (int component) const { return &m_closures[(size_t) component * m_words]; }
+
+   std::vector<include_node> m_nodes;
+   std::unordered_map<std::string, int> m_index;   /* include_key of the path to node */
+   bool m_modified;
+
+   /* Set by analyse(), -1 for nodes not analysed */
+   std::vector<int> m_component;
+   std::vector<int> m_componentSize;
+   std::vector<bool> m_selfInclude;                /* By component, a member includes itself */
+   size_t m_words;                                 /* uint64_t words of a closure */
+   std::vector<uint64_t> m_closures;               /* By component, the nodes reachable */
+   std::vector<int> m_fanIn;
+};
+
+#endif /* INCLUDEGRAPH_H */
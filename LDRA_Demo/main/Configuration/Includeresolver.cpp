@@ -0,0 +1,578 @@
+/***-------------------------------------------------------------------------------------------------------------
+***
+*** File: Includeresolver.cpp
+***
+*** Resolves #include names through sysearch.dat, see Includeresolver.h.
+***
+***-------------------------------------------------------------------------------------------------------------*/
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <dirent.h>
+#include <sys/stat.h>
+#endif
+#include "Includeresolver.h"
+
+
+/*
+ * Macros
+ */
+#define MAX_SYSEARCH_LINE 1024
+#define SOURCE_INDEX_DEPTH 2    /* Sub-directories indexed below a source directory */
+
+
+/*
+ * Prototypes
+ */
+static void index_directory (const std::string& directory, const std::string& prefix, int depth,
+                             std::unordered_map<std::string, std::string>* index);
+
+static std::string expand_name (const char* name, const std::string& base_directory);
+
+static std::string collapse_path (const std::string& name);
+
+static std::string directory_name (std::string_view file_name);
+
+
+
+/***----------------------------------------------------------------
+***
+*** Routine: include_key
+***
+*** Parameters:
+*** ===========
+***
+*** Action  Name                      Type                Use
+*** ------  ----                      ----                ---
+*** I       name                      std::string_view    Include or relative file name
+***
+*** Return value:
+*** std::string     Name with '/' separators and without "./", lower case
+***                 on Windows where file names are not case sensitive
+***
+***----------------------------------------------------------------*/
+std::string include_key (std::string_view name)
+{
+   std::string key;
+
+   key.reserve(name.size());
+   for (size_t pos = 0; pos < name.size(); pos++)
+   {
+      const char c = (name[pos] == '\\') ? '/' : name[pos];
+
+      if (c == '/' && (key.empty() || key.back() == '/'))
+      {
+         continue;
+      }
+      if (c == '.' && (key.empty() || key.back() == '/')
+          && (pos + 1 == name.size() || name[pos + 1] == '/' || name[pos + 1] == '\\'))
+      {
+         pos++;
+         continue;
+      }
+#ifdef _WIN32
+      key.push_back((char) tolower((unsigned char) c));
+#else
+      key.push_back(c);
+#endif
+   }
+
+   return key;
+} /* End of include_key */
+
+/***----------------------------------------------------------------
+***
+*** Routine: parse_include
+***
+*** Parameters:
+*** ===========
+***
+*** Action  Name                      Type                Use
+*** ------  ----                      ----                ---
+*** I       line                      std::string_view    Source line
+*** O       name                      std::string_view *  Name between "" or <>
+*** O       quoted                    bool *              "name" rather than <name>
+***
+*** Return value:
+*** bool            false if the line is not such an include, e.g. an
+***                 include of a macro
+***
+***----------------------------------------------------------------*/
+bool parse_include (std::string_view line, std::string_view* name, bool* quoted)
+{
+   size_t pos = line.find_first_not_of(" \t");
+
+   /* # include is allowed */
+   if (pos == std::string_view::npos || line[pos] != '#')
+   {
+      return false;
+   }
+   pos = line.find_first_not_of(" \t", pos + 1);
+   if (pos == std::string_view::npos || line.compare(pos, 7, "include") != 0)
+   {
+      return false;
+   }
+
+   const size_t open = line.find_first_not_of(" \t", pos + 7);
+   if (open == std::string_view::npos || (line[open] != '"' && line[open] != '<'))
+   {
+      return false;
+   }
+   const size_t close = line.find((line[open] == '"') ? '"' : '>', open + 1);
+   if (close == std::string_view::npos)
+   {
+      return false;
+   }
+
+   *name = line.substr(open + 1, close - open - 1);
+   *quoted = (line[open] == '"');
+   return true;
+} /* End of parse_include */
+
+CIncludeResolver::CIncludeResolver ()
+   : m_loaded(false)
+{
+}
+
+/***----------------------------------------------------------------
+***
+*** Routine: CIncludeResolver::load
+***
+*** Parameters:
+*** ===========
+***
+*** Action  Name                      Type                Use
+*** ------  ----                      ----                ---
+*** I       sysearch_file             const char *        sysearch.dat
+*** O       error                     std::string *       Reason for failure, may be NULL
+***
+*** Return value:
+*** bool            false if the file cannot be read
+***
+*** Description:
+*** ============
+***
+*** Reads the records of sysearch.dat and indexes the files of each search
+*** directory. A search directory which does not exist is ignored, as it
+*** is by the analysis.
+***
+***----------------------------------------------------------------*/
+bool CIncludeResolver::load (const char* sysearch_file, std::string* error)
+{
+   FILE* fp = fopen(sysearch_file, "r");
+   const std::string base_directory = directory_name(sysearch_file);
+   char line[MAX_SYSEARCH_LINE];
+
+   m_loaded = false;
+   m_directories.clear();
+   m_files.clear();
+   m_ignored.clear();
+   {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_sourceDirectories.clear();
+   }
+
+   if (fp == NULL)
+   {
+      if (error != NULL)
+      {
+         *error = std::string("Unable to open ") + sysearch_file;
+      }
+      return false;
+   }
+
+   while (fgets(line, sizeof(line), fp) != NULL)
+   {
+      char* name = line;
+      const long type = strtol(line, &name, 10);
+
+      /* Name is the rest of the line */
+      while (*name == ' ' || *name == '\t')
+      {
+         name++;
+      }
+      name[strcspn(name, "\r\n")] = '\0';
+      if (name == line || *name == '\0')
+      {
+         continue;
+      }
+
+      switch (type)
+      {
+         case 1:
+         case 2:
+         case 3:
+            add_directory(expand_name(name, base_directory));
+            break;
+
+         case 200:
+         case 201:
+         case 202:
+            add_directory(directory_name(expand_name(name, base_directory)));
+            break;
+
+         case 300:
+         case 301:
+            m_ignored.insert(include_key(name));
+            break;
+
+         default:
+            break;
+      }
+   }
+
+   fclose(fp);
+   m_loaded = true;
+   return true;
+} /* End of CIncludeResolver::load */
+
+/***----------------------------------------------------------------
+***
+*** Routine: CIncludeResolver::add_directory
+*** Indexes the files of a search directory not already added
+***
+***----------------------------------------------------------------*/
+void CIncludeResolver::add_directory (const std::string& directory)
+{
+   for (const std::string& added : m_directories)
+   {
+      if (include_key(added) == include_key(directory))
+      {
+         return;
+      }
+   }
+
+   m_directories.push_back(directory);
+   index_directory(directory, std::string(), INCLUDE_INDEX_DEPTH, &m_files);
+} /* End of CIncludeResolver::add_directory */
+
+/***----------------------------------------------------------------
+***
+*** Routine: CIncludeResolver::resolve
+***
+*** Parameters:
+*** ===========
+***
+*** Action  Name                      Type                Use
+*** ------  ----                      ----                ---
+*** I       include_name              std::string_view    Name between "" or <>
+*** I       source_name               std::string_view    Including File
+*** I       quoted                    bool                "name" rather than <name>
+***
+*** Return value:
+*** struct include_resolution
+***
+*** Description:
+*** ============
+***
+*** Type 300 and 301 names are ignored whatever their directory. A "name"
+*** is then looked for in the directory of the source, then every name in
+*** the search directories in sysearch.dat order.
+***
+***----------------------------------------------------------------*/
+struct include_resolution CIncludeResolver::resolve (std::string_view include_name,
+                                                     std::string_view source_name,
+                                                     bool quoted) const
+{
+   const std::string key = include_key(include_name);
+   const size_t slash = key.rfind('/');
+   struct include_resolution resolution = { IncludeNotFound, std::string_view() };
+
+   if (m_ignored.count((slash == std::string::npos) ? key : key.substr(slash + 1)) != 0)
+   {
+      resolution.status = IncludeIgnored;
+      return resolution;
+   }
+
+   /* Names going up a directory, e.g. "../Inc/io.h", are from each directory in turn */
+   if (key.compare(0, 3, "../") == 0 || key.find("/../") != std::string::npos)
+   {
+      std::vector<std::string> directories;
+
+      if (quoted)
+      {
+         directories.push_back(directory_name(source_name));
+      }
+      directories.insert(directories.end(), m_directories.begin(), m_directories.end());
+
+      for (const std::string& directory : directories)
+      {
+         const std::string full_name = collapse_path(directory.empty() ? key : directory + "/" + key);
+         const size_t end = full_name.rfind('/');
+
+         if (end != std::string::npos
+             && find_in_directory(full_name.substr(0, end), full_name.substr(end + 1), &resolution.path))
+         {
+            resolution.status = IncludeFound;
+            break;
+         }
+      }
+      return resolution;
+   }
+
+   if (quoted && find_in_directory(directory_name(source_name), key, &resolution.path))
+   {
+      resolution.status = IncludeFound;
+      return resolution;
+   }
+
+   file_index::const_iterator found = m_files.find(key);
+   if (found != m_files.end())
+   {
+      resolution.status = IncludeFound;
+      resolution.path = found->second;
+   }
+
+   return resolution;
+} /* End of CIncludeResolver::resolve */
+
+/***----------------------------------------------------------------
+***
+*** Routine: CIncludeResolver::find_in_directory
+***
+*** Parameters:
+*** ===========
+***
+*** Action  Name                      Type                Use
+*** ------  ----                      ----                ---
+*** I       directory                 const std::string & Directory, not a search directory
+*** I       key                       const std::string & include_key of the name
+*** O       path                      std::string_view *  Full name when found
+***
+*** Return value:
+*** bool            true if found
+***
+*** Description:
+*** ============
+***
+*** The directory is indexed the first time it is used and then kept, so
+*** the files of a source directory are listed once however many sources
+*** and includes use it.
+***
+***----------------------------------------------------------------*/
+bool CIncludeResolver::find_in_directory (const std::string& directory, const std::string& key,
+                                          std::string_view* path) const
+{
+   std::lock_guard<std::mutex> lock(m_mutex);
+   std::unique_ptr<file_index>& index = m_sourceDirectories[include_key(directory)];
+
+   if (!index)
+   {
+      index.reset(new file_index());
+      index_directory(directory, std::string(), SOURCE_INDEX_DEPTH, index.get());
+   }
+
+   file_index::const_iterator found = index->find(key);
+   if (found == index->end())
+   {
+      return false;
+   }
+   *path = found->second;
+   return true;
+} /* End of CIncludeResolver::find_in_directory */
+
+/***----------------------------------------------------------------
+***
+*** Routine: index_directory
+***
+*** Parameters:
+*** ===========
+***
+*** Action  Name                      Type                Use
+*** ------  ----                      ----                ---
+*** I       directory                 const std::string & Directory to list
+*** I       prefix                    const std::string & Its name relative to the search directory
+*** I       depth                     int                 Sub-directory levels still to index
+*** IO      index                     file_index *        Relative name to full name
+***
+***----------------------------------------------------------------*/
+static void index_directory (const std::string& directory, const std::string& prefix, int depth,
+                             std::unordered_map<std::string, std::string>* index)
+{
+   const std::string path = directory.empty() ? std::string(".") : directory;
+   std::vector<std::string> subdirectories;
+
+#ifdef _WIN32
+   WIN32_FIND_DATAA entry;
+   HANDLE find = FindFirstFileA((path + "/*").c_str(), &entry);
+
+   if (find == INVALID_HANDLE_VALUE)
+   {
+      return;
+   }
+   do
+   {
+      const std::string name = entry.cFileName;
+      const bool is_directory = (entry.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
+#else
+   DIR* dir = opendir(path.c_str());
+   struct dirent* entry;
+
+   if (dir == NULL)
+   {
+      return;
+   }
+   while ((entry = readdir(dir)) != NULL)
+   {
+      const std::string name = entry->d_name;
+      bool is_directory = false;
+      struct stat status;
+
+      if (entry->d_type == DT_DIR)
+      {
+         is_directory = true;
+      }
+      else if (entry->d_type == DT_UNKNOWN || entry->d_type == DT_LNK)
+      {
+         is_directory = (stat((path + "/" + name).c_str(), &status) == 0 && S_ISDIR(status.st_mode));
+      }
+#endif
+
+      if (name[0] == '.')
+      {
+         /* ., .. and hidden directories such as .git */
+      }
+      else if (is_directory)
+      {
+         subdirectories.push_back(name);
+      }
+      else
+      {
+         /* emplace keeps the first file of a name */
+         index->emplace(include_key(prefix + name), path + "/" + name);
+      }
+#ifdef _WIN32
+   } while (FindNextFileA(find, &entry));
+   FindClose(find);
+#else
+   }
+   closedir(dir);
+#endif
+
+   /* Files of a directory before those of its sub-directories */
+   if (depth > 0)
+   {
+      for (const std::string& name : subdirectories)
+      {
+         index_directory(path + "/" + name, prefix + name + "/", depth - 1, index);
+      }
+   }
+} /* End of index_directory */
+
+/***----------------------------------------------------------------
+***
+*** Routine: expand_name
+***
+*** Parameters:
+*** ===========
+***
+*** Action  Name                      Type                Use
+*** ------  ----                      ----                ---
+*** I       name                      const char *        Name from sysearch.dat
+*** I       base_directory            const std::string & Directory of sysearch.dat
+***
+*** Return value:
+*** std::string     Name with $(ENVDIR) expanded, '/' separators, and
+***                 from base_directory if relative
+***
+***----------------------------------------------------------------*/
+static std::string expand_name (const char* name, const std::string& base_directory)
+{
+   std::string expanded;
+
+   for (const char* c = name; *c != '\0'; c++)
+   {
+      const char* end;
+
+      if (c[0] == '$' && c[1] == '(' && (end = strchr(c + 2, ')')) != NULL)
+      {
+         const char* value = getenv(std::string(c + 2, end - c - 2).c_str());
+         if (value != NULL)
+         {
+            expanded.append(value);
+         }
+         c = end;
+      }
+      else
+      {
+         expanded.push_back(*c);
+      }
+   }
+
+   for (char& c : expanded)
+   {
+      c = (c == '\\') ? '/' : c;
+   }
+   while (expanded.size() > 1 && expanded.back() == '/')
+   {
+      expanded.pop_back();
+   }
+
+   const bool absolute = (!expanded.empty() && expanded[0] == '/')
+                         || (expanded.size() > 1 && expanded[1] == ':');
+   if (!absolute && !base_directory.empty())
+   {
+      expanded = base_directory + "/" + expanded;
+   }
+
+   return expanded;
+} /* End of expand_name */
+
+/***----------------------------------------------------------------
+***
+*** Routine: collapse_path
+*** Removes each "<dir>/.." of a name with '/' separators
+***
+***----------------------------------------------------------------*/
+static std::string collapse_path (const std::string& name)
+{
+   std::vector<std::string> parts;
+   size_t start = 0;
+
+   while (start <= name.size())
+   {
+      size_t end = name.find('/', start);
+      end = (end == std::string::npos) ? name.size() : end;
+
+      const std::string part = name.substr(start, end - start);
+      if (part == ".." && !parts.empty() && parts.back() != ".." && !parts.back().empty())
+      {
+         parts.pop_back();
+      }
+      else if (part != "." && (!part.empty() || parts.empty()))
+      {
+         parts.push_back(part);
+      }
+      start = end + 1;
+   }
+
+   std::string collapsed;
+   for (size_t part = 0; part < parts.size(); part++)
+   {
+      collapsed.append((part == 0) ? "" : "/").append(parts[part]);
+   }
+   return collapsed;
+} /* End of collapse_path */
+
+/***----------------------------------------------------------------
+***
+*** Routine: directory_name
+*** Directory of a file, with '/' separators, empty for the current one
+***
+***----------------------------------------------------------------*/
+static std::string directory_name (std::string_view file_name)
+{
+   const size_t slash = file_name.find_last_of("/\\");
+   std::string directory((slash == std::string_view::npos) ? std::string_view()
+                                                            : file_name.substr(0, (slash == 0) ? 1 : slash));
+
+   for (char& c : directory)
+   {
+      c = (c == '\\') ? '/' : c;
+   }
+   return directory;
+} /* End of directory_name */
@@ -0,0 +1,113 @@
+/***-------------------------------------------------------------------------------------------------------------
+***
+*** File: Includeresolver.h
+***
+*** Resolves #include names through the search directories of sysearch.dat.
+***
+*** The search directories are read once and every file under them is
+*** indexed in memory, so resolving an include is a single lookup, without
+*** probing the file system:
+***
+***     CIncludeResolver includes;
+***     if (includes.load("C:\\Work\\sysearch.dat"))
+***     {
+***        struct include_resolution found = includes.resolve("Std_Types.h", source_name);
+***     }
+***
+*** sysearch.dat records used, <type> <name> on each line:
+***   1, 2, 3  search directory, searched in the order of the file
+***   200, 201, 202  include file, its directory is also searched
+***   300, 301  include file name which is not searched for
+***   0 and others are comments or macros and are not used
+*** Names may hold $(ENVDIR) environment variables, relative names are from
+*** the directory of sysearch.dat.
+***
+*** A "name" include is looked for in the directory of the source first. Each
+*** source directory is indexed when first used and then kept.
+***
+*** Files added to the search directories after load() are not seen until
+*** the next load().
+***
+***-------------------------------------------------------------------------------------------------------------*/
+#ifndef INCLUDERESOLVER_H
+#define INCLUDERESOLVER_H
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+
+/*
+ * Macros
+ */
+#define INCLUDE_INDEX_DEPTH 8   /* Sub-directories indexed below a search directory */
+
+
+/*
+ * Enumeration
+ */
+typedef enum { IncludeFound, IncludeIgnored, IncludeNotFound } Include_e;
+
+/*
+ * struct include_resolution
+ * Where an include resolves to. The path is held by the resolver.
+ */
+struct include_resolution
+{
+   Include_e status;
+   std::string_view path;     /* Full file name when found, empty otherwise */
+};
+
+/*
+ * class CIncludeResolver
+ * The search directories of one sysearch.dat. Once loaded, resolve() may be
+ * called from any number of threads.
+ */
+class CIncludeResolver
+{
+public:
+   CIncludeResolver ();
+
+   bool load (const char* sysearch_file, std::string* error = NULL);
+   bool is_loaded () const { return m_loaded; }
+
+   /* include_name is the text between "" or <>, source_name the including File */
+   struct include_resolution resolve (std::string_view include_name, std::string_view source_name,
+                                      bool quoted = true) const;
+
+   size_t file_count () const { return m_files.size(); }
+   const std::vector<std::string>& directories () const { return m_directories; }
+
+private:
+   /* Relative name to full name, first found wins */
+   typedef std::unordered_map<std::string, std::string> file_index;
+
+   void add_directory (const std::string& directory);
+   bool find_in_directory (const std::string& directory, const std::string& key,
+                           std::string_view* path) const;
+
+   bool m_loaded;
+   std::vector<std::string> m_directories;           /* Search directories, in order */
+   file_index m_files;                                /* Every file of the search directories */
+   std::unordered_set<std::string> m_ignored;         /* Type 300 and 301 names */
+
+   /* Source and other directories, indexed when first used */
+   mutable std::mutex m_mutex;
+   mutable std::unordered_map<std::string, std::unique_ptr<file_index> > m_sourceDirectories;
+
+   CIncludeResolver (const CIncludeResolver&);
+   CIncludeResolver& operator= (const CIncludeResolver&);
+};
+
+
+/* Include name as used for the index: '/' separators, lower case on Windows */
+std::string include_key (std::string_view name);
+
+/* Name of a #include "name" or <name> line, false for other lines */
+bool parse_include (std::string_view line, std::string_view* name, bool* quoted);
+
+#endif /* INCLUDERESOLVER_H */
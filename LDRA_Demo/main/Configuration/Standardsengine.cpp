@@ -0,0 +1,2610 @@
+/***-------------------------------------------------------------------------------------------------------------
+***
+*** File: Standardsengine.cpp
+***
+*** The H and Z standards used by Userstandards_combined.exe, see Standardsengine.h
+*** for the interface and Combinedstandards.cpp for how the results are written
+*** to the SIF file.
+***
+*** This file has no dependency on the TBglhapi, so it can be built into
+*** libstandardsengine.a and used in-process by other tools.
+***
+***
+*** Editing this File
+*** -----------------
+*** New H Standards work from the symbol table (struct symbol_table), anything
+*** needed from the GLH API must first be added to load_symbol_table in
+*** Combinedstandards.cpp.
+***
+*** New Z Standards either work on the source as a whole or on each line of it,
+*** add the call to CStandardsChecker::check below.
+***
+*** Any standard added must also be added to the <lang>pen.dat and <lang>report.dat
+*** files, see Combinedstandards.cpp.
+***
+***-------------------------------------------------------------------------------------------------------------*/
+#include <algorithm>
+#include <cctype>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include "Standardsengine.h"
+
+
+/*
+ * Macros
+ */
+#define TEMPLATE_MAX 11 /* Lines in the layout template, 4 Z */
+#define PARALLEL_SCAN_SIZE (8u * 1024u * 1024u) /* Sources this size or more are scanned in chunks */
+
+
+/*
+ * Structures
+ *
+ *
+ * struct check_state
+ * State of a single CStandardsChecker::check call, passed to every rule.
+ */
+struct check_state
+{
+   const struct check_request* request;
+   struct check_result* result;
+   CSymbolArena* arena;
+   int current_template;      /* Position in the layout template, 4 Z */
+   bool in_scope;             /* Current source line is one to report */
+   const std::vector<violation_info>* templates; /* 4 Z found by the prefix pass, NULL if not run */
+   size_t next_template;      /* Next of templates to report */
+};
+
+
+/*
+ * H Standard - User Editable Prototypes
+ */
+/* Check Globals 1 H */
+void check_globals (struct check_state * state);
+
+/* Check Class Members 2 H */
+void check_class_members (struct check_state * state);
+
+/* Check Enums 3 H, 7 H */
+void check_enums (struct check_state * state);
+
+/* Check Classes 4 H */
+void check_classes (struct check_state * state);
+
+/* Check Namespaces 5 H */
+void check_namespaces (struct check_state * state);
+
+/* Check Pointer Parameters 6 H */
+void check_pointers (struct check_state * state);
+
+/* Check Global Functions 8 H */
+void check_global_functions (struct check_state * state);
+
+/* Check Global Vars 9 H */
+void check_global_vars (struct check_state * state);
+
+/* Check Null Terminated String 10 H */
+void check_null_terminated_strings (struct check_state * state);
+
+
+/*
+ * Z Standard - User Editable Prototypes
+ */
+/* 1 Z: File exceeds required size. */
+void check_file_size (struct check_state * state);
+
+/* 2 Z: Checks filename size is <= 8 characters */
+void check_filename_size (struct check_state * state);
+
+/* 3 Z: Checks include filename is the same as the source filename */
+void check_includename (struct check_state * state, std::string_view line, int linenum);
+
+/* 4 Z: Checks that layout templates are met */
+void check_templates (struct check_state * state, std::string_view line, int linenum);
+
+/* 5 Z: Checks that there is no use of hexadecimal radix */
+void check_radix (struct check_state * state, std::string_view line, int linenum);
+
+/* 6 Z: Checks that there is no use of forbidden words */
+void check_forbidden_words (struct check_state * state, std::string_view line, int linenum);
+
+/* 7 Z - 10 Z: Checks procedure metrics against the Metpen.dat limits */
+void check_procedure_metrics (struct check_state * state);
+
+/* 11 Z: Checks that each include is found in the sysearch.dat directories */
+void check_include_found (struct check_state * state, std::string_view line, int linenum);
+
+/* 16 Z: Checks that no banned function or macro is used */
+void check_banned_identifiers (struct check_state * state);
+
+
+/*
+ * Engine Prototypes
+ */
+void add_violation (struct check_state * state,
+                    const int std_num,
+                    std::string_view message,
+                    const int linenumber,
+                    const char std_letter);
+
+void process_naming_conformance (struct check_state * state,
+                                  const char* type,
+                                  const char* style,
+                                  std::string_view name,
+                                  const int conforms,
+                                  const int linenumber,
+                                  const int std_num);
+
+std::string_view file_base_name (std::string_view file_name);
+
+std::string_view next_token (std::string_view * rest, std::string_view delimiters);
+
+bool in_line_ranges (const std::vector<line_range>* ranges, int line);
+
+void scan_lines (struct check_state * state, std::string_view source, int linenum);
+
+void collect_suppressions (struct check_state * state, std::string_view line, int linenum);
+
+void join_suppressions (struct check_state * state);
+
+void follow_template (struct check_state * state, std::string_view line, int linenum);
+
+
+
+/***----------------------------------------------------------------
+***
+*** Routine: CStandardsChecker::check
+***
+*** Parameters:
+*** ===========
+***
+*** Action  Name                      Type                      Use
+*** ------  ----                      ----                      ---
+*** I       request                   const struct check_request &
+***
+*** Return value:
+*** const struct check_result &      Valid until the next call
+***
+*** Description:
+*** ============
+***
+*** Runs each of the enabled H Standards over the symbol table, then the
+*** Z Standards over the source, line by line. Violations are returned
+*** in the order the old executable wrote them to the SIF file.
+***
+*** When the request gives source_lines, the line by line Z Standards
+*** only run on those lines, except the layout template (4 Z) which must
+*** see each line from the top of the file until the template is complete.
+*** Scanning stops after the last range.
+***
+***----------------------------------------------------------------*/
+CStandardsChecker::CStandardsChecker ()
+{
+}
+
+CStandardsChecker::~CStandardsChecker ()
+{
+}
+
+const struct check_result& CStandardsChecker::check (const struct check_request& request)
+{
+   struct check_state state = {&request, &m_result, &m_arena, -1, true, NULL, 0};
+   const unsigned int h_rules = request.h_rules;
+   const unsigned int z_rules = request.z_rules;
+
+   m_result.violations.clear();
+   m_result.report.clear();
+   m_result.includes.clear();
+   m_result.suppressions.clear();
+   m_arena.reset();
+
+   /* Start H Standards Checking *******************************************/
+   if (request.symbols != NULL)
+   {
+      /* Check Globals 1 H */
+      if (h_rules & RULE_BIT(1)) check_globals(&state);
+
+      /* Check Class Members 2 H */
+      if (h_rules & RULE_BIT(2)) check_class_members(&state);
+
+      /* Check Enums 3 H, 7 H */
+      if (h_rules & (RULE_BIT(3) | RULE_BIT(7))) check_enums(&state);
+
+      /* Check Classes 4 H */
+      if (h_rules & RULE_BIT(4)) check_classes(&state);
+
+      /* Check Namespaces 5 H */
+      if (h_rules & RULE_BIT(5)) check_namespaces(&state);
+
+      /* Check Pointer Parameters 6 H */
+      if (h_rules & RULE_BIT(6)) check_pointers(&state);
+
+      /* Check Global Function Names 8 H */
+      if (h_rules & RULE_BIT(8)) check_global_functions(&state);
+
+      /* Check Global Var Names 9 H */
+      if (h_rules & RULE_BIT(9)) check_global_vars(&state);
+
+      /* Check Null Terminated Strings 10 H */
+      if (h_rules & RULE_BIT(10)) check_null_terminated_strings(&state);
+   }
+   /* End H Standards Checking *********************************************/
+
+
+   /* Start Z Standards Checking *******************************************/
+   /* Check File Size 1 Z */
+   if (z_rules & RULE_BIT(1)) check_file_size(&state);
+
+   /* 2 Z: Checks filename size is <= 8 characters */
+   if (z_rules & RULE_BIT(2)) check_filename_size(&state);
+
+   /* 7 Z - 10 Z: Checks procedure metrics, a single pass over the whole source */
+   if (request.metrics != NULL
+       &&
+       (z_rules & (RULE_BIT(7) | RULE_BIT(8) | RULE_BIT(9) | RULE_BIT(10))))
+   {
+      check_procedure_metrics(&state);
+   }
+
+   /* 16 Z: Checks that no banned function or macro is used, a single pass over the whole source */
+   if (request.banned != NULL && (z_rules & RULE_BIT(16))) check_banned_identifiers(&state);
+
+   /* The following checks are performed on the source, line by line */
+   const unsigned int threads = (request.scan_threads != 0) ? request.scan_threads
+                                                            : std::thread::hardware_concurrency();
+   if (request.source_lines == NULL && request.source.size() >= PARALLEL_SCAN_SIZE && threads > 1)
+   {
+      scan_parallel(&state, threads);
+   }
+   else
+   {
+      scan_lines(&state, request.source, 1);
+   }
+   join_suppressions(&state);
+   /* End Z Standards Checking *********************************************/
+
+   return m_result;
+} /* End of CStandardsChecker::check */
+
+
+
+
+
+/***----------------------------------------------------------------
+***
+*** Routine: scan_lines
+***
+*** Parameters:
+*** ===========
+***
+*** Action  Name                      Type                      Use
+*** ------  ----                      ----                      ---
+*** IO      state                     struct check_state *      Check State
+*** I       source                    std::string_view          Source, or a chunk of it
+*** I       linenum                   int                       Line number of its first line
+***
+*** Description:
+*** ============
+***
+*** Runs the line by line Z Standards over the source.
+***
+***----------------------------------------------------------------*/
+void scan_lines (struct check_state * state, std::string_view source, int linenum)
+{
+   const unsigned int z_rules = state->request->z_rules;
+   const std::vector<line_range>* ranges = state->request->source_lines;
+   size_t next_range = 0;
+   size_t pos = 0;
+
+   while (pos < source.size())
+   {
+      if (ranges != NULL)
+      {
+         while (next_range < ranges->size() && (*ranges)[next_range].last < linenum)
+         {
+            next_range++;
+         }
+         if (next_range == ranges->size())
+         {
+            break; /* Past the last changed line */
+         }
+         state->in_scope = ((*ranges)[next_range].first <= linenum);
+      }
+
+      size_t eol = source.find('\n', pos);
+      if (eol == std::string_view::npos)
+      {
+         eol = source.size();
+      }
+
+      /* remove newline (and carriage return) from end of string */
+      std::string_view line = source.substr(pos, eol - pos);
+      if (!line.empty() && line.back() == '\r')
+      {
+         line.remove_suffix(1);
+      }
+
+      /* Suppressions apply from the lines before the changed lines */
+      collect_suppressions(state, line, linenum);
+
+      /* Outside the changed lines only the layout template is followed */
+      if (!state->in_scope)
+      {
+         if ((z_rules & RULE_BIT(4)) && state->current_template+1 < TEMPLATE_MAX)
+         {
+            check_templates(state, line, linenum);
+         }
+         linenum++;
+         pos = eol + 1;
+         continue;
+      }
+
+      /* 3 Z: Checks include filename is the same as the source filename */
+      if (z_rules & RULE_BIT(3)) check_includename(state, line, linenum);
+
+      /* 11 Z: Checks that each include is found in the sysearch.dat directories */
+      if (state->request->includes != NULL) check_include_found(state, line, linenum);
+
+      /* 4 Z: Checks that layout templates are met */
+      if (z_rules & RULE_BIT(4)) follow_template(state, line, linenum);
+
+      /* 5 Z: Checks that there is no use of hexadecimal radix */
+      if (z_rules & RULE_BIT(5)) check_radix(state, line, linenum);
+
+      /* 6 Z: Checks that there is no use of forbidden words */
+      if (z_rules & RULE_BIT(6)) check_forbidden_words(state, line, linenum);
+
+      linenum++;
+      pos = eol + 1;
+   }
+} /* End of scan_lines */
+
+/***----------------------------------------------------------------
+***
+*** Routine: follow_template
+*** 4 Z for a line, either checked here or, when the source is scanned
+*** in chunks, as found for the line by the prefix pass
+***
+***----------------------------------------------------------------*/
+void follow_template (struct check_state * state, std::string_view line, int linenum)
+{
+   const std::vector<violation_info>* templates = state->templates;
+
+   if (templates == NULL)
+   {
+      check_templates(state, line, linenum);
+      return;
+   }
+
+   while (state->next_template < templates->size()
+          &&
+          (*templates)[state->next_template].line < linenum)
+   {
+      state->next_template++;
+   }
+   while (state->next_template < templates->size()
+          &&
+          (*templates)[state->next_template].line == linenum)
+   {
+      state->result->violations.push_back((*templates)[state->next_template++]);
+   }
+} /* End of follow_template */
+
+/***----------------------------------------------------------------
+***
+*** Routine: collect_suppressions
+***
+*** Parameters:
+*** ===========
+***
+*** Action  Name                      Type                      Use
+*** ------  ----                      ----                      ---
+*** IO      state                     struct check_state *      Check State
+*** I       line                      std::string_view          line of source text
+*** I       linenum                   int                       line number of text
+***
+*** Description:
+*** ============
+***
+*** Adds the suppressions of the line to the result, their reasons held
+*** in the arena. A suppression comment which cannot be read is reported.
+***
+***----------------------------------------------------------------*/
+void collect_suppressions (struct check_state * state, std::string_view line, int linenum)
+{
+   std::vector<suppression>& suppressions = state->result->suppressions;
+   const size_t first = suppressions.size();
+   std::string_view bad;
+
+   if (!parse_suppressions(line, linenum, &suppressions, &bad))
+   {
+      if (state->request->report)
+      {
+         struct report_entry entry;
+         entry.line = linenum;
+         entry.text = state->arena->format("Suppression not read, the standards or the reason are missing : %.*s",
+                                           (int) bad.size(), bad.data());
+         state->result->report.push_back(entry);
+      }
+      return;
+   }
+
+   for (size_t index = first; index < suppressions.size(); index++)
+   {
+      if (!suppressions[index].reason.empty())
+      {
+         suppressions[index].reason = state->arena->intern(suppressions[index].reason);
+      }
+   }
+} /* End of collect_suppressions */
+
+/***----------------------------------------------------------------
+***
+*** Routine: join_suppressions
+***
+*** Parameters:
+*** ===========
+***
+*** Action  Name                      Type                      Use
+*** ------  ----                      ----                      ---
+*** IO      state                     struct check_state *      Check State
+***
+*** Description:
+*** ============
+***
+*** Once every line is scanned (by one thread or several), each END is
+*** joined to the last open BEGIN of the same standard, which then ends
+*** on the line of the END, and removed. A BEGIN left open runs to the end
+*** of the File, an END without a BEGIN is reported.
+***
+***----------------------------------------------------------------*/
+void join_suppressions (struct check_state * state)
+{
+   std::vector<suppression>& suppressions = state->result->suppressions;
+   std::vector<size_t> open;
+   size_t kept = 0;
+
+   for (size_t index = 0; index < suppressions.size(); index++)
+   {
+      const struct suppression mark = suppressions[index];
+
+      if (mark.kind != SuppressEnd)
+      {
+         if (mark.kind == SuppressBegin)
+         {
+            open.push_back(kept);
+         }
+         suppressions[kept++] = mark;
+         continue;
+      }
+
+      std::vector<size_t>::reverse_iterator begin =
+         std::find_if(open.rbegin(), open.rend(), [&suppressions, &mark](size_t at)
+                      { return suppressions[at].std_letter == mark.std_letter
+                               && suppressions[at].std_num == mark.std_num; });
+      if (begin != open.rend())
+      {
+         suppressions[*begin].last = mark.first;
+         open.erase(std::next(begin).base());
+      }
+      else if (state->request->report)
+      {
+         struct report_entry entry;
+         entry.line = mark.first;
+         entry.text = state->arena->format("Suppression end of %d %c without a begin",
+                                           mark.std_num, mark.std_letter);
+         state->result->report.push_back(entry);
+      }
+   }
+   suppressions.resize(kept);
+} /* End of join_suppressions */
+
+/***----------------------------------------------------------------
+***
+*** Routine: CStandardsChecker::scan_parallel
+***
+*** Parameters:
+*** ===========
+***
+*** Action  Name                      Type                      Use
+*** ------  ----                      ----                      ---
+*** IO      state                     struct check_state *      Check State
+*** I       threads                   unsigned int              Number of chunks
+***
+*** Description:
+*** ============
+***
+*** Scans a large source in chunks, one thread each, with the same
+*** results as scan_lines would give:
+***
+***  - Chunks are split at line ends, and the lines of each chunk are
+***    counted (in parallel) to give the line number it starts at.
+***  - 4 Z is the only rule with state carried from line to line, and only
+***    until the template is complete. A sequential prefix pass follows the
+***    template from the top of the file, the chunks then report what it
+***    found for their lines in place of checking 4 Z themselves.
+***  - Each chunk has its own results and arena, the results are joined
+***    in chunk order.
+***
+*** None of the other rules need lexer state (comments or strings), as
+*** they match the raw text of a line.
+***
+***----------------------------------------------------------------*/
+void CStandardsChecker::scan_parallel (struct check_state * state, unsigned int threads)
+{
+   const std::string_view source = state->request->source;
+   std::vector<std::string_view> chunks;
+   std::vector<int> first_lines(threads, 1);
+   std::vector<std::thread> workers;
+   struct check_result templates;
+
+   /* Split at the first line end after each 1/threads of the source */
+   for (size_t start = 0; start < source.size(); )
+   {
+      size_t end = std::min(source.size(), start + source.size() / threads + 1);
+      end = source.find('\n', end - 1);
+      end = (end == std::string_view::npos) ? source.size() : end + 1;
+      chunks.push_back(source.substr(start, end - start));
+      start = end;
+   }
+
+   while (m_chunkArenas.size() < chunks.size())
+   {
+      m_chunkArenas.emplace_back(new CSymbolArena());
+   }
+   m_chunkResults.resize(chunks.size());
+   first_lines.resize(chunks.size());
+
+   /* Prefix pass, lines in each chunk */
+   for (size_t chunk = 1; chunk < chunks.size(); chunk++)
+   {
+      workers.emplace_back([&chunks, &first_lines, chunk] {
+         const std::string_view text = chunks[chunk - 1];
+         first_lines[chunk] = (int) std::count(text.begin(), text.end(), '\n');
+      });
+   }
+
+   /* Prefix pass, the layout template, while the lines are counted */
+   if (state->request->z_rules & RULE_BIT(4))
+   {
+      struct check_state prefix = *state;
+      size_t pos = 0;
+      int linenum = 1;
+
+      prefix.result = &templates;
+      while (pos < source.size() && prefix.current_template+1 < TEMPLATE_MAX)
+      {
+         size_t eol = std::min(source.find('\n', pos), source.size());
+         std::string_view line = source.substr(pos, eol - pos);
+         if (!line.empty() && line.back() == '\r')
+         {
+            line.remove_suffix(1);
+         }
+         check_templates(&prefix, line, linenum);
+         linenum++;
+         pos = eol + 1;
+      }
+   }
+
+   for (std::thread& worker : workers)
+   {
+      worker.join();
+   }
+   workers.clear();
+   for (size_t chunk = 1; chunk < chunks.size(); chunk++)
+   {
+      first_lines[chunk] += first_lines[chunk - 1];
+   }
+
+   /* Scan the chunks */
+   for (size_t chunk = 0; chunk < chunks.size(); chunk++)
+   {
+      workers.emplace_back([this, state, &chunks, &first_lines, &templates, chunk] {
+         struct check_state chunk_state = *state;
+         struct check_result& result = m_chunkResults[chunk];
+
+         result.violations.clear();
+         result.report.clear();
+         result.includes.clear();
+         result.suppressions.clear();
+         m_chunkArenas[chunk]->reset();
+         chunk_state.result = &result;
+         chunk_state.arena = m_chunkArenas[chunk].get();
+         chunk_state.templates = &templates.violations;
+         chunk_state.next_template = 0;
+         scan_lines(&chunk_state, chunks[chunk], first_lines[chunk]);
+      });
+   }
+   for (std::thread& worker : workers)
+   {
+      worker.join();
+   }
+
+   for (size_t chunk = 0; chunk < chunks.size(); chunk++)
+   {
+      const std::vector<violation_info>& found = m_chunkResults[chunk].violations;
+      const std::vector<report_entry>& report = m_chunkResults[chunk].report;
+      const std::vector<include_entry>& includes = m_chunkResults[chunk].includes;
+      const std::vector<suppression>& suppressions = m_chunkResults[chunk].suppressions;
+      state->result->violations.insert(state->result->violations.end(), found.begin(), found.end());
+      state->result->report.insert(state->result->report.end(), report.begin(), report.end());
+      state->result->includes.insert(state->result->includes.end(), includes.begin(), includes.end());
+      state->result->suppressions.insert(state->result->suppressions.end(), suppressions.begin(), suppressions.end());
+   }
+} /* End of CStandardsChecker::scan_parallel */
+
+
+
+
+
+/***----------------------------------------------------------------
+***
+*** Start of Standards
+***
+***----------------------------------------------------------------*/
+
+/***----------------------------------------------------------------
+***
+*** Routine: check_globals
+***
+*** Parameters:
+*** ===========
+***
+*** Action  Name             Type                           Use
+*** ------  ----             ----                           ---
+*** I       state            struct check_state *           Check State
+***
+*** Description:
+*** ============
+***
+*** Checks that global variables in a File conform to H Standard g_<name>
+***
+*** Standards:
+*** ==========
+***
+*** 1 H Global Variable does not conform to style g_<name>
+***
+***-----------------------------------------------------------------*/
+void check_globals (struct check_state * state)
+{
+   /* Loop through each global variable found and check conformation with the Penalty */
+   for (const struct symbol_entry & globalVariable : state->request->symbols->entries)
+   {
+      if (globalVariable.kind == SymGlobalVar)
+      {
+         /* Perform the check */
+         const int conforms = globalVariable.name.substr(0, 2) == "g_";
+
+         /* Record the Result */
+         process_naming_conformance (state,
+                                      "Global",
+                                      "g_<name>",
+                                      globalVariable.name, conforms, globalVariable.line,
+                                      1);
+      }
+   }
+} /* End of check_globals */
+
+
+/*
+ * fullName = "C:\LDRA\LDRA_Demos\TICCS50_Workspace\TICCS50_TMS320F28335_Dice\dice.c"
+ * return just the name ex: "dice"
+ */
+std::string_view file_stem (std::string_view file_name)
+{
+   const size_t slash_pos = file_name.find_last_of("/\\");
+   const size_t start = (slash_pos == std::string_view::npos) ? 0 : slash_pos + 1;
+   const size_t dot_pos = file_name.rfind('.');
+
+   if (dot_pos == std::string_view::npos || dot_pos < start)
+   {
+      return std::string_view();
+   }
+   return file_name.substr(start, dot_pos - start);
+}
+
+
+/***----------------------------------------------------------------
+***
+*** Routine: check_global_vars
+***
+*** Parameters:
+*** ===========
+***
+*** Action  Name             Type                           Use
+*** ------  ----             ----                           ---
+*** I       state            struct check_state *           Check State
+***
+*** Description:
+*** ============
+***
+*** Checks that global variables in a File conform to H Standard <file>_<name>
+***
+*** Standards:
+*** ==========
+***
+*** 9 H Global Var does not conform to style <file>_<name>
+***
+***-----------------------------------------------------------------*/
+
+void check_global_vars (struct check_state * state) {
+   /* Get the expected name for all global variables in this file */
+   const std::string_view expectedStem = file_stem(state->request->source_name);
+
+   /* Loop through each global variable found and check conformation with the Penalty */
+   for (const struct symbol_entry & globalVariable : state->request->symbols->entries) {
+      /* Only find the variables that are not static */
+      if (globalVariable.kind == SymGlobalVar && !(globalVariable.flags & SYM_STATIC)) {
+         /* This is a global var, so check that it conforms to <file>_<name> */
+         const std::string_view name = globalVariable.name;
+         const int conforms = name.size() > expectedStem.size()
+                              && name.substr(0, expectedStem.size()) == expectedStem
+                              && name[expectedStem.size()] == '_';
+
+         /* Record the Result */
+         process_naming_conformance (state, "Global var", "<file>_<name>",
+                                     name, conforms, globalVariable.line, 9);
+      }
+   }
+} /* End of check_global_vars */
+
+
+
+/***----------------------------------------------------------------
+***
+*** Routine: check_class_members
+***
+*** Parameters:
+*** ===========
+***
+*** Action  Name            Type                            Use
+*** ------  ----            ----                            ---
+*** I       state           struct check_state *            Check State
+***
+*** Description:
+*** ============
+***
+*** Checks that Class Member variables conform to H Standard m_<name>
+***
+*** Standards:
+*** ==========
+***
+*** 2 H Class Member does not conform to style m_<name>
+***
+***-----------------------------------------------------------------*/
+void check_class_members (struct check_state * state)
+{
+   /* Loop through the class member variables declared in this File */
+   for (const struct symbol_entry & classMember : state->request->symbols->entries)
+   {
+      if (classMember.kind == SymClassMember)
+      {
+         /* Perform the check */
+         const int conforms = classMember.name.substr(0, 2) == "m_";
+
+         /* Record the Result */
+         process_naming_conformance (state,
+                                        "Member",
+                                        "m_<name>",
+                                        classMember.name,
+                                        conforms,
+                                        classMember.line,
+                                        2);
+      }
+   }
+} /* End of check_class_members */
+
+
+
+/***----------------------------------------------------------------
+***
+*** Routine: check_enums
+***
+*** Parameters:
+*** ===========
+***
+*** Action  Name          Type                          Use
+*** ------  ----          ----                          ---
+*** I       state         struct check_state *          Check State
+***
+*** Description:
+*** ============
+***
+*** Checks the Enum Name conforms to style E<name>.
+*** It then checks all the elements of the enum that they conform to style e_<name>
+***
+*** Standards:
+*** ==========
+***
+*** 3 H Enum Element does not conform to style e_<name>
+*** 7 H Enum Name does not conform to style E<name>
+***
+***-----------------------------------------------------------------*/
+void check_enums (struct check_state * state)
+{
+   const unsigned int h_rules = state->request->h_rules;
+
+   /* Enum elements follow their Enum Name in the table */
+   for (const struct symbol_entry & enumSymbol : state->request->symbols->entries)
+   {
+      if (enumSymbol.kind == SymEnumName && (h_rules & RULE_BIT(7)))
+      {
+         /* Check Penalty 7 H - Conformance of the Enum Name*/
+         const int conforms = enumSymbol.name.substr(0, 1) == "E";
+
+         /* Record the Result */
+         process_naming_conformance (state,
+                                          "Enum name",
+                                          "E<name>",
+                                          enumSymbol.name, conforms, enumSymbol.line,
+                                          7);
+      }
+      else if (enumSymbol.kind == SymEnumElement && (h_rules & RULE_BIT(3)))
+      {
+         /* Check Penalty 3 H - Conformance of the Enum Elements*/
+         const int conforms = enumSymbol.name.substr(0, 2) == "e_";
+
+         /* Record the Result */
+         process_naming_conformance (state,
+                                     "Enum element",
+                                     "e_<name>",
+                                     enumSymbol.name, conforms, enumSymbol.line,
+                                     3);
+      }
+   }
+} /* End of check_enums */
+
+
+/***----------------------------------------------------------------
+***
+*** Routine: check_null_terminated_strings
+***
+*** Parameters:
+*** ===========
+***
+*** Action  Name          Type                          Use
+*** ------  ----          ----                          ---
+*** I       state         struct check_state *          Check State
+***
+*** Description:
+*** ============
+***
+*** Checks the Name of a null terminated string conforms to style sz_<name>.
+***
+*** Standards:
+*** ==========
+***
+*** 10 H Null Terminated String Name does not conform to style sz_<name>
+***
+***-----------------------------------------------------------------*/
+void check_null_terminated_strings (struct check_state * state)
+{
+   /* Loop through each global variable found and check conformation with the Penalty */
+   for (const struct symbol_entry & globalVariable : state->request->symbols->entries)
+   {
+      if (globalVariable.kind == SymGlobalVar)
+      {
+         /* Check if the global is a null terminated string */
+
+         /* Perform the check */
+         const int conforms = globalVariable.name.substr(0, 3) == "sz_";
+
+         /* Record the Result */
+         process_naming_conformance (state,
+                                      "Null Terminated String",
+                                      "sz_<name>",
+                                      globalVariable.name, conforms, globalVariable.line,
+                                      10);
+      }
+   }
+} /* End of check_null_terminated_strings */
+
+
+
+/***----------------------------------------------------------------
+***
+*** Routine: check_classes
+***
+*** Parameters:
+*** ===========
+***
+*** Action  Name          Type                          Use
+*** ------  ----          ----                          ---
+*** I       state         struct check_state *          Check State
+***
+*** Description:
+*** ============
+***
+*** Checks Class Names conform to H Standard C<name>
+***
+*** Standards:
+*** ==========
+***
+*** 4 H Class Name does not conform to style C<name>
+***
+***-----------------------------------------------------------------*/
+
+void check_classes (struct check_state * state)
+{
+   /* Loop through the classes declared in this File */
+   for (const struct symbol_entry & classSymbol : state->request->symbols->entries)
+   {
+      if (classSymbol.kind == SymClass && !classSymbol.name.empty())
+      {
+         /* Class name is fully qualified, to validate it we need to get just the class name. */
+         const std::string_view fullClassName = classSymbol.name;
+         const size_t pos = fullClassName.rfind(':');
+         const std::string_view className =
+            (pos == std::string_view::npos) ? fullClassName : fullClassName.substr(pos + 1);
+
+         /* Perform the check */
+         const int conforms = className.substr(0, 1) == "C";
+
+         /* Record the Result */
+         process_naming_conformance (state,
+                                     "Class Name",
+                                     "C<name>",
+                                     className, conforms, classSymbol.line,
+                                     4);
+      }
+   }
+} /* End of check_classes */
+
+
+
+/***----------------------------------------------------------------
+***
+*** Routine: check_namespaces
+***
+*** Parameters:
+*** ===========
+***
+*** Action  Name          Type                          Use
+*** ------  ----          ----                          ---
+*** I       state         struct check_state *          Check State
+***
+*** Description:
+*** ============
+***
+*** Checks Namespace names conform to H Standard N<name>
+***
+*** Standards:
+*** ==========
+***
+*** 5 H Namespace Name does not conform to style N<name>
+***
+***-----------------------------------------------------------------*/
+void check_namespaces (struct check_state * state)
+{
+   /* Loop through Namespaces available */
+   for (const struct symbol_entry & namespaceSymbol : state->request->symbols->entries)
+   {
+      if (namespaceSymbol.kind == SymNamespace)
+      {
+         /* Perform the check */
+         const int conforms = namespaceSymbol.name.substr(0, 1) == "N";
+
+         /* Record the Result */
+         process_naming_conformance (state,
+                                      "Namespace Name",
+                                      "N<name>",
+                                      namespaceSymbol.name, conforms, -1,
+                                      5);
+      }
+   }
+} /* End of check_namespaces */
+
+
+
+/***----------------------------------------------------------------
+***
+*** Routine: check_pointers
+***
+*** Parameters:
+*** ===========
+***
+*** Action  Name          Type                          Use
+*** ------  ----          ----                          ---
+*** I       state         struct check_state *          Check State
+***
+*** Description:
+*** ============
+***
+*** Checks that Pointer Parameters conform to the style rule.
+*** The same principle can be applied for Local variables etc.
+***
+*** Standards:
+*** ==========
+***
+*** 6 H Pointer does not conform to style p_<name>
+***
+***-----------------------------------------------------------------*/
+void check_pointers (struct check_state * state)
+{
+   /* Loop over each parameter, the line number already falls back to the function */
+   for (const struct symbol_entry & parameter : state->request->symbols->entries)
+   {
+      /* Check if the parameter is a pointer */
+      if (parameter.kind == SymParameter && (parameter.flags & SYM_POINTER))
+      {
+         /* Perform the check */
+         const int conforms = parameter.name.substr(0, 2) == "p_";
+
+         /* Record the Result */
+         process_naming_conformance (state,
+            "Pointer",
+            "p_<name>",
+            parameter.name, conforms, parameter.line,
+            6);
+      }
+   }
+} /* End of check_pointers */
+
+
+/***----------------------------------------------------------------
+***
+*** Routine: check_global_functions
+***
+*** Parameters:
+*** ===========
+***
+*** Action  Name          Type                          Use
+*** ------  ----          ----                          ---
+*** I       state         struct check_state *          Check State
+***
+*** Description:
+*** ============
+***
+*** Checks that each Global Function conform to the style rule.
+*** The same principle can be applied for Local variables etc.
+***
+*** Standards:
+*** ==========
+***
+*** 8 H Global Function Name does not conform to style <file>_<name>
+***
+***-----------------------------------------------------------------*/
+void check_global_functions (struct check_state * state)
+{
+   /* Loop over each function in the file */
+   for (const struct symbol_entry & function : state->request->symbols->entries)
+   {
+      if (function.kind == SymFunction
+          &&
+          (function.flags & SYM_LANG_C)
+          &&
+          !(function.flags & (SYM_STATIC | SYM_MAIN)))
+      {
+         /* This is a global function so check that it conforms to <file>_<name> */
+         const std::string_view stem = function.stem;
+         const int conforms = function.name.size() > stem.size()
+                              && function.name.substr(0, stem.size()) == stem
+                              && function.name[stem.size()] == '_';
+
+         /* Record the Result */
+         process_naming_conformance (state, "Global Function", "<file>_<name>", function.name, conforms, function.line, 8);
+      }
+  }
+} /* End of check_global_functions */
+
+/***----------------------------------------------------------------
+***
+*** Routine: check_file_size
+*** This is an example of checking for a user-defined standard:
+***
+*** 1 Z File exceeds 30000 bytes in size
+***
+*** Parameters:
+*** ===========
+***
+*** Action  Name                      Type            Use
+*** ------  ----                      ----            ---
+*** I       state                     struct check_state *
+***
+***
+*** Return value:
+*** void
+***
+***----------------------------------------------------------------*/
+void check_file_size (struct check_state * state)
+{
+   const long src_size = (long) state->request->source.size();
+   const long PEN_1Z_LIMIT = 30000L;
+
+   if (src_size > PEN_1Z_LIMIT)
+   {
+      add_violation(state, 1,
+                    state->arena->format("File exceeds %ld bytes in size : %s (%ld)",
+                                         PEN_1Z_LIMIT, state->request->source_name, src_size),
+                    0, ZSTANDARD);
+   }
+} /* End of check_file_size */
+
+
+
+/***----------------------------------------------------------------
+***
+*** Routine: check_filename_size
+***
+*** 2 Z Filename exceeds 8 characters
+***  8 characters refers to the number of characters before the "."
+***  (Currently assumes that extension is .c or .h)
+***
+*** Parameters:
+*** ===========
+***
+*** Action  Name                      Type            Use
+*** ------  ----                      ----            ---
+*** I       state                     struct check_state *
+***
+***
+*** Return value:
+*** void
+***
+***
+*** Calls:
+*** ======
+***
+*** Name                      Location
+*** ----                      --------
+*** file_base_name            This File
+*** add_violation             This File
+***
+***
+***----------------------------------------------------------------*/
+void check_filename_size (struct check_state * state)
+{
+   const size_t NAME_LIMIT = 8; /* excludes .c or .h */
+   const std::string_view short_name = file_base_name(state->request->source_name);
+
+   if (short_name.size() > (NAME_LIMIT+2))  /* includes .c or .h */
+   {
+      add_violation(state, 2,
+                    state->arena->format("Filename exceeds %d characters : %.*s (%d)",
+                                         (int) NAME_LIMIT,
+                                         (int) short_name.size(), short_name.data(),
+                                         (int) short_name.size()),
+                    0, ZSTANDARD);
+   }
+} /* End of check_filename_size */
+
+
+
+/***----------------------------------------------------------------
+***
+*** Routine: check_includename
+***
+*** 3 Z Include name does not match source file name.
+***  Checks that the  #include filaname is the same as the source filename
+***
+*** Parameters:
+*** ===========
+***
+*** Action  Name                Type            Use
+*** ------  ----                ----            ---
+*** I       state               struct check_state *
+*** I       line                std::string_view    line of source text
+*** I       linenum             int                 line number of text, unused (reported on line 0)
+***
+***
+*** Return value:
+*** void
+***
+***
+*** Calls:
+*** ======
+***
+*** Name                      Location
+*** ----                      --------
+*** file_base_name            This File
+*** next_token                This File
+*** add_violation             This File
+***
+***
+***----------------------------------------------------------------*/
+void check_includename (struct check_state * state, std::string_view line, int /* linenum */)
+{
+   std::string_view rest = line;
+   const std::string_view include_tok = next_token(&rest, " ");
+
+   if (include_tok == "#include")
+   {
+     /* excludes "" or < > */
+     const std::string_view h_source = next_token(&rest, " <\"");
+     const std::string_view include_name = h_source.substr(0, h_source.find('.'));
+
+     const std::string_view c_source = file_base_name(state->request->source_name);
+     const std::string_view source_name = c_source.substr(0, c_source.find('.'));
+
+     if (!h_source.empty() && source_name != include_name)
+     {
+       add_violation(state, 3,
+                     state->arena->format("Include name does not match source file name : %.*s %.*s",
+                                          (int) c_source.size(), c_source.data(),
+                                          (int) h_source.size(), h_source.data()),
+                     0, ZSTANDARD);
+     }
+   }
+} /* End of check_includename */
+
+/***----------------------------------------------------------------
+***
+*** Routine: check_include_found
+***
+*** 11 Z Include file not found.
+***  Resolves "name" and <name> includes through the request's resolver.
+***  Includes sysearch.dat marks as not searched for (type 300/301) and
+***  macro includes are not checked. With the report, where each include
+***  resolves to is added to it. Each include is also added to the result
+***  for the include graph, see Includegraph.h.
+***
+*** Parameters:
+*** ===========
+***
+*** Action  Name                Type            Use
+*** ------  ----                ----            ---
+*** I       state               struct check_state *
+*** I       line                std::string_view line of source text
+*** I       linenum             int             current line number
+***
+***
+*** Return value:
+*** void
+***
+***----------------------------------------------------------------*/
+void check_include_found (struct check_state * state, std::string_view line, int linenum)
+{
+   std::string_view include_name;
+   bool quoted = false;
+
+   if (!parse_include(line, &include_name, &quoted))
+   {
+      return;
+   }
+
+   const struct include_resolution resolution =
+      state->request->includes->resolve(include_name, state->request->source_name, quoted);
+   struct include_entry include;
+
+   include.line = linenum;
+   include.name = include_name;
+   include.path = resolution.path;
+   include.status = resolution.status;
+   state->result->includes.push_back(include);
+
+   if (resolution.status == IncludeNotFound && (state->request->z_rules & RULE_BIT(11)))
+   {
+      add_violation(state, 11,
+                    state->arena->format("Include file not found : %.*s",
+                                         (int) include_name.size(), include_name.data()),
+                    linenum, ZSTANDARD);
+   }
+   else if (resolution.status == IncludeFound && state->request->report && state->in_scope)
+   {
+      struct report_entry entry;
+      entry.line = linenum;
+      entry.text = state->arena->format("Include %.*s resolves to %.*s",
+                                        (int) include_name.size(), include_name.data(),
+                                        (int) resolution.path.size(), resolution.path.data());
+      state->result->report.push_back(entry);
+   }
+} /* End of check_include_found */
+
+
+
+
+
+/***----------------------------------------------------------------
+***
+*** Routine: match_template
+***
+*** Returns the index value of a template if found
+*** Other wise returns -1
+***
+*** Parameters:
+*** ===========
+***
+*** Action  Name                Type            Use
+*** ------  ----                ----            ---
+*** I       line                std::string_view line of source text
+*** I       current_template    int             position in template list
+***
+*** Return value:
+*** int
+***
+***----------------------------------------------------------------*/
+static const char * const usertemplate[TEMPLATE_MAX] =
+{/* 0 */ "/*******************************************",
+ /* 1 */ " * Copyright statement",
+ /* 2 */ " *******************************************/",
+ /* 3 */ "/*******************************************",
+ /* 4 */ " * Filename:",
+ /* 5 */ " * Author:",
+ /* 6 */ " * Date:",
+ /* 7 */ " * Purpose:",
+ /* 8 */ " * Revision:",
+ /* 9 */ " *******************************************/",
+ /* 10 */ " /* Include Section */"
+};
+
+int match_template(std::string_view line, int current_template)
+{
+  int template_no;
+  for (template_no = current_template+1; template_no < TEMPLATE_MAX; template_no++)
+  {
+    /* Check to see whether template matches start of line */
+    const std::string_view expected = usertemplate[template_no];
+    if ( line.substr(0, expected.size()) == expected )
+    {
+      break;
+    }
+  }
+  return  ( template_no == TEMPLATE_MAX ? -1 : template_no ) ;
+} /* End of match_template */
+
+/***----------------------------------------------------------------
+***
+*** Routine: check_templates
+***
+*** 4 Z Source does not match layout template.
+***  Check to see whether any templates have been skipped.
+***
+*** Parameters:
+*** ===========
+***
+*** Action  Name                Type            Use
+*** ------  ----                ----            ---
+*** IO      state               struct check_state *  holds position in template
+*** I       line                std::string_view      current source line
+*** I       linenum             int                   line number of text, unused (reported on line 0)
+***
+*** Return value:
+*** void
+***
+***
+*** Calls:
+*** ======
+***
+*** Name                      Location
+*** ----                      --------
+*** add_violation             This File
+*** match_template            This File
+***
+***
+***----------------------------------------------------------------*/
+void check_templates (struct check_state * state, std::string_view line, int /* linenum */)
+{
+   const int current_template = state->current_template;
+
+   if ( current_template+1 < TEMPLATE_MAX )
+   { /* In template section */
+     int template_no = match_template(line, current_template);
+
+     if ( template_no != -1 )
+     {  /* template match found */
+       if ( template_no != current_template+1 )
+       {
+           add_violation(state, 4,
+                         state->arena->format("Source does not match layout template : %s",
+                                              usertemplate[current_template+1]),
+                         0, ZSTANDARD);
+       }
+       state->current_template = template_no;
+     }
+   }
+} /* End of check_templates */
+
+
+
+/***----------------------------------------------------------------
+***
+*** Routine: check_radix
+***
+*** 5 Z Hexadecimal number found.
+***  Checks that  there is no use of hexadecimal radix
+***
+*** Parameters:
+*** ===========
+***
+*** Action  Name                Type            Use
+*** ------  ----                ----            ---
+*** I       state               struct check_state *
+*** I       line                std::string_view    line of source text
+*** I       linenum             int                 line number of text, unused (reported on line 5)
+***
+***
+*** Return value:
+*** void
+***
+***
+*** Calls:
+*** ======
+***
+*** Name                      Location
+*** ----                      --------
+*** add_violation             This File
+***
+***
+***----------------------------------------------------------------*/
+void check_radix (struct check_state * state, std::string_view line, int /* linenum */)
+{
+   size_t pos = line.find("0x");
+   if (pos == std::string_view::npos)
+   {
+     pos = line.find("0X");
+   }
+   if (pos != std::string_view::npos)
+   {
+     const std::string_view s = line.substr(pos);
+     add_violation(state, 5,
+                   state->arena->format("Hexadecimal number found : %.*s", (int) s.size(), s.data()),
+                   5, ZSTANDARD);
+   }
+} /* End of check_radix */
+
+/***----------------------------------------------------------------
+***
+*** Routine: check_forbidden_words
+***
+*** 6 Z Forbidden word found.
+***  Checks that there is no use of forbidden words
+***
+*** Parameters:
+*** ===========
+***
+*** Action  Name                Type            Use
+*** ------  ----                ----            ---
+*** I       state               struct check_state *
+*** I       line                std::string_view    line of source text
+*** I       linenum             int                 line number of text
+***
+***
+*** Return value:
+*** void
+***
+***
+*** Calls:
+*** ======
+***
+*** Name                      Location
+*** ----                      --------
+*** add_violation             This File
+***
+***----------------------------------------------------------------*/
+void check_forbidden_words (struct check_state * state, std::string_view line, int linenum)
+{
+   const int WORDS = 3;
+   static const char * const WORD_LIST[WORDS] = {"TODO", "TEMPORARY", "REMOVE" };
+
+   for ( int i = 0; i < WORDS; i++ )
+   {
+      if (line.find(WORD_LIST[i]) != std::string_view::npos)
+      {
+         add_violation(state, 6,
+                       state->arena->format("Forbidden word found : %s", WORD_LIST[i]),
+                       linenum, ZSTANDARD);
+      }
+   }
+} /* End of check_forbidden_words */
+
+/***----------------------------------------------------------------
+***
+*** Routine: skip_block
+***
+*** Parameters:
+*** ===========
+***
+*** Action  Name                Type                Use
+*** ------  ----                ----                ---
+*** I       source              std::string_view    Source text
+*** I       pos                 size_t              Position just after a '{'
+*** IO      line                int *               Line number at pos
+***
+***
+*** Return value:
+*** size_t          Position just after the matching '}'
+***
+*** Description:
+*** ============
+***
+*** Skips a block that is not a procedure body, such as an enum body or an
+*** initialiser. Braces in comments, strings and character constants are
+*** not counted.
+***
+***----------------------------------------------------------------*/
+size_t skip_block (std::string_view source, size_t pos, int* line)
+{
+   int nested = 1;
+
+   while (pos < source.size() && nested > 0)
+   {
+      const char c = source[pos];
+
+      if (c == '/' && pos + 1 < source.size() && (source[pos + 1] == '*' || source[pos + 1] == '/'))
+      {
+         const bool block = (source[pos + 1] == '*');
+         size_t end = block ? source.find("*/", pos + 2) : source.find('\n', pos + 2);
+
+         end = (end == std::string_view::npos) ? source.size() : end + (block ? 2 : 0);
+         *line += (int) std::count(source.begin() + pos, source.begin() + end, '\n');
+         pos = end;
+         continue;
+      }
+      if (c == '"' || c == '\'')
+      {
+         pos++;
+         while (pos < source.size() && source[pos] != c && source[pos] != '\n')
+         {
+            pos += (source[pos] == '\\' && pos + 1 < source.size()) ? 2 : 1;
+         }
+         pos++;
+         continue;
+      }
+
+      if (c == '\n') (*line)++;
+      else if (c == '{') nested++;
+      else if (c == '}') nested--;
+      pos++;
+   }
+   return pos;
+} /* End of skip_block */
+
+/***----------------------------------------------------------------
+***
+*** Routine: scan_procedures
+***
+*** Parameters:
+*** ===========
+***
+*** Action  Name                Type                                Use
+*** ------  ----                ----                                ---
+*** I       source              std::string_view                    Source text
+*** O       procedures          std::vector<procedure_metrics> *    Procedures found
+***
+***
+*** Return value:
+*** void
+***
+*** Description:
+*** ============
+***
+*** A single pass over the source that follows comments, strings,
+*** character constants and preprocessor directives, and finds each
+*** procedure definition: an identifier and parameter list at declaration
+*** level followed by '{'. Namespace, class, struct, union and extern "C"
+*** bodies are declaration level too, so member functions defined in a
+*** class are found. Between the parameter list and the '{' there may be
+*** qualifiers (const, noexcept(...), override, ...), a trailing return
+*** type or a constructor initialiser list. For each procedure it counts
+***  - cyclomatic complexity, 1 + each if, while, for, case, ?, && and ||
+***  - executable lines, lines of the body with code other than braces
+***  - comments in the body, and in its header (since the previous
+***    declaration or procedure at declaration level)
+***  - parameters
+***
+*** This follows the source as written, the toolsuite metrics of the same
+*** name are calculated on the reformatted code after full analysis.
+***
+***----------------------------------------------------------------*/
+void scan_procedures (std::string_view source, std::vector<procedure_metrics>* procedures)
+{
+   struct procedure_metrics current = {};
+   std::string_view last_identifier;
+   int last_identifier_line = 0;
+   int depth = 0;               /* Brace depth in a procedure body */
+   int scopes = 0;              /* Namespace, class and extern "C" bodies open */
+   int paren = 0;               /* Parenthesis depth at declaration level */
+   int angle = 0;               /* Template brackets at declaration level */
+   int header_comments = 0;     /* Comments since the last declaration */
+   int parameters = 0;
+   bool parameter_seen = false;
+   bool only_void = false;
+   bool candidate = false;      /* name(...) seen at declaration level, '{' would start a procedure */
+   bool suffix_paren = false;   /* The parentheses open follow the parameter list, e.g. noexcept(...) */
+   bool initialisers = false;   /* In the constructor initialiser list of the candidate */
+   bool trailing_return = false;/* In the trailing return type of the candidate */
+   bool scope_head = false;     /* namespace, class, struct, union or extern "C" seen, '{' opens a scope */
+   bool enum_head = false;      /* enum seen, "enum class" is not a scope */
+   char previous = '\0';        /* Last token at declaration level, 'a' for an identifier */
+   int code_line = 0;           /* Last line counted as executable */
+   int line = 1;
+   bool line_start = true;      /* Only white space so far on the line */
+   size_t pos = 0;
+
+   procedures->clear();
+
+   while (pos < source.size())
+   {
+      const char c = source[pos];
+
+      /* New lines, white space */
+      if (c == '\n')
+      {
+         line++;
+         line_start = true;
+         pos++;
+         continue;
+      }
+      if (c == ' ' || c == '\t' || c == '\r' || c == '\f' || c == '\v')
+      {
+         pos++;
+         continue;
+      }
+
+      /* Comments */
+      if (c == '/' && pos + 1 < source.size() && (source[pos + 1] == '*' || source[pos + 1] == '/'))
+      {
+         const bool block = (source[pos + 1] == '*');
+         size_t end = block ? source.find("*/", pos + 2) : source.find('\n', pos + 2);
+
+         end = (end == std::string_view::npos) ? source.size() : end + (block ? 2 : 0);
+         line += (int) std::count(source.begin() + pos, source.begin() + end, '\n');
+         pos = end;
+
+         if (depth > 0)
+         {
+            current.comments++;
+         }
+         else
+         {
+            header_comments++;
+         }
+         continue;
+      }
+
+      /* Preprocessor directives, to the end of the line and any continuation */
+      if (c == '#' && line_start)
+      {
+         while (pos < source.size() && source[pos] != '\n')
+         {
+            if (source[pos] == '\\' && pos + 1 < source.size() && source[pos + 1] == '\n')
+            {
+               line++;
+               pos++;
+            }
+            else if (source[pos] == '/' && pos + 1 < source.size() && source[pos + 1] == '*')
+            {
+               break; /* Counted as a comment */
+            }
+            pos++;
+         }
+         continue;
+      }
+      line_start = false;
+
+      /* Lines of the body with code, other than the braces */
+      if (depth > 0 && c != '{' && c != '}' && code_line != line)
+      {
+         code_line = line;
+         current.executable_lines++;
+      }
+
+      /* Strings and character constants */
+      if (c == '"' || c == '\'')
+      {
+         pos++;
+         while (pos < source.size() && source[pos] != c && source[pos] != '\n')
+         {
+            pos += (source[pos] == '\\' && pos + 1 < source.size()) ? 2 : 1;
+         }
+         pos++;
+         if (depth == 0 && paren > 0)
+         {
+            parameter_seen = true;
+            only_void = false;
+         }
+         else if (depth == 0 && last_identifier == "extern")
+         {
+            scope_head = true; /* extern "C" */
+         }
+         previous = c;
+         continue;
+      }
+
+      /* Identifiers and keywords */
+      if (isalpha((unsigned char) c) || c == '_')
+      {
+         size_t end = pos;
+         while (end < source.size() && (isalnum((unsigned char) source[end]) || source[end] == '_'))
+         {
+            end++;
+         }
+         const std::string_view word = source.substr(pos, end - pos);
+         pos = end;
+
+         if (depth > 0)
+         {
+            if (word == "if" || word == "while" || word == "for" || word == "case")
+            {
+               current.cyclomatic++;
+            }
+         }
+         else if (paren > 0)
+         {
+            only_void = !parameter_seen && word == "void";
+            parameter_seen = true;
+         }
+         else if (candidate
+                  && (initialisers || trailing_return
+                      || word == "const" || word == "volatile" || word == "noexcept" || word == "throw"
+                      || word == "override" || word == "final" || word == "__attribute__"))
+         {
+            /* Part of the procedure declaration after its parameter list */
+         }
+         else
+         {
+            last_identifier = word;
+            last_identifier_line = line;
+            candidate = false;
+            if (word == "enum")
+            {
+               enum_head = true;
+               scope_head = false;
+            }
+            else if ((word == "namespace" || word == "class" || word == "struct" || word == "union")
+                     && !enum_head && angle == 0)
+            {
+               scope_head = true;
+            }
+         }
+         previous = 'a';
+         continue;
+      }
+
+      /* Numbers, so their letters are not taken as identifiers */
+      if (isdigit((unsigned char) c))
+      {
+         while (pos < source.size() && (isalnum((unsigned char) source[pos]) || source[pos] == '.' || source[pos] == '_'))
+         {
+            pos++;
+         }
+         if (depth == 0 && paren > 0)
+         {
+            parameter_seen = true;
+            only_void = false;
+         }
+         previous = '0';
+         continue;
+      }
+
+      /* Punctuation */
+      pos++;
+      if (depth > 0)
+      {
+         if (c == '?')
+         {
+            current.cyclomatic++;
+         }
+         else if ((c == '&' || c == '|') && pos < source.size() && source[pos] == c)
+         {
+            current.cyclomatic++;
+            pos++;
+         }
+         else if (c == '{')
+         {
+            depth++;
+         }
+         else if (c == '}' && --depth == 0)
+         {
+            current.end_line = line;
+            procedures->push_back(current);
+            header_comments = 0;
+            previous = c;
+         }
+         continue;
+      }
+
+      if (c == '(')
+      {
+         if (paren++ == 0)
+         {
+            if (candidate)
+            {
+               /* Arguments of a qualifier or an initialiser, not a parameter list */
+               suffix_paren = true;
+            }
+            else
+            {
+               /* Start of a possible parameter list */
+               current = procedure_metrics();
+               current.name = last_identifier;
+               current.line = last_identifier_line;
+               parameters = 0;
+               parameter_seen = false;
+               only_void = false;
+            }
+         }
+         else if (paren == 2 && !parameter_seen)
+         {
+            parameter_seen = true; /* e.g. a function pointer parameter */
+         }
+      }
+      else if (c == ')' && paren > 0)
+      {
+         if (--paren == 0)
+         {
+            if (suffix_paren)
+            {
+               suffix_paren = false;
+            }
+            else
+            {
+               candidate = !current.name.empty();
+               current.parameters = (!parameter_seen || only_void) ? 0 : parameters + 1;
+               initialisers = false;
+               trailing_return = false;
+            }
+         }
+      }
+      else if (paren > 0)
+      {
+         if (c == ',' && paren == 1 && !suffix_paren)
+         {
+            parameters++;
+         }
+         parameter_seen = true;
+         only_void = false;
+      }
+      else if (c == '{' && candidate && initialisers && (previous == 'a' || previous == '>'))
+      {
+         /* Brace initialiser of a member or base in the initialiser list */
+         pos = skip_block(source, pos, &line);
+         previous = '}';
+         continue;
+      }
+      else if (c == '{')
+      {
+         if (candidate)
+         {
+            /* Procedure body */
+            depth = 1;
+            current.cyclomatic = 1;
+            current.header_comments = header_comments;
+            current.comments = 0;
+            current.executable_lines = 0;
+            code_line = line;
+         }
+         else if (scope_head)
+         {
+            /* Namespace, class or extern "C" body, its declarations are scanned */
+            scopes++;
+            header_comments = 0;
+            last_identifier = std::string_view();
+         }
+         else
+         {
+            /* enum body or initialiser, skip it */
+            pos = skip_block(source, pos, &line);
+         }
+         candidate = false;
+         initialisers = false;
+         trailing_return = false;
+         scope_head = false;
+         enum_head = false;
+         angle = 0;
+      }
+      else if (c == '}')
+      {
+         /* End of a namespace, class or extern "C" body */
+         if (scopes > 0)
+         {
+            scopes--;
+         }
+         candidate = false;
+         header_comments = 0;
+         last_identifier = std::string_view();
+      }
+      else if (c == ';')
+      {
+         /* End of a declaration or prototype */
+         candidate = false;
+         initialisers = false;
+         trailing_return = false;
+         scope_head = false;
+         enum_head = false;
+         angle = 0;
+         header_comments = 0;
+         last_identifier = std::string_view();
+      }
+      else if (c == '=')
+      {
+         /* = 0, = default, = delete or an initialiser */
+         candidate = false;
+         scope_head = false;
+      }
+      else if (candidate && c == ':' && !initialisers && !trailing_return
+               && !(pos < source.size() && source[pos] == ':'))
+      {
+         initialisers = true;
+      }
+      else if (candidate && c == '-' && pos < source.size() && source[pos] == '>')
+      {
+         trailing_return = true;
+      }
+      else
+      {
+         if (c == '<')
+         {
+            angle++;
+         }
+         else if (c == '>' && angle > 0)
+         {
+            angle--;
+         }
+         if (!(candidate && (initialisers || trailing_return || c == '&'))
+             && c != '*' && c != '[' && c != ']')
+         {
+            candidate = false;
+         }
+      }
+      previous = c;
+   }
+} /* End of scan_procedures */
+
+/***----------------------------------------------------------------
+***
+*** Routine: check_procedure_metrics
+***
+*** 7 Z Cyclomatic complexity greater than ***.
+*** 8 Z Procedure exceeds *** executable lines.
+*** 9 Z Procedure has fewer than *** comments.
+*** 10 Z More than *** parameters in procedure.
+***  Checks the metrics of each procedure against the limits of the
+***  request (from Metpen.dat, see Combinedstandards.cpp)
+***
+*** Parameters:
+*** ===========
+***
+*** Action  Name                Type            Use
+*** ------  ----                ----            ---
+*** I       state               struct check_state *
+***
+***
+*** Return value:
+*** void
+***
+***
+*** Calls:
+*** ======
+***
+*** Name                      Location
+*** ----                      --------
+*** scan_procedures           This File
+*** add_violation             This File
+***
+***----------------------------------------------------------------*/
+void check_procedure_metrics (struct check_state * state)
+{
+   const struct metric_limits* limits = state->request->metrics;
+   const std::vector<line_range>* ranges = state->request->source_lines;
+   const unsigned int z_rules = state->request->z_rules;
+   std::vector<procedure_metrics> procedures;
+
+   scan_procedures(state->request->source, &procedures);
+
+   for (const struct procedure_metrics & procedure : procedures)
+   {
+      const int name_length = (int) procedure.name.size();
+      const char* name = procedure.name.data();
+
+      /* When checking changed lines only, procedures with a changed line */
+      if (ranges != NULL)
+      {
+         std::vector<line_range>::const_iterator range =
+            std::lower_bound(ranges->begin(), ranges->end(), procedure.line,
+                             [](const line_range& r, int l) { return r.last < l; });
+         if (range == ranges->end() || range->first > procedure.end_line)
+         {
+            continue;
+         }
+      }
+
+      if ((z_rules & RULE_BIT(7)) && limits->max_cyclomatic > 0
+          && procedure.cyclomatic > limits->max_cyclomatic)
+      {
+         add_violation(state, 7,
+                       state->arena->format("Cyclomatic complexity greater than %d : %.*s (%d)",
+                                            limits->max_cyclomatic, name_length, name, procedure.cyclomatic),
+                       procedure.line, ZSTANDARD);
+      }
+      if ((z_rules & RULE_BIT(8)) && limits->max_executable_lines > 0
+          && procedure.executable_lines > limits->max_executable_lines)
+      {
+         add_violation(state, 8,
+                       state->arena->format("Procedure exceeds %d executable lines : %.*s (%d)",
+                                            limits->max_executable_lines, name_length, name,
+                                            procedure.executable_lines),
+                       procedure.line, ZSTANDARD);
+      }
+      if ((z_rules & RULE_BIT(9)) && limits->min_header_comments > 0
+          && procedure.header_comments < limits->min_header_comments)
+      {
+         add_violation(state, 9,
+                       state->arena->format("Procedure has fewer than %d header comments : %.*s (%d)",
+                                            limits->min_header_comments, name_length, name,
+                                            procedure.header_comments),
+                       procedure.line, ZSTANDARD);
+      }
+      if ((z_rules & RULE_BIT(9)) && limits->min_comments > 0
+          && procedure.header_comments + procedure.comments < limits->min_comments)
+      {
+         add_violation(state, 9,
+                       state->arena->format("Procedure has fewer than %d comments : %.*s (%d)",
+                                            limits->min_comments, name_length, name,
+                                            procedure.header_comments + procedure.comments),
+                       procedure.line, ZSTANDARD);
+      }
+      if ((z_rules & RULE_BIT(10)) && limits->max_parameters > 0
+          && procedure.parameters > limits->max_parameters)
+      {
+         add_violation(state, 10,
+                       state->arena->format("More than %d parameters in procedure : %.*s (%d)",
+                                            limits->max_parameters, name_length, name, procedure.parameters),
+                       procedure.line, ZSTANDARD);
+      }
+   }
+} /* End of check_procedure_metrics */
+
+/***----------------------------------------------------------------
+***
+*** Routine: check_banned_identifiers
+***
+*** 16 Z Banned function or macro used.
+***  Checks each identifier of the code against the banned list of the
+***  request (see Bannedlist.h)
+***
+*** Parameters:
+*** ===========
+***
+*** Action  Name                Type            Use
+*** ------  ----                ----            ---
+*** I       state               struct check_state *
+***
+***
+*** Return value:
+*** void
+***
+***
+*** Description:
+*** ============
+***
+*** A single pass over the source, following comments, strings, character
+*** constants and numbers as scan_procedures does, so that a banned name
+*** is only found as a whole identifier of the code. Names of #include
+*** lines and members (after . or ->) are not identifiers of the list.
+*** Each use is reported on the source line it is on.
+***
+***
+*** Calls:
+*** ======
+***
+*** Name                      Location
+*** ----                      --------
+*** CBannedList::find         Bannedlist.cpp
+*** in_line_ranges            This File
+*** add_violation             This File
+***
+***----------------------------------------------------------------*/
+void check_banned_identifiers (struct check_state * state)
+{
+   const CBannedList* banned = state->request->banned;
+   const std::vector<line_range>* ranges = state->request->source_lines;
+   const std::string_view source = state->request->source;
+   bool line_start = true;      /* Only white space so far on the line */
+   bool member = false;         /* Last token was . or -> */
+   int line = 1;
+   size_t pos = 0;
+
+   while (pos < source.size())
+   {
+      const char c = source[pos];
+
+      /* New lines, white space */
+      if (c == '\n')
+      {
+         line++;
+         line_start = true;
+         pos++;
+         continue;
+      }
+      if (c == ' ' || c == '\t' || c == '\r' || c == '\f' || c == '\v')
+      {
+         pos++;
+         continue;
+      }
+
+      /* Comments */
+      if (c == '/' && pos + 1 < source.size() && (source[pos + 1] == '*' || source[pos + 1] == '/'))
+      {
+         const bool block = (source[pos + 1] == '*');
+         size_t end = block ? source.find("*/", pos + 2) : source.find('\n', pos + 2);
+
+         end = (end == std::string_view::npos) ? source.size() : end + (block ? 2 : 0);
+         line += (int) std::count(source.begin() + pos, source.begin() + end, '\n');
+         pos = end;
+         continue;
+      }
+
+      /* Include lines, the name is a file not an identifier */
+      if (c == '#' && line_start)
+      {
+         size_t end = pos + 1;
+         while (end < source.size() && (source[end] == ' ' || source[end] == '\t'))
+         {
+            end++;
+         }
+         if (source.compare(end, 7, "include") == 0)
+         {
+            end = std::min(source.find('\n', end), source.size());
+         }
+         pos = end;
+         line_start = false;
+         continue;
+      }
+      line_start = false;
+
+      /* Strings and character constants */
+      if (c == '"' || c == '\'')
+      {
+         pos++;
+         while (pos < source.size() && source[pos] != c && source[pos] != '\n')
+         {
+            pos += (source[pos] == '\\' && pos + 1 < source.size()) ? 2 : 1;
+         }
+         pos++;
+         member = false;
+         continue;
+      }
+
+      /* Identifiers and keywords */
+      if (isalpha((unsigned char) c) || c == '_')
+      {
+         size_t end = pos;
+         while (end < source.size() && (isalnum((unsigned char) source[end]) || source[end] == '_'))
+         {
+            end++;
+         }
+         const std::string_view word = source.substr(pos, end - pos);
+         const struct banned_name* found = member ? NULL : banned->find(word);
+         pos = end;
+         member = false;
+
+         if (found != NULL && in_line_ranges(ranges, line))
+         {
+            add_violation(state, 16,
+                          found->reason.empty()
+                          ? state->arena->format("Banned identifier : %s", found->name.c_str())
+                          : state->arena->format("Banned identifier : %s, %s",
+                                                 found->name.c_str(), found->reason.c_str()),
+                          line, ZSTANDARD);
+         }
+         continue;
+      }
+
+      /* Numbers, so their letters are not taken as identifiers */
+      if (isdigit((unsigned char) c))
+      {
+         while (pos < source.size() && (isalnum((unsigned char) source[pos]) || source[pos] == '.' || source[pos] == '_'))
+         {
+            pos++;
+         }
+         member = false;
+         continue;
+      }
+
+      /* Punctuation */
+      member = (c == '.') || (c == '-' && pos + 1 < source.size() && source[pos + 1] == '>');
+      pos += (c == '-' && member) ? 2 : 1;
+   }
+} /* End of check_banned_identifiers */
+
+/***----------------------------------------------------------------
+***
+*** End of Standards
+***
+***----------------------------------------------------------------*/
+
+
+
+
+
+
+/***----------------------------------------------------------------
+***
+*** Start of Engine Functions **Editing below this point is not recommended.
+***
+***----------------------------------------------------------------*/
+
+/***-------------------------------------------------------------------------------------------------------------
+***
+*** Routine: process_naming_conformance
+***
+*** Parameters:
+*** ===========
+***
+*** Action  Name            Type                          Use
+*** ------  ----            ----                          ---
+*** I       state           struct check_state *          Check State
+*** I       type            const char *                  Variable Type
+*** I       style           const char *                  Conformance Style
+*** I       name            std::string_view              Variable Name
+*** I       conforms        int                           Whether or not variable conforms to style
+*** I       linenumber      int                           Line number of variable declaration
+*** I       std_num         int                           Number for H Standard
+***
+*** Description:
+*** ===========
+*** If a variable does not conform to standards, adds it to the violations.
+*** Also adds an entry to the naming report if requested
+***
+***-------------------------------------------------------------------------------------------------------------*/
+void process_naming_conformance (struct check_state * state,
+                                  const char* type,
+                                  const char* style,
+                                  std::string_view name,
+                                  const int conforms,
+                                  const int linenumber,
+                                  const int std_num)
+{
+   /* Only symbols on the changed lines are reported */
+   if (!in_line_ranges(state->request->symbol_lines, linenumber))
+   {
+      return;
+   }
+
+   /* If variable does not conform to standard, add it to the violations */
+   if(!conforms)
+   {
+      add_violation (state, std_num, name, linenumber, HSTANDARD);
+   }
+
+   if (state->request->report)
+   {
+      struct report_entry entry;
+      entry.line = linenumber;
+      entry.text = state->arena->format(conforms ? "%s conforms to style '%s': %.*s"
+                                                 : "%s does not conform to style '%s': %.*s",
+                                        type, style, (int) name.size(), name.data());
+      state->result->report.push_back(entry);
+   }
+}
+
+/***----------------------------------------------------------------
+***
+*** Routine: add_violation
+***
+*** Parameters:
+*** ===========
+***
+*** Action  Name                 Type              Use
+*** ------  ----                 ----              ---
+*** I       state       struct check_state *       Check State
+*** I       std_num              int               5th column in pen file
+*** I       message              std::string_view  text for the 101 record
+*** I       linenumber           int               line, 0 for the file as a whole
+*** I       std_letter           char              HSTANDARD or ZSTANDARD
+***
+*** Description:
+*** ============
+***
+*** Adds a violation to the results, unless the check is limited to
+*** changed lines and the violation is not on one of them. Violations of
+*** the file as a whole (line 0) are always added.
+***
+***----------------------------------------------------------------*/
+void add_violation (struct check_state * state,
+                    const int std_num,
+                    std::string_view message,
+                    const int linenumber,
+                    const char std_letter)
+{
+   struct violation_info violation;
+
+   if (std_letter == ZSTANDARD && linenumber > 0 && !state->in_scope)
+   {
+      return;
+   }
+   if (std_letter == HSTANDARD
+       &&
+       !in_line_ranges(state->request->symbol_lines, linenumber))
+   {
+      return;
+   }
+
+   violation.std_letter = std_letter;
+   violation.std_num = std_num; /* This number must match column 5 in <lang>pen.dat */
+   violation.line = (linenumber > 0) ? linenumber : 0;
+   violation.text = message;
+
+   state->result->violations.push_back(violation);
+} /* End of add_violation */
+
+/***----------------------------------------------------------------
+***
+*** Routine: in_line_ranges
+*** Whether the line is in one of the ranges, always true if there are
+*** no ranges (NULL)
+***
+***----------------------------------------------------------------*/
+bool in_line_ranges (const std::vector<line_range>* ranges, int line)
+{
+   if (ranges == NULL)
+   {
+      return true;
+   }
+
+   /* First range that does not end before the line */
+   std::vector<line_range>::const_iterator range =
+      std::lower_bound(ranges->begin(), ranges->end(), line,
+                       [](const line_range& r, int l) { return r.last < l; });
+
+   return range != ranges->end() && range->first <= line;
+} /* End of in_line_ranges */
+
+/***----------------------------------------------------------------
+***
+*** Routine: merge_line_ranges
+*** Sorts the ranges and joins those that overlap or touch
+***
+***----------------------------------------------------------------*/
+void merge_line_ranges (std::vector<line_range>* ranges)
+{
+   size_t merged = 0;
+
+   std::sort(ranges->begin(), ranges->end(),
+             [](const line_range& a, const line_range& b) { return a.first < b.first; });
+
+   for (size_t index = 0; index < ranges->size(); index++)
+   {
+      const line_range& range = (*ranges)[index];
+
+      if (merged > 0 && range.first <= (*ranges)[merged-1].last + 1)
+      {
+         (*ranges)[merged-1].last = std::max((*ranges)[merged-1].last, range.last);
+      }
+      else
+      {
+         (*ranges)[merged++] = range;
+      }
+   }
+   ranges->resize(merged);
+} /* End of merge_line_ranges */
+
+/***----------------------------------------------------------------
+***
+*** Routine: file_base_name
+*** Returns the file name without its path
+***
+***----------------------------------------------------------------*/
+std::string_view file_base_name (std::string_view file_name)
+{
+   const size_t pos = file_name.find_last_of("\\:/");
+   return (pos == std::string_view::npos) ? file_name : file_name.substr(pos + 1);
+} /* End of file_base_name */
+
+/***----------------------------------------------------------------
+***
+*** Routine: next_token
+*** strtok for views: skips leading delimiters, returns the token and
+*** moves rest past it. Returns an empty view when there are no tokens.
+***
+***----------------------------------------------------------------*/
+std::string_view next_token (std::string_view * rest, std::string_view delimiters)
+{
+   const size_t start = rest->find_first_not_of(delimiters);
+   if (start == std::string_view::npos)
+   {
+      *rest = std::string_view();
+      return std::string_view();
+   }
+
+   size_t end = rest->find_first_of(delimiters, start);
+   if (end == std::string_view::npos)
+   {
+      end = rest->size();
+   }
+
+   const std::string_view token = rest->substr(start, end - start);
+   rest->remove_prefix(end);
+   return token;
+} /* End of next_token */
+
+/***----------------------------------------------------------------
+***
+*** End of Engine Functions
+***
+***----------------------------------------------------------------*/
+
+
+
+/***----------------------------------------------------------------
+***
+*** Start of Symbol Arena
+***
+***----------------------------------------------------------------*/
+
+/***----------------------------------------------------------------
+***
+*** Routine: CSymbolArena::CSymbolArena
+***
+*** Parameters:
+*** Action  Name                      Type            Use
+*** ------  ----                      ----            ---
+*** I       block_size                size_t          Default block size
+***
+*** Description:
+*** ============
+*** No memory is taken until the first allocation.
+***
+***----------------------------------------------------------------*/
+CSymbolArena::CSymbolArena (size_t block_size)
+   : m_blockSize (block_size), m_pFirst (NULL), m_pCurrent (NULL)
+{
+}
+
+CSymbolArena::~CSymbolArena ()
+{
+   block* p_block = m_pFirst;
+   while (p_block != NULL)
+   {
+      block* p_next = p_block->p_next;
+      free (p_block);
+      p_block = p_next;
+   }
+}
+
+/***----------------------------------------------------------------
+***
+*** Routine: CSymbolArena::new_block
+***
+*** Allocates a block of at least size bytes of data.
+***
+***----------------------------------------------------------------*/
+CSymbolArena::block* CSymbolArena::new_block (size_t size)
+{
+   const size_t data_size = (size > m_blockSize) ? size : m_blockSize;
+   block* p_block = static_cast<block*>(malloc (sizeof(block) + data_size));
+
+   if (p_block == NULL)
+   {
+      throw "Out of memory in symbol arena";
+   }
+   p_block->p_next = NULL;
+   p_block->m_size = data_size;
+   p_block->m_used = 0;
+   return p_block;
+}
+
+/***----------------------------------------------------------------
+***
+*** Routine: CSymbolArena::allocate
+***
+*** Parameters:
+*** Action  Name                      Type            Use
+*** ------  ----                      ----            ---
+*** I       size                      size_t          Number of bytes
+***
+*** Return value:
+*** void *          Pointer aligned for any type, valid until reset
+***
+*** Description:
+*** ============
+*** Bumps the cursor of the current block. Blocks kept from before the
+*** last reset are reused in order, a new block is only taken when none
+*** of them has room.
+***
+***----------------------------------------------------------------*/
+void* CSymbolArena::allocate (size_t size)
+{
+   const size_t align = alignof(std::max_align_t);
+   size = (size + align - 1) & ~(align - 1);
+
+   while (m_pCurrent != NULL && m_pCurrent->m_used + size > m_pCurrent->m_size)
+   {
+      if (m_pCurrent->p_next == NULL)
+      {
+         m_pCurrent->p_next = new_block (size);
+      }
+      m_pCurrent = m_pCurrent->p_next;
+   }
+   if (m_pCurrent == NULL)
+   {
+      m_pFirst = new_block (size);
+      m_pCurrent = m_pFirst;
+   }
+
+   void* p_data = block_data (m_pCurrent) + m_pCurrent->m_used;
+   m_pCurrent->m_used += size;
+   return p_data;
+}
+
+/***----------------------------------------------------------------
+***
+*** Routine: CSymbolArena::intern
+***
+*** Copies a null terminated string into the arena and returns a view
+*** of it. The copy is still null terminated. NULL gives an empty view.
+***
+***----------------------------------------------------------------*/
+std::string_view CSymbolArena::intern (const char* text)
+{
+   if (text == NULL)
+   {
+      return std::string_view();
+   }
+
+   const size_t length = strlen (text);
+   char* p_copy = static_cast<char*>(allocate (length + 1));
+   memcpy (p_copy, text, length + 1);
+   return std::string_view (p_copy, length);
+}
+
+/***----------------------------------------------------------------
+***
+*** Routine: CSymbolArena::intern
+***
+*** Copies a view into the arena, null terminated.
+***
+***----------------------------------------------------------------*/
+std::string_view CSymbolArena::intern (std::string_view text)
+{
+   char* p_copy = static_cast<char*>(allocate (text.size() + 1));
+   memcpy (p_copy, text.data(), text.size());
+   p_copy[text.size()] = '\0';
+   return std::string_view (p_copy, text.size());
+}
+
+/***----------------------------------------------------------------
+***
+*** Routine: CSymbolArena::format
+***
+*** printf style formatting into the arena, the result is not limited
+*** in length.
+***
+***----------------------------------------------------------------*/
+std::string_view CSymbolArena::format (const char* fmt, ...)
+{
+   va_list args;
+   va_list args_copy;
+
+   va_start (args, fmt);
+   va_copy (args_copy, args);
+   const int length = vsnprintf (NULL, 0, fmt, args);
+   va_end (args);
+
+   if (length < 0)
+   {
+      va_end (args_copy);
+      return std::string_view();
+   }
+
+   char* p_text = static_cast<char*>(allocate (length + 1));
+   vsnprintf (p_text, length + 1, fmt, args_copy);
+   va_end (args_copy);
+   return std::string_view (p_text, length);
+}
+
+/***----------------------------------------------------------------
+***
+*** Routine: CSymbolArena::reset
+***
+*** Releases everything allocated, keeping the blocks for reuse.
+***
+***----------------------------------------------------------------*/
+void CSymbolArena::reset ()
+{
+   for (block* p_block = m_pFirst; p_block != NULL; p_block = p_block->p_next)
+   {
+      p_block->m_used = 0;
+   }
+   m_pCurrent = m_pFirst;
+}
+
+/***----------------------------------------------------------------
+***
+*** End of Symbol Arena
+***
+***----------------------------------------------------------------*/
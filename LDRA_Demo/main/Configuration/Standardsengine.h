@@ -0,0 +1,291 @@
+/***-------------------------------------------------------------------------------------------------------------
+***
+*** File: Standardsengine.h
+***
+*** Public interface of the standards rule engine.
+***
+*** The engine holds the H (Hungarian Notation) and Z (User Defined) standards
+*** used by Userstandards_combined.exe, without any dependency on the TBglhapi,
+*** the SIF files or the file system. It checks a source held in memory, plus
+*** an optional table of symbols, and returns the violations as structures.
+***
+*** It is built as a static library (libstandardsengine.a, see makefile) so that
+*** other tools, such as editor plugins or review bots, can run the checks
+*** in-process:
+***
+***     CStandardsChecker checker;
+***     struct check_request request;
+***     request.source_name = "C:\\Work\\Src\\program.c";
+***     request.source = std::string_view(buffer, length);
+***     const struct check_result& result = checker.check(request);
+***
+*** Line numbers of H violations are those of the symbol table (reformatted
+*** code lines when loaded from a GLH). Line numbers of Z violations are raw
+*** source lines, 0 for the file as a whole.
+***
+*** Includes are resolved (11 Z) through a CIncludeResolver given by the
+*** caller, the only part of a check which may list a directory.
+***
+*** Banned functions and macros (16 Z) are those of a CBannedList given by
+*** the caller, matched as whole identifiers outside comments and strings.
+***
+*** Suppression comments (see Suppressions.h) are collected as the lines are
+*** scanned and returned with the violations, which are not filtered: the
+*** caller decides what a suppression covers, as H violations are on
+*** reformatted lines and the suppressions on source lines.
+***
+*** A check may be limited to the lines changed by a patch, see line_range.
+*** Only those lines of the source are scanned (plus the lines before them the
+*** layout template needs) and only violations on them are returned.
+***
+***-------------------------------------------------------------------------------------------------------------*/
+#ifndef STANDARDSENGINE_H
+#define STANDARDSENGINE_H
+
+#include <cstddef>
+#include <memory>
+#include <string_view>
+#include <vector>
+#include "Bannedlist.h"
+#include "Includeresolver.h"
+#include "Suppressions.h"
+
+
+/*
+ * Macros
+ */
+#define HSTANDARD 'H'
+#define ZSTANDARD 'Z'
+#define ARENA_BLOCK_SIZE 65536 /* Default size of a symbol arena block */
+
+/* Rule selection, bit n enables standard n */
+#define RULE_BIT(n)        (1u << (n))
+#define ALL_RULES          0xFFFFFFFFu
+#define DEFAULT_H_RULES    (ALL_RULES & ~RULE_BIT(10)) /* 10 H is not enabled by default */
+#define DEFAULT_Z_RULES    ALL_RULES
+
+/* Symbol flags */
+#define SYM_STATIC    0x01 /* Static global variable or static linkage function */
+#define SYM_POINTER   0x02 /* Pointer parameter */
+#define SYM_MAIN      0x04 /* Function is main */
+#define SYM_LANG_C    0x08 /* Function is declared in a C source */
+
+/*
+ * Enumeration
+ */
+typedef enum { SymGlobalVar, SymClassMember, SymEnumName, SymEnumElement,
+               SymClass, SymNamespace, SymParameter, SymFunction } Symbol_e;
+
+
+/*
+ * class CSymbolArena
+ * Bump allocator holding the per-file symbol data. All names loaded from
+ * the GLH API are stored here once, and the rules only ever see views of
+ * them. The arena is reset (not freed) between files, so once the blocks
+ * have grown to fit the largest file no further allocation takes place.
+ */
+class CSymbolArena
+{
+public:
+   explicit CSymbolArena (size_t block_size = ARENA_BLOCK_SIZE);
+   ~CSymbolArena ();
+
+   void* allocate (size_t size);
+   std::string_view intern (const char* text);
+   std::string_view intern (std::string_view text);
+   std::string_view format (const char* fmt, ...);
+   void reset ();
+
+private:
+   /* Padded so the data after the header is aligned for any type */
+   struct alignas(std::max_align_t) block
+   {
+      block* p_next;
+      size_t m_size;
+      size_t m_used;
+   };
+
+   block* new_block (size_t size);
+   char* block_data (block* p_block) { return reinterpret_cast<char*>(p_block + 1); }
+
+   size_t m_blockSize;
+   block* m_pFirst;
+   block* m_pCurrent;
+
+   CSymbolArena (const CSymbolArena&);
+   CSymbolArena& operator= (const CSymbolArena&);
+};
+
+/*
+ * struct symbol_entry
+ * A single symbol of the file being checked.
+ */
+struct symbol_entry
+{
+   Symbol_e kind;
+   std::string_view name;     /* Symbol name, held in the arena */
+   std::string_view stem;     /* Declarative stem for functions, empty otherwise */
+   int line;                  /* Reformatted line number, -1 if not known */
+   unsigned int flags;        /* SYM_ flags */
+};
+
+/*
+ * struct symbol_table
+ * Per-file symbol data used by the H rules.
+ * Enum elements must directly follow their enum name.
+ */
+struct symbol_table
+{
+   std::vector<symbol_entry> entries;
+   CSymbolArena arena;
+};
+
+/*
+ * struct line_range
+ * Lines first to last inclusive. Lists of ranges given to the checker
+ * must be sorted and not overlap, see merge_line_ranges.
+ */
+struct line_range
+{
+   int first;
+   int last;
+};
+
+/*
+ * struct metric_limits
+ * Limits for the procedure metrics, 7 Z to 10 Z. 0 does not check.
+ */
+struct metric_limits
+{
+   int max_cyclomatic = 0;           /* 7 Z */
+   int max_executable_lines = 0;     /* 8 Z */
+   int min_header_comments = 0;      /* 9 Z */
+   int min_comments = 0;             /* 9 Z, in the header and body */
+   int max_parameters = 0;           /* 10 Z */
+};
+
+/*
+ * struct procedure_metrics
+ * Metrics of a procedure defined in the source, see scan_procedures.
+ */
+struct procedure_metrics
+{
+   std::string_view name;
+   int line;                  /* Source line of the name */
+   int end_line;              /* Source line of the closing brace */
+   int cyclomatic;
+   int executable_lines;
+   int comments;              /* In the body */
+   int header_comments;       /* Before the procedure */
+   int parameters;
+};
+
+/*
+ * struct check_request
+ * What to check. The source and symbols are only read during check().
+ */
+struct check_request
+{
+   const char* source_name = "";                 /* Full source file name */
+   std::string_view source;                      /* Source text */
+   const struct symbol_table* symbols = NULL;    /* NULL to skip the H Standards */
+   unsigned int h_rules = DEFAULT_H_RULES;       /* RULE_BIT(n) enables n H */
+   unsigned int z_rules = DEFAULT_Z_RULES;       /* RULE_BIT(n) enables n Z */
+   bool report = false;                          /* Collect the .naming report lines */
+   const std::vector<line_range>* source_lines = NULL; /* Source lines to check, NULL for all */
+   const std::vector<line_range>* symbol_lines = NULL; /* Symbol lines to report, NULL for all */
+   unsigned int scan_threads = 0;                /* Threads for large sources, 0 for one per core */
+   const struct metric_limits* metrics = NULL;   /* NULL to skip the procedure metrics */
+   const CIncludeResolver* includes = NULL;      /* NULL to skip resolving the includes */
+   const CBannedList* banned = NULL;             /* NULL to skip the banned identifiers */
+};
+
+/*
+ * struct violation_info
+ * A single standards violation, the information needed for a 101 record.
+ */
+struct violation_info
+{
+   char std_letter;           /* HSTANDARD or ZSTANDARD */
+   int std_num;               /* Must match <n> H/Z in <lang>pen.dat */
+   int line;                  /* See line numbers in the File header, 0 for the file */
+   std::string_view text;     /* Text for the 101 record */
+};
+
+/*
+ * struct report_entry
+ * A line of the .naming report.
+ */
+struct report_entry
+{
+   int line;
+   std::string_view text;
+};
+
+/*
+ * struct include_entry
+ * An include of the source, when the request has a resolver.
+ */
+struct include_entry
+{
+   int line;
+   std::string_view name;     /* Between "" or <> */
+   std::string_view path;     /* Full file name, held by the resolver, empty if not found */
+   Include_e status;
+};
+
+/*
+ * struct check_result
+ * Text views refer to the checker or to the request's symbol table and
+ * remain valid until the next check() or until the symbol table is reset.
+ */
+struct check_result
+{
+   std::vector<violation_info> violations;
+   std::vector<report_entry> report;
+   std::vector<include_entry> includes;     /* Of the lines scanned, in line order */
+   std::vector<suppression> suppressions;   /* Of the lines scanned, each BEGIN joined to its END */
+};
+
+
+struct check_state;
+
+/*
+ * class CStandardsChecker
+ * Runs the H and Z standards. One checker may be reused for any number of
+ * files, its memory is kept between calls. A checker must not be shared
+ * between threads, use one per thread instead.
+ * Very large sources are scanned on several threads by the checker itself,
+ * so programs using the library must be linked with -pthread.
+ */
+class CStandardsChecker
+{
+public:
+   CStandardsChecker ();
+   ~CStandardsChecker ();
+
+   const struct check_result& check (const struct check_request& request);
+
+private:
+   void scan_parallel (struct check_state* state, unsigned int threads);
+
+   CSymbolArena m_arena;
+   struct check_result m_result;
+   std::vector<std::unique_ptr<CSymbolArena> > m_chunkArenas;  /* One per chunk of a large source */
+   std::vector<struct check_result> m_chunkResults;
+
+   CStandardsChecker (const CStandardsChecker&);
+   CStandardsChecker& operator= (const CStandardsChecker&);
+};
+
+
+/* Name of a file without path or extension */
+std::string_view file_stem (std::string_view file_name);
+
+/* Sort line ranges and join those that overlap or touch */
+void merge_line_ranges (std::vector<line_range>* ranges);
+
+/* Procedures defined in the source, with their metrics */
+void scan_procedures (std::string_view source, std::vector<procedure_metrics>* procedures);
+
+#endif /* STANDARDSENGINE_H */
@@ -0,0 +1,80 @@
+/***-------------------------------------------------------------------------------------------------------------
+***
+*** File: Stdbaseline.cpp
+***
+*** Writes the baseline of accepted violations (see Baseline.h and Baseline
+*** in Combinedstandards.cpp) from the fingerprints the generator recorded.
+***
+***     Stdbaseline.exe <record> [<record> ...] <baseline>
+***
+*** Each record holds a fingerprint in hex per line, as written to the file
+*** STDCHK_BASELINE_RECORD names. The fingerprints of all the records are
+*** sorted and written once each to the baseline, replacing it.
+***
+*** Returns 0, or 1 if a record cannot be read or the baseline written.
+***
+***-------------------------------------------------------------------------------------------------------------*/
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "Baseline.h"
+
+
+/*
+ * Macros
+ */
+#define MAX_RECORD_LINE 64
+
+
+
+/***----------------------------------------------------------------
+***
+*** Routine: main
+***
+*** Return value:
+*** int             0 on success, 1 on failure
+***
+***----------------------------------------------------------------*/
+int main (int argc, char* argv[])
+{
+   std::vector<uint64_t> fingerprints;
+   std::string error;
+   char line[MAX_RECORD_LINE];
+
+   if (argc < 3)
+   {
+      printf("Arguments are: <record> [<record> ...] <baseline>\n");
+      return 1;
+   }
+
+   for (int arg = 1; arg < argc - 1; arg++)
+   {
+      FILE* fp = fopen(argv[arg], "r");
+
+      if (fp == NULL)
+      {
+         printf("Unable to read baseline record %s\n", argv[arg]);
+         return 1;
+      }
+      while (fgets(line, sizeof(line), fp) != NULL)
+      {
+         char* end = NULL;
+         const uint64_t fingerprint = strtoull(line, &end, 16);
+
+         if (end != line)
+         {
+            fingerprints.push_back(fingerprint);
+         }
+      }
+      fclose(fp);
+   }
+
+   if (!write_baseline(&fingerprints, argv[argc - 1], &error))
+   {
+      printf("%s\n", error.c_str());
+      return 1;
+   }
+
+   printf("%s: %u violations\n", argv[argc - 1], (unsigned) fingerprints.size());
+   return 0;
+} /* End of main */
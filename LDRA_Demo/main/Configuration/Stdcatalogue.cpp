@@ -0,0 +1,497 @@
+/***-------------------------------------------------------------------------------------------------------------
+***
+*** File: Stdcatalogue.cpp
+***
+*** Reads <lang>pen.dat and <lang>report.dat into a standards_catalogue,
+*** see Stdcatalogue.h.
+***
+***-------------------------------------------------------------------------------------------------------------*/
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "Stdcatalogue.h"
+
+
+/*
+ * Macros
+ */
+#define PEN_TEXT_COLUMN   23   /* Standard text, 60 characters */
+#define PEN_TEXT_WIDTH    60
+#define PEN_REF_COLUMN    83   /* External references, <standard> <id,id...> pairs */
+
+
+/*
+ * Prototypes
+ */
+static bool read_lines (const char* file_name, std::vector<std::string>* lines);
+
+static bool parse_pen_line (const std::string& line, struct catalogue_standard* standard);
+
+static void parse_model_entry (struct standards_catalogue* catalogue,
+                               struct catalogue_standard* standard,
+                               const std::string& entry);
+
+static std::string trim (const std::string& text);
+
+
+
+/***----------------------------------------------------------------
+***
+*** Routine: load_catalogue
+***
+*** Parameters:
+*** ===========
+***
+*** Action  Name                      Type                           Use
+*** ------  ----                      ----                           ---
+*** I       pen_file                  const char *                   <lang>pen.dat
+*** I       report_file               const char *                   <lang>report.dat
+*** O       catalogue                 struct standards_catalogue *   Catalogue read
+*** O       error                     std::string *                  Reason for failure
+***
+*** Return value:
+*** bool            false if either file cannot be read or is not valid
+***
+*** Description:
+*** ============
+***
+*** The pen file has a count line, then one fixed width line per standard.
+*** The report file has four sections, see its header:
+***   one   - model names and "<model>:<M/C/O/I>:<description>" strings, to -1
+***   two   - "<n> <letter> <class>" then the quoted model entries
+***   three - parameters 1001 and 1002, to 2000
+***   four  - excluded header files, to -1
+***
+***----------------------------------------------------------------*/
+bool load_catalogue (const char* pen_file, const char* report_file,
+                     struct standards_catalogue* catalogue, std::string* error)
+{
+   std::vector<std::string> lines;
+   int section = 1;
+
+   catalogue->models.clear();
+   catalogue->standards.clear();
+   catalogue->excluded_headers.clear();
+   catalogue->procedure_comment_lines = 0;
+   catalogue->comment_ratio = 0.0;
+
+   /* Pen file */
+   if (!read_lines(pen_file, &lines) || lines.empty())
+   {
+      *error = std::string("Unable to read ") + pen_file;
+      return false;
+   }
+
+   const int expected = atoi(lines[0].c_str());
+   for (size_t index = 1; index < lines.size(); index++)
+   {
+      struct catalogue_standard standard;
+
+      if (trim(lines[index]).empty())
+      {
+         continue;
+      }
+      if (!parse_pen_line(lines[index], &standard))
+      {
+         char message[64];
+         sprintf(message, ": line %d is not valid", (int) index + 1);
+         *error = pen_file + std::string(message);
+         return false;
+      }
+      catalogue->standards.push_back(standard);
+   }
+   if ((int) catalogue->standards.size() != expected)
+   {
+      *error = std::string(pen_file) + ": count on the first line does not match the standards";
+      return false;
+   }
+
+   /* Report file */
+   if (!read_lines(report_file, &lines))
+   {
+      *error = std::string("Unable to read ") + report_file;
+      return false;
+   }
+
+   for (const std::string& line : lines)
+   {
+      const std::string data = trim(line);
+
+      /* Comments must start in the first column */
+      if (line.empty() || line[0] == '#' || data.empty())
+      {
+         continue;
+      }
+
+      if (section == 1)
+      {
+         if (data == "-1")
+         {
+            section = 2;
+         }
+         else if (data.size() > 2 && data[0] == '"' && data.back() == '"')
+         {
+            const std::string entry = data.substr(1, data.size() - 2);
+            int model = -1;
+            size_t model_length = 0;
+
+            /* "<model>:<M/C/O/I>:<description>", the model name may itself hold ':' */
+            for (size_t index = 0; index < catalogue->models.size(); index++)
+            {
+               const std::string& name = catalogue->models[index].name;
+               if (entry.size() > name.size() + 3 && entry.compare(0, name.size(), name) == 0
+                   && entry[name.size()] == ':' && strchr(CLASS_LETTERS, entry[name.size() + 1])
+                   && entry[name.size() + 2] == ':' && name.size() > model_length)
+               {
+                  model = (int) index;
+                  model_length = name.size();
+               }
+            }
+
+            if (model >= 0)
+            {
+               catalogue->models[model].class_names[CLASS_INDEX(entry[model_length + 1])] =
+                  entry.substr(model_length + 3);
+            }
+            else
+            {
+               struct catalogue_model new_model;
+               new_model.name = entry;
+               catalogue->models.push_back(new_model);
+            }
+         }
+      }
+      else if (section == 2)
+      {
+         int number = 0;
+         char letter = '\0';
+         char std_class = '\0';
+         int consumed = 0;
+
+         if (sscanf(data.c_str(), "%d %c %c%n", &number, &letter, &std_class, &consumed) == 3
+             && isalpha((unsigned char) letter))
+         {
+            const int found = find_standard(catalogue, number, letter);
+            if (found < 0)
+            {
+               *error = std::string(report_file) + ": no standard in the pen file for " + data;
+               return false;
+            }
+
+            struct catalogue_standard* standard = &catalogue->standards[found];
+            standard->in_report = true;
+            standard->default_class = std_class;
+
+            /* Quoted model entries */
+            const char* next = data.c_str() + consumed;
+            while ((next = strchr(next, '"')) != NULL)
+            {
+               const char* end = strchr(next + 1, '"');
+               if (end == NULL)
+               {
+                  break;
+               }
+               parse_model_entry(catalogue, standard, std::string(next + 1, end - next - 1));
+               next = end + 1;
+            }
+         }
+         else
+         {
+            section = 3;
+         }
+      }
+
+      if (section == 3)
+      {
+         int type = atoi(data.c_str());
+         const char* value = strchr(data.c_str(), ' ');
+
+         if (type == 1001 && value != NULL)
+         {
+            catalogue->procedure_comment_lines = atoi(value);
+         }
+         else if (type == 1002 && value != NULL)
+         {
+            catalogue->comment_ratio = atof(value);
+         }
+         else if (type == 2000)
+         {
+            section = 4;
+         }
+      }
+      else if (section == 4)
+      {
+         if (data == "-1")
+         {
+            break;
+         }
+         if (data.size() > 2 && data[0] == '"' && data.back() == '"')
+         {
+            catalogue->excluded_headers.push_back(data.substr(1, data.size() - 2));
+         }
+      }
+   }
+
+   return true;
+} /* End of load_catalogue */
+
+/***----------------------------------------------------------------
+***
+*** Routine: parse_pen_line
+***
+*** Parameters:
+*** ===========
+***
+*** Action  Name                      Type                           Use
+*** ------  ----                      ----                           ---
+*** I       line                      const std::string &            Line of the pen file
+*** O       standard                  struct catalogue_standard *    Standard read
+***
+*** Return value:
+*** bool            false if the line is not valid
+***
+*** Description:
+*** ============
+***
+***  "  835 00 1    0    1 Z File exceeds required size.      <refs>"
+***  index group applicable limit number letter text(60) references
+***
+***----------------------------------------------------------------*/
+static bool parse_pen_line (const std::string& line, struct catalogue_standard* standard)
+{
+   int applicable = 0;
+
+   if (sscanf(line.c_str(), "%d %d %d %d %d %c", &standard->pen_index, &standard->group,
+              &applicable, &standard->limit, &standard->number, &standard->letter) != 6
+       ||
+       line.size() < PEN_TEXT_COLUMN)
+   {
+      return false;
+   }
+
+   standard->applicable = (applicable != 0);
+   if (standard->limit == 0)
+   {
+      standard->limit = NO_LIMIT;
+   }
+   standard->text = trim(line.substr(PEN_TEXT_COLUMN, PEN_TEXT_WIDTH));
+   standard->in_report = false;
+   standard->default_class = ' ';
+
+   /* <standard> <id>[,<id>...] pairs */
+   if (line.size() > PEN_REF_COLUMN)
+   {
+      std::vector<std::string> tokens;
+      const std::string references = line.substr(PEN_REF_COLUMN);
+      size_t pos = 0;
+
+      while ((pos = references.find_first_not_of(' ', pos)) != std::string::npos)
+      {
+         size_t end = references.find(' ', pos);
+         tokens.push_back(references.substr(pos, end - pos));
+         pos = end;
+      }
+
+      for (size_t token = 0; token + 1 < tokens.size(); token += 2)
+      {
+         const std::string& ids = tokens[token + 1];
+         for (size_t start = 0; start <= ids.size(); )
+         {
+            size_t comma = ids.find(',', start);
+            if (comma == std::string::npos)
+            {
+               comma = ids.size();
+            }
+            if (comma > start)
+            {
+               standard->references.push_back(tokens[token] + " " + ids.substr(start, comma - start));
+            }
+            start = comma + 1;
+         }
+      }
+   }
+
+   return true;
+} /* End of parse_pen_line */
+
+/***----------------------------------------------------------------
+***
+*** Routine: parse_model_entry
+***
+*** Parameters:
+*** ===========
+***
+*** Action  Name                      Type                           Use
+*** ------  ----                      ----                           ---
+*** IO      catalogue                 struct standards_catalogue *   Catalogue
+*** IO      standard                  struct catalogue_standard *    Standard of the entry
+*** I       entry                     const std::string &            Entry, without quotes
+***
+*** Description:
+*** ============
+***
+*** "<model>[:<M/C/O/I>][:<limit>|:<modifier>]", and the two special
+*** entries "PDTMCSFVA:<digits>" and "K:<keyword>". Entries for models
+*** not in section one are ignored, as they are by the report writer.
+***
+***----------------------------------------------------------------*/
+static void parse_model_entry (struct standards_catalogue* catalogue,
+                               struct catalogue_standard* standard,
+                               const std::string& entry)
+{
+   int model = -1;
+   size_t model_length = 0;
+
+   if (entry.compare(0, 10, "PDTMCSFVA:") == 0)
+   {
+      standard->pdtmcsfva = entry.substr(10);
+      return;
+   }
+   if (entry.compare(0, 2, "K:") == 0)
+   {
+      standard->keyword = entry.substr(2);
+      return;
+   }
+
+   /* Longest model name the entry starts with, "MISRA" and "MISRA-C:2004" */
+   for (size_t index = 0; index < catalogue->models.size(); index++)
+   {
+      const std::string& name = catalogue->models[index].name;
+      if (entry.compare(0, name.size(), name) == 0
+          && (entry.size() == name.size() || entry[name.size()] == ':')
+          && name.size() > model_length)
+      {
+         model = (int) index;
+         model_length = name.size();
+      }
+   }
+   if (model < 0)
+   {
+      return;
+   }
+
+   struct model_setting setting;
+   setting.model = model;
+   setting.std_class = standard->default_class;
+   setting.limit = NO_LIMIT;
+
+   size_t pos = model_length;
+   while (pos < entry.size())
+   {
+      size_t end = entry.find(':', pos + 1);
+      const std::string part = entry.substr(pos + 1, (end == std::string::npos) ? std::string::npos
+                                                                                 : end - pos - 1);
+      if (part.size() == 1 && strchr(CLASS_LETTERS, part[0]) != NULL)
+      {
+         setting.std_class = part[0];
+      }
+      else if (!part.empty() && strspn(part.c_str(), "0123456789") == part.size())
+      {
+         setting.limit = atoi(part.c_str());
+      }
+      else
+      {
+         setting.modifier = part;
+      }
+      pos = (end == std::string::npos) ? entry.size() : end;
+   }
+
+   standard->models.push_back(setting);
+} /* End of parse_model_entry */
+
+/***----------------------------------------------------------------
+***
+*** Routine: find_standard
+*** Index of the standard <number> <letter>, -1 if none. The letter is
+*** matched either case, as the pen file has 's' for standards reported
+*** on source lines where the report file has 'S'.
+***
+***----------------------------------------------------------------*/
+int find_standard (const struct standards_catalogue* catalogue, int number, char letter)
+{
+   for (size_t index = 0; index < catalogue->standards.size(); index++)
+   {
+      const struct catalogue_standard& standard = catalogue->standards[index];
+      if (standard.number == number && toupper(standard.letter) == toupper(letter))
+      {
+         return (int) index;
+      }
+   }
+   return -1;
+} /* End of find_standard */
+
+/***----------------------------------------------------------------
+***
+*** Routine: find_model
+*** Index of the model, -1 if none
+***
+***----------------------------------------------------------------*/
+int find_model (const struct standards_catalogue* catalogue, const std::string& name)
+{
+   for (size_t index = 0; index < catalogue->models.size(); index++)
+   {
+      if (catalogue->models[index].name == name)
+      {
+         return (int) index;
+      }
+   }
+   return -1;
+} /* End of find_model */
+
+/***----------------------------------------------------------------
+***
+*** Routine: read_lines
+*** Reads a text file as lines, without line ends
+***
+***----------------------------------------------------------------*/
+static bool read_lines (const char* file_name, std::vector<std::string>* lines)
+{
+   FILE* fp = fopen(file_name, "rb");
+   char buffer[4096];
+   std::string line;
+
+   lines->clear();
+   if (fp == NULL)
+   {
+      return false;
+   }
+
+   while (fgets(buffer, sizeof(buffer), fp) != NULL)
+   {
+      line += buffer;
+      if (!line.empty() && line.back() == '\n')
+      {
+         line.pop_back();
+         if (!line.empty() && line.back() == '\r')
+         {
+            line.pop_back();
+         }
+         lines->push_back(line);
+         line.clear();
+      }
+   }
+   if (!line.empty())
+   {
+      lines->push_back(line);
+   }
+
+   fclose(fp);
+   return true;
+} /* End of read_lines */
+
+/***----------------------------------------------------------------
+***
+*** Routine: trim
+*** Text without leading and trailing white space
+***
+***----------------------------------------------------------------*/
+static std::string trim (const std::string& text)
+{
+   const size_t first = text.find_first_not_of(" \t");
+   if (first == std::string::npos)
+   {
+      return std::string();
+   }
+   return text.substr(first, text.find_last_not_of(" \t") - first + 1);
+} /* End of trim */
@@ -0,0 +1,101 @@
+/***-------------------------------------------------------------------------------------------------------------
+***
+*** File: Stdcatalogue.h
+***
+*** The standards catalogue: the standards of <lang>pen.dat with their settings
+*** in each Programming Standards Model of <lang>report.dat, read into memory.
+***
+*** Used by the standards table compiler (Stdtablegen.cpp) and the catalogue
+*** query tool. Like the rule engine it has no dependency on the TBglhapi.
+***
+***     struct standards_catalogue catalogue;
+***     std::string error;
+***     if (!load_catalogue("Cpen.dat", "Creport.dat", &catalogue, &error)) ...
+***
+***-------------------------------------------------------------------------------------------------------------*/
+#ifndef STDCATALOGUE_H
+#define STDCATALOGUE_H
+
+#include <string>
+#include <vector>
+
+
+/*
+ * Macros
+ */
+#define NO_LIMIT      (-1)   /* Standard or model setting without a *** value */
+#define CLASS_COUNT   4      /* M, C, O and I */
+
+/* M/C/O/I classification, as an index */
+#define CLASS_INDEX(c) ((c) == 'M' ? 0 : (c) == 'C' ? 1 : (c) == 'O' ? 2 : 3)
+static const char CLASS_LETTERS[CLASS_COUNT + 1] = "MCOI";
+
+
+/*
+ * struct model_setting
+ * A standard's entry for one model in section two of <lang>report.dat,
+ * e.g. "EADS:C:1000" or "MISRA:M:tbend F".
+ */
+struct model_setting
+{
+   int model;                 /* Index in standards_catalogue::models */
+   char std_class;            /* M, C, O or I */
+   int limit;                 /* *** value for the model, NO_LIMIT if not changed */
+   std::string modifier;      /* vals/tbend modifier, empty if none */
+};
+
+/*
+ * struct catalogue_standard
+ * A line of <lang>pen.dat, with its section two entry of <lang>report.dat.
+ */
+struct catalogue_standard
+{
+   int pen_index;             /* First column of the pen file, 1 to n */
+   int group;                 /* Second column of the pen file */
+   bool applicable;           /* Third column, 0 for standards not used for the language */
+   int limit;                 /* Default *** value, NO_LIMIT if 0 */
+   int number;                /* <n> of <n> <letter> */
+   char letter;               /* Phase letter, S D C ... Z H, lower case for source lines */
+   std::string text;
+   std::vector<std::string> references;   /* External ids, e.g. "MISRA-C:2012 R.15.6" */
+   bool in_report;            /* Has a section two entry */
+   char default_class;        /* M, C, O or I, ' ' if not in the report file */
+   std::string pdtmcsfva;     /* "PDTMCSFVA:" digits */
+   std::string keyword;       /* "K:" tag, e.g. loop */
+   std::vector<model_setting> models;
+};
+
+/*
+ * struct catalogue_model
+ * A Programming Standards Model of section one of <lang>report.dat.
+ */
+struct catalogue_model
+{
+   std::string name;
+   std::string class_names[CLASS_COUNT];  /* User descriptions of M/C/O/I, empty if none */
+};
+
+/*
+ * struct standards_catalogue
+ */
+struct standards_catalogue
+{
+   std::vector<catalogue_model> models;
+   std::vector<catalogue_standard> standards;   /* In pen file order */
+   int procedure_comment_lines;                 /* Section three type 1001 */
+   double comment_ratio;                        /* Section three type 1002 */
+   std::vector<std::string> excluded_headers;   /* Section four */
+};
+
+
+/* Read <lang>pen.dat and <lang>report.dat */
+bool load_catalogue (const char* pen_file, const char* report_file,
+                     struct standards_catalogue* catalogue, std::string* error);
+
+/* Index of the standard <number> <letter>, -1 if none */
+int find_standard (const struct standards_catalogue* catalogue, int number, char letter);
+
+/* Index of the model, -1 if none */
+int find_model (const struct standards_catalogue* catalogue, const std::string& name);
+
+#endif /* STDCATALOGUE_H */
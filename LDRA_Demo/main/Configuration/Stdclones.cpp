@@ -0,0 +1,158 @@
+/***-------------------------------------------------------------------------------------------------------------
+***
+*** File: Stdclones.cpp
+***
+*** Duplicated code of a whole set of sources, the check of 15 Z (see
+*** Clonedetect.h and Duplicated Code in Combinedstandards.cpp) in one pass.
+***
+***     Stdclones.exe [-t <tokens>] [-j <threads>] <source list>|-
+***
+*** The source list holds one full file name per line, - reads it from stdin.
+*** The sources are fingerprinted on -j threads (one per core by default)
+*** and the fingerprints joined, each thread taking a partition of the
+*** hashes. Each duplicate of at least -t tokens (100 by default) is one tab
+*** separated line:
+***     <tokens> <file>:<first line>-<last line> <other file>:<first line>-<last line>
+***
+*** Returns 0, or 1 if the source list cannot be read.
+***
+***-------------------------------------------------------------------------------------------------------------*/
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <sys/stat.h>
+#include <thread>
+#include <vector>
+#include "Clonedetect.h"
+
+
+/*
+ * Macros
+ */
+#define DEFAULT_MIN_TOKENS 100
+#define MAX_FILE_NAME 1024
+
+
+
+/***----------------------------------------------------------------
+***
+*** Routine: main
+***
+*** Return value:
+*** int             0, 1 if the source list cannot be read
+***
+***----------------------------------------------------------------*/
+int main (int argc, char* argv[])
+{
+   int min_tokens = DEFAULT_MIN_TOKENS;
+   unsigned int threads = 0;
+   std::vector<std::string> sources;
+   char line[MAX_FILE_NAME];
+   int arg = 1;
+
+   while (arg + 1 < argc && argv[arg][0] == '-' && argv[arg][1] != '\0')
+   {
+      if (strcmp(argv[arg], "-t") == 0)
+      {
+         min_tokens = atoi(argv[arg + 1]);
+      }
+      else if (strcmp(argv[arg], "-j") == 0)
+      {
+         threads = (unsigned int) atoi(argv[arg + 1]);
+      }
+      else
+      {
+         break;
+      }
+      arg += 2;
+   }
+   if (argc - arg != 1)
+   {
+      printf("Arguments are: [-t <tokens>] [-j <threads>] <source list>|-\n");
+      return 1;
+   }
+
+   FILE* list = (strcmp(argv[arg], "-") == 0) ? stdin : fopen(argv[arg], "r");
+   if (list == NULL)
+   {
+      printf("Unable to read source list %s\n", argv[arg]);
+      return 1;
+   }
+   while (fgets(line, sizeof(line), list) != NULL)
+   {
+      line[strcspn(line, "\r\n")] = '\0';
+      if (line[0] != '\0')
+      {
+         sources.push_back(line);
+      }
+   }
+   if (list != stdin)
+   {
+      fclose(list);
+   }
+
+   if (threads == 0)
+   {
+      threads = std::max(1u, std::thread::hardware_concurrency());
+   }
+
+   /* Fingerprint the sources, each thread taking the next not yet done */
+   CCloneIndex index(min_tokens);
+   std::vector<std::vector<clone_fingerprint> > fingerprints(sources.size());
+   std::vector<time_t> mtimes(sources.size(), 0);
+   std::atomic<size_t> next(0);
+   std::vector<std::thread> workers;
+
+   for (unsigned int worker = 0; worker < threads; worker++)
+   {
+      workers.emplace_back([&sources, &fingerprints, &mtimes, &next, &index] {
+         std::string text;
+
+         for (size_t source = next++; source < sources.size(); source = next++)
+         {
+            FILE* fp = fopen(sources[source].c_str(), "rb");
+            struct stat status;
+            char buffer[65536];
+            size_t length;
+
+            if (fp == NULL)
+            {
+               continue;
+            }
+            text.clear();
+            while ((length = fread(buffer, 1, sizeof(buffer), fp)) > 0)
+            {
+               text.append(buffer, length);
+            }
+            fclose(fp);
+
+            mtimes[source] = (stat(sources[source].c_str(), &status) == 0) ? status.st_mtime : 0;
+            fingerprint_source(text, index.window(), &fingerprints[source]);
+         }
+      });
+   }
+   for (std::thread& worker : workers)
+   {
+      worker.join();
+   }
+
+   for (size_t source = 0; source < sources.size(); source++)
+   {
+      index.set_file(sources[source], mtimes[source], fingerprints[source]);
+   }
+
+   /* The join */
+   std::vector<clone_region> clones;
+   index.find_clones(-1, threads, &clones);
+
+   for (const struct clone_region& clone : clones)
+   {
+      printf("%d\t%s:%d-%d\t%s:%d-%d\n", clone.tokens,
+             index.file(clone.file).path.c_str(), clone.first_line, clone.last_line,
+             index.file(clone.other_file).path.c_str(), clone.other_first_line, clone.other_last_line);
+   }
+
+   return 0;
+} /* End of main */
@@ -0,0 +1,128 @@
+/***-------------------------------------------------------------------------------------------------------------
+***
+*** File: Stdincludes.cpp
+***
+*** Report of the include graph the generator caches, Includegraph.dat (see
+*** Includegraph.h and Include Graph in Combinedstandards.cpp).
+***
+***     Stdincludes.exe [-n <count>] <include graph>
+***
+*** Lists each include cycle of the set, then the compile time hotspots:
+*** the headers ranked by cost, the number of files including them (directly
+*** or through others) times the files each of those inclusions pulls in.
+*** Each hotspot is one tab separated line:
+***     <rank> <cost> <includers> <files pulled in> <full file name>
+*** -n gives the number of hotspots, 20 by default, 0 for all.
+***
+*** The graph is that of the last generator runs, files not checked since
+*** they changed are reported as they were.
+***
+*** Returns 0, or 1 if the graph cannot be read.
+***
+***-------------------------------------------------------------------------------------------------------------*/
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include "Includegraph.h"
+
+
+/*
+ * Macros
+ */
+#define DEFAULT_HOTSPOTS 20
+
+
+/*
+ * struct hotspot
+ */
+struct hotspot
+{
+   int node;
+   int includers;
+   int closure;
+   long long cost;
+};
+
+
+
+/***----------------------------------------------------------------
+***
+*** Routine: main
+***
+*** Return value:
+*** int             0, 1 if the graph cannot be read
+***
+***----------------------------------------------------------------*/
+int main (int argc, char* argv[])
+{
+   CIncludeGraph graph;
+   std::vector<struct hotspot> hotspots;
+   std::vector<bool> cycle_listed;
+   int count = DEFAULT_HOTSPOTS;
+   int arg = 1;
+
+   if (arg + 1 < argc && strcmp(argv[arg], "-n") == 0)
+   {
+      count = atoi(argv[arg + 1]);
+      arg += 2;
+   }
+   if (argc - arg != 1)
+   {
+      printf("Arguments are: [-n <count>] <include graph>\n");
+      return 1;
+   }
+   if (!graph.load(argv[arg]))
+   {
+      printf("Unable to read include graph %s\n", argv[arg]);
+      return 1;
+   }
+
+   graph.analyse(-1);
+
+   /* Cycles */
+   cycle_listed.assign(graph.node_count(), false);
+   for (int node = 0; node < graph.node_count(); node++)
+   {
+      if (graph.in_cycle(node) && !cycle_listed[graph.component(node)])
+      {
+         cycle_listed[graph.component(node)] = true;
+         printf("Cycle:");
+         for (int member : graph.component_members(node))
+         {
+            printf(" %s", graph.node(member).path.c_str());
+         }
+         printf("\n");
+      }
+   }
+
+   /* Hotspots, headers being files included by another */
+   for (int node = 0; node < graph.node_count(); node++)
+   {
+      struct hotspot entry;
+
+      entry.node = node;
+      entry.includers = graph.fan_in(node);
+      entry.closure = graph.closure_size(node);
+      entry.cost = (long long) entry.includers * (entry.closure + 1);
+      if (entry.includers > 0)
+      {
+         hotspots.push_back(entry);
+      }
+   }
+   std::sort(hotspots.begin(), hotspots.end(), [](const struct hotspot& a, const struct hotspot& b)
+             { return (a.cost != b.cost) ? a.cost > b.cost : a.node < b.node; });
+   if (count > 0 && (size_t) count < hotspots.size())
+   {
+      hotspots.resize(count);
+   }
+
+   for (size_t rank = 0; rank < hotspots.size(); rank++)
+   {
+      printf("%u\t%lld\t%d\t%d\t%s\n", (unsigned) rank + 1, hotspots[rank].cost, hotspots[rank].includers,
+             hotspots[rank].closure, graph.node(hotspots[rank].node).path.c_str());
+   }
+
+   return 0;
+} /* End of main */
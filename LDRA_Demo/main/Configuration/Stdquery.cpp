@@ -0,0 +1,413 @@
+/***-------------------------------------------------------------------------------------------------------------
+***
+*** File: Stdquery.cpp
+***
+*** Query tool over the standards catalogue, <lang>pen.dat and <lang>report.dat.
+***
+***     Stdquery.exe [-c] <pen file> <report file> <query>
+***     Stdquery.exe [-c] <pen file> <report file> -      (queries read from stdin)
+***
+*** A query is a set of standards built from terms joined left to right by
+*** + (union), & (intersection) and - (difference):
+***
+***     all                   every standard of the pen file
+***     used                  standards used for the language
+***     model:<model>         standards in the model
+***     class:<model>:<M/C/O/I>  standards of that class in the model
+***     ref:<id>              standards implementing an external id, e.g.
+***                           "ref:CERT EXP30-C", or all of one, e.g. ref:CERT
+***     keyword:<k>           standards with the "K:<k>" tag
+***     phase:<letter>        standards of the phase, e.g. phase:Z
+***
+*** e.g.
+***     Stdquery Cpen.dat Creport.dat "ref:CERT EXP30-C"
+***     Stdquery Cpen.dat Creport.dat "model:ACME Standard" - "model:MISRA-C:2012"
+***     Stdquery Cpen.dat Creport.dat used - model:VSOS
+***
+*** Each standard found is one tab separated line:
+***     <pen index> <number> <letter> <default class> <text>
+*** -c gives just the number of standards found. Queries read from stdin give
+*** their results after a "# <query>" line, and an empty line after each.
+***
+*** Returns 0, or 1 if a query is not valid.
+***
+***-------------------------------------------------------------------------------------------------------------*/
+#include <cctype>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+#include "Stdcatalogue.h"
+
+
+/*
+ * Macros
+ */
+#define MAX_QUERY 4096
+
+
+/* A set of standards, bit n for the standard at index n */
+typedef std::vector<uint64_t> standard_set;
+
+/*
+ * struct catalogue_index
+ * Inverted indexes over the catalogue, built once at start.
+ */
+struct catalogue_index
+{
+   const struct standards_catalogue* catalogue;
+   size_t words;
+   standard_set all;
+   standard_set used;
+   std::vector<standard_set> models;                         /* By model index */
+   std::vector<standard_set> classes;                        /* By model index * CLASS_COUNT + class */
+   std::map<std::string, standard_set> references;           /* By external id */
+   std::map<std::string, standard_set> reference_standards;  /* By external standard, e.g. CERT */
+   std::map<std::string, standard_set> keywords;
+   std::map<char, standard_set> phases;
+};
+
+
+/*
+ * Prototypes
+ */
+static void build_index (const struct standards_catalogue* catalogue, struct catalogue_index* index);
+
+static bool evaluate_query (const struct catalogue_index* index, const std::vector<std::string>& words,
+                            standard_set* result, std::string* error);
+
+static void print_result (const struct catalogue_index* index, const standard_set& result, bool count_only);
+
+
+
+/***----------------------------------------------------------------
+***
+*** Routine: main
+***
+*** Return value:
+*** int             0, 1 if a query is not valid
+***
+***----------------------------------------------------------------*/
+int main (int argc, char* argv[])
+{
+   struct standards_catalogue catalogue;
+   struct catalogue_index index;
+   std::string error;
+   bool count_only = false;
+   int arg = 1;
+   int return_code = 0;
+
+   if (arg < argc && strcmp(argv[arg], "-c") == 0)
+   {
+      count_only = true;
+      arg++;
+   }
+   if (argc - arg < 3)
+   {
+      printf("Arguments are: [-c] <pen file> <report file> <query>|-\n");
+      return 1;
+   }
+
+   if (!load_catalogue(argv[arg], argv[arg + 1], &catalogue, &error))
+   {
+      printf("%s\n", error.c_str());
+      return 1;
+   }
+   build_index(&catalogue, &index);
+   arg += 2;
+
+   if (argc - arg == 1 && strcmp(argv[arg], "-") == 0)
+   {
+      char line[MAX_QUERY];
+
+      while (fgets(line, sizeof(line), stdin) != NULL)
+      {
+         std::vector<std::string> words;
+         standard_set result;
+
+         line[strcspn(line, "\r\n")] = '\0';
+         if (line[0] == '\0')
+         {
+            continue;
+         }
+
+         /* Terms and operators are separated by " + ", " & " and " - " */
+         std::string query(line);
+         size_t start = 0;
+         for (size_t pos = 0; pos + 2 < query.size(); pos++)
+         {
+            if (query[pos] == ' ' && query[pos + 2] == ' ' && strchr("+&-", query[pos + 1]) != NULL)
+            {
+               words.push_back(query.substr(start, pos - start));
+               words.push_back(query.substr(pos + 1, 1));
+               start = pos + 3;
+               pos += 2;
+            }
+         }
+         words.push_back(query.substr(start));
+
+         printf("# %s\n", line);
+         if (evaluate_query(&index, words, &result, &error))
+         {
+            print_result(&index, result, count_only);
+         }
+         else
+         {
+            printf("%s\n", error.c_str());
+            return_code = 1;
+         }
+         printf("\n");
+         fflush(stdout);
+      }
+   }
+   else
+   {
+      std::vector<std::string> words(argv + arg, argv + argc);
+      standard_set result;
+
+      if (evaluate_query(&index, words, &result, &error))
+      {
+         print_result(&index, result, count_only);
+      }
+      else
+      {
+         printf("%s\n", error.c_str());
+         return_code = 1;
+      }
+   }
+
+   return return_code;
+} /* End of main */
+
+/***----------------------------------------------------------------
+***
+*** Routine: add_standard
+*** Adds the standard to the set, making the set the catalogue size
+***
+***----------------------------------------------------------------*/
+static void add_standard (standard_set* set, size_t words, size_t standard)
+{
+   set->resize(words, 0);
+   (*set)[standard / 64] |= (uint64_t) 1 << (standard % 64);
+} /* End of add_standard */
+
+/***----------------------------------------------------------------
+***
+*** Routine: build_index
+***
+*** Parameters:
+*** ===========
+***
+*** Action  Name                      Type                                Use
+*** ------  ----                      ----                                ---
+*** I       catalogue                 const struct standards_catalogue *  Catalogue
+*** O       index                     struct catalogue_index *            Indexes
+***
+***----------------------------------------------------------------*/
+static void build_index (const struct standards_catalogue* catalogue, struct catalogue_index* index)
+{
+   const size_t words = (catalogue->standards.size() + 63) / 64;
+
+   index->catalogue = catalogue;
+   index->words = words;
+   index->all.assign(words, 0);
+   index->used.assign(words, 0);
+   index->models.assign(catalogue->models.size(), standard_set(words, 0));
+   index->classes.assign(catalogue->models.size() * CLASS_COUNT, standard_set(words, 0));
+
+   for (size_t number = 0; number < catalogue->standards.size(); number++)
+   {
+      const struct catalogue_standard& standard = catalogue->standards[number];
+
+      add_standard(&index->all, words, number);
+      if (standard.applicable)
+      {
+         add_standard(&index->used, words, number);
+      }
+      for (const struct model_setting& setting : standard.models)
+      {
+         add_standard(&index->models[setting.model], words, number);
+         add_standard(&index->classes[setting.model * CLASS_COUNT + CLASS_INDEX(setting.std_class)],
+                      words, number);
+      }
+      for (const std::string& id : standard.references)
+      {
+         add_standard(&index->references[id], words, number);
+         add_standard(&index->reference_standards[id.substr(0, id.find(' '))], words, number);
+      }
+      if (!standard.keyword.empty())
+      {
+         add_standard(&index->keywords[standard.keyword], words, number);
+      }
+      add_standard(&index->phases[(char) toupper(standard.letter)], words, number);
+   }
+} /* End of build_index */
+
+/***----------------------------------------------------------------
+***
+*** Routine: find_term
+***
+*** Parameters:
+*** ===========
+***
+*** Action  Name                      Type                            Use
+*** ------  ----                      ----                            ---
+*** I       index                     const struct catalogue_index *  Indexes
+*** I       term                      const std::string &             Query term
+*** O       set                       standard_set *                  Standards of the term
+*** O       error                     std::string *                   Reason the term is not valid
+***
+*** Return value:
+*** bool            false if the term is not valid
+***
+***----------------------------------------------------------------*/
+static bool find_term (const struct catalogue_index* index, const std::string& term,
+                       standard_set* set, std::string* error)
+{
+   const size_t colon = term.find(':');
+   const std::string kind = term.substr(0, colon);
+   const std::string value = (colon == std::string::npos) ? std::string() : term.substr(colon + 1);
+   const standard_set empty(index->words, 0);
+
+   if (term == "all" || term == "used")
+   {
+      *set = (term == "all") ? index->all : index->used;
+   }
+   else if (kind == "model" || kind == "class")
+   {
+      std::string model_name = value;
+      int class_index = -1;
+
+      /* class:<model>:<M/C/O/I>, the model name may itself hold ':' */
+      if (kind == "class")
+      {
+         if (value.size() < 3 || value[value.size() - 2] != ':'
+             || strchr(CLASS_LETTERS, value.back()) == NULL)
+         {
+            *error = "Expected class:<model>:<M/C/O/I>, not " + term;
+            return false;
+         }
+         class_index = CLASS_INDEX(value.back());
+         model_name = value.substr(0, value.size() - 2);
+      }
+
+      const int model = find_model(index->catalogue, model_name);
+      if (model < 0)
+      {
+         *error = "No model " + model_name;
+         return false;
+      }
+      *set = (class_index < 0) ? index->models[model]
+                               : index->classes[model * CLASS_COUNT + class_index];
+   }
+   else if (kind == "ref" || kind == "keyword")
+   {
+      const std::map<std::string, standard_set>& map =
+         (kind == "keyword") ? index->keywords
+         : (value.find(' ') != std::string::npos) ? index->references : index->reference_standards;
+      std::map<std::string, standard_set>::const_iterator found = map.find(value);
+
+      *set = (found != map.end()) ? found->second : empty;
+   }
+   else if (kind == "phase" && value.size() == 1)
+   {
+      std::map<char, standard_set>::const_iterator found = index->phases.find((char) toupper(value[0]));
+      *set = (found != index->phases.end()) ? found->second : empty;
+   }
+   else
+   {
+      *error = "Unknown query term " + term;
+      return false;
+   }
+
+   return true;
+} /* End of find_term */
+
+/***----------------------------------------------------------------
+***
+*** Routine: evaluate_query
+***
+*** Parameters:
+*** ===========
+***
+*** Action  Name                      Type                                Use
+*** ------  ----                      ----                                ---
+*** I       index                     const struct catalogue_index *      Indexes
+*** I       words                     const std::vector<std::string> &    term [op term]...
+*** O       result                    standard_set *                      Standards found
+*** O       error                     std::string *                       Reason the query is not valid
+***
+*** Return value:
+*** bool            false if the query is not valid
+***
+***----------------------------------------------------------------*/
+static bool evaluate_query (const struct catalogue_index* index, const std::vector<std::string>& words,
+                            standard_set* result, std::string* error)
+{
+   if (words.empty() || words.size() % 2 == 0)
+   {
+      *error = "Expected <term> [<+|&|-> <term>]...";
+      return false;
+   }
+   if (!find_term(index, words[0], result, error))
+   {
+      return false;
+   }
+
+   for (size_t word = 1; word + 1 < words.size(); word += 2)
+   {
+      const std::string& op = words[word];
+      standard_set operand;
+
+      if (op != "+" && op != "&" && op != "-")
+      {
+         *error = "Expected + & or -, not " + op;
+         return false;
+      }
+      if (!find_term(index, words[word + 1], &operand, error))
+      {
+         return false;
+      }
+      for (size_t bits = 0; bits < index->words; bits++)
+      {
+         (*result)[bits] = (op == "+") ? ((*result)[bits] | operand[bits])
+                         : (op == "&") ? ((*result)[bits] & operand[bits])
+                                       : ((*result)[bits] & ~operand[bits]);
+      }
+   }
+
+   return true;
+} /* End of evaluate_query */
+
+/***----------------------------------------------------------------
+***
+*** Routine: print_result
+*** Prints the standards of the set in pen file order, or their number
+***
+***----------------------------------------------------------------*/
+static void print_result (const struct catalogue_index* index, const standard_set& result, bool count_only)
+{
+   size_t count = 0;
+
+   for (size_t number = 0; number < index->catalogue->standards.size(); number++)
+   {
+      if (result[number / 64] & ((uint64_t) 1 << (number % 64)))
+      {
+         const struct catalogue_standard& standard = index->catalogue->standards[number];
+
+         count++;
+         if (!count_only)
+         {
+            printf("%d\t%d\t%c\t%c\t%s\n", standard.pen_index, standard.number, standard.letter,
+                   standard.default_class, standard.text.c_str());
+         }
+      }
+   }
+
+   if (count_only)
+   {
+      printf("%u\n", (unsigned) count);
+   }
+} /* End of print_result */
@@ -0,0 +1,538 @@
+/***-------------------------------------------------------------------------------------------------------------
+***
+*** File: Stdtable.cpp
+***
+*** Writes and maps the precompiled standards table, see Stdtable.h.
+***
+***-------------------------------------------------------------------------------------------------------------*/
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#include "Stdcatalogue.h"
+#include "Stdtable.h"
+
+
+/*
+ * Macros
+ */
+#define ALIGN8(n) (((n) + 7u) & ~7u)
+
+
+/*
+ * struct string_pool
+ * Strings of the table being written, each stored once.
+ */
+struct string_pool
+{
+   std::string data;
+   std::map<std::string, uint32_t> offsets;
+};
+
+static uint32_t add_string (struct string_pool* pool, const std::string& text)
+{
+   std::map<std::string, uint32_t>::const_iterator found = pool->offsets.find(text);
+   if (found != pool->offsets.end())
+   {
+      return found->second;
+   }
+
+   const uint32_t offset = (uint32_t) pool->data.size();
+   pool->data.append(text).push_back('\0');
+   pool->offsets[text] = offset;
+   return offset;
+} /* End of add_string */
+
+
+
+/***----------------------------------------------------------------
+***
+*** Routine: write_standards_table
+***
+*** Parameters:
+*** ===========
+***
+*** Action  Name                      Type                                Use
+*** ------  ----                      ----                                ---
+*** I       catalogue                 const struct standards_catalogue *  Catalogue to compile
+*** I       file_name                 const char *                        Table file
+*** O       error                     std::string *                       Reason for failure
+***
+*** Return value:
+*** bool            false if the table cannot be written
+***
+*** Description:
+*** ============
+***
+*** Builds the table in memory in the layout of Stdtable.h, then writes
+*** it to a temporary file which is renamed over the table, so tools
+*** mapping the old table are not disturbed.
+***
+***----------------------------------------------------------------*/
+bool write_standards_table (const struct standards_catalogue* catalogue,
+                            const char* file_name, std::string* error)
+{
+   struct string_pool strings;
+   struct stdtable_header header;
+   std::vector<struct stdtable_standard> standards;
+   std::vector<struct stdtable_model> models;
+   std::vector<uint64_t> bitsets;
+   std::vector<struct stdtable_limit> limits;
+   std::vector<std::pair<std::string, uint32_t> > references;
+   std::vector<struct stdtable_reference> reference_table;
+
+   if (catalogue->standards.size() > 0xFFFF || catalogue->models.size() > 0xFFFF)
+   {
+      *error = "Too many standards or models for the table";
+      return false;
+   }
+
+   memset(&header, 0, sizeof(header));
+   strcpy(header.magic, STDTABLE_MAGIC);
+   header.version = STDTABLE_VERSION;
+   header.byte_order = STDTABLE_BYTE_ORDER;
+   header.standard_count = (uint32_t) catalogue->standards.size();
+   header.model_count = (uint32_t) catalogue->models.size();
+   header.bitset_words = (header.standard_count + 63) / 64;
+
+   bitsets.assign((size_t) header.model_count * CLASS_COUNT * header.bitset_words, 0);
+   add_string(&strings, "");
+
+   for (uint32_t model = 0; model < header.model_count; model++)
+   {
+      struct stdtable_model entry;
+
+      entry.name = add_string(&strings, catalogue->models[model].name);
+      for (int class_index = 0; class_index < CLASS_COUNT; class_index++)
+      {
+         entry.class_names[class_index] = add_string(&strings, catalogue->models[model].class_names[class_index]);
+      }
+      models.push_back(entry);
+   }
+
+   for (uint32_t index = 0; index < header.standard_count; index++)
+   {
+      const struct catalogue_standard& standard = catalogue->standards[index];
+      struct stdtable_standard entry;
+
+      memset(&entry, 0, sizeof(entry));
+      entry.text = add_string(&strings, standard.text);
+      entry.keyword = add_string(&strings, standard.keyword);
+      entry.pdtmcsfva = add_string(&strings, standard.pdtmcsfva);
+      entry.limit = standard.limit;
+      entry.pen_index = (uint16_t) standard.pen_index;
+      entry.number = (uint16_t) standard.number;
+      entry.letter = standard.letter;
+      entry.default_class = standard.default_class;
+      entry.applicable = standard.applicable ? 1 : 0;
+      entry.group = (uint8_t) standard.group;
+      standards.push_back(entry);
+
+      for (const struct model_setting& setting : standard.models)
+      {
+         const size_t word = ((size_t) setting.model * CLASS_COUNT + CLASS_INDEX(setting.std_class))
+                             * header.bitset_words + index / 64;
+         bitsets[word] |= (uint64_t) 1 << (index % 64);
+
+         if (setting.limit != NO_LIMIT)
+         {
+            struct stdtable_limit limit = { (uint16_t) setting.model, (uint16_t) index, setting.limit };
+            limits.push_back(limit);
+         }
+      }
+
+      for (const std::string& id : standard.references)
+      {
+         references.push_back(std::make_pair(id, index));
+      }
+   }
+
+   std::sort(limits.begin(), limits.end(),
+             [](const struct stdtable_limit& a, const struct stdtable_limit& b)
+             { return (a.model != b.model) ? a.model < b.model : a.standard < b.standard; });
+
+   std::sort(references.begin(), references.end());
+   for (const std::pair<std::string, uint32_t>& reference : references)
+   {
+      struct stdtable_reference entry = { add_string(&strings, reference.first), reference.second };
+      reference_table.push_back(entry);
+   }
+
+   header.limit_count = (uint32_t) limits.size();
+   header.reference_count = (uint32_t) reference_table.size();
+   header.strings_size = (uint32_t) strings.data.size();
+
+   /* Layout */
+   uint32_t offset = ALIGN8((uint32_t) sizeof(header));
+   header.standards_offset = offset;
+   offset = ALIGN8(offset + (uint32_t) (standards.size() * sizeof(struct stdtable_standard)));
+   header.models_offset = offset;
+   offset = ALIGN8(offset + (uint32_t) (models.size() * sizeof(struct stdtable_model)));
+   header.bitsets_offset = offset;
+   offset = ALIGN8(offset + (uint32_t) (bitsets.size() * sizeof(uint64_t)));
+   header.limits_offset = offset;
+   offset = ALIGN8(offset + (uint32_t) (limits.size() * sizeof(struct stdtable_limit)));
+   header.references_offset = offset;
+   offset = ALIGN8(offset + (uint32_t) (reference_table.size() * sizeof(struct stdtable_reference)));
+   header.strings_offset = offset;
+   header.file_size = offset + header.strings_size;
+
+   std::string image(header.file_size, '\0');
+   memcpy(&image[0], &header, sizeof(header));
+   if (!standards.empty())
+      memcpy(&image[header.standards_offset], standards.data(), standards.size() * sizeof(standards[0]));
+   if (!models.empty())
+      memcpy(&image[header.models_offset], models.data(), models.size() * sizeof(models[0]));
+   if (!bitsets.empty())
+      memcpy(&image[header.bitsets_offset], bitsets.data(), bitsets.size() * sizeof(bitsets[0]));
+   if (!limits.empty())
+      memcpy(&image[header.limits_offset], limits.data(), limits.size() * sizeof(limits[0]));
+   if (!reference_table.empty())
+      memcpy(&image[header.references_offset], reference_table.data(), reference_table.size() * sizeof(reference_table[0]));
+   memcpy(&image[header.strings_offset], strings.data.data(), strings.data.size());
+
+   /* Write */
+   const std::string temp_name = std::string(file_name) + ".tmp";
+   FILE* fp = fopen(temp_name.c_str(), "wb");
+   if (fp == NULL)
+   {
+      *error = "Unable to create " + temp_name;
+      return false;
+   }
+   const bool written = (fwrite(image.data(), 1, image.size(), fp) == image.size());
+   if (fclose(fp) != 0 || !written)
+   {
+      remove(temp_name.c_str());
+      *error = "Unable to write " + temp_name;
+      return false;
+   }
+#ifdef _WIN32
+   if (!MoveFileExA(temp_name.c_str(), file_name, MOVEFILE_REPLACE_EXISTING))
+#else
+   if (rename(temp_name.c_str(), file_name) != 0)
+#endif
+   {
+      remove(temp_name.c_str());
+      *error = std::string("Unable to replace ") + file_name;
+      return false;
+   }
+
+   return true;
+} /* End of write_standards_table */
+
+
+
+/***----------------------------------------------------------------
+***
+*** Start of CStandardsTable
+***
+***----------------------------------------------------------------*/
+CStandardsTable::CStandardsTable ()
+   : m_pMapping(NULL), m_size(0),
+#ifdef _WIN32
+     m_hFile(NULL), m_hMapping(NULL),
+#endif
+     m_pHeader(NULL), m_pStandards(NULL), m_pModels(NULL), m_pBitsets(NULL),
+     m_pLimits(NULL), m_pReferences(NULL), m_pStrings(NULL)
+{
+}
+
+CStandardsTable::~CStandardsTable ()
+{
+   close();
+}
+
+/***----------------------------------------------------------------
+***
+*** Routine: CStandardsTable::open
+***
+*** Parameters:
+*** ===========
+***
+*** Action  Name                      Type            Use
+*** ------  ----                      ----            ---
+*** I       file_name                 const char *    Table file
+*** O       error                     std::string *   Reason for failure, may be NULL
+***
+*** Return value:
+*** bool            false if the file cannot be mapped or is not a valid table
+***
+*** Description:
+*** ============
+***
+*** Maps the table read only. The header and the entries are checked
+*** against the file so a truncated, foreign or damaged file is refused
+*** rather than read out of bounds. A table of the other byte order is
+*** refused, it is not converted.
+***
+***----------------------------------------------------------------*/
+bool CStandardsTable::open (const char* file_name, std::string* error)
+{
+   std::string reason;
+
+   close();
+
+#ifdef _WIN32
+   m_hFile = CreateFileA(file_name, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, NULL,
+                         OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+   if (m_hFile == INVALID_HANDLE_VALUE)
+   {
+      m_hFile = NULL;
+      reason = "Unable to open ";
+   }
+   else
+   {
+      LARGE_INTEGER size;
+      GetFileSizeEx(m_hFile, &size);
+      m_size = (size_t) size.QuadPart;
+      m_hMapping = (m_size > 0) ? CreateFileMappingA(m_hFile, NULL, PAGE_READONLY, 0, 0, NULL) : NULL;
+      m_pMapping = (m_hMapping != NULL) ? MapViewOfFile(m_hMapping, FILE_MAP_READ, 0, 0, 0) : NULL;
+      if (m_pMapping == NULL)
+      {
+         reason = "Unable to map ";
+      }
+   }
+#else
+   int fd = ::open(file_name, O_RDONLY);
+   struct stat file_stat;
+
+   if (fd < 0 || fstat(fd, &file_stat) != 0)
+   {
+      reason = "Unable to open ";
+   }
+   else
+   {
+      m_size = (size_t) file_stat.st_size;
+      m_pMapping = (m_size > 0) ? mmap(NULL, m_size, PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+      if (m_pMapping == MAP_FAILED)
+      {
+         m_pMapping = NULL;
+         reason = "Unable to map ";
+      }
+   }
+   if (fd >= 0)
+   {
+      ::close(fd);
+   }
+#endif
+
+   if (reason.empty())
+   {
+      const struct stdtable_header* header = (const struct stdtable_header*) m_pMapping;
+      const char* base = (const char*) m_pMapping;
+
+      if (m_size < sizeof(struct stdtable_header) || memcmp(header->magic, STDTABLE_MAGIC, 8) != 0)
+      {
+         reason = "Not a standards table: ";
+      }
+      else if (header->version == (uint32_t) STDTABLE_VERSION << 24  /* Read in the other byte order */
+               || (header->version == STDTABLE_VERSION && header->byte_order != STDTABLE_BYTE_ORDER))
+      {
+         reason = "Standards table is of another byte order, compile it again: ";
+      }
+      else if (header->version != STDTABLE_VERSION)
+      {
+         reason = "Standards table is of another version, compile it again: ";
+      }
+      else if (header->file_size != m_size
+               || header->strings_size == 0
+               || header->strings_offset + (uint64_t) header->strings_size != m_size
+               || base[m_size - 1] != '\0'
+               || header->standards_offset + (uint64_t) header->standard_count * sizeof(struct stdtable_standard) > m_size
+               || header->models_offset + (uint64_t) header->model_count * sizeof(struct stdtable_model) > m_size
+               || header->bitsets_offset + (uint64_t) header->model_count * CLASS_COUNT * header->bitset_words * 8 > m_size
+               || header->limits_offset + (uint64_t) header->limit_count * sizeof(struct stdtable_limit) > m_size
+               || header->references_offset + (uint64_t) header->reference_count * sizeof(struct stdtable_reference) > m_size
+               || header->bitset_words != (header->standard_count + 63) / 64)
+      {
+         reason = "Standards table is damaged: ";
+      }
+      else
+      {
+         m_pHeader = header;
+         m_pStandards = (const struct stdtable_standard*) (base + header->standards_offset);
+         m_pModels = (const struct stdtable_model*) (base + header->models_offset);
+         m_pBitsets = (const uint64_t*) (base + header->bitsets_offset);
+         m_pLimits = (const struct stdtable_limit*) (base + header->limits_offset);
+         m_pReferences = (const struct stdtable_reference*) (base + header->references_offset);
+         m_pStrings = base + header->strings_offset;
+         if (!entries_valid())
+         {
+            reason = "Standards table is damaged: ";
+         }
+      }
+   }
+
+   if (!reason.empty())
+   {
+      close();
+      if (error != NULL)
+      {
+         *error = reason + file_name;
+      }
+      return false;
+   }
+   return true;
+} /* End of CStandardsTable::open */
+
+void CStandardsTable::close ()
+{
+#ifdef _WIN32
+   if (m_pMapping != NULL) UnmapViewOfFile(m_pMapping);
+   if (m_hMapping != NULL) CloseHandle(m_hMapping);
+   if (m_hFile != NULL) CloseHandle(m_hFile);
+   m_hMapping = NULL;
+   m_hFile = NULL;
+#else
+   if (m_pMapping != NULL) munmap(m_pMapping, m_size);
+#endif
+   m_pMapping = NULL;
+   m_size = 0;
+   m_pHeader = NULL;
+} /* End of CStandardsTable::close */
+
+/* Standard <number> <letter>, the letter either case, -1 if none */
+int CStandardsTable::find_standard (int number, char letter) const
+{
+   for (uint32_t index = 0; index < m_pHeader->standard_count; index++)
+   {
+      if (m_pStandards[index].number == number
+          && toupper(m_pStandards[index].letter) == toupper(letter))
+      {
+         return (int) index;
+      }
+   }
+   return -1;
+}
+
+/* Model by name, -1 if none */
+int CStandardsTable::find_model (const char* name) const
+{
+   for (uint32_t index = 0; index < m_pHeader->model_count; index++)
+   {
+      if (strcmp(string(m_pModels[index].name), name) == 0)
+      {
+         return (int) index;
+      }
+   }
+   return -1;
+}
+
+/* Strings and indexes of the entries within the table, the strings each ending within it */
+bool CStandardsTable::entries_valid () const
+{
+   const uint32_t strings_size = m_pHeader->strings_size;
+
+   for (uint32_t index = 0; index < m_pHeader->standard_count; index++)
+   {
+      const struct stdtable_standard& entry = m_pStandards[index];
+      if (entry.text >= strings_size || entry.keyword >= strings_size || entry.pdtmcsfva >= strings_size)
+      {
+         return false;
+      }
+   }
+   for (uint32_t index = 0; index < m_pHeader->model_count; index++)
+   {
+      const struct stdtable_model& entry = m_pModels[index];
+      if (entry.name >= strings_size)
+      {
+         return false;
+      }
+      for (int class_index = 0; class_index < CLASS_COUNT; class_index++)
+      {
+         if (entry.class_names[class_index] >= strings_size)
+         {
+            return false;
+         }
+      }
+   }
+   for (uint32_t index = 0; index < m_pHeader->limit_count; index++)
+   {
+      if (m_pLimits[index].model >= m_pHeader->model_count
+          || m_pLimits[index].standard >= m_pHeader->standard_count)
+      {
+         return false;
+      }
+   }
+   for (uint32_t index = 0; index < m_pHeader->reference_count; index++)
+   {
+      if (m_pReferences[index].id >= strings_size
+          || m_pReferences[index].standard >= m_pHeader->standard_count)
+      {
+         return false;
+      }
+   }
+   return true;
+}
+
+const uint64_t* CStandardsTable::bitset (int model, int class_index) const
+{
+   return m_pBitsets + ((size_t) model * CLASS_COUNT + class_index) * m_pHeader->bitset_words;
+}
+
+bool CStandardsTable::enabled (int model, int standard) const
+{
+   if (model < 0)
+   {
+      return m_pStandards[standard].applicable != 0;
+   }
+   return std_class(model, standard) != ' ';
+}
+
+char CStandardsTable::std_class (int model, int standard) const
+{
+   for (int class_index = 0; class_index < CLASS_COUNT; class_index++)
+   {
+      if (bitset(model, class_index)[standard / 64] & ((uint64_t) 1 << (standard % 64)))
+      {
+         return CLASS_LETTERS[class_index];
+      }
+   }
+   return ' ';
+}
+
+int CStandardsTable::limit (int model, int standard) const
+{
+   const struct stdtable_limit* end = m_pLimits + m_pHeader->limit_count;
+   const struct stdtable_limit* found =
+      std::lower_bound(m_pLimits, end, std::make_pair(model, standard),
+                       [](const struct stdtable_limit& entry, const std::pair<int, int>& key)
+                       { return (entry.model != key.first) ? entry.model < key.first
+                                                           : entry.standard < key.second; });
+
+   if (found != end && found->model == model && found->standard == standard)
+   {
+      return found->limit;
+   }
+   return m_pStandards[standard].limit;
+}
+
+void CStandardsTable::find_reference (const char* id, std::vector<int>* standards) const
+{
+   const struct stdtable_reference* end = m_pReferences + m_pHeader->reference_count;
+   const struct stdtable_reference* found =
+      std::lower_bound(m_pReferences, end, id,
+                       [this](const struct stdtable_reference& entry, const char* key)
+                       { return strcmp(string(entry.id), key) < 0; });
+
+   standards->clear();
+   for ( ; found != end && strcmp(string(found->id), id) == 0; found++)
+   {
+      standards->push_back((int) found->standard);
+   }
+}
+
+/***----------------------------------------------------------------
+***
+*** End of CStandardsTable
+***
+***----------------------------------------------------------------*/
@@ -0,0 +1,174 @@
+/***-------------------------------------------------------------------------------------------------------------
+***
+*** File: Stdtable.h
+***
+*** The precompiled standards table, <lang>standards.tbl.
+***
+*** Stdtablegen compiles <lang>pen.dat and <lang>report.dat into a single binary
+*** file which tools map into memory and use in place, without parsing any text:
+***
+***     Stdtablegen Cpen.dat Creport.dat Cstandards.tbl
+***
+***     CStandardsTable table;
+***     if (table.open("Cstandards.tbl"))
+***     {
+***        int model = table.find_model("MISRA-C:2012");
+***        int standard = table.find_standard(1, 'Z');
+***        bool enabled = table.enabled(model, standard);
+***     }
+***
+*** The table must be compiled again whenever the .dat files change. A table of
+*** a different STDTABLE_VERSION is refused, compile it again with the new tools.
+*** The table is in the byte order of the machine which compiled it, as it is
+*** used in place; a table of the other byte order is refused too.
+***
+*** File layout, all values in the byte order of byte_order, each part 8 byte aligned:
+***   stdtable_header
+***   stdtable_standard [standard_count]       in pen file order
+***   stdtable_model    [model_count]
+***   uint64_t          [model_count][CLASS_COUNT][bitset_words]
+***                     bit n set when standard n is in the model with that class
+***   stdtable_limit    [limit_count]          model *** values, by model then standard
+***   stdtable_reference[reference_count]      sorted on the id string
+***   char              [strings_size]         '\0' terminated strings
+***
+***-------------------------------------------------------------------------------------------------------------*/
+#ifndef STDTABLE_H
+#define STDTABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+/*
+ * Macros
+ */
+#define STDTABLE_MAGIC    "LDRASTD"  /* 8 bytes with the '\0' */
+#define STDTABLE_VERSION  2
+#define STDTABLE_BYTE_ORDER 0x01020304u /* As read on the machine which compiled the table */
+#define CLASS_COUNT       4          /* M, C, O and I */
+#define STDTABLE_NO_LIMIT (-1)
+
+struct standards_catalogue;
+
+
+/*
+ * Structures of the file
+ */
+struct stdtable_header
+{
+   char magic[8];
+   uint32_t version;
+   uint32_t file_size;
+   uint32_t standard_count;
+   uint32_t model_count;
+   uint32_t bitset_words;             /* uint64_t words in one bitset */
+   uint32_t limit_count;
+   uint32_t reference_count;
+   uint32_t strings_size;
+   uint32_t standards_offset;         /* Offsets are from the start of the file */
+   uint32_t models_offset;
+   uint32_t bitsets_offset;
+   uint32_t limits_offset;
+   uint32_t references_offset;
+   uint32_t strings_offset;
+   uint32_t byte_order;               /* STDTABLE_BYTE_ORDER */
+};
+
+struct stdtable_standard
+{
+   uint32_t text;                     /* Offsets in the strings */
+   uint32_t keyword;
+   uint32_t pdtmcsfva;
+   int32_t limit;                     /* Default *** value, STDTABLE_NO_LIMIT if none */
+   uint16_t pen_index;
+   uint16_t number;
+   char letter;
+   char default_class;                /* M, C, O or I, ' ' if not in the report file */
+   uint8_t applicable;
+   uint8_t group;
+};
+
+struct stdtable_model
+{
+   uint32_t name;
+   uint32_t class_names[CLASS_COUNT];
+};
+
+struct stdtable_limit
+{
+   uint16_t model;
+   uint16_t standard;
+   int32_t limit;
+};
+
+struct stdtable_reference
+{
+   uint32_t id;                       /* e.g. "MISRA-C:2012 R.15.6" */
+   uint32_t standard;
+};
+
+
+/*
+ * class CStandardsTable
+ * A table file mapped read only into memory. Standards and models are
+ * identified by their index in the table.
+ */
+class CStandardsTable
+{
+public:
+   CStandardsTable ();
+   ~CStandardsTable ();
+
+   bool open (const char* file_name, std::string* error = NULL);
+   void close ();
+   bool is_open () const { return m_pHeader != NULL; }
+
+   int standard_count () const { return (int) m_pHeader->standard_count; }
+   int model_count () const { return (int) m_pHeader->model_count; }
+   const struct stdtable_standard& standard (int index) const { return m_pStandards[index]; }
+   const struct stdtable_model& model (int index) const { return m_pModels[index]; }
+   const char* string (uint32_t offset) const { return m_pStrings + offset; }
+
+   int find_standard (int number, char letter) const;
+   int find_model (const char* name) const;
+
+   /* Standard is in the model, or, for model -1, applies to the language */
+   bool enabled (int model, int standard) const;
+   /* M/C/O/I of the standard in the model, ' ' if not in it */
+   char std_class (int model, int standard) const;
+   /* *** value of the standard in the model */
+   int limit (int model, int standard) const;
+   /* Standards with the external id, e.g. "CERT EXP30-C" */
+   void find_reference (const char* id, std::vector<int>* standards) const;
+
+private:
+   const uint64_t* bitset (int model, int class_index) const;
+   bool entries_valid () const;
+
+   void* m_pMapping;
+   size_t m_size;
+#ifdef _WIN32
+   void* m_hFile;
+   void* m_hMapping;
+#endif
+   const struct stdtable_header* m_pHeader;
+   const struct stdtable_standard* m_pStandards;
+   const struct stdtable_model* m_pModels;
+   const uint64_t* m_pBitsets;
+   const struct stdtable_limit* m_pLimits;
+   const struct stdtable_reference* m_pReferences;
+   const char* m_pStrings;
+
+   CStandardsTable (const CStandardsTable&);
+   CStandardsTable& operator= (const CStandardsTable&);
+};
+
+
+/* Compile the catalogue into a table file */
+bool write_standards_table (const struct standards_catalogue* catalogue,
+                            const char* file_name, std::string* error);
+
+#endif /* STDTABLE_H */
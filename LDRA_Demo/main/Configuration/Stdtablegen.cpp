@@ -0,0 +1,52 @@
+/***-------------------------------------------------------------------------------------------------------------
+***
+*** File: Stdtablegen.cpp
+***
+*** Compiles <lang>pen.dat and <lang>report.dat into the standards table read by
+*** Userstandards_combined.exe and other tools, see Stdtable.h.
+***
+***     Stdtablegen.exe <pen file> <report file> <table file>
+***
+*** e.g. from the LDRA installation directory:
+***
+***     Stdtablegen.exe Cpen.dat Creport.dat Cstandards.tbl
+***
+***-------------------------------------------------------------------------------------------------------------*/
+#include <cstdio>
+#include "Stdcatalogue.h"
+#include "Stdtable.h"
+
+
+/***----------------------------------------------------------------
+***
+*** Routine: main
+***
+*** Return value:
+*** int             0 on success, 1 on failure
+***
+***----------------------------------------------------------------*/
+int main (int argc, char* argv[])
+{
+   struct standards_catalogue catalogue;
+   std::string error;
+   CStandardsTable table;
+
+   if (argc != 4)
+   {
+      printf("Arguments are: <pen file> <report file> <table file>\n");
+      return 1;
+   }
+
+   if (!load_catalogue(argv[1], argv[2], &catalogue, &error)
+       ||
+       !write_standards_table(&catalogue, argv[3], &error)
+       ||
+       !table.open(argv[3], &error))
+   {
+      printf("%s\n", error.c_str());
+      return 1;
+   }
+
+   printf("%s: %d standards, %d models\n", argv[3], table.standard_count(), table.model_count());
+   return 0;
+} /* End of main */
@@ -0,0 +1,286 @@
+/***-------------------------------------------------------------------------------------------------------------
+***
+*** File: Suppressions.cpp
+***
+*** Suppression comments and their interval tree, see Suppressions.h.
+***
+***-------------------------------------------------------------------------------------------------------------*/
+#include <algorithm>
+#include <cctype>
+#include <numeric>
+#include "Suppressions.h"
+
+
+
+/***----------------------------------------------------------------
+***
+*** Routine: parse_suppressions
+***
+*** Parameters:
+*** ===========
+***
+*** Action  Name                      Type                          Use
+*** ------  ----                      ----                          ---
+*** I       line                      std::string_view              Line of source text
+*** I       linenum                   int                           Its line number
+*** O       marks                     std::vector<suppression> *    One more per standard listed
+*** O       bad                       std::string_view *            Comment not read, on failure
+***
+*** Return value:
+*** bool            false if the suppression comment cannot be read
+***
+*** Description:
+*** ============
+***
+*** Reads STDCHK-SUPPRESS[-BEGIN|-END|-FILE] <standards>: <reason> from a
+*** comment of the line. The standards are <n>H or <n>Z, separated by
+*** commas or spaces. The marker outside a comment is not a suppression.
+*** The reason is a view of the line.
+***
+***----------------------------------------------------------------*/
+bool parse_suppressions (std::string_view line, int linenum, std::vector<suppression>* marks,
+                         std::string_view* bad)
+{
+   const size_t marker = line.find(SUPPRESS_MARKER);
+   struct suppression entry;
+
+   if (marker == std::string_view::npos)
+   {
+      return true;
+   }
+
+   /* Only in a comment, opened on this line */
+   const std::string_view before = line.substr(0, marker);
+   const size_t block = before.rfind("/*");
+   const size_t comment = std::min(block, before.rfind("//"));
+   if (comment == std::string_view::npos)
+   {
+      return true;
+   }
+
+   std::string_view rest = line.substr(marker + sizeof(SUPPRESS_MARKER) - 1);
+   const size_t end = (block != std::string_view::npos) ? rest.find("*/") : std::string_view::npos;
+   if (end != std::string_view::npos)
+   {
+      rest = rest.substr(0, end);
+   }
+   *bad = line.substr(marker, rest.data() + rest.size() - (line.data() + marker));
+   bad->remove_suffix(bad->size() - (bad->find_last_not_of(" \t") + 1));
+
+   entry.kind = SuppressLine;
+   entry.first = linenum;
+   entry.last = linenum;
+   if (rest.compare(0, 6, "-BEGIN") == 0)
+   {
+      entry.kind = SuppressBegin;
+      entry.last = SUPPRESS_LAST_LINE;
+      rest.remove_prefix(6);
+   }
+   else if (rest.compare(0, 4, "-END") == 0)
+   {
+      entry.kind = SuppressEnd;
+      rest.remove_prefix(4);
+   }
+   else if (rest.compare(0, 5, "-FILE") == 0)
+   {
+      entry.kind = SuppressFile;
+      entry.first = 0;
+      entry.last = SUPPRESS_LAST_LINE;
+      rest.remove_prefix(5);
+   }
+   else if (line.substr(0, comment).find_first_not_of(" \t") == std::string_view::npos)
+   {
+      entry.last = linenum + 1; /* Alone on its line, also the next */
+   }
+   if (rest.empty() || (rest[0] != ' ' && rest[0] != '\t'))
+   {
+      return false;
+   }
+
+   /* The reason, after the standards */
+   const size_t colon = rest.find(':');
+   std::string_view standards = rest.substr(0, colon);
+   std::string_view reason;
+   if (colon != std::string_view::npos)
+   {
+      reason = rest.substr(colon + 1);
+      reason.remove_prefix(std::min(reason.size(), reason.find_first_not_of(" \t")));
+      reason.remove_suffix(reason.size() - (reason.find_last_not_of(" \t") + 1));
+   }
+   if (reason.empty() && entry.kind != SuppressEnd)
+   {
+      return false;
+   }
+   entry.reason = reason;
+
+   /* The standards, <n>H or <n>Z, a space allowed between */
+   const size_t first_mark = marks->size();
+   size_t pos = 0;
+   while (true)
+   {
+      int number = 0;
+
+      while (pos < standards.size() && (standards[pos] == ' ' || standards[pos] == '\t' || standards[pos] == ','))
+      {
+         pos++;
+      }
+      if (pos == standards.size())
+      {
+         break;
+      }
+      if (!isdigit((unsigned char) standards[pos]))
+      {
+         marks->resize(first_mark);
+         return false;
+      }
+      while (pos < standards.size() && isdigit((unsigned char) standards[pos]))
+      {
+         number = number * 10 + (standards[pos++] - '0');
+      }
+      while (pos < standards.size() && (standards[pos] == ' ' || standards[pos] == '\t'))
+      {
+         pos++;
+      }
+      if (pos == standards.size() || number == 0
+          ||
+          (toupper((unsigned char) standards[pos]) != 'H' && toupper((unsigned char) standards[pos]) != 'Z'))
+      {
+         marks->resize(first_mark);
+         return false;
+      }
+      entry.std_letter = (char) toupper((unsigned char) standards[pos++]);
+      entry.std_num = number;
+      marks->push_back(entry);
+   }
+
+   return marks->size() > first_mark;
+} /* End of parse_suppressions */
+
+/***----------------------------------------------------------------
+***
+*** Routine: CSuppressionIndex::clear
+***
+***----------------------------------------------------------------*/
+void CSuppressionIndex::clear ()
+{
+   m_entries.clear();
+   m_added.clear();
+   m_maxLast.clear();
+} /* End of CSuppressionIndex::clear */
+
+/***----------------------------------------------------------------
+***
+*** Routine: CSuppressionIndex::add
+***
+*** Adds a suppression, find() needs build() first
+***
+***----------------------------------------------------------------*/
+void CSuppressionIndex::add (const struct suppression& entry)
+{
+   m_added.push_back((int) m_entries.size());
+   m_entries.push_back(entry);
+} /* End of CSuppressionIndex::add */
+
+/***----------------------------------------------------------------
+***
+*** Routine: CSuppressionIndex::build
+***
+*** Description:
+*** ============
+***
+*** Sorts the suppressions by first line. The middle one of any range is
+*** the root of the subtree of that range, so the tree needs no pointers,
+*** only the largest last line below each root.
+***
+***----------------------------------------------------------------*/
+void CSuppressionIndex::build ()
+{
+   std::vector<int> order(m_entries.size());
+   std::vector<suppression> entries;
+   std::vector<int> added;
+
+   std::iota(order.begin(), order.end(), 0);
+   std::stable_sort(order.begin(), order.end(), [this](int a, int b)
+                    { return m_entries[a].first < m_entries[b].first; });
+   for (int index : order)
+   {
+      entries.push_back(m_entries[index]);
+      added.push_back(m_added[index]);
+   }
+   m_entries.swap(entries);
+   m_added.swap(added);
+
+   m_maxLast.assign(m_entries.size(), 0);
+   build(0, (int) m_entries.size());
+} /* End of CSuppressionIndex::build */
+
+int CSuppressionIndex::build (int low, int high)
+{
+   if (low >= high)
+   {
+      return INT_MIN;
+   }
+
+   const int middle = low + (high - low) / 2;
+   m_maxLast[middle] = std::max(m_entries[middle].last, std::max(build(low, middle), build(middle + 1, high)));
+   return m_maxLast[middle];
+} /* End of CSuppressionIndex::build */
+
+/***----------------------------------------------------------------
+***
+*** Routine: CSuppressionIndex::find
+***
+*** Parameters:
+*** ===========
+***
+*** Action  Name                      Type                Use
+*** ------  ----                      ----                ---
+*** I       std_letter                char                HSTANDARD or ZSTANDARD
+*** I       std_num                   int                 Standard of the violation
+*** I       line                      int                 Line of the violation, 0 for the File
+***
+*** Return value:
+*** int             Order added of a suppression covering it, -1 if none
+***
+*** Description:
+*** ============
+***
+*** A subtree whose largest last line is before the line has nothing to
+*** cover it, nor has the right of a root starting after the line.
+***
+***----------------------------------------------------------------*/
+int CSuppressionIndex::find (char std_letter, int std_num, int line) const
+{
+   return find(0, (int) m_entries.size(), std_letter, std_num, line);
+} /* End of CSuppressionIndex::find */
+
+int CSuppressionIndex::find (int low, int high, char std_letter, int std_num, int line) const
+{
+   if (low >= high)
+   {
+      return -1;
+   }
+
+   const int middle = low + (high - low) / 2;
+   if (m_maxLast[middle] < line)
+   {
+      return -1;
+   }
+
+   const int found = find(low, middle, std_letter, std_num, line);
+   if (found >= 0)
+   {
+      return found;
+   }
+
+   const struct suppression& entry = m_entries[middle];
+   if (entry.first > line)
+   {
+      return -1;
+   }
+   if (entry.last >= line && entry.std_letter == std_letter && entry.std_num == std_num)
+   {
+      return m_added[middle];
+   }
+   return find(middle + 1, high, std_letter, std_num, line);
+} /* End of CSuppressionIndex::find */
@@ -0,0 +1,106 @@
+/***-------------------------------------------------------------------------------------------------------------
+***
+*** File: Suppressions.h
+***
+*** Suppression comments, justifying a violation of a standard in the
+*** source itself (see Suppressions in Combinedstandards.cpp):
+***
+***     x = 0x1F;   // STDCHK-SUPPRESS 5Z: register layout from the data sheet
+***
+***     // STDCHK-SUPPRESS-BEGIN 5Z, 6Z: generated tables
+***     ...
+***     // STDCHK-SUPPRESS-END 5Z, 6Z
+***
+***     // STDCHK-SUPPRESS-FILE 2Z: name fixed by the vendor
+***
+*** or the same in comments between / * and * /.
+***
+*** A suppression covers its own line, and the next line too when the
+*** comment is alone on its line. A BEGIN covers the lines up to the END of
+*** the same standard, or to the end of the File. A FILE covers the whole
+*** File, including violations of the File as a whole (line 0). Each but END
+*** must give its reason after the ':', one without is not a suppression.
+***
+*** The engine collects the suppressions as it scans the lines, and the
+*** caller filters the violations through a CSuppressionIndex:
+***
+***     CSuppressionIndex index;
+***     for (const struct suppression& entry : result.suppressions) index.add(entry);
+***     index.build();
+***     if (index.find(violation.std_letter, violation.std_num, violation.line) >= 0) ...
+***
+*** The index is an interval tree, so a check costs O(log n) in the number
+*** of suppressions of the File.
+***
+***-------------------------------------------------------------------------------------------------------------*/
+#ifndef SUPPRESSIONS_H
+#define SUPPRESSIONS_H
+
+#include <climits>
+#include <string_view>
+#include <vector>
+
+
+/*
+ * Macros
+ */
+#define SUPPRESS_MARKER   "STDCHK-SUPPRESS"
+#define SUPPRESS_LAST_LINE INT_MAX           /* Last line of a suppression to the end of the File */
+
+
+/*
+ * Enumeration
+ */
+typedef enum { SuppressLine, SuppressBegin, SuppressEnd, SuppressFile } Suppress_e;
+
+/*
+ * struct suppression
+ * A standard suppressed for the lines first to last inclusive. END marks
+ * are only found while scanning, the engine joins them to their BEGIN.
+ */
+struct suppression
+{
+   Suppress_e kind;
+   int first;
+   int last;
+   char std_letter;
+   int std_num;
+   std::string_view reason;
+};
+
+/*
+ * class CSuppressionIndex
+ * The suppressions of a File, as an interval tree: the suppressions sorted
+ * by first line form an implicit balanced tree, each node holding the
+ * largest last line below it.
+ */
+class CSuppressionIndex
+{
+public:
+   void clear ();
+   void add (const struct suppression& entry);
+   void build ();
+   size_t size () const { return m_entries.size(); }
+
+   /* Order added of a suppression covering the violation, -1 if none */
+   int find (char std_letter, int std_num, int line) const;
+
+private:
+   int find (int low, int high, char std_letter, int std_num, int line) const;
+   int build (int low, int high);
+
+   std::vector<suppression> m_entries;
+   std::vector<int> m_added;                  /* Order added, of each entry */
+   std::vector<int> m_maxLast;                /* Largest last line of the subtree */
+};
+
+
+/*
+ * Suppressions of a line of source, appended to marks. Returns false if
+ * the line has a suppression comment which cannot be read, bad is then
+ * the text of it.
+ */
+bool parse_suppressions (std::string_view line, int linenum, std::vector<suppression>* marks,
+                         std::string_view* bad);
+
+#endif /* SUPPRESSIONS_H */
@@ -0,0 +1,38 @@
+/* Duplicated code of exactly 100 tokens, see clone_b.c */
+
+void reset_a (void)
+{
+   /* Nothing to reset */
+}
+
+int sum_values (const int* values, int count)
+{
+   int sum = 0;
+   int i = 0;
+
+   for (i = 0; i < count; i++)
+   {
+      if (values[i] > 0)
+      {
+         sum += values[i];
+      }
+      else
+      {
+         sum -= values[i];
+      }
+   }
+   while (sum > 1000)
+   {
+      sum = sum / 2;
+   }
+   if (sum < 0)
+   {
+      sum = -sum;
+   }
+   return sum;
+}
+
+long scale_a (long value)
+{
+   return value * 3L;
+}
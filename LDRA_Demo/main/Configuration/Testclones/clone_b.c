@@ -0,0 +1,45 @@
+/* Duplicated code of exactly 100 tokens, see clone_a.c */
+#include <stdlib.h>
+
+struct point
+{
+   double x;
+   double y;
+};
+
+double length_b (struct point p)
+{
+   return p.x + p.y;
+}
+
+int add_items (const int* items, int n)
+{
+   int total = 0;
+   int k = 0;
+
+   for (k = 0; k < n; k++)
+   {
+      if (items[k] > 0)
+      {
+         total += items[k];
+      }
+      else
+      {
+         total -= items[k];
+      }
+   }
+   while (total > 1000)
+   {
+      total = total / 2;
+   }
+   if (total < 0)
+   {
+      total = -total;
+   }
+   return total;
+}
+
+void free_b (void* block)
+{
+   free(block);
+}
@@ -0,0 +1,168 @@
+/***-------------------------------------------------------------------------------------------------------------
+***
+*** File: Testscan.cpp
+***
+*** Regression check of the scan of a large source in chunks (see
+*** CStandardsChecker::scan_parallel): the source is checked on one thread
+*** and on several, and the violations, includes and suppressions must be
+*** the same.
+***
+***     Testscan.exe <sysearch.dat>
+***
+*** The source is generated, larger than the size scanned in chunks, with
+*** violations, includes found and not found in the sysearch.dat directories
+*** and BEGIN and END suppressions far enough apart to cross the chunks.
+***
+*** Returns 0, or 1 with the first difference.
+***
+***-------------------------------------------------------------------------------------------------------------*/
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "../Standardsengine.h"
+
+
+/*
+ * Macros
+ */
+#define SOURCE_LINES 400000          /* Some 10 MB of source */
+#define SUPPRESS_SPAN 30011          /* Lines between a BEGIN and its END */
+#define MAX_THREADS 7
+
+
+
+/***----------------------------------------------------------------
+***
+*** Routine: make_source
+***
+*** Parameters:
+*** ===========
+***
+*** Action  Name                      Type            Use
+*** ------  ----                      ----            ---
+*** O       source                    std::string *   Generated source
+***
+***----------------------------------------------------------------*/
+static void make_source (std::string* source)
+{
+   char line[128];
+
+   source->clear();
+   for (int linenum = 1; linenum <= SOURCE_LINES; linenum++)
+   {
+      if (linenum % SUPPRESS_SPAN == 1)
+      {
+         snprintf(line, sizeof(line), "/* STDCHK-SUPPRESS-BEGIN 5Z, 6Z: block %d */\n", linenum);
+      }
+      else if (linenum % SUPPRESS_SPAN == 0)
+      {
+         snprintf(line, sizeof(line), "/* STDCHK-SUPPRESS-END 5Z */ int end_%d;\n", linenum);
+      }
+      else if (linenum % 997 == 0)
+      {
+         snprintf(line, sizeof(line), "#include \"%s.h\"\n", (linenum % 2 == 0) ? "scan" : "missing");
+      }
+      else if (linenum % 101 == 0)
+      {
+         snprintf(line, sizeof(line), "int mask_%d = 0x%X; // STDCHK-SUPPRESS 5Z: line %d\n",
+                  linenum, linenum, linenum);
+      }
+      else if (linenum % 13 == 0)
+      {
+         snprintf(line, sizeof(line), "int value_%d = 0x%X;\n", linenum, linenum);
+      }
+      else if (linenum % 17 == 0)
+      {
+         snprintf(line, sizeof(line), "/* TODO: line %d */\n", linenum);
+      }
+      else
+      {
+         snprintf(line, sizeof(line), "int value_%d = %d;\n", linenum, linenum);
+      }
+      source->append(line);
+   }
+} /* End of make_source */
+
+/***----------------------------------------------------------------
+***
+*** Routine: describe
+***
+*** Parameters:
+*** ===========
+***
+*** Action  Name                      Type                        Use
+*** ------  ----                      ----                        ---
+*** I       result                    const struct check_result & Result of a check
+***
+*** Return value:
+*** A line of text for each violation, include and suppression, in order
+***
+***----------------------------------------------------------------*/
+static std::vector<std::string> describe (const struct check_result& result)
+{
+   std::vector<std::string> lines;
+
+   for (const struct violation_info& violation : result.violations)
+   {
+      lines.push_back("violation " + std::to_string(violation.std_num) + violation.std_letter
+                      + " " + std::to_string(violation.line) + " " + std::string(violation.text));
+   }
+   for (const struct include_entry& include : result.includes)
+   {
+      lines.push_back("include " + std::to_string(include.line) + " " + std::string(include.name)
+                      + " " + std::to_string(include.status) + " " + std::string(include.path));
+   }
+   for (const struct suppression& entry : result.suppressions)
+   {
+      lines.push_back("suppression " + std::to_string(entry.kind) + " " + std::to_string(entry.first)
+                      + "-" + std::to_string(entry.last) + " " + std::to_string(entry.std_num)
+                      + entry.std_letter + " " + std::string(entry.reason));
+   }
+   return lines;
+} /* End of describe */
+
+/***----------------------------------------------------------------
+***
+*** Routine: main
+***
+***----------------------------------------------------------------*/
+int main (int argc, char* argv[])
+{
+   CIncludeResolver includes;
+   CStandardsChecker checker;
+   struct check_request request;
+   std::string source;
+
+   if (argc != 2 || !includes.load(argv[1]))
+   {
+      fprintf(stderr, "Usage: Testscan.exe <sysearch.dat>\n");
+      return 1;
+   }
+
+   make_source(&source);
+   request.source_name = "scan.c";
+   request.source = source;
+   request.includes = &includes;
+   request.scan_threads = 1;
+   const std::vector<std::string> serial = describe(checker.check(request));
+
+   for (unsigned int threads = 2; threads <= MAX_THREADS; threads++)
+   {
+      request.scan_threads = threads;
+      const std::vector<std::string> parallel = describe(checker.check(request));
+
+      for (size_t entry = 0; entry < serial.size() || entry < parallel.size(); entry++)
+      {
+         if (entry >= serial.size() || entry >= parallel.size() || serial[entry] != parallel[entry])
+         {
+            printf("%u threads, entry %zu:\n  1: %s\n  %u: %s\n", threads, entry,
+                   (entry < serial.size()) ? serial[entry].c_str() : "(none)",
+                   threads, (entry < parallel.size()) ? parallel[entry].c_str() : "(none)");
+            return 1;
+         }
+      }
+   }
+
+   printf("%zu entries, the same on 1 to %d threads\n", serial.size(), MAX_THREADS);
+   return 0;
+} /* End of main */
@@ -0,0 +1 @@
+/* Found by the includes of Testscan.cpp */
@@ -0,0 +1,552 @@
+/***-------------------------------------------------------------------------------------------------------------
+***
+*** File: exhconvert.c
+***
+*** Converts a binary execution history, written by an instrumented program
+*** built with QQQBINARY_EXH (see qqoutputh in inszt_program.c), back to the
+*** text execution history the toolsuite reads. It also recovers a mapped
+*** execution history, from a program built with QQQMAPPED_EXH (see
+*** program_21zzmopn), whether or not the program ended.
+***
+***     exhconvert <history.exb|history.exm> [<history.exh>]
+***
+*** The text is the same, byte for byte, as the program would have written
+*** without QQQBINARY_EXH. It goes to standard output when no .exh is given.
+*** The history is converted a block at a time, so a history of any size
+*** needs no more memory than its largest block. Each block is unpacked (see
+*** qqoutputz) before its probes are decoded. A history cut short, by a
+*** crash of the program, is converted up to its last whole block. The loop
+*** records of a history built with QQQLOOP_EXH are expanded again into the
+*** probes they stand for.
+***
+*** A mapped history is read from its cursor: the ring from the oldest probe
+*** kept to the last recorded. Once the ring has wrapped the probes before
+*** those are lost, which is reported, as is a history the program did not
+*** close. A mapped history is in the byte order of the machine that
+*** recorded it, which its header gives, so one from a big endian machine
+*** is read as well.
+***
+*** Returns 0, or 1 if the history cannot be read or the .exh written.
+***
+***-------------------------------------------------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+/*
+ * Macros
+ */
+#define EXB_MAGIC          "LDRAEXHB"  /* 8 bytes, without the '\0' */
+#define EXB_VERSION        2
+#define EXB_HEADER_SIZE    24
+#define EXB_BLOCK_SIZE     12
+#define EXB_MAX_VARINT     5           /* bytes of a 32 bit value */
+#define EXB_MAX_ITEM       (2 + 2 * EXB_MAX_VARINT)  /* bytes of a loop record */
+#define EXM_MAGIC          "LDRAEXHM"  /* 8 bytes, without the '\0' */
+#define EXM_VERSION        1
+#define EXM_HEADER_SIZE    40
+#define EXM_ORDER          0x01020304u /* as written by a little endian machine */
+#define EXM_ORDER_SWAPPED  0x04030201u /* as written by a big endian machine */
+#define EXM_CHUNK          4096        /* probes read at a time */
+#define TEXT_BUFFER_SIZE   (1 << 20)
+
+
+/*
+ * struct history
+ * What the blocks of a history need from those before them: the last
+ * probes, which a loop record repeats.
+ */
+struct history
+{
+   unsigned int window;                /* longest loop, 0 without loop records */
+   int* recent;                        /* the last window probes, a ring */
+   unsigned long probes;               /* probes converted */
+};
+
+
+/*
+ * Prototypes
+ */
+static unsigned int read_u32 (const unsigned char* bytes);
+static unsigned int read_ordered_u32 (const unsigned char* bytes, int big_endian);
+static int unpack_block (const unsigned char* packed, unsigned int packed_size,
+                         unsigned char* bytes, unsigned int size);
+static int convert_block (const unsigned char* bytes, unsigned int size, unsigned int items,
+                          struct history* history, FILE* out);
+static void put_probe (struct history* history, int probe, FILE* out);
+static int convert_mapped (FILE* in, const char* name, FILE* out);
+
+
+
+/***----------------------------------------------------------------
+***
+*** Routine: main
+***
+*** Return value:
+*** int             0 on success, 1 on failure
+***
+***----------------------------------------------------------------*/
+int main (int argc, char* argv[])
+{
+   unsigned char header[EXB_HEADER_SIZE];
+   char magic[8];
+   unsigned char frame[EXB_BLOCK_SIZE];
+   unsigned char* block = NULL;
+   unsigned int block_capacity = 0;
+   unsigned char* packed = NULL;
+   unsigned int packed_capacity = 0;
+   unsigned long blocks = 0;
+   struct history history;
+   FILE* in;
+   FILE* out = stdout;
+   int status = 0;
+
+   if (argc < 2 || argc > 3)
+   {
+      printf("Arguments are: <history.exb|history.exm> [<history.exh>]\n");
+      return 1;
+   }
+
+   in = fopen(argv[1], "rb");
+   if (in == NULL)
+   {
+      fprintf(stderr, "Unable to read %s\n", argv[1]);
+      return 1;
+   }
+   if (fread(magic, 1, sizeof(magic), in) == sizeof(magic) && memcmp(magic, EXM_MAGIC, 8) == 0)
+   {
+      if (argc == 3)
+      {
+         out = fopen(argv[2], "w");
+         if (out == NULL)
+         {
+            fprintf(stderr, "Unable to write %s\n", argv[2]);
+            fclose(in);
+            return 1;
+         }
+      }
+      setvbuf(out, NULL, _IOFBF, TEXT_BUFFER_SIZE);
+      status = convert_mapped(in, argv[1], out);
+      fclose(in);
+      if (ferror(out) || (out != stdout && fclose(out) != 0) || (out == stdout && fflush(out) != 0))
+      {
+         fprintf(stderr, "Unable to write %s\n", (argc == 3) ? argv[2] : "the history");
+         return 1;
+      }
+      return status;
+   }
+   rewind(in);
+   if (fread(header, 1, sizeof(header), in) != sizeof(header) || memcmp(header, EXB_MAGIC, 8) != 0)
+   {
+      fprintf(stderr, "Not a binary execution history: %s\n", argv[1]);
+      fclose(in);
+      return 1;
+   }
+   if (read_u32(header + 8) != EXB_VERSION)
+   {
+      fprintf(stderr, "Binary execution history of version %u, not %d: %s\n",
+              read_u32(header + 8), EXB_VERSION, argv[1]);
+      fclose(in);
+      return 1;
+   }
+
+   history.window = read_u32(header + 20);
+   history.probes = 0;
+   history.recent = (history.window > 0) ? (int*) calloc(history.window, sizeof(int)) : NULL;
+   if (history.window > 0 && history.recent == NULL)
+   {
+      fprintf(stderr, "Out of memory for loops of %u probes: %s\n", history.window, argv[1]);
+      fclose(in);
+      return 1;
+   }
+
+   if (argc == 3)
+   {
+      out = fopen(argv[2], "w");
+      if (out == NULL)
+      {
+         fprintf(stderr, "Unable to write %s\n", argv[2]);
+         free(history.recent);
+         fclose(in);
+         return 1;
+      }
+   }
+   setvbuf(out, NULL, _IOFBF, TEXT_BUFFER_SIZE);
+
+   while (fread(frame, 1, sizeof(frame), in) == sizeof(frame))
+   {
+      const unsigned int items = read_u32(frame);
+      const unsigned int size = read_u32(frame + 4);
+      const unsigned int packed_size = read_u32(frame + 8);
+
+      if (size > items * (unsigned long) EXB_MAX_ITEM || size < items || packed_size > 2 * (unsigned long) size + 8)
+      {
+         fprintf(stderr, "Damaged block %lu, history converted up to it: %s\n", blocks + 1, argv[1]);
+         status = 1;
+         break;
+      }
+      if (size > block_capacity)
+      {
+         unsigned char* larger = (unsigned char*) realloc(block, size);
+         if (larger == NULL)
+         {
+            fprintf(stderr, "Out of memory for block %lu: %s\n", blocks + 1, argv[1]);
+            status = 1;
+            break;
+         }
+         block = larger;
+         block_capacity = size;
+      }
+      if (packed_size > packed_capacity)
+      {
+         unsigned char* larger = (unsigned char*) realloc(packed, packed_size);
+         if (larger == NULL)
+         {
+            fprintf(stderr, "Out of memory for block %lu: %s\n", blocks + 1, argv[1]);
+            status = 1;
+            break;
+         }
+         packed = larger;
+         packed_capacity = packed_size;
+      }
+      if (fread(packed, 1, packed_size, in) != packed_size)
+      {
+         fprintf(stderr, "History cut short in block %lu, converted up to it: %s\n", blocks + 1, argv[1]);
+         break;
+      }
+      if (!unpack_block(packed, packed_size, block, size)
+          || !convert_block(block, size, items, &history, out))
+      {
+         fprintf(stderr, "Damaged block %lu, history converted up to it: %s\n", blocks + 1, argv[1]);
+         status = 1;
+         break;
+      }
+      blocks++;
+   }
+
+   free(block);
+   free(packed);
+   free(history.recent);
+   fclose(in);
+   if (ferror(out) || (out != stdout && fclose(out) != 0) || (out == stdout && fflush(out) != 0))
+   {
+      fprintf(stderr, "Unable to write %s\n", (argc == 3) ? argv[2] : "the history");
+      return 1;
+   }
+
+   fprintf(stderr, "%s: file id %u, %u branches, %lu probes in %lu blocks\n",
+           argv[1], read_u32(header + 12), read_u32(header + 16), history.probes, blocks);
+   return status;
+} /* End of main */
+
+/* Little endian 32 bit value */
+static unsigned int read_u32 (const unsigned char* bytes)
+{
+   return (unsigned int) bytes[0] | ((unsigned int) bytes[1] << 8)
+          | ((unsigned int) bytes[2] << 16) | ((unsigned int) bytes[3] << 24);
+} /* End of read_u32 */
+
+/* 32 bit value in the byte order of a mapped history */
+static unsigned int read_ordered_u32 (const unsigned char* bytes, int big_endian)
+{
+   if (!big_endian)
+   {
+      return read_u32(bytes);
+   }
+   return ((unsigned int) bytes[0] << 24) | ((unsigned int) bytes[1] << 16)
+          | ((unsigned int) bytes[2] << 8) | (unsigned int) bytes[3];
+} /* End of read_ordered_u32 */
+
+/***----------------------------------------------------------------
+***
+*** Routine: unpack_block
+***
+*** Parameters:
+*** ===========
+***
+*** Action  Name                Type                      Use
+*** ------  ----                ----                      ---
+*** I       packed              const unsigned char *     Block as written
+*** I       packed_size         unsigned int              Bytes of it
+*** O       bytes               unsigned char *           Probes and loop records of the block
+*** I       size                unsigned int              Bytes of them
+***
+*** Return value:
+*** int             0 if the block does not unpack to exactly size bytes
+***
+*** Description:
+*** ============
+***
+*** Undoes qqoutputz: a number n in 7 bit groups, then for an even n a
+*** run of n / 2 bytes as they are, for an odd n a repeat of n / 2 + 4
+*** bytes from a number of bytes back which follows. A repeat may overlap
+*** the bytes it makes, so it is copied a byte at a time.
+***
+***----------------------------------------------------------------*/
+static int unpack_block (const unsigned char* packed, unsigned int packed_size,
+                         unsigned char* bytes, unsigned int size)
+{
+   const unsigned char* end = packed + packed_size;
+   unsigned int done = 0;
+
+   while (packed < end)
+   {
+      const int repeat_fields = (*packed & 1) ? 2 : 1;   /* the low bit of n is in its first byte */
+      unsigned int fields[2];
+      int field;
+
+      for (field = 0; field < repeat_fields; field++)
+      {
+         unsigned int number = 0;
+         int shift = 0;
+
+         do
+         {
+            if (packed == end || shift > 28)
+            {
+               return 0;
+            }
+            number |= (unsigned int) (*packed & 0x7F) << shift;
+            shift += 7;
+         } while (*packed++ & 0x80);
+         fields[field] = number;
+      }
+
+      if ((fields[0] & 1) == 0)
+      {
+         const unsigned int run = fields[0] >> 1;
+         if (run > size - done || run > (unsigned int) (end - packed))
+         {
+            return 0;
+         }
+         memcpy(bytes + done, packed, run);
+         packed += run;
+         done += run;
+      }
+      else
+      {
+         unsigned int repeat = (fields[0] >> 1) + 4;
+         const unsigned int back = fields[1];
+         if (back == 0 || back > done || repeat > size - done)
+         {
+            return 0;
+         }
+         for ( ; repeat > 0; repeat--, done++)
+         {
+            bytes[done] = bytes[done - back];
+         }
+      }
+   }
+
+   return done == size;
+} /* End of unpack_block */
+
+/***----------------------------------------------------------------
+***
+*** Routine: convert_block
+***
+*** Parameters:
+*** ===========
+***
+*** Action  Name                Type                      Use
+*** ------  ----                ----                      ---
+*** I       bytes               const unsigned char *     Probes and loop records of the block
+*** I       size                unsigned int              Bytes of them
+*** I       items               unsigned int              Probes and loop records the block holds
+*** IO      history             struct history *          Probes before the block
+*** I       out                 FILE *                    Text history
+***
+*** Return value:
+*** int             0 if the bytes do not hold that many, or a loop record
+***                 repeats more probes than there are
+***
+*** Description:
+*** ============
+***
+*** Undoes the zig-zag and the change from the probe before, and writes
+*** each probe as "%6d\n". A loop record, 0x80 0x00 then the period and
+*** the repeats, writes the last period probes that many times again.
+***
+***----------------------------------------------------------------*/
+static int convert_block (const unsigned char* bytes, unsigned int size, unsigned int items,
+                          struct history* history, FILE* out)
+{
+   const unsigned char* end = bytes + size;
+   unsigned int value = 0;
+   unsigned int fields[2];
+   unsigned int count;
+
+   for (count = 0; count < items; count++)
+   {
+      const int loop = (end - bytes >= 2 && bytes[0] == 0x80 && bytes[1] == 0x00);
+      int field;
+
+      if (loop)
+      {
+         bytes += 2;
+      }
+      for (field = 0; field < (loop ? 2 : 1); field++)
+      {
+         unsigned int number = 0;
+         int shift = 0;
+
+         do
+         {
+            if (bytes == end || shift > 28)
+            {
+               return 0;
+            }
+            number |= (unsigned int) (*bytes & 0x7F) << shift;
+            shift += 7;
+         } while (*bytes++ & 0x80);
+         fields[field] = number;
+      }
+
+      if (!loop)
+      {
+         value += (fields[0] >> 1) ^ (0u - (fields[0] & 1u));
+         put_probe(history, (int) value, out);
+      }
+      else
+      {
+         const unsigned int period = fields[0];
+         unsigned long repeat;
+
+         if (period == 0 || period > history->window || period > history->probes)
+         {
+            return 0;
+         }
+         for (repeat = (unsigned long) period * fields[1]; repeat > 0; repeat--)
+         {
+            put_probe(history, history->recent[(history->probes - period) % history->window], out);
+         }
+      }
+   }
+
+   return bytes == end;
+} /* End of convert_block */
+
+/* Writes a probe and keeps it for the loop records */
+static void put_probe (struct history* history, int probe, FILE* out)
+{
+   if (history->window > 0)
+   {
+      history->recent[history->probes % history->window] = probe;
+   }
+   history->probes++;
+   fprintf(out, "%6d\n", probe);
+} /* End of put_probe */
+
+/***----------------------------------------------------------------
+***
+*** Routine: convert_mapped
+***
+*** Parameters:
+*** ===========
+***
+*** Action  Name                Type                      Use
+*** ------  ----                ----                      ---
+*** I       in                  FILE *                    Mapped history
+*** I       name                const char *              Its file name, for messages
+*** I       out                 FILE *                    Text history
+***
+*** Return value:
+*** int             0 on success, 1 if the history is damaged
+***
+*** Description:
+*** ============
+***
+*** The header (struct program_21zzmhdr) holds the cursor, count probes
+*** recorded, the last at (count - 1) % size of the ring. Before the ring
+*** has wrapped the probes are 0 to count - 1, after it they start at the
+*** cursor and go round to it. The header and the probes are in the byte
+*** order of the machine, little endian unless order reads back swapped.
+***
+***----------------------------------------------------------------*/
+static int convert_mapped (FILE* in, const char* name, FILE* out)
+{
+   unsigned char header[EXM_HEADER_SIZE];
+   unsigned char chunk[EXM_CHUNK * 4];
+   unsigned int size;
+   unsigned int count;
+   unsigned int first;
+   unsigned long probes;
+   unsigned long left;
+   int big_endian;
+   int wrapped;
+   int part;
+
+   rewind(in);
+   if (fread(header, 1, sizeof(header), in) != sizeof(header))
+   {
+      fprintf(stderr, "Mapped execution history without its header: %s\n", name);
+      return 1;
+   }
+   if (read_u32(header + 12) != EXM_ORDER && read_u32(header + 12) != EXM_ORDER_SWAPPED)
+   {
+      fprintf(stderr, "Mapped execution history of an unknown byte order: %s\n", name);
+      return 1;
+   }
+   big_endian = (read_u32(header + 12) == EXM_ORDER_SWAPPED);
+   if (read_ordered_u32(header + 8, big_endian) != EXM_VERSION)
+   {
+      fprintf(stderr, "Mapped execution history of version %u, not %d: %s\n",
+              read_ordered_u32(header + 8, big_endian), EXM_VERSION, name);
+      return 1;
+   }
+
+   size = read_ordered_u32(header + 24, big_endian);
+   count = read_ordered_u32(header + 32, big_endian);
+   wrapped = (read_ordered_u32(header + 28, big_endian) != 0 || count >= size);
+   if (size == 0 || (size & (size - 1)) != 0)
+   {
+      fprintf(stderr, "Damaged header, ring of %u probes: %s\n", size, name);
+      return 1;
+   }
+   first = wrapped ? (count & (size - 1)) : 0;
+   probes = wrapped ? size : count;
+
+   /* From the oldest probe to the end of the ring, then from its start */
+   for (part = 0; part < 2; part++)
+   {
+      left = (part == 0) ? (wrapped ? size - first : count) : (wrapped ? first : 0);
+      if (left == 0)
+      {
+         continue;
+      }
+      if (fseek(in, EXM_HEADER_SIZE + 4L * ((part == 0) ? first : 0), SEEK_SET) != 0)
+      {
+         fprintf(stderr, "History cut short, ring of %u probes: %s\n", size, name);
+         return 1;
+      }
+      while (left > 0)
+      {
+         const size_t want = (left < EXM_CHUNK) ? (size_t) left : EXM_CHUNK;
+         size_t probe;
+
+         if (fread(chunk, 4, want, in) != want)
+         {
+            fprintf(stderr, "History cut short, ring of %u probes: %s\n", size, name);
+            return 1;
+         }
+         for (probe = 0; probe < want; probe++)
+         {
+            fprintf(out, "%6d\n", (int) read_ordered_u32(chunk + 4 * probe, big_endian));
+         }
+         left -= want;
+      }
+   }
+
+   fprintf(stderr, "%s: file id %u, %u branches, %lu probes recovered\n",
+           name, read_ordered_u32(header + 16, big_endian), read_ordered_u32(header + 20, big_endian), probes);
+   if (wrapped)
+   {
+      fprintf(stderr, "%s: the ring of %u probes has wrapped, the probes before these are lost\n", name, size);
+   }
+   if (read_ordered_u32(header + 36, big_endian) == 0)
+   {
+      fprintf(stderr, "%s: not closed by the program, recovered up to its last probe\n", name);
+   }
+   return 0;
+} /* End of convert_mapped */
@@ -42,6 +42,15 @@ DATE OF ANALYSIS : Mon Mar 05 17:38:14 2018
 #undef QQQTIC2XSERIALIO
 #undef QQQTIC2XFLASH
 #undef QQQCOMPRESSED_EXH
+#undef QQQBUFFERED_EXH
+#undef QQQBITMAP_EXH
+#undef QQQBINARY_EXH
+#undef QQQLOOP_EXH
+#undef QQQINLINE_PROBES
+#undef QQQSAMPLED_EXH
+#undef QQQASYNC_EXH
+#undef QQQMAPPED_EXH
+#undef QQQSIGNAL_EXH
 #define QQQMAINFL
 #undef QQQSINGLEFILE
 #undef QQQFILEID
@@ -67,6 +76,110 @@ DATE OF ANALYSIS : Mon Mar 05 17:38:14 2018
 #ifndef QQQnumfil                                                                                                                                                                                                                                                   
 #define QQQnumfil 40  /* default setting */                                                                                                                                                                                                                         
 #endif  /* QQQnumfil */                                                                                                                                                                                                                                             
+#ifndef QQQexhbuf                                                                                                                                                                                                                                                   
+#define QQQexhbuf 65536  /* default setting, probes held by a buffered history */                                                                                                                                                                                   
+#endif  /* QQQexhbuf */                                                                                                                                                                                                                                             
+#ifndef QQQexhblk                                                                                                                                                                                                                                                   
+#define QQQexhblk 4096  /* default setting, probes formatted per fwrite */                                                                                                                                                                                          
+#endif  /* QQQexhblk */                                                                                                                                                                                                                                             
+#ifndef QQQthrbuf                                                                                                                                                                                                                                                   
+#define QQQthrbuf 16384  /* default setting, probes held by each thread */                                                                                                                                                                                          
+#endif  /* QQQthrbuf */                                                                                                                                                                                                                                             
+#ifndef QQQloopwin                                                                                                                                                                                                                                                  
+#define QQQloopwin 16  /* default setting, longest loop found, a power of 2 */                                                                                                                                                                                      
+#endif  /* QQQloopwin */                                                                                                                                                                                                                                            
+#define QQQloopmax 1073741824  /* most repeats of a loop in one record */                                                                                                                                                                                           
+#define QQQloopmark (-2147483647 - 1)  /* a loop record in the buffer */                                                                                                                                                                                            
+#ifndef QQQsampleon                                                                                                                                                                                                                                                 
+#define QQQsampleon 1  /* default setting, probes counted in each sampling window of a thread */                                                                                                                                                                    
+#endif  /* QQQsampleon */                                                                                                                                                                                                                                           
+#ifndef QQQsampleoff                                                                                                                                                                                                                                                
+#define QQQsampleoff 63  /* default setting, probes not counted between the windows */                                                                                                                                                                              
+#endif  /* QQQsampleoff */                                                                                                                                                                                                                                          
+#ifndef QQQasyncbufs                                                                                                                                                                                                                                                
+#define QQQasyncbufs 2  /* default setting, buffers of an ASYNC history, at least 2 */                                                                                                                                                                              
+#endif  /* QQQasyncbufs */                                                                                                                                                                                                                                          
+#define QQQasyncblock 0  /* all the buffers full: wait for the thread writing the history */                                                                                                                                                                        
+#define QQQasyncdrop 1  /* all the buffers full: drop the probes of the buffer, counting them */                                                                                                                                                                    
+#define QQQasyncgrow 2  /* all the buffers full: add another buffer */                                                                                                                                                                                              
+#ifndef QQQasyncfull                                                                                                                                                                                                                                                
+#define QQQasyncfull QQQasyncblock  /* default setting */                                                                                                                                                                                                           
+#endif  /* QQQasyncfull */                                                                                                                                                                                                                                          
+#ifndef QQQmapsize                                                                                                                                                                                                                                                  
+#define QQQmapsize 1048576  /* default setting, last probes held by a MAPPED history, a power of 2 */                                                                                                                                                               
+#endif  /* QQQmapsize */                                                                                                                                                                                                                                            
+#ifndef QQQsigsnap                                                                                                                                                                                                                                                  
+#define QQQsigsnap SIGUSR1  /* default setting, the signal for a coverage snapshot */                                                                                                                                                                               
+#endif  /* QQQsigsnap */                                                                                                                                                                                                                                            
+#ifndef QQQsigfence                                                                                                                                                                                                                                                 
+#define QQQsigfence() __asm__ __volatile__("" : : : "memory")  /* GCC, stores stay inside the busy flag */                                                                                                                                                          
+#endif  /* QQQsigfence */                                                                                                                                                                                                                                           
+#ifndef QQQinline                                                                                                                                                                                                                                                   
+#ifdef QQQINLINE_PROBES                                                                                                                                                                                                                                             
+#define QQQinline __inline__ __attribute__((always_inline))  /* GCC, probes inlined where they are hit */                                                                                                                                                           
+#else  /* QQQINLINE_PROBES */                                                                                                                                                                                                                                       
+#define QQQinline                                                                                                                                                                                                                                                   
+#endif  /* QQQINLINE_PROBES */                                                                                                                                                                                                                                      
+#endif  /* QQQinline */                                                                                                                                                                                                                                             
+#ifndef QQQthreadlocal                                                                                                                                                                                                                                              
+#define QQQthreadlocal __thread  /* GCC, __declspec(thread) for Microsoft C */                                                                                                                                                                                      
+#endif  /* QQQthreadlocal */                                                                                                                                                                                                                                        
+#ifndef QQQthreadyield                                                                                                                                                                                                                                              
+#define QQQthreadyield() sched_yield()  /* default setting, lets the thread writing the history run */                                                                                                                                                              
+#endif  /* QQQthreadyield */                                                                                                                                                                                                                                        
+#if defined(QQQBITMAP_EXH)                                                                                                                                                                                                                                          
+  /* for BITMAP execution histories QQQthreaded, QQQSAMPLED_EXH and QQQMAPPED_EXH are not defined,                                                                                                                                                                  
+   * the threads of a threaded program share the bitmap and set their bits atomically */                                                                                                                                                                            
+#if defined(QQQthreaded)                                                                                                                                                                                                                                            
+#define QQQBITMAP_ATOMIC                                                                                                                                                                                                                                            
+#endif  /* QQQthreaded */                                                                                                                                                                                                                                           
+#undef QQQthreaded                                                                                                                                                                                                                                                  
+#undef QQQSAMPLED_EXH                                                                                                                                                                                                                                               
+#undef QQQMAPPED_EXH                                                                                                                                                                                                                                                
+#endif  /* QQQBITMAP_EXH */                                                                                                                                                                                                                                         
+#if defined(QQQSAMPLED_EXH)                                                                                                                                                                                                                                         
+  /* SAMPLED execution histories keep their own state for each thread */                                                                                                                                                                                            
+#undef QQQthreaded                                                                                                                                                                                                                                                  
+#undef QQQMAPPED_EXH                                                                                                                                                                                                                                                
+#endif  /* QQQSAMPLED_EXH */                                                                                                                                                                                                                                        
+#if defined(QQQMAPPED_EXH)                                                                                                                                                                                                                                          
+  /* MAPPED execution histories are the file itself, not buffered, binary or threaded */                                                                                                                                                                            
+#undef QQQthreaded                                                                                                                                                                                                                                                  
+#undef QQQLOOP_EXH                                                                                                                                                                                                                                                  
+#undef QQQBINARY_EXH                                                                                                                                                                                                                                                
+#undef QQQBUFFERED_EXH                                                                                                                                                                                                                                              
+#undef QQQASYNC_EXH                                                                                                                                                                                                                                                 
+#endif  /* QQQMAPPED_EXH */                                                                                                                                                                                                                                         
+#if defined(QQQLOOP_EXH)                                                                                                                                                                                                                                            
+  /* LOOP execution histories are binary, and QQQthreaded is not defined */                                                                                                                                                                                         
+#undef QQQthreaded                                                                                                                                                                                                                                                  
+#ifndef QQQBINARY_EXH                                                                                                                                                                                                                                               
+#define QQQBINARY_EXH                                                                                                                                                                                                                                               
+#endif  /* QQQBINARY_EXH */                                                                                                                                                                                                                                         
+#endif  /* QQQLOOP_EXH */                                                                                                                                                                                                                                           
+#if defined(QQQASYNC_EXH) && (defined(QQQBITMAP_EXH) || defined(QQQSAMPLED_EXH) || defined(QQQthreaded))                                                                                                                                                            
+  /* BITMAP, SAMPLED and threaded execution histories are not written from the buffer */                                                                                                                                                                            
+#undef QQQASYNC_EXH                                                                                                                                                                                                                                                 
+#endif  /* QQQASYNC_EXH && (QQQBITMAP_EXH || QQQSAMPLED_EXH || QQQthreaded) */                                                                                                                                                                                      
+#if defined(QQQSIGNAL_EXH) && (defined(QQQSAMPLED_EXH) || defined(QQQthreaded))                                                                                                                                                                                     
+  /* SAMPLED and threaded execution histories are not written in a signal handler */                                                                                                                                                                                
+#undef QQQSIGNAL_EXH                                                                                                                                                                                                                                                
+#endif  /* QQQSIGNAL_EXH && (QQQSAMPLED_EXH || QQQthreaded) */                                                                                                                                                                                                      
+#if defined(QQQSIGNAL_EXH)                                                                                                                                                                                                                                          
+  /* SIGNAL execution histories are written from the buffer by the handlers, not by a thread */                                                                                                                                                                     
+#undef QQQASYNC_EXH                                                                                                                                                                                                                                                 
+#if !defined(QQQMAPPED_EXH) && !defined(QQQBUFFERED_EXH)                                                                                                                                                                                                            
+#define QQQBUFFERED_EXH                                                                                                                                                                                                                                             
+#endif  /* !QQQMAPPED_EXH && !QQQBUFFERED_EXH */                                                                                                                                                                                                                    
+#endif  /* QQQSIGNAL_EXH */                                                                                                                                                                                                                                         
+#if defined(QQQASYNC_EXH) && !defined(QQQBUFFERED_EXH)                                                                                                                                                                                                              
+  /* ASYNC execution histories are written from the buffers by a thread of their own */                                                                                                                                                                             
+#define QQQBUFFERED_EXH                                                                                                                                                                                                                                             
+#endif  /* QQQASYNC_EXH && !QQQBUFFERED_EXH */                                                                                                                                                                                                                      
+#if defined(QQQBINARY_EXH) && !defined(QQQBUFFERED_EXH)                                                                                                                                                                                                             
+  /* BINARY execution histories are written from the buffer */                                                                                                                                                                                                      
+#define QQQBUFFERED_EXH                                                                                                                                                                                                                                             
+#endif  /* QQQBINARY_EXH && !QQQBUFFERED_EXH */                                                                                                                                                                                                                     
 #if defined(QQQstructbitmap) && defined(QQQSINGLEFILE)                                                                                                                                                                                                              
       typedef void(*VoidFunction)();                                                                                                                                                                                                                                
 #if defined(QQQMAINFL)                                                                                                                                                                                                                                              
@@ -122,12 +235,29 @@ DATE OF ANALYSIS : Mon Mar 05 17:38:14 2018
 #endif  /* __STDC__ */                                                                                                                                                                                                                                              
   static void qqoutput(FILEPOINT char * s,int i);                                                                                                                                                                                                                   
   static void qqoutput0(FILEPOINT char * s);                                                                                                                                                                                                                        
+#if defined(QQQBUFFERED_EXH) || defined(QQQthreaded)                                                                                                                                                                                                                
+  static void qqoutputn(FILEPOINT int * p,int n);                                                                                                                                                                                                                   
+#endif  /* QQQBUFFERED_EXH || QQQthreaded */                                                                                                                                                                                                                        
+#ifdef QQQBINARY_EXH                                                                                                                                                                                                                                                
+  static void qqoutputh(FILEPOINT int fileid,int branches);                                                                                                                                                                                                         
+  static int qqoutputv(unsigned char * t,unsigned int u);                                                                                                                                                                                                           
+  static int qqoutputz(const unsigned char * r,int n,unsigned char * t);                                                                                                                                                                                            
+#endif  /* QQQBINARY_EXH */                                                                                                                                                                                                                                         
+#if defined(QQQSIGNAL_EXH) || ((defined(QQQBUFFERED_EXH) || defined(QQQthreaded)) && !defined(QQQBINARY_EXH))                                                                                                                                                       
+  static int qqoutputd(char * t,int i);                                                                                                                                                                                                                             
+#endif  /* QQQSIGNAL_EXH || ((QQQBUFFERED_EXH || QQQthreaded) && !QQQBINARY_EXH) */                                                                                                                                                                                 
+#ifdef QQQSIGNAL_EXH                                                                                                                                                                                                                                                
+  static void qqoutputw(int d,const void * t,int k);                                                                                                                                                                                                                
+#endif  /* QQQSIGNAL_EXH */                                                                                                                                                                                                                                         
   static int program_21zqqzqz(qqnull_params);                                                                                                                                                                                                                       
   static int program_21zqqzqz1(qqnull_params);                                                                                                                                                                                                                      
-  static int program_21zzqqzz (int qqqi);                                                                                                                                                                                                                           
+  static QQQinline int program_21zzqqzz (int qqqi);                                                                                                                                                                                                                 
   static int program_21zqzqzq (int qqqi);                                                                                                                                                                                                                           
-  static int program_21zzzqtz (int qqqa, int qqqb);                                                                                                                                                                                                                 
-  static int program_21zzzqfz (int qqqa, int qqqb);                                                                                                                                                                                                                 
+  static QQQinline int program_21zzzqtz (int qqqa, int qqqb);                                                                                                                                                                                                       
+  static QQQinline int program_21zzzqfz (int qqqa, int qqqb);                                                                                                                                                                                                       
+#if defined(QQQSIGNAL_EXH) && defined(QQQMAINFL) && !(defined(QQQstructbitmap) && defined(QQQSINGLEFILE))                                                                                                                                                           
+  void qqqtotalreset(void);                                                                                                                                                                                                                                         
+#endif  /* QQQSIGNAL_EXH && QQQMAINFL && !(QQQstructbitmap && QQQSINGLEFILE) */                                                                                                                                                                                     
 /* ------------------------------ END OF TESTBED PROTOTYPES -------------------------------- */                                                                                                                                                                     
  
 int
@@ -179,6 +309,152 @@ int
     /* not single file and not fileid */                                                                                                                                                                                                                            
     static char qqqqone[]   = "%6d\n";           /* single point */                                                                                                                                                                                                 
   /* uncompressed data structures */                                                                                                                                                                                                                                
+#if ((defined(QQQBUFFERED_EXH) || defined(QQQBITMAP_EXH) || defined(QQQSAMPLED_EXH)) && !defined(QQQNOATEXIT)) || defined(QQQthreaded)                                                                                                                              
+#include <stdlib.h>                                                                                                                                                                                                                                                 
+#endif  /* ((QQQBUFFERED_EXH || QQQBITMAP_EXH || QQQSAMPLED_EXH) && !QQQNOATEXIT) || QQQthreaded */                                                                                                                                                                 
+#if defined(QQQthreaded) || defined(QQQASYNC_EXH)                                                                                                                                                                                                                   
+#include <sched.h>                                                                                                                                                                                                                                                  
+#endif  /* QQQthreaded || QQQASYNC_EXH */                                                                                                                                                                                                                           
+#ifdef QQQASYNC_EXH                                                                                                                                                                                                                                                 
+#include <pthread.h>                                                                                                                                                                                                                                                
+#include <semaphore.h>                                                                                                                                                                                                                                              
+#endif  /* QQQASYNC_EXH */                                                                                                                                                                                                                                          
+#ifdef QQQthreaded                                                                                                                                                                                                                                                  
+#include <pthread.h>                                                                                                                                                                                                                                                
+#endif  /* QQQthreaded */                                                                                                                                                                                                                                           
+#if defined(QQQMAPPED_EXH) || defined(QQQSIGNAL_EXH)                                                                                                                                                                                                                
+#include <fcntl.h>                                                                                                                                                                                                                                                  
+#include <string.h>                                                                                                                                                                                                                                                 
+#include <unistd.h>                                                                                                                                                                                                                                                 
+#endif  /* QQQMAPPED_EXH || QQQSIGNAL_EXH */                                                                                                                                                                                                                        
+#ifdef QQQMAPPED_EXH                                                                                                                                                                                                                                                
+#include <sys/mman.h>                                                                                                                                                                                                                                               
+#endif  /* QQQMAPPED_EXH */                                                                                                                                                                                                                                         
+#ifdef QQQSIGNAL_EXH                                                                                                                                                                                                                                                
+#include <errno.h>                                                                                                                                                                                                                                                  
+#include <signal.h>                                                                                                                                                                                                                                                 
+#include <time.h>                                                                                                                                                                                                                                                   
+#endif  /* QQQSIGNAL_EXH */                                                                                                                                                                                                                                         
+#ifdef QQQBITMAP_EXH                                                                                                                                                                                                                                                
+  /* bitmap data structures */                                                                                                                                                                                                                                      
+  static unsigned char program_21zzhbit[qqqbranches / 8 + 1];  /* a bit for each probe 0 to qqqbranches */                                                                                                                                                          
+  static int program_21zzhreg = 0;                                                                                                                                                                                                                                  
+  static void program_21zzhdmp(qqnull_params);                                                                                                                                                                                                                      
+#if defined(QQQINLINE_PROBES) && !defined(QQQNOATEXIT)                                                                                                                                                                                                              
+  static void program_21zzinit(qqnull_params) __attribute__((constructor));                                                                                                                                                                                         
+#endif  /* QQQINLINE_PROBES && !QQQNOATEXIT */                                                                                                                                                                                                                      
+#endif  /* QQQBITMAP_EXH */                                                                                                                                                                                                                                         
+#ifdef QQQSAMPLED_EXH                                                                                                                                                                                                                                               
+  /* sampled data structures */                                                                                                                                                                                                                                     
+  static unsigned long program_21zzscnt[qqqbranches + 1];  /* hits of each probe counted */                                                                                                                                                                         
+  static unsigned char program_21zzsput[qqqbranches / 8 + 1];  /* probes in the execution history */                                                                                                                                                                
+  static QQQthreadlocal int program_21zzsdwn = 0;  /* probes of this thread to the end of the window */                                                                                                                                                             
+  static QQQthreadlocal unsigned int program_21zzsrnd = 0;  /* random state of this thread */                                                                                                                                                                       
+  static volatile int program_21zzsreg = 0;                                                                                                                                                                                                                         
+  static void program_21zzsamp(int qqqi);                                                                                                                                                                                                                           
+  static int program_21zzsgap(qqnull_params);                                                                                                                                                                                                                       
+  static void program_21zzsdmp(qqnull_params);                                                                                                                                                                                                                      
+#endif  /* QQQSAMPLED_EXH */                                                                                                                                                                                                                                        
+#ifdef QQQBUFFERED_EXH                                                                                                                                                                                                                                              
+  /* buffered data structures */                                                                                                                                                                                                                                    
+#ifdef QQQASYNC_EXH                                                                                                                                                                                                                                                 
+  struct program_21zzhblk                                                                                                                                                                                                                                           
+  {                                                                                                                                                                                                                                                                 
+    struct program_21zzhblk * next;                                                                                                                                                                                                                                 
+    int full;                /* handed to the thread writing the history */                                                                                                                                                                                         
+    int count;                                                                                                                                                                                                                                                      
+    int probes[QQQexhbuf];                                                                                                                                                                                                                                          
+  };                                                                                                                                                                                                                                                                
+  static struct program_21zzhblk program_21zzhrng[QQQasyncbufs];  /* the ring of buffers */                                                                                                                                                                         
+  static struct program_21zzhblk * program_21zzhcur = &program_21zzhrng[0];  /* the buffer being filled */                                                                                                                                                          
+  static int * program_21zzhbuf = program_21zzhrng[0].probes;  /* probes not yet handed over */                                                                                                                                                                     
+  static sem_t program_21zzhsem;  /* posted for each buffer handed over */                                                                                                                                                                                          
+  static int program_21zzhwon = 0;  /* 1 the thread is running, -1 it could not be started */                                                                                                                                                                       
+  static unsigned long program_21zzhdrp = 0;  /* entries of the buffer dropped, QQQasyncdrop */                                                                                                                                                                     
+  static void * program_21zzhwrt(void * qqqa);                                                                                                                                                                                                                      
+  static void program_21zzhdrn(qqnull_params);                                                                                                                                                                                                                      
+#else  /* QQQASYNC_EXH */                                                                                                                                                                                                                                           
+  static int program_21zzhbuf[QQQexhbuf];  /* probes not yet written */                                                                                                                                                                                             
+#endif  /* QQQASYNC_EXH */                                                                                                                                                                                                                                          
+  static int program_21zzhcnt = 0;                                                                                                                                                                                                                                  
+  static void program_21zzflsh(qqnull_params);                                                                                                                                                                                                                      
+#endif  /* QQQBUFFERED_EXH */                                                                                                                                                                                                                                       
+#ifdef QQQMAPPED_EXH                                                                                                                                                                                                                                                
+  /* mapped data structures, program_21.exm is the header then the ring of                                                                                                                                                                                          
+   * QQQmapsize probes, in the byte order of the machine */                                                                                                                                                                                                         
+  struct program_21zzmhdr                                                                                                                                                                                                                                           
+  {                                                                                                                                                                                                                                                                 
+    char magic[8];           /* "LDRAEXHM" */                                                                                                                                                                                                                       
+    unsigned int version;    /* 1 */                                                                                                                                                                                                                                
+    unsigned int order;      /* 0x01020304, the byte order */                                                                                                                                                                                                       
+    unsigned int fileid;                                                                                                                                                                                                                                            
+    unsigned int branches;                                                                                                                                                                                                                                          
+    unsigned int size;       /* QQQmapsize */                                                                                                                                                                                                                       
+    unsigned int wrapped;    /* 1 once the ring has been filled */                                                                                                                                                                                                  
+    unsigned int count;      /* probes recorded, the next at count % size */                                                                                                                                                                                        
+    unsigned int closed;     /* 1 while closed by program_21zqzqzq */                                                                                                                                                                                               
+  };                                                                                                                                                                                                                                                                
+  static volatile struct program_21zzmhdr * program_21zzmmap = 0;  /* the history mapped, 0 if not */                                                                                                                                                               
+  static volatile int * program_21zzmrng = 0;  /* the ring, after the header */                                                                                                                                                                                     
+  static void program_21zzmopn(int qqqnew);                                                                                                                                                                                                                         
+  static void program_21zzmcls(qqnull_params);                                                                                                                                                                                                                      
+#endif  /* QQQMAPPED_EXH */                                                                                                                                                                                                                                         
+#ifdef QQQSIGNAL_EXH                                                                                                                                                                                                                                                
+  /* signal data structures */                                                                                                                                                                                                                                      
+  static unsigned char program_21zzgbit[qqqbranches / 8 + 1];  /* probes hit in this coverage epoch */                                                                                                                                                              
+  static volatile sig_atomic_t program_21zzgbsy = 0;  /* 1 while recording or writing the history */                                                                                                                                                                
+  static volatile sig_atomic_t program_21zzgpnd = 0;  /* a signal put off until then, 0 if none */                                                                                                                                                                  
+  static unsigned int program_21zzgseq = 0;  /* snapshots written */                                                                                                                                                                                                
+  static const int program_21zzgsig[8] = { SIGTERM, SIGINT, QQQsigsnap, SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT };                                                                                                                                                 
+  static struct sigaction program_21zzgold[8];  /* their actions before the handler */                                                                                                                                                                              
+  static QQQinline int program_21zzgbeg(qqnull_params);                                                                                                                                                                                                             
+  static QQQinline void program_21zzgend(int qqqb);                                                                                                                                                                                                                 
+  static void program_21zzghnd(int qqqs);                                                                                                                                                                                                                           
+  static void program_21zzgact(int qqqs);                                                                                                                                                                                                                           
+  static void program_21zzgsnp(qqnull_params);                                                                                                                                                                                                                      
+  static void program_21zzgins(qqnull_params);                                                                                                                                                                                                                      
+#endif  /* QQQSIGNAL_EXH */                                                                                                                                                                                                                                         
+#ifdef QQQLOOP_EXH                                                                                                                                                                                                                                                  
+  /* loop data structures */                                                                                                                                                                                                                                        
+  static int program_21zzlhst[2 * QQQloopwin];  /* the last probes */                                                                                                                                                                                               
+  static int program_21zzlmat[QQQloopwin + 1];  /* probes in a row the same as a period before */                                                                                                                                                                   
+  static unsigned int program_21zzlt = 0;  /* probes seen, the last at program_21zzlt in program_21zzlhst */                                                                                                                                                        
+  static int program_21zzlval = 0;  /* probes in program_21zzlhst */                                                                                                                                                                                                
+  static int program_21zzlpnd = 0;  /* last probes not yet buffered */                                                                                                                                                                                              
+  static int program_21zzlper = 0;  /* period repeating, 0 if none */                                                                                                                                                                                               
+  static int program_21zzlpos = 0;  /* probes into the next repeat */                                                                                                                                                                                               
+  static int program_21zzlcnt = 0;  /* repeats not yet buffered */                                                                                                                                                                                                  
+  static void program_21zzloop(int qqqi);                                                                                                                                                                                                                           
+  static void program_21zzlput(int qqqa, int qqqb);                                                                                                                                                                                                                 
+  static void program_21zzlend(qqnull_params);                                                                                                                                                                                                                      
+#endif  /* QQQLOOP_EXH */                                                                                                                                                                                                                                           
+#ifdef QQQthreaded                                                                                                                                                                                                                                                  
+  /* threaded data structures, thread 0 writes program_21.exh and thread n                                                                                                                                                                                          
+   * program_21.n.exh (.exb if binary) */                                                                                                                                                                                                                           
+  struct program_21zzthrd                                                                                                                                                                                                                                           
+  {                                                                                                                                                                                                                                                                 
+    struct program_21zzthrd * next;                                                                                                                                                                                                                                 
+    int id;                  /* order the thread first recorded a probe */                                                                                                                                                                                          
+    int count;                                                                                                                                                                                                                                                      
+    int done;                /* the thread has ended, set holding the lock */                                                                                                                                                                                       
+    FILE * fil;              /* history of thread n, 0 until first written */                                                                                                                                                                                       
+    int probes[QQQthrbuf];   /* probes of the thread not yet written */                                                                                                                                                                                             
+  };                                                                                                                                                                                                                                                                
+  static QQQthreadlocal struct program_21zzthrd * program_21zzhthr = 0;  /* buffer of this thread */                                                                                                                                                                
+  static struct program_21zzthrd * volatile program_21zzhlst = 0;  /* buffers of all the threads */                                                                                                                                                                 
+  static volatile int program_21zzhtid = 0;                                                                                                                                                                                                                         
+  static volatile int program_21zzhlck = 0;  /* held only to write the history */                                                                                                                                                                                   
+  static pthread_key_t program_21zzhkey;  /* ends each thread with program_21zzthre */                                                                                                                                                                              
+  static pthread_once_t program_21zzhonc = PTHREAD_ONCE_INIT;                                                                                                                                                                                                       
+  static struct program_21zzthrd * program_21zzthr1(qqnull_params);                                                                                                                                                                                                 
+  static void program_21zzthrk(qqnull_params);                                                                                                                                                                                                                      
+  static void program_21zzthre(void * qqqp);                                                                                                                                                                                                                        
+  static void program_21zzthrf(struct program_21zzthrd * qqqt);                                                                                                                                                                                                     
+  static void program_21zzthrw(struct program_21zzthrd * qqqt);                                                                                                                                                                                                     
+  static void program_21zzthra(qqnull_params);                                                                                                                                                                                                                      
+  static void program_21zzthrx(qqnull_params);                                                                                                                                                                                                                      
+  static void program_21zzlock(int qqqon);                                                                                                                                                                                                                          
+#endif  /* QQQthreaded */                                                                                                                                                                                                                                           
   static int program_21zqqzqz(qqnull_params);                                                                                                                                                                                                                       
   static int program_21zqqzqz1(qqnull_params);                                                                                                                                                                                                                      
     /* ----------------------------------------------------------------------* 187 *                                                                                                                                                                                
@@ -188,6 +464,10 @@ int
   /* ----------------------------------------------------------------------* 197 *                                                                                                                                                                                  
    *    C System utilities in use:                                                                                                                                                                                                                                  
    *        fprintf                                                                                                                                                                                                                                                 
+   *        fwrite (QQQBUFFERED_EXH)                                                                                                                                                                                                                                
+   *        pthread_create, sem_post, sem_wait (QQQASYNC_EXH)                                                                                                                                                                                                       
+   *        open, posix_fallocate, mmap, munmap (QQQMAPPED_EXH)                                                                                                                                                                                                     
+   *        sigaction, raise, write, time (QQQSIGNAL_EXH)                                                                                                                                                                                                           
    *        fclose                                                                                                                                                                                                                                                  
    *        sscanf                                                                                                                                                                                                                                                  
    * -----------------------------------------------------------------------------                                                                                                                                                                                  
@@ -219,6 +499,290 @@ int
     {                                                                                                                                                                                                                                                               
     fprintf(f,s);                                                                                                                                                                                                                                                   
     } /* end of qqoutput0 */                                                                                                                                                                                                                                        
+#if defined(QQQBUFFERED_EXH) || defined(QQQthreaded)                                                                                                                                                                                                                
+    /* ----------------------------------------------------------------------* 203 *                                                                                                                                                                                
+     *            qqoutputn                                                                                                                                                                                                                                         
+     *    Writes n probe values exactly as qqoutput does with qqqqone, but                                                                                                                                                                                          
+     *    formatted here into blocks of QQQexhblk probes, one fwrite each.                                                                                                                                                                                          
+     * -----------------------------------------------------------------------------                                                                                                                                                                                
+     */                                                                                                                                                                                                                                                             
+    static void qqoutputn(FILEPOINT int * p,int n)                                                                                                                                                                                                                  
+    /* f - file pointer, p - probe values, n - number of them */                                                                                                                                                                                                    
+#ifdef QQQBINARY_EXH                                                                                                                                                                                                                                                
+    {                                                                                                                                                                                                                                                               
+      /* a block of the binary history, see qqoutputh: r as encoded, t as packed */                                                                                                                                                                                 
+      static unsigned char r[QQQexhblk * 12];                                                                                                                                                                                                                       
+      static unsigned char t[12 + QQQexhblk * 24 + 8];                                                                                                                                                                                                              
+      unsigned int u;                                                                                                                                                                                                                                               
+      unsigned int v;                                                                                                                                                                                                                                               
+      int k;                                                                                                                                                                                                                                                        
+      int m;                                                                                                                                                                                                                                                        
+      int w;                                                                                                                                                                                                                                                        
+      int j;                                                                                                                                                                                                                                                        
+      while ( n > 0 )                                                                                                                                                                                                                                               
+      {                                                                                                                                                                                                                                                             
+        k = 0;                                                                                                                                                                                                                                                      
+        v = 0u;                                                                                                                                                                                                                                                     
+        for ( m = 0; m < QQQexhblk && n > 0; m++ )                                                                                                                                                                                                                  
+        {                                                                                                                                                                                                                                                           
+          w = 1;                                                                                                                                                                                                                                                    
+#ifdef QQQLOOP_EXH                                                                                                                                                                                                                                                  
+          if ( *p == QQQloopmark )                                                                                                                                                                                                                                  
+          {                                                                                                                                                                                                                                                         
+            /* a loop record, or the probe QQQloopmark itself */                                                                                                                                                                                                    
+            w = 3;                                                                                                                                                                                                                                                  
+            if ( p[2] != 0 )                                                                                                                                                                                                                                        
+            {                                                                                                                                                                                                                                                       
+              r[k++] = 0x80u;                                                                                                                                                                                                                                       
+              r[k++] = 0x00u;                                                                                                                                                                                                                                       
+              k += qqoutputv(r + k, (unsigned int) p[1]);                                                                                                                                                                                                           
+              k += qqoutputv(r + k, (unsigned int) p[2]);                                                                                                                                                                                                           
+              p += w;                                                                                                                                                                                                                                               
+              n -= w;                                                                                                                                                                                                                                               
+              continue;                                                                                                                                                                                                                                             
+            }                                                                                                                                                                                                                                                       
+          }                                                                                                                                                                                                                                                         
+#endif  /* QQQLOOP_EXH */                                                                                                                                                                                                                                           
+          /* the change from the last probe, zig-zag so small either way */                                                                                                                                                                                         
+          u = (unsigned int) *p - v;                                                                                                                                                                                                                                
+          v = (unsigned int) *p;                                                                                                                                                                                                                                    
+          k += qqoutputv(r + k, (u << 1) ^ (0u - (u >> 31)));                                                                                                                                                                                                       
+          p += w;                                                                                                                                                                                                                                                   
+          n -= w;                                                                                                                                                                                                                                                   
+        }                                                                                                                                                                                                                                                           
+        u = (unsigned int) qqoutputz(r, k, t + 12);                                                                                                                                                                                                                 
+        for ( j = 0; j < 4; j++ )                                                                                                                                                                                                                                   
+        {                                                                                                                                                                                                                                                           
+          t[j] = (unsigned char) ((unsigned int) m >> (8 * j));                                                                                                                                                                                                     
+          t[4 + j] = (unsigned char) ((unsigned int) k >> (8 * j));                                                                                                                                                                                                 
+          t[8 + j] = (unsigned char) (u >> (8 * j));                                                                                                                                                                                                                
+        }                                                                                                                                                                                                                                                           
+#ifdef QQQSIGNAL_EXH                                                                                                                                                                                                                                                
+        qqoutputw(fileno(f), t, 12 + (int) u);                                                                                                                                                                                                                      
+#else  /* QQQSIGNAL_EXH */                                                                                                                                                                                                                                          
+        fwrite(t, 1, 12 + (size_t) u, f);                                                                                                                                                                                                                           
+#endif  /* QQQSIGNAL_EXH */                                                                                                                                                                                                                                         
+      }                                                                                                                                                                                                                                                             
+    } /* end of qqoutputn */                                                                                                                                                                                                                                        
+    /* ----------------------------------------------------------------------* 205 *                                                                                                                                                                                
+     *            qqoutputv                                                                                                                                                                                                                                         
+     *    Puts u in 7 bit groups, low first, the top bit set on all but the                                                                                                                                                                                         
+     *    last group, and returns the bytes put.                                                                                                                                                                                                                    
+     * -----------------------------------------------------------------------------                                                                                                                                                                                
+     */                                                                                                                                                                                                                                                             
+    static int qqoutputv(unsigned char * t,unsigned int u)                                                                                                                                                                                                          
+    {                                                                                                                                                                                                                                                               
+      int k = 0;                                                                                                                                                                                                                                                    
+      while ( u >= 0x80u )                                                                                                                                                                                                                                          
+      {                                                                                                                                                                                                                                                             
+        t[k++] = (unsigned char) (u | 0x80u);                                                                                                                                                                                                                       
+        u >>= 7;                                                                                                                                                                                                                                                    
+      }                                                                                                                                                                                                                                                             
+      t[k++] = (unsigned char) u;                                                                                                                                                                                                                                   
+      return(k);                                                                                                                                                                                                                                                    
+    } /* end of qqoutputv */                                                                                                                                                                                                                                        
+    /* ----------------------------------------------------------------------* 209 *                                                                                                                                                                                
+     *            qqoutputz                                                                                                                                                                                                                                         
+     *    Packs the n bytes of r into t and returns the bytes put: a run of                                                                                                                                                                                         
+     *    bytes as they are, or a repeat of 4 or more bytes met before in r,                                                                                                                                                                                        
+     *    as its length and how far back. The probes of a loop repeat, so                                                                                                                                                                                           
+     *    they pack into a few repeats. t takes at most 2 * n + 8 bytes.                                                                                                                                                                                            
+     * -----------------------------------------------------------------------------                                                                                                                                                                                
+     */                                                                                                                                                                                                                                                             
+    static int qqoutputz(const unsigned char * r,int n,unsigned char * t)                                                                                                                                                                                           
+    {                                                                                                                                                                                                                                                               
+      /* where the last 4 bytes of each hash began, plus 1, 0 for none */                                                                                                                                                                                           
+      static int h[4096];                                                                                                                                                                                                                                           
+      unsigned int x;                                                                                                                                                                                                                                               
+      int i = 0;                                                                                                                                                                                                                                                    
+      int s = 0;                                                                                                                                                                                                                                                    
+      int k = 0;                                                                                                                                                                                                                                                    
+      int c;                                                                                                                                                                                                                                                        
+      int m;                                                                                                                                                                                                                                                        
+      int j;                                                                                                                                                                                                                                                        
+      for ( j = 0; j < 4096; j++ )                                                                                                                                                                                                                                  
+      {                                                                                                                                                                                                                                                             
+        h[j] = 0;                                                                                                                                                                                                                                                   
+      }                                                                                                                                                                                                                                                             
+      while ( i + 4 <= n )                                                                                                                                                                                                                                          
+      {                                                                                                                                                                                                                                                             
+        x = (unsigned int) r[i] | ((unsigned int) r[i + 1] << 8)                                                                                                                                                                                                    
+            | ((unsigned int) r[i + 2] << 16) | ((unsigned int) r[i + 3] << 24);                                                                                                                                                                                    
+        j = (int) ((x * 2654435761u) >> 20);                                                                                                                                                                                                                        
+        c = h[j] - 1;                                                                                                                                                                                                                                               
+        h[j] = i + 1;                                                                                                                                                                                                                                               
+        if ( c < 0 || r[c] != r[i] || r[c + 1] != r[i + 1] || r[c + 2] != r[i + 2] || r[c + 3] != r[i + 3] )                                                                                                                                                        
+        {                                                                                                                                                                                                                                                           
+          /* the longer nothing repeats, the fewer places are tried */                                                                                                                                                                                              
+          i += 1 + ((i - s) >> 6);                                                                                                                                                                                                                                  
+          continue;                                                                                                                                                                                                                                                 
+        }                                                                                                                                                                                                                                                           
+        for ( m = 4; i + m < n && r[c + m] == r[i + m]; m++ )                                                                                                                                                                                                       
+        {                                                                                                                                                                                                                                                           
+        }                                                                                                                                                                                                                                                           
+        if ( i > s )                                                                                                                                                                                                                                                
+        {                                                                                                                                                                                                                                                           
+          /* the run before the repeat, its length doubled */                                                                                                                                                                                                       
+          k += qqoutputv(t + k, (unsigned int) (i - s) << 1);                                                                                                                                                                                                       
+          for ( ; s < i; s++ )                                                                                                                                                                                                                                      
+          {                                                                                                                                                                                                                                                         
+            t[k++] = r[s];                                                                                                                                                                                                                                          
+          }                                                                                                                                                                                                                                                         
+        }                                                                                                                                                                                                                                                           
+        /* the repeat, its length less 4 doubled plus 1, then how far back */                                                                                                                                                                                       
+        k += qqoutputv(t + k, ((unsigned int) (m - 4) << 1) | 1u);                                                                                                                                                                                                  
+        k += qqoutputv(t + k, (unsigned int) (i - c));                                                                                                                                                                                                              
+        i += m;                                                                                                                                                                                                                                                     
+        s = i;                                                                                                                                                                                                                                                      
+      }                                                                                                                                                                                                                                                             
+      if ( n > s )                                                                                                                                                                                                                                                  
+      {                                                                                                                                                                                                                                                             
+        k += qqoutputv(t + k, (unsigned int) (n - s) << 1);                                                                                                                                                                                                         
+        for ( ; s < n; s++ )                                                                                                                                                                                                                                        
+        {                                                                                                                                                                                                                                                           
+          t[k++] = r[s];                                                                                                                                                                                                                                            
+        }                                                                                                                                                                                                                                                           
+      }                                                                                                                                                                                                                                                             
+      return(k);                                                                                                                                                                                                                                                    
+    } /* end of qqoutputz */                                                                                                                                                                                                                                        
+    /* ----------------------------------------------------------------------* 204 *                                                                                                                                                                                
+     *            qqoutputh                                                                                                                                                                                                                                         
+     *    Writes the header of the binary history. All in little endian:                                                                                                                                                                                            
+     *      "LDRAEXHB", version 2, file id, qqqbranches, loop window or 0                                                                                                                                                                                           
+     *                                                         (4 bytes each)                                                                                                                                                                                       
+     *    then blocks, each of                                                                                                                                                                                                                                      
+     *      probes and loop records, bytes of them, bytes packed                                                                                                                                                                                                    
+     *                                                         (4 bytes each)                                                                                                                                                                                       
+     *      the bytes packed by qqoutputz, which unpack to                                                                                                                                                                                                          
+     *      each probe less the one before it (0 before the first of the                                                                                                                                                                                            
+     *      block), zig-zag encoded in 7 bit groups, low first, the top bit                                                                                                                                                                                         
+     *      set on all but the last group                                                                                                                                                                                                                           
+     *      a loop record as 0x80 0x00, never the start of a probe, then                                                                                                                                                                                            
+     *      the period and the repeats in 7 bit groups: the last period                                                                                                                                                                                             
+     *      probes are repeated that many times                                                                                                                                                                                                                     
+     *    exhconvert turns it back into the text history.                                                                                                                                                                                                           
+     * -----------------------------------------------------------------------------                                                                                                                                                                                
+     */                                                                                                                                                                                                                                                             
+    static void qqoutputh(FILEPOINT int fileid,int branches)                                                                                                                                                                                                        
+    {                                                                                                                                                                                                                                                               
+      unsigned char t[24];                                                                                                                                                                                                                                          
+      unsigned int h[4];                                                                                                                                                                                                                                            
+      int j;                                                                                                                                                                                                                                                        
+      h[0] = 2u;                                                                                                                                                                                                                                                    
+      h[1] = (unsigned int) fileid;                                                                                                                                                                                                                                 
+      h[2] = (unsigned int) branches;                                                                                                                                                                                                                               
+#ifdef QQQLOOP_EXH                                                                                                                                                                                                                                                  
+      h[3] = (unsigned int) QQQloopwin;                                                                                                                                                                                                                             
+#else  /* QQQLOOP_EXH */                                                                                                                                                                                                                                            
+      h[3] = 0u;                                                                                                                                                                                                                                                    
+#endif  /* QQQLOOP_EXH */                                                                                                                                                                                                                                           
+      for ( j = 0; j < 8; j++ )                                                                                                                                                                                                                                     
+      {                                                                                                                                                                                                                                                             
+        t[j] = (unsigned char) "LDRAEXHB"[j];                                                                                                                                                                                                                       
+      }                                                                                                                                                                                                                                                             
+      for ( j = 0; j < 16; j++ )                                                                                                                                                                                                                                    
+      {                                                                                                                                                                                                                                                             
+        t[8 + j] = (unsigned char) (h[j / 4] >> (8 * (j % 4)));                                                                                                                                                                                                     
+      }                                                                                                                                                                                                                                                             
+#ifdef QQQSIGNAL_EXH                                                                                                                                                                                                                                                
+      qqoutputw(fileno(f), t, (int) sizeof(t));                                                                                                                                                                                                                     
+#else  /* QQQSIGNAL_EXH */                                                                                                                                                                                                                                          
+      fwrite(t, 1, sizeof(t), f);                                                                                                                                                                                                                                   
+#endif  /* QQQSIGNAL_EXH */                                                                                                                                                                                                                                         
+    } /* end of qqoutputh */                                                                                                                                                                                                                                        
+#else  /* QQQBINARY_EXH */                                                                                                                                                                                                                                          
+    {                                                                                                                                                                                                                                                               
+      static char t[QQQexhblk * 12];                                                                                                                                                                                                                                
+      int k = 0;                                                                                                                                                                                                                                                    
+      while ( n-- > 0 )                                                                                                                                                                                                                                             
+      {                                                                                                                                                                                                                                                             
+        k += qqoutputd(t + k, *p++);                                                                                                                                                                                                                                
+        if ( k > (int) sizeof(t) - 12 )                                                                                                                                                                                                                             
+        {                                                                                                                                                                                                                                                           
+#ifdef QQQSIGNAL_EXH                                                                                                                                                                                                                                                
+          qqoutputw(fileno(f), t, k);                                                                                                                                                                                                                               
+#else  /* QQQSIGNAL_EXH */                                                                                                                                                                                                                                          
+          fwrite(t, 1, (size_t) k, f);                                                                                                                                                                                                                              
+#endif  /* QQQSIGNAL_EXH */                                                                                                                                                                                                                                         
+          k = 0;                                                                                                                                                                                                                                                    
+        }                                                                                                                                                                                                                                                           
+      }                                                                                                                                                                                                                                                             
+      if ( k > 0 )                                                                                                                                                                                                                                                  
+      {                                                                                                                                                                                                                                                             
+#ifdef QQQSIGNAL_EXH                                                                                                                                                                                                                                                
+        qqoutputw(fileno(f), t, k);                                                                                                                                                                                                                                 
+#else  /* QQQSIGNAL_EXH */                                                                                                                                                                                                                                          
+        fwrite(t, 1, (size_t) k, f);                                                                                                                                                                                                                                
+#endif  /* QQQSIGNAL_EXH */                                                                                                                                                                                                                                         
+      }                                                                                                                                                                                                                                                             
+    } /* end of qqoutputn */                                                                                                                                                                                                                                        
+#endif  /* QQQBINARY_EXH */                                                                                                                                                                                                                                         
+#endif  /* QQQBUFFERED_EXH || QQQthreaded */                                                                                                                                                                                                                        
+#if defined(QQQSIGNAL_EXH) || ((defined(QQQBUFFERED_EXH) || defined(QQQthreaded)) && !defined(QQQBINARY_EXH))                                                                                                                                                       
+    /* ----------------------------------------------------------------------* 207 *                                                                                                                                                                                
+     *            qqoutputd                                                                                                                                                                                                                                         
+     *    Puts i as qqoutput does with qqqqone, "%6d\n", and returns the                                                                                                                                                                                            
+     *    characters put, at most 12. It calls nothing, so it may be used in                                                                                                                                                                                        
+     *    a signal handler.                                                                                                                                                                                                                                         
+     * -----------------------------------------------------------------------------                                                                                                                                                                                
+     */                                                                                                                                                                                                                                                             
+    static int qqoutputd(char * t,int i)                                                                                                                                                                                                                            
+    {                                                                                                                                                                                                                                                               
+      char d[12];                                                                                                                                                                                                                                                   
+      unsigned int u;                                                                                                                                                                                                                                               
+      int k = 0;                                                                                                                                                                                                                                                    
+      int m = 0;                                                                                                                                                                                                                                                    
+      /* the digits reversed then padded to width 6 */                                                                                                                                                                                                              
+      u = ( i < 0 ) ? 0u - (unsigned int) i : (unsigned int) i;                                                                                                                                                                                                     
+      do                                                                                                                                                                                                                                                            
+      {                                                                                                                                                                                                                                                             
+        d[m++] = (char) ('0' + u % 10u);                                                                                                                                                                                                                            
+        u /= 10u;                                                                                                                                                                                                                                                   
+      } while ( u != 0u );                                                                                                                                                                                                                                          
+      if ( i < 0 )                                                                                                                                                                                                                                                  
+      {                                                                                                                                                                                                                                                             
+        d[m++] = '-';                                                                                                                                                                                                                                               
+      }                                                                                                                                                                                                                                                             
+      while ( m < 6 )                                                                                                                                                                                                                                               
+      {                                                                                                                                                                                                                                                             
+        d[m++] = ' ';                                                                                                                                                                                                                                               
+      }                                                                                                                                                                                                                                                             
+      while ( m > 0 )                                                                                                                                                                                                                                               
+      {                                                                                                                                                                                                                                                             
+        t[k++] = d[--m];                                                                                                                                                                                                                                            
+      }                                                                                                                                                                                                                                                             
+      t[k++] = '\n';                                                                                                                                                                                                                                                
+      return(k);                                                                                                                                                                                                                                                    
+    } /* end of qqoutputd */                                                                                                                                                                                                                                        
+#endif  /* QQQSIGNAL_EXH || ((QQQBUFFERED_EXH || QQQthreaded) && !QQQBINARY_EXH) */                                                                                                                                                                                 
+#ifdef QQQSIGNAL_EXH                                                                                                                                                                                                                                                
+    /* ----------------------------------------------------------------------* 208 *                                                                                                                                                                                
+     *            qqoutputw                                                                                                                                                                                                                                         
+     *    Writes k bytes to the file descriptor d. write, unlike fwrite, may                                                                                                                                                                                        
+     *    be called in a signal handler, and leaves nothing in the buffer of                                                                                                                                                                                        
+     *    the stream to be lost.                                                                                                                                                                                                                                    
+     * -----------------------------------------------------------------------------                                                                                                                                                                                
+     */                                                                                                                                                                                                                                                             
+    static void qqoutputw(int d,const void * t,int k)                                                                                                                                                                                                               
+    {                                                                                                                                                                                                                                                               
+      const char * c = (const char *) t;                                                                                                                                                                                                                            
+      ssize_t w;                                                                                                                                                                                                                                                    
+      while ( k > 0 )                                                                                                                                                                                                                                               
+      {                                                                                                                                                                                                                                                             
+        w = write(d, c, (size_t) k);                                                                                                                                                                                                                                
+        if ( w < 0 && errno == EINTR )                                                                                                                                                                                                                              
+        {                                                                                                                                                                                                                                                           
+          continue;                                                                                                                                                                                                                                                 
+        }                                                                                                                                                                                                                                                           
+        if ( w <= 0 )                                                                                                                                                                                                                                               
+        {                                                                                                                                                                                                                                                           
+          return;                                                                                                                                                                                                                                                   
+        }                                                                                                                                                                                                                                                           
+        c += w;                                                                                                                                                                                                                                                     
+        k -= (int) w;                                                                                                                                                                                                                                               
+      }                                                                                                                                                                                                                                                             
+    } /* end of qqoutputw */                                                                                                                                                                                                                                        
+#endif  /* QQQSIGNAL_EXH */                                                                                                                                                                                                                                         
   /* ----------------------------------------------------------------------* 206 *                                                                                                                                                                                  
    *            end of qqoutput* suite                                                                                                                                                                                                                              
    * -----------------------------------------------------------------------------                                                                                                                                                                                  
@@ -272,20 +836,52 @@ int
    */                                                                                                                                                                                                                                                               
   static int program_21zqqzqz1(qqnull_params)                                                                                                                                                                                                                       
   {                                                                                                                                                                                                                                                                 
+#ifdef QQQSIGNAL_EXH                                                                                                                                                                                                                                                
+    int qqqg = program_21zzgbeg();                                                                                                                                                                                                                                  
+#endif  /* QQQSIGNAL_EXH */                                                                                                                                                                                                                                         
     if ( program_21zzopen != 1 )                                                                                                                                                                                                                                    
     {                                                                                                                                                                                                                                                               
       if ( program_21zzopen == 0 )                                                                                                                                                                                                                                  
       {                                                                                                                                                                                                                                                             
+#ifdef QQQSIGNAL_EXH                                                                                                                                                                                                                                                
+      program_21zzgins();                                                                                                                                                                                                                                           
+#endif  /* QQQSIGNAL_EXH */                                                                                                                                                                                                                                         
+#if defined(QQQMAPPED_EXH)                                                                                                                                                                                                                                          
+      program_21zzmopn(1);                                                                                                                                                                                                                                          
+#elif defined(QQQBINARY_EXH)                                                                                                                                                                                                                                        
+      program_21zzhfil =                                                                                                                                                                                                                                            
+           fopen( "program_21.exb","wb");                                                                                                                                                                                                                           
+      qqoutputh(program_21zzhfil, zzfileid, qqqbranches);                                                                                                                                                                                                           
+#else  /* QQQBINARY_EXH */                                                                                                                                                                                                                                          
       program_21zzhfil =                                                                                                                                                                                                                                            
            fopen( "program_21.exh","w");  /* 12 */                                                                                                                                                                                                                  
+#endif  /* QQQBINARY_EXH */                                                                                                                                                                                                                                         
+#if defined(QQQLOOP_EXH) && !defined(QQQNOATEXIT)                                                                                                                                                                                                                   
+      atexit(program_21zzlend);                                                                                                                                                                                                                                     
+#elif defined(QQQASYNC_EXH) && !defined(QQQNOATEXIT)                                                                                                                                                                                                                
+      /* not program_21zzflsh, which may drop the last buffer */                                                                                                                                                                                                    
+      atexit(program_21zzhdrn);                                                                                                                                                                                                                                     
+#elif defined(QQQBUFFERED_EXH) && !defined(QQQNOATEXIT)                                                                                                                                                                                                             
+      atexit(program_21zzflsh);                                                                                                                                                                                                                                     
+#endif  /* QQQBUFFERED_EXH && !QQQNOATEXIT */                                                                                                                                                                                                                       
       }                                                                                                                                                                                                                                                             
       else                                                                                                                                                                                                                                                          
       {                                                                                                                                                                                                                                                             
+#if defined(QQQMAPPED_EXH)                                                                                                                                                                                                                                          
+        program_21zzmopn(0);                                                                                                                                                                                                                                        
+#elif defined(QQQBINARY_EXH)                                                                                                                                                                                                                                        
+        program_21zzhfil =                                                                                                                                                                                                                                          
+             fopen( "program_21.exb","ab");                                                                                                                                                                                                                         
+#else  /* QQQBINARY_EXH */                                                                                                                                                                                                                                          
         program_21zzhfil =                                                                                                                                                                                                                                          
              fopen( "program_21.exh","a");  /* 13 */                                                                                                                                                                                                                
+#endif  /* QQQBINARY_EXH */                                                                                                                                                                                                                                         
       }                                                                                                                                                                                                                                                             
       program_21zzopen = 1;                                                                                                                                                                                                                                         
     }                                                                                                                                                                                                                                                               
+#ifdef QQQSIGNAL_EXH                                                                                                                                                                                                                                                
+    program_21zzgend(qqqg);                                                                                                                                                                                                                                         
+#endif  /* QQQSIGNAL_EXH */                                                                                                                                                                                                                                         
     return(1);                                                                                                                                                                                                                                                      
   }                                                                                                                                                                                                                                                                 
   /* ----------- zzqqzz ---------------------------------------------------* 308 *                                                                                                                                                                                  
@@ -301,20 +897,1079 @@ int
    */                                                                                                                                                                                                                                                               
   static int program_21zzqqzz(int qqqi)                                                                                                                                                                                                                             
   {                                                                                                                                                                                                                                                                 
+#ifdef QQQSIGNAL_EXH                                                                                                                                                                                                                                                
+    /* a signal now is put off until the probe is recorded */                                                                                                                                                                                                       
+    int qqqg = program_21zzgbeg();                                                                                                                                                                                                                                  
+    if ( (unsigned int) qqqi <= (unsigned int) qqqbranches )                                                                                                                                                                                                        
+    {                                                                                                                                                                                                                                                               
+      program_21zzgbit[qqqi >> 3] |= (unsigned char) (1 << (qqqi & 7));                                                                                                                                                                                             
+    }                                                                                                                                                                                                                                                               
+#endif  /* QQQSIGNAL_EXH */                                                                                                                                                                                                                                         
+#if defined(QQQBITMAP_EXH) && defined(QQQINLINE_PROBES)                                                                                                                                                                                                             
+    /* bitmap, inlined where the probe is hit: qqqi is a constant, so the                                                                                                                                                                                           
+     * test goes and the probe is a single store (a test and, the first                                                                                                                                                                                             
+     * time, an atomic or when threaded) */                                                                                                                                                                                                                         
+    if ( (unsigned int) qqqi <= (unsigned int) qqqbranches )                                                                                                                                                                                                        
+    {                                                                                                                                                                                                                                                               
+#if defined(QQQBITMAP_ATOMIC)                                                                                                                                                                                                                                       
+      if ( !(program_21zzhbit[qqqi >> 3] & (1 << (qqqi & 7))) )                                                                                                                                                                                                     
+      {                                                                                                                                                                                                                                                             
+        __sync_fetch_and_or(&program_21zzhbit[qqqi >> 3], (unsigned char) (1 << (qqqi & 7)));                                                                                                                                                                       
+      }                                                                                                                                                                                                                                                             
+#else  /* QQQBITMAP_ATOMIC */                                                                                                                                                                                                                                       
+      program_21zzhbit[qqqi >> 3] |= (unsigned char) (1 << (qqqi & 7));                                                                                                                                                                                             
+#endif  /* QQQBITMAP_ATOMIC */                                                                                                                                                                                                                                      
+    }                                                                                                                                                                                                                                                               
+#elif defined(QQQBITMAP_EXH)                                                                                                                                                                                                                                        
+    /* bitmap, a probe is only set the first time it is hit */                                                                                                                                                                                                      
+    if ( (unsigned int) qqqi <= (unsigned int) qqqbranches                                                                                                                                                                                                          
+         && !(program_21zzhbit[qqqi >> 3] & (1 << (qqqi & 7))) )                                                                                                                                                                                                    
+    {                                                                                                                                                                                                                                                               
+#if defined(QQQBITMAP_ATOMIC)                                                                                                                                                                                                                                       
+      /* another thread may be setting a bit of the same byte */                                                                                                                                                                                                    
+      __sync_fetch_and_or(&program_21zzhbit[qqqi >> 3], (unsigned char) (1 << (qqqi & 7)));                                                                                                                                                                         
+#if !defined(QQQNOATEXIT)                                                                                                                                                                                                                                           
+      if ( !program_21zzhreg && !__sync_lock_test_and_set(&program_21zzhreg, 1) )                                                                                                                                                                                   
+      {                                                                                                                                                                                                                                                             
+        atexit(program_21zzhdmp);                                                                                                                                                                                                                                   
+      }                                                                                                                                                                                                                                                             
+#endif  /* !defined(QQQNOATEXIT) */                                                                                                                                                                                                                                 
+#else  /* QQQBITMAP_ATOMIC */                                                                                                                                                                                                                                       
+      program_21zzhbit[qqqi >> 3] |= (unsigned char) (1 << (qqqi & 7));                                                                                                                                                                                             
+#if !defined(QQQNOATEXIT)                                                                                                                                                                                                                                           
+      if ( !program_21zzhreg )                                                                                                                                                                                                                                      
+      {                                                                                                                                                                                                                                                             
+        program_21zzhreg = 1;                                                                                                                                                                                                                                       
+        atexit(program_21zzhdmp);                                                                                                                                                                                                                                   
+      }                                                                                                                                                                                                                                                             
+#endif  /* !defined(QQQNOATEXIT) */                                                                                                                                                                                                                                 
+#endif  /* QQQBITMAP_ATOMIC */                                                                                                                                                                                                                                      
+    }                                                                                                                                                                                                                                                               
+#elif defined(QQQSAMPLED_EXH)                                                                                                                                                                                                                                       
+    /* sampled, a thread counts QQQsampleon probes then skips QQQsampleoff,                                                                                                                                                                                         
+     * on average */                                                                                                                                                                                                                                                
+    int qqqd = program_21zzsdwn;                                                                                                                                                                                                                                    
+    if ( qqqd <= 0 )                                                                                                                                                                                                                                                
+    {                                                                                                                                                                                                                                                               
+      qqqd = program_21zzsgap();                                                                                                                                                                                                                                    
+    }                                                                                                                                                                                                                                                               
+    program_21zzsdwn = qqqd - 1;                                                                                                                                                                                                                                    
+    if ( qqqd <= QQQsampleon && (unsigned int) qqqi <= (unsigned int) qqqbranches )                                                                                                                                                                                 
+    {                                                                                                                                                                                                                                                               
+      program_21zzsamp(qqqi);                                                                                                                                                                                                                                       
+    }                                                                                                                                                                                                                                                               
+#elif defined(QQQthreaded)                                                                                                                                                                                                                                          
+    /* threaded, into the buffer of this thread without a lock */                                                                                                                                                                                                   
+    struct program_21zzthrd * qqqt = program_21zzhthr;                                                                                                                                                                                                              
+    if ( qqqt == 0 && (qqqt = program_21zzthr1()) == 0 )                                                                                                                                                                                                            
+    {                                                                                                                                                                                                                                                               
+      return(1);                                                                                                                                                                                                                                                    
+    }                                                                                                                                                                                                                                                               
+    if ( qqqt->count == QQQthrbuf )                                                                                                                                                                                                                                 
+    {                                                                                                                                                                                                                                                               
+      program_21zzthrf(qqqt);                                                                                                                                                                                                                                       
+    }                                                                                                                                                                                                                                                               
+    qqqt->probes[qqqt->count++] = qqqi;                                                                                                                                                                                                                             
+#else  /* QQQBITMAP_EXH */                                                                                                                                                                                                                                          
     if ( program_21zzopen != 1 )                                                                                                                                                                                                                                    
     {                                                                                                                                                                                                                                                               
       program_21zqqzqz1();                                                                                                                                                                                                                                          
     }                                                                                                                                                                                                                                                               
     if ( program_21zzopen )                                                                                                                                                                                                                                         
     {                                                                                                                                                                                                                                                               
+#if defined(QQQMAPPED_EXH)                                                                                                                                                                                                                                          
+      /* mapped, the probe then the cursor, so the file is whole after a crash */                                                                                                                                                                                   
+      if ( program_21zzmmap != 0 )                                                                                                                                                                                                                                  
+      {                                                                                                                                                                                                                                                             
+        unsigned int qqqc = program_21zzmmap->count;                                                                                                                                                                                                                
+        program_21zzmrng[qqqc & (QQQmapsize - 1)] = qqqi;                                                                                                                                                                                                           
+        program_21zzmmap->count = qqqc + 1;                                                                                                                                                                                                                         
+        if ( qqqc + 1 == QQQmapsize )                                                                                                                                                                                                                               
+        {                                                                                                                                                                                                                                                           
+          program_21zzmmap->wrapped = 1;                                                                                                                                                                                                                            
+        }                                                                                                                                                                                                                                                           
+      }                                                                                                                                                                                                                                                             
+#elif defined(QQQLOOP_EXH)                                                                                                                                                                                                                                          
+      /* loops found */                                                                                                                                                                                                                                             
+      program_21zzloop(qqqi);                                                                                                                                                                                                                                       
+#elif defined(QQQBUFFERED_EXH)                                                                                                                                                                                                                                      
+      /* buffered */                                                                                                                                                                                                                                                
+      program_21zzhbuf[program_21zzhcnt++] = qqqi;                                                                                                                                                                                                                  
+      if ( program_21zzhcnt == QQQexhbuf )                                                                                                                                                                                                                          
+      {                                                                                                                                                                                                                                                             
+        program_21zzflsh();                                                                                                                                                                                                                                         
+      }                                                                                                                                                                                                                                                             
+#else  /* QQQBUFFERED_EXH */                                                                                                                                                                                                                                        
       /* streamed */                                                                                                                                                                                                                                                
       /* unbuffered */                                                                                                                                                                                                                                              
         qqoutput(                                                                                                                                                                                                                                                   
         program_21zzhfil,                                                                                                                                                                                                                                           
           qqqqone, qqqi);                                                                                                                                                                                                                                           
+#endif  /* QQQBUFFERED_EXH */                                                                                                                                                                                                                                       
     }                                                                                                                                                                                                                                                               
+#endif  /* QQQBITMAP_EXH */                                                                                                                                                                                                                                         
+#ifdef QQQSIGNAL_EXH                                                                                                                                                                                                                                                
+    program_21zzgend(qqqg);                                                                                                                                                                                                                                         
+#endif  /* QQQSIGNAL_EXH */                                                                                                                                                                                                                                         
     return(1);                                                                                                                                                                                                                                                      
   } /* End of zzqqzz */                                                                                                                                                                                                                                             
+#ifdef QQQBITMAP_EXH                                                                                                                                                                                                                                                
+  /* ----------- zzhdmp ---------------------------------------------------* 314 *                                                                                                                                                                                  
+   * -----------------------------------------------------------------------------                                                                                                                                                                                  
+   */                                                                                                                                                                                                                                                               
+  /* ----------------------------------------------------------------------* 315 *                                                                                                                                                                                  
+   * This routine dumps the bitmap to the execution history, each probe hit                                                                                                                                                                                         
+   * once in ascending order, and clears it. It is called by program_21zqzqzq                                                                                                                                                                                       
+   * and at exit, so a probe does no output.                                                                                                                                                                                                                        
+   * -----------------------------------------------------------------------------                                                                                                                                                                                  
+   */                                                                                                                                                                                                                                                               
+  static void program_21zzhdmp(qqnull_params)                                                                                                                                                                                                                       
+  {                                                                                                                                                                                                                                                                 
+    int qqqj;                                                                                                                                                                                                                                                       
+#if defined(QQQBINARY_EXH) || defined(QQQSIGNAL_EXH)                                                                                                                                                                                                                
+    int qqqk[256];                                                                                                                                                                                                                                                  
+    int qqqn = 0;                                                                                                                                                                                                                                                   
+#endif  /* QQQBINARY_EXH || QQQSIGNAL_EXH */                                                                                                                                                                                                                        
+#ifdef QQQSIGNAL_EXH                                                                                                                                                                                                                                                
+    int qqqg = program_21zzgbeg();                                                                                                                                                                                                                                  
+#endif  /* QQQSIGNAL_EXH */                                                                                                                                                                                                                                         
+    for ( qqqj = 0; qqqj <= qqqbranches; qqqj++ )                                                                                                                                                                                                                   
+    {                                                                                                                                                                                                                                                               
+      if ( program_21zzhbit[qqqj >> 3] & (1 << (qqqj & 7)) )                                                                                                                                                                                                        
+      {                                                                                                                                                                                                                                                             
+        if ( program_21zzopen != 1 )                                                                                                                                                                                                                                
+        {                                                                                                                                                                                                                                                           
+          program_21zqqzqz1();                                                                                                                                                                                                                                      
+        }                                                                                                                                                                                                                                                           
+#if defined(QQQBINARY_EXH) || defined(QQQSIGNAL_EXH)                                                                                                                                                                                                                
+        qqqk[qqqn++] = qqqj;                                                                                                                                                                                                                                        
+        if ( qqqn == 256 )                                                                                                                                                                                                                                          
+        {                                                                                                                                                                                                                                                           
+          qqoutputn(program_21zzhfil, qqqk, qqqn);                                                                                                                                                                                                                  
+          qqqn = 0;                                                                                                                                                                                                                                                 
+        }                                                                                                                                                                                                                                                           
+#else  /* QQQBINARY_EXH || QQQSIGNAL_EXH */                                                                                                                                                                                                                         
+        qqoutput(program_21zzhfil, qqqqone, qqqj);                                                                                                                                                                                                                  
+#endif  /* QQQBINARY_EXH || QQQSIGNAL_EXH */                                                                                                                                                                                                                        
+      }                                                                                                                                                                                                                                                             
+    }                                                                                                                                                                                                                                                               
+#if defined(QQQBINARY_EXH) || defined(QQQSIGNAL_EXH)                                                                                                                                                                                                                
+    if ( qqqn > 0 )                                                                                                                                                                                                                                                 
+    {                                                                                                                                                                                                                                                               
+      qqoutputn(program_21zzhfil, qqqk, qqqn);                                                                                                                                                                                                                      
+    }                                                                                                                                                                                                                                                               
+#endif  /* QQQBINARY_EXH || QQQSIGNAL_EXH */                                                                                                                                                                                                                        
+    for ( qqqj = 0; qqqj < (int) sizeof(program_21zzhbit); qqqj++ )                                                                                                                                                                                                 
+    {                                                                                                                                                                                                                                                               
+      program_21zzhbit[qqqj] = 0;                                                                                                                                                                                                                                   
+    }                                                                                                                                                                                                                                                               
+#ifdef QQQSIGNAL_EXH                                                                                                                                                                                                                                                
+    program_21zzgend(qqqg);                                                                                                                                                                                                                                         
+#endif  /* QQQSIGNAL_EXH */                                                                                                                                                                                                                                         
+  } /* End of zzhdmp */                                                                                                                                                                                                                                             
+#if defined(QQQINLINE_PROBES) && !defined(QQQNOATEXIT)                                                                                                                                                                                                              
+  /* ----------------------------------------------------------------------* 328 *                                                                                                                                                                                  
+   *            program_21zzinit                                                                                                                                                                                                                                    
+   * Inlined bitmap probes only store, so the dump at exit is registered                                                                                                                                                                                            
+   * when the program starts.                                                                                                                                                                                                                                       
+   * -----------------------------------------------------------------------------                                                                                                                                                                                  
+   */                                                                                                                                                                                                                                                               
+  static void program_21zzinit(qqnull_params)                                                                                                                                                                                                                       
+  {                                                                                                                                                                                                                                                                 
+    program_21zzhreg = 1;                                                                                                                                                                                                                                           
+    atexit(program_21zzhdmp);                                                                                                                                                                                                                                       
+  } /* End of zzinit */                                                                                                                                                                                                                                             
+#endif  /* QQQINLINE_PROBES && !QQQNOATEXIT */                                                                                                                                                                                                                      
+#endif  /* QQQBITMAP_EXH */                                                                                                                                                                                                                                         
+#ifdef QQQSAMPLED_EXH                                                                                                                                                                                                                                               
+  /* ----------- zzsamp ---------------------------------------------------* 335 *                                                                                                                                                                                  
+   * -----------------------------------------------------------------------------                                                                                                                                                                                  
+   */                                                                                                                                                                                                                                                               
+  /* ----------------------------------------------------------------------* 336 *                                                                                                                                                                                  
+   * This routine counts a hit of a probe in a sampling window. The count is                                                                                                                                                                                        
+   * shared by all the threads, so it is added atomically, only windows pay.                                                                                                                                                                                        
+   * -----------------------------------------------------------------------------                                                                                                                                                                                  
+   */                                                                                                                                                                                                                                                               
+  static void program_21zzsamp(int qqqi)                                                                                                                                                                                                                            
+  {                                                                                                                                                                                                                                                                 
+    __sync_fetch_and_add(&program_21zzscnt[qqqi], 1ul);                                                                                                                                                                                                             
+#if !defined(QQQNOATEXIT)                                                                                                                                                                                                                                           
+    if ( !program_21zzsreg && !__sync_lock_test_and_set(&program_21zzsreg, 1) )                                                                                                                                                                                     
+    {                                                                                                                                                                                                                                                               
+      atexit(program_21zzsdmp);                                                                                                                                                                                                                                     
+    }                                                                                                                                                                                                                                                               
+#endif  /* !defined(QQQNOATEXIT) */                                                                                                                                                                                                                                 
+  } /* End of zzsamp */                                                                                                                                                                                                                                             
+  /* ----------------------------------------------------------------------* 339 *                                                                                                                                                                                  
+   *            program_21zzsgap                                                                                                                                                                                                                                    
+   * Probes to the end of the next window of this thread: a gap of 0 to                                                                                                                                                                                             
+   * 2 * QQQsampleoff probes, then QQQsampleon. A gap of fixed length would                                                                                                                                                                                         
+   * see the same probes each time round a loop whose length divides it.                                                                                                                                                                                            
+   * -----------------------------------------------------------------------------                                                                                                                                                                                  
+   */                                                                                                                                                                                                                                                               
+  static int program_21zzsgap(qqnull_params)                                                                                                                                                                                                                        
+  {                                                                                                                                                                                                                                                                 
+    unsigned int qqqr = program_21zzsrnd;                                                                                                                                                                                                                           
+    if ( qqqr == 0u )                                                                                                                                                                                                                                               
+    {                                                                                                                                                                                                                                                               
+      qqqr = 2463534242u ^ (unsigned int) (unsigned long) &program_21zzsrnd;                                                                                                                                                                                        
+    }                                                                                                                                                                                                                                                               
+    qqqr ^= qqqr << 13;                                                                                                                                                                                                                                             
+    qqqr ^= qqqr >> 17;                                                                                                                                                                                                                                             
+    qqqr ^= qqqr << 5;                                                                                                                                                                                                                                              
+    program_21zzsrnd = qqqr;                                                                                                                                                                                                                                        
+    return(QQQsampleon + (int) (qqqr % (2u * QQQsampleoff + 1u)));                                                                                                                                                                                                  
+  } /* End of zzsgap */                                                                                                                                                                                                                                             
+  /* ----------- zzsdmp ---------------------------------------------------* 337 *                                                                                                                                                                                  
+   * -----------------------------------------------------------------------------                                                                                                                                                                                  
+   */                                                                                                                                                                                                                                                               
+  /* ----------------------------------------------------------------------* 338 *                                                                                                                                                                                  
+   * This routine writes program_21.exc, each probe counted and its hits                                                                                                                                                                                            
+   * estimated from the windows,                                                                                                                                                                                                                                    
+   *      probe  hits      ("%6d %10lu")                                                                                                                                                                                                                            
+   * and adds the probes not yet in it to the execution history, once each in                                                                                                                                                                                       
+   * ascending order, for coverage. It is called by program_21zqzqzq and at                                                                                                                                                                                         
+   * exit. The counts go on, a later dump writes program_21.exc again.                                                                                                                                                                                              
+   * -----------------------------------------------------------------------------                                                                                                                                                                                  
+   */                                                                                                                                                                                                                                                               
+  static void program_21zzsdmp(qqnull_params)                                                                                                                                                                                                                       
+  {                                                                                                                                                                                                                                                                 
+    FILE * qqqf;                                                                                                                                                                                                                                                    
+    int qqqj;                                                                                                                                                                                                                                                       
+#ifdef QQQBINARY_EXH                                                                                                                                                                                                                                                
+    int qqqk[256];                                                                                                                                                                                                                                                  
+    int qqqn = 0;                                                                                                                                                                                                                                                   
+#endif  /* QQQBINARY_EXH */                                                                                                                                                                                                                                         
+    qqqf = fopen( "program_21.exc","w");                                                                                                                                                                                                                            
+    for ( qqqj = 0; qqqj <= qqqbranches; qqqj++ )                                                                                                                                                                                                                   
+    {                                                                                                                                                                                                                                                               
+      if ( program_21zzscnt[qqqj] > 0 )                                                                                                                                                                                                                             
+      {                                                                                                                                                                                                                                                             
+        if ( qqqf != 0 )                                                                                                                                                                                                                                            
+        {                                                                                                                                                                                                                                                           
+          fprintf(qqqf, "%6d %10lu\n", qqqj,                                                                                                                                                                                                                        
+                  (unsigned long) ((double) program_21zzscnt[qqqj] * (QQQsampleon + QQQsampleoff) / QQQsampleon + 0.5));                                                                                                                                            
+        }                                                                                                                                                                                                                                                           
+        if ( !(program_21zzsput[qqqj >> 3] & (1 << (qqqj & 7))) )                                                                                                                                                                                                   
+        {                                                                                                                                                                                                                                                           
+          program_21zzsput[qqqj >> 3] |= (unsigned char) (1 << (qqqj & 7));                                                                                                                                                                                         
+          if ( program_21zzopen != 1 )                                                                                                                                                                                                                              
+          {                                                                                                                                                                                                                                                         
+            program_21zqqzqz1();                                                                                                                                                                                                                                    
+          }                                                                                                                                                                                                                                                         
+#ifdef QQQBINARY_EXH                                                                                                                                                                                                                                                
+          qqqk[qqqn++] = qqqj;                                                                                                                                                                                                                                      
+          if ( qqqn == 256 )                                                                                                                                                                                                                                        
+          {                                                                                                                                                                                                                                                         
+            qqoutputn(program_21zzhfil, qqqk, qqqn);                                                                                                                                                                                                                
+            qqqn = 0;                                                                                                                                                                                                                                               
+          }                                                                                                                                                                                                                                                         
+#else  /* QQQBINARY_EXH */                                                                                                                                                                                                                                          
+          qqoutput(program_21zzhfil, qqqqone, qqqj);                                                                                                                                                                                                                
+#endif  /* QQQBINARY_EXH */                                                                                                                                                                                                                                         
+        }                                                                                                                                                                                                                                                           
+      }                                                                                                                                                                                                                                                             
+    }                                                                                                                                                                                                                                                               
+#ifdef QQQBINARY_EXH                                                                                                                                                                                                                                                
+    if ( qqqn > 0 )                                                                                                                                                                                                                                                 
+    {                                                                                                                                                                                                                                                               
+      qqoutputn(program_21zzhfil, qqqk, qqqn);                                                                                                                                                                                                                      
+    }                                                                                                                                                                                                                                                               
+#endif  /* QQQBINARY_EXH */                                                                                                                                                                                                                                         
+    if ( qqqf != 0 )                                                                                                                                                                                                                                                
+    {                                                                                                                                                                                                                                                               
+      fclose(qqqf);                                                                                                                                                                                                                                                 
+    }                                                                                                                                                                                                                                                               
+  } /* End of zzsdmp */                                                                                                                                                                                                                                             
+#endif  /* QQQSAMPLED_EXH */                                                                                                                                                                                                                                        
+#ifdef QQQBUFFERED_EXH                                                                                                                                                                                                                                              
+  /* ----------- zzflsh ---------------------------------------------------* 312 *                                                                                                                                                                                  
+   * -----------------------------------------------------------------------------                                                                                                                                                                                  
+   */                                                                                                                                                                                                                                                               
+  /* ----------------------------------------------------------------------* 313 *                                                                                                                                                                                  
+   * This routine writes the buffered probes to the execution history. It is                                                                                                                                                                                        
+   * called when the buffer is full, by program_21zqzqzq and at exit.                                                                                                                                                                                               
+   * With QQQASYNC_EXH the buffer is only handed to the thread writing the                                                                                                                                                                                          
+   * history, started here the first time, and the probes go on into the                                                                                                                                                                                            
+   * next buffer of the ring. If that is still full QQQasyncfull decides:                                                                                                                                                                                           
+   * wait for it, drop the probes of this buffer, or add a buffer to the                                                                                                                                                                                            
+   * ring after this one. At the end program_21zzhdrn is called instead, so                                                                                                                                                                                         
+   * the last buffer is never dropped.                                                                                                                                                                                                                              
+   * -----------------------------------------------------------------------------                                                                                                                                                                                  
+   */                                                                                                                                                                                                                                                               
+  static void program_21zzflsh(qqnull_params)                                                                                                                                                                                                                       
+  {                                                                                                                                                                                                                                                                 
+#ifdef QQQASYNC_EXH                                                                                                                                                                                                                                                 
+    struct program_21zzhblk * qqqb = program_21zzhcur;                                                                                                                                                                                                              
+    struct program_21zzhblk * qqqn;                                                                                                                                                                                                                                 
+    pthread_t qqqw;                                                                                                                                                                                                                                                 
+    int qqqj;                                                                                                                                                                                                                                                       
+    if ( program_21zzopen != 1 || program_21zzhcnt == 0 )                                                                                                                                                                                                           
+    {                                                                                                                                                                                                                                                               
+      program_21zzhcnt = 0;                                                                                                                                                                                                                                         
+      return;                                                                                                                                                                                                                                                       
+    }                                                                                                                                                                                                                                                               
+    if ( program_21zzhwon == 0 )                                                                                                                                                                                                                                    
+    {                                                                                                                                                                                                                                                               
+      for ( qqqj = 0; qqqj < QQQasyncbufs; qqqj++ )                                                                                                                                                                                                                 
+      {                                                                                                                                                                                                                                                             
+        program_21zzhrng[qqqj].next = &program_21zzhrng[(qqqj + 1) % QQQasyncbufs];                                                                                                                                                                                 
+      }                                                                                                                                                                                                                                                             
+      program_21zzhwon = -1;                                                                                                                                                                                                                                        
+      if ( sem_init(&program_21zzhsem, 0, 0) == 0                                                                                                                                                                                                                   
+           && pthread_create(&qqqw, 0, program_21zzhwrt, 0) == 0 )                                                                                                                                                                                                  
+      {                                                                                                                                                                                                                                                             
+        pthread_detach(qqqw);                                                                                                                                                                                                                                       
+        program_21zzhwon = 1;                                                                                                                                                                                                                                       
+      }                                                                                                                                                                                                                                                             
+    }                                                                                                                                                                                                                                                               
+    if ( program_21zzhwon != 1 )                                                                                                                                                                                                                                    
+    {                                                                                                                                                                                                                                                               
+      /* no thread, written here */                                                                                                                                                                                                                                 
+      qqoutputn(program_21zzhfil, program_21zzhbuf, program_21zzhcnt);                                                                                                                                                                                              
+      program_21zzhcnt = 0;                                                                                                                                                                                                                                         
+      return;                                                                                                                                                                                                                                                       
+    }                                                                                                                                                                                                                                                               
+    qqqn = qqqb->next;                                                                                                                                                                                                                                              
+    if ( __sync_fetch_and_add(&qqqn->full, 0) )                                                                                                                                                                                                                     
+    {                                                                                                                                                                                                                                                               
+#if QQQasyncfull == QQQasyncdrop                                                                                                                                                                                                                                    
+      program_21zzhdrp += (unsigned long) program_21zzhcnt;                                                                                                                                                                                                         
+      program_21zzhcnt = 0;                                                                                                                                                                                                                                         
+      return;                                                                                                                                                                                                                                                       
+#elif QQQasyncfull == QQQasyncgrow                                                                                                                                                                                                                                  
+      qqqn = (struct program_21zzhblk *) malloc(sizeof(struct program_21zzhblk));                                                                                                                                                                                   
+      if ( qqqn != 0 )                                                                                                                                                                                                                                              
+      {                                                                                                                                                                                                                                                             
+        qqqn->full = 0;                                                                                                                                                                                                                                             
+        qqqn->next = qqqb->next;                                                                                                                                                                                                                                    
+        qqqb->next = qqqn;                                                                                                                                                                                                                                          
+      }                                                                                                                                                                                                                                                             
+      else                                                                                                                                                                                                                                                          
+      {                                                                                                                                                                                                                                                             
+        qqqn = qqqb->next;                                                                                                                                                                                                                                          
+      }                                                                                                                                                                                                                                                             
+#endif  /* QQQasyncfull */                                                                                                                                                                                                                                          
+      while ( __sync_fetch_and_add(&qqqn->full, 0) )                                                                                                                                                                                                                
+      {                                                                                                                                                                                                                                                             
+        QQQthreadyield();                                                                                                                                                                                                                                           
+      }                                                                                                                                                                                                                                                             
+    }                                                                                                                                                                                                                                                               
+    qqqb->count = program_21zzhcnt;                                                                                                                                                                                                                                 
+    __sync_add_and_fetch(&qqqb->full, 1);                                                                                                                                                                                                                           
+    sem_post(&program_21zzhsem);                                                                                                                                                                                                                                    
+    program_21zzhcur = qqqn;                                                                                                                                                                                                                                        
+    program_21zzhbuf = qqqn->probes;                                                                                                                                                                                                                                
+#else  /* QQQASYNC_EXH */                                                                                                                                                                                                                                           
+#ifdef QQQSIGNAL_EXH                                                                                                                                                                                                                                                
+    int qqqg = program_21zzgbeg();                                                                                                                                                                                                                                  
+#endif  /* QQQSIGNAL_EXH */                                                                                                                                                                                                                                         
+    if ( program_21zzopen == 1 && program_21zzhcnt > 0 )                                                                                                                                                                                                            
+    {                                                                                                                                                                                                                                                               
+      qqoutputn(program_21zzhfil, program_21zzhbuf, program_21zzhcnt);                                                                                                                                                                                              
+    }                                                                                                                                                                                                                                                               
+#endif  /* QQQASYNC_EXH */                                                                                                                                                                                                                                          
+    program_21zzhcnt = 0;                                                                                                                                                                                                                                           
+#ifdef QQQSIGNAL_EXH                                                                                                                                                                                                                                                
+    program_21zzgend(qqqg);                                                                                                                                                                                                                                         
+#endif  /* QQQSIGNAL_EXH */                                                                                                                                                                                                                                         
+  } /* End of zzflsh */                                                                                                                                                                                                                                             
+#ifdef QQQASYNC_EXH                                                                                                                                                                                                                                                 
+  /* ----------------------------------------------------------------------* 332 *                                                                                                                                                                                  
+   *            program_21zzhwrt                                                                                                                                                                                                                                    
+   * The thread writing the history. It writes the buffers handed over in                                                                                                                                                                                           
+   * the order of the ring, then gives each back. The next buffer is taken                                                                                                                                                                                          
+   * before this one is given back, as a buffer may be added after it.                                                                                                                                                                                              
+   * -----------------------------------------------------------------------------                                                                                                                                                                                  
+   */                                                                                                                                                                                                                                                               
+  static void * program_21zzhwrt(void * qqqa)                                                                                                                                                                                                                       
+  {                                                                                                                                                                                                                                                                 
+    struct program_21zzhblk * qqqb = &program_21zzhrng[0];                                                                                                                                                                                                          
+    struct program_21zzhblk * qqqn;                                                                                                                                                                                                                                 
+    for ( ;; )                                                                                                                                                                                                                                                      
+    {                                                                                                                                                                                                                                                               
+      while ( sem_wait(&program_21zzhsem) != 0 )                                                                                                                                                                                                                    
+      {                                                                                                                                                                                                                                                             
+      }                                                                                                                                                                                                                                                             
+      while ( __sync_fetch_and_add(&qqqb->full, 0) )                                                                                                                                                                                                                
+      {                                                                                                                                                                                                                                                             
+        qqoutputn(program_21zzhfil, qqqb->probes, qqqb->count);                                                                                                                                                                                                     
+        qqqn = qqqb->next;                                                                                                                                                                                                                                          
+        __sync_sub_and_fetch(&qqqb->full, 1);                                                                                                                                                                                                                       
+        qqqb = qqqn;                                                                                                                                                                                                                                                
+      }                                                                                                                                                                                                                                                             
+    }                                                                                                                                                                                                                                                               
+    return(qqqa);                                                                                                                                                                                                                                                   
+  } /* End of zzhwrt */                                                                                                                                                                                                                                             
+  /* ----------------------------------------------------------------------* 333 *                                                                                                                                                                                  
+   *            program_21zzhdrn                                                                                                                                                                                                                                    
+   * Hands over the probes buffered, never dropping them, and waits until                                                                                                                                                                                           
+   * the thread has written every buffer. It is called by program_21zqzqzq,                                                                                                                                                                                         
+   * before the history is closed, by program_21zzlend and at exit.                                                                                                                                                                                                 
+   * -----------------------------------------------------------------------------                                                                                                                                                                                  
+   */                                                                                                                                                                                                                                                               
+  static void program_21zzhdrn(qqnull_params)                                                                                                                                                                                                                       
+  {                                                                                                                                                                                                                                                                 
+    struct program_21zzhblk * qqqb;                                                                                                                                                                                                                                 
+    while ( program_21zzhwon == 1 && program_21zzhcnt > 0                                                                                                                                                                                                           
+            && __sync_fetch_and_add(&program_21zzhcur->next->full, 0) )                                                                                                                                                                                             
+    {                                                                                                                                                                                                                                                               
+      QQQthreadyield();                                                                                                                                                                                                                                             
+    }                                                                                                                                                                                                                                                               
+    program_21zzflsh();                                                                                                                                                                                                                                             
+    if ( program_21zzhwon == 1 )                                                                                                                                                                                                                                    
+    {                                                                                                                                                                                                                                                               
+      qqqb = program_21zzhcur;                                                                                                                                                                                                                                      
+      do                                                                                                                                                                                                                                                            
+      {                                                                                                                                                                                                                                                             
+        while ( __sync_fetch_and_add(&qqqb->full, 0) )                                                                                                                                                                                                              
+        {                                                                                                                                                                                                                                                           
+          QQQthreadyield();                                                                                                                                                                                                                                         
+        }                                                                                                                                                                                                                                                           
+        qqqb = qqqb->next;                                                                                                                                                                                                                                          
+      } while ( qqqb != program_21zzhcur );                                                                                                                                                                                                                         
+    }                                                                                                                                                                                                                                                               
+    if ( program_21zzhdrp > 0 )                                                                                                                                                                                                                                     
+    {                                                                                                                                                                                                                                                               
+      fprintf(stderr, "program_21: %lu execution history entries dropped\n", program_21zzhdrp);                                                                                                                                                                     
+      program_21zzhdrp = 0;                                                                                                                                                                                                                                         
+    }                                                                                                                                                                                                                                                               
+  } /* End of zzhdrn */                                                                                                                                                                                                                                             
+#endif  /* QQQASYNC_EXH */                                                                                                                                                                                                                                          
+#endif  /* QQQBUFFERED_EXH */                                                                                                                                                                                                                                       
+#ifdef QQQMAPPED_EXH                                                                                                                                                                                                                                                
+  /* ----------- zzmopn ---------------------------------------------------* 330 *                                                                                                                                                                                  
+   * -----------------------------------------------------------------------------                                                                                                                                                                                  
+   */                                                                                                                                                                                                                                                               
+  /* ----------------------------------------------------------------------* 334 *                                                                                                                                                                                  
+   * This routine maps the execution history program_21.exm. A new history                                                                                                                                                                                          
+   * (qqqnew 1) is given all its blocks, so that a probe never needs the disk,                                                                                                                                                                                      
+   * and an empty ring. Otherwise the history is mapped again after                                                                                                                                                                                                 
+   * program_21zqzqzq, and goes on from its cursor. Nothing is written to                                                                                                                                                                                           
+   * the file as such: a probe is stored in the mapping, which the system                                                                                                                                                                                           
+   * keeps however the program ends. If it cannot be mapped the probes are                                                                                                                                                                                          
+   * not recorded.                                                                                                                                                                                                                                                  
+   * -----------------------------------------------------------------------------                                                                                                                                                                                  
+   */                                                                                                                                                                                                                                                               
+  static void program_21zzmopn(int qqqnew)                                                                                                                                                                                                                          
+  {                                                                                                                                                                                                                                                                 
+    size_t qqql = sizeof(struct program_21zzmhdr) + (size_t) QQQmapsize * sizeof(int);                                                                                                                                                                              
+    volatile struct program_21zzmhdr * qqqh;                                                                                                                                                                                                                        
+    void * qqqm;                                                                                                                                                                                                                                                    
+    int qqqd;                                                                                                                                                                                                                                                       
+    qqqd = open("program_21.exm", qqqnew ? O_RDWR | O_CREAT | O_TRUNC : O_RDWR, 0666);                                                                                                                                                                              
+    if ( qqqd < 0 )                                                                                                                                                                                                                                                 
+    {                                                                                                                                                                                                                                                               
+      return;                                                                                                                                                                                                                                                       
+    }                                                                                                                                                                                                                                                               
+    if ( qqqnew && posix_fallocate(qqqd, 0, (off_t) qqql) != 0 )                                                                                                                                                                                                    
+    {                                                                                                                                                                                                                                                               
+      close(qqqd);                                                                                                                                                                                                                                                  
+      return;                                                                                                                                                                                                                                                       
+    }                                                                                                                                                                                                                                                               
+    qqqm = mmap(0, qqql, PROT_READ | PROT_WRITE, MAP_SHARED, qqqd, 0);                                                                                                                                                                                              
+    close(qqqd);                                                                                                                                                                                                                                                    
+    if ( qqqm == MAP_FAILED )                                                                                                                                                                                                                                       
+    {                                                                                                                                                                                                                                                               
+      return;                                                                                                                                                                                                                                                       
+    }                                                                                                                                                                                                                                                               
+    qqqh = (volatile struct program_21zzmhdr *) qqqm;                                                                                                                                                                                                               
+    if ( qqqnew )                                                                                                                                                                                                                                                   
+    {                                                                                                                                                                                                                                                               
+      memcpy(qqqm, "LDRAEXHM", 8);                                                                                                                                                                                                                                  
+      qqqh->version = 1u;                                                                                                                                                                                                                                           
+      qqqh->order = 0x01020304u;                                                                                                                                                                                                                                    
+      qqqh->fileid = (unsigned int) zzfileid;                                                                                                                                                                                                                       
+      qqqh->branches = (unsigned int) qqqbranches;                                                                                                                                                                                                                  
+      qqqh->size = (unsigned int) QQQmapsize;                                                                                                                                                                                                                       
+      qqqh->wrapped = 0u;                                                                                                                                                                                                                                           
+      qqqh->count = 0u;                                                                                                                                                                                                                                             
+    }                                                                                                                                                                                                                                                               
+    else if ( qqqh->size != (unsigned int) QQQmapsize )                                                                                                                                                                                                             
+    {                                                                                                                                                                                                                                                               
+      munmap(qqqm, qqql);                                                                                                                                                                                                                                           
+      return;                                                                                                                                                                                                                                                       
+    }                                                                                                                                                                                                                                                               
+    qqqh->closed = 0u;                                                                                                                                                                                                                                              
+    program_21zzmrng = (volatile int *) (qqqh + 1);                                                                                                                                                                                                                 
+    program_21zzmmap = qqqh;                                                                                                                                                                                                                                        
+  } /* End of zzmopn */                                                                                                                                                                                                                                             
+  /* ----------------------------------------------------------------------* 344 *                                                                                                                                                                                  
+   *            program_21zzmcls                                                                                                                                                                                                                                    
+   * Marks the history closed and unmaps it, called by program_21zqzqzq.                                                                                                                                                                                            
+   * -----------------------------------------------------------------------------                                                                                                                                                                                  
+   */                                                                                                                                                                                                                                                               
+  static void program_21zzmcls(qqnull_params)                                                                                                                                                                                                                       
+  {                                                                                                                                                                                                                                                                 
+    if ( program_21zzmmap != 0 )                                                                                                                                                                                                                                    
+    {                                                                                                                                                                                                                                                               
+      program_21zzmmap->closed = 1u;                                                                                                                                                                                                                                
+      munmap((void *) program_21zzmmap, sizeof(struct program_21zzmhdr) + (size_t) QQQmapsize * sizeof(int));                                                                                                                                                       
+      program_21zzmmap = 0;                                                                                                                                                                                                                                         
+      program_21zzmrng = 0;                                                                                                                                                                                                                                         
+    }                                                                                                                                                                                                                                                               
+  } /* End of zzmcls */                                                                                                                                                                                                                                             
+#endif  /* QQQMAPPED_EXH */                                                                                                                                                                                                                                         
+#ifdef QQQSIGNAL_EXH                                                                                                                                                                                                                                                
+  /* ----------------------------------------------------------------------* 345 *                                                                                                                                                                                  
+   *            program_21zzgbeg, program_21zzgend                                                                                                                                                                                                                  
+   * Mark the probes recorded and the history written, which a signal                                                                                                                                                                                               
+   * handler cannot break into. program_21zzgbeg returns the mark before,                                                                                                                                                                                           
+   * for program_21zzgend to put back, which then acts on a signal put off.                                                                                                                                                                                         
+   * -----------------------------------------------------------------------------                                                                                                                                                                                  
+   */                                                                                                                                                                                                                                                               
+  static int program_21zzgbeg(qqnull_params)                                                                                                                                                                                                                        
+  {                                                                                                                                                                                                                                                                 
+    int qqqb = (int) program_21zzgbsy;                                                                                                                                                                                                                              
+    program_21zzgbsy = 1;                                                                                                                                                                                                                                           
+    QQQsigfence();                                                                                                                                                                                                                                                  
+    return(qqqb);                                                                                                                                                                                                                                                   
+  } /* End of zzgbeg */                                                                                                                                                                                                                                             
+  static void program_21zzgend(int qqqb)                                                                                                                                                                                                                            
+  {                                                                                                                                                                                                                                                                 
+    int qqqs;                                                                                                                                                                                                                                                       
+    QQQsigfence();                                                                                                                                                                                                                                                  
+    program_21zzgbsy = qqqb;                                                                                                                                                                                                                                        
+    if ( !qqqb && program_21zzgpnd != 0 )                                                                                                                                                                                                                           
+    {                                                                                                                                                                                                                                                               
+      qqqs = (int) program_21zzgpnd;                                                                                                                                                                                                                                
+      program_21zzgpnd = 0;                                                                                                                                                                                                                                         
+      program_21zzgact(qqqs);                                                                                                                                                                                                                                       
+    }                                                                                                                                                                                                                                                               
+  } /* End of zzgend */                                                                                                                                                                                                                                             
+  /* ----------- zzghnd ---------------------------------------------------* 346 *                                                                                                                                                                                  
+   * -----------------------------------------------------------------------------                                                                                                                                                                                  
+   */                                                                                                                                                                                                                                                               
+  /* ----------------------------------------------------------------------* 347 *                                                                                                                                                                                  
+   * This is the signal handler. If the signal came while a probe was being                                                                                                                                                                                         
+   * recorded or the history written it is put off until that is done, or,                                                                                                                                                                                          
+   * for a fatal signal, which cannot wait, the history is left as it is.                                                                                                                                                                                           
+   * Otherwise program_21zzgact acts on it at once. Only functions which are                                                                                                                                                                                        
+   * safe in a handler are called: the history is written with write, not                                                                                                                                                                                           
+   * stdio (see qqoutputw).                                                                                                                                                                                                                                         
+   * -----------------------------------------------------------------------------                                                                                                                                                                                  
+   */                                                                                                                                                                                                                                                               
+  static void program_21zzghnd(int qqqs)                                                                                                                                                                                                                            
+  {                                                                                                                                                                                                                                                                 
+    int qqqe = errno;                                                                                                                                                                                                                                               
+    int qqqj;                                                                                                                                                                                                                                                       
+    if ( !program_21zzgbsy )                                                                                                                                                                                                                                        
+    {                                                                                                                                                                                                                                                               
+      program_21zzgact(qqqs);                                                                                                                                                                                                                                       
+    }                                                                                                                                                                                                                                                               
+    else if ( qqqs == SIGTERM || qqqs == SIGINT || qqqs == QQQsigsnap )                                                                                                                                                                                             
+    {                                                                                                                                                                                                                                                               
+      program_21zzgpnd = qqqs;                                                                                                                                                                                                                                      
+    }                                                                                                                                                                                                                                                               
+    else                                                                                                                                                                                                                                                            
+    {                                                                                                                                                                                                                                                               
+      for ( qqqj = 0; qqqj < 8; qqqj++ )                                                                                                                                                                                                                            
+      {                                                                                                                                                                                                                                                             
+        if ( program_21zzgsig[qqqj] == qqqs )                                                                                                                                                                                                                       
+        {                                                                                                                                                                                                                                                           
+          sigaction(qqqs, &program_21zzgold[qqqj], 0);                                                                                                                                                                                                              
+        }                                                                                                                                                                                                                                                           
+      }                                                                                                                                                                                                                                                             
+      raise(qqqs);                                                                                                                                                                                                                                                  
+    }                                                                                                                                                                                                                                                               
+    errno = qqqe;                                                                                                                                                                                                                                                   
+  } /* End of zzghnd */                                                                                                                                                                                                                                             
+  /* ----------------------------------------------------------------------* 348 *                                                                                                                                                                                  
+   *            program_21zzgact                                                                                                                                                                                                                                    
+   * Acts on the signal qqqs. QQQsigsnap writes a snapshot and the program                                                                                                                                                                                          
+   * goes on. Any other writes what the history holds in memory, then the                                                                                                                                                                                           
+   * action the program had for the signal is put back and the signal                                                                                                                                                                                               
+   * raised again, to end the program as it would have ended.                                                                                                                                                                                                       
+   * -----------------------------------------------------------------------------                                                                                                                                                                                  
+   */                                                                                                                                                                                                                                                               
+  static void program_21zzgact(int qqqs)                                                                                                                                                                                                                            
+  {                                                                                                                                                                                                                                                                 
+    int qqqg = program_21zzgbeg();                                                                                                                                                                                                                                  
+    int qqqj;                                                                                                                                                                                                                                                       
+    if ( qqqs == QQQsigsnap )                                                                                                                                                                                                                                       
+    {                                                                                                                                                                                                                                                               
+      program_21zzgsnp();                                                                                                                                                                                                                                           
+    }                                                                                                                                                                                                                                                               
+    else if ( program_21zzopen == 1 )                                                                                                                                                                                                                               
+    {                                                                                                                                                                                                                                                               
+#if defined(QQQBITMAP_EXH)                                                                                                                                                                                                                                          
+      program_21zzhdmp();                                                                                                                                                                                                                                           
+#elif defined(QQQLOOP_EXH)                                                                                                                                                                                                                                          
+      program_21zzlend();                                                                                                                                                                                                                                           
+#elif defined(QQQBUFFERED_EXH)                                                                                                                                                                                                                                      
+      program_21zzflsh();                                                                                                                                                                                                                                           
+#endif  /* QQQBITMAP_EXH */                                                                                                                                                                                                                                         
+      /* mapped, the history is the file already */                                                                                                                                                                                                                 
+    }                                                                                                                                                                                                                                                               
+    program_21zzgend(qqqg);                                                                                                                                                                                                                                         
+    if ( qqqs != QQQsigsnap )                                                                                                                                                                                                                                       
+    {                                                                                                                                                                                                                                                               
+      for ( qqqj = 0; qqqj < 8; qqqj++ )                                                                                                                                                                                                                            
+      {                                                                                                                                                                                                                                                             
+        if ( program_21zzgsig[qqqj] == qqqs )                                                                                                                                                                                                                       
+        {                                                                                                                                                                                                                                                           
+          sigaction(qqqs, &program_21zzgold[qqqj], 0);                                                                                                                                                                                                              
+        }                                                                                                                                                                                                                                                           
+      }                                                                                                                                                                                                                                                             
+      raise(qqqs);                                                                                                                                                                                                                                                  
+    }                                                                                                                                                                                                                                                               
+  } /* End of zzgact */                                                                                                                                                                                                                                             
+  /* ----------------------------------------------------------------------* 349 *                                                                                                                                                                                  
+   *            program_21zzgsnp                                                                                                                                                                                                                                    
+   * Writes the coverage of this epoch to program_21.<time>.<n>.exh, the                                                                                                                                                                                            
+   * probes hit since the start or the last qqqtotalreset once each, in                                                                                                                                                                                             
+   * ascending order, n counting the snapshots.                                                                                                                                                                                                                     
+   * -----------------------------------------------------------------------------                                                                                                                                                                                  
+   */                                                                                                                                                                                                                                                               
+  static void program_21zzgsnp(qqnull_params)                                                                                                                                                                                                                       
+  {                                                                                                                                                                                                                                                                 
+    char qqqt[64 * 12];                                                                                                                                                                                                                                             
+    char qqqd[16];                                                                                                                                                                                                                                                  
+    unsigned long qqqu[2];                                                                                                                                                                                                                                          
+    int qqqf;                                                                                                                                                                                                                                                       
+    int qqqj;                                                                                                                                                                                                                                                       
+    int qqqk = 0;                                                                                                                                                                                                                                                   
+    int qqqm;                                                                                                                                                                                                                                                       
+    qqqu[0] = (unsigned long) time(0);                                                                                                                                                                                                                              
+    qqqu[1] = (unsigned long) ++program_21zzgseq;                                                                                                                                                                                                                   
+    for ( qqqj = 0; "program_21."[qqqj] != '\0'; qqqj++ )                                                                                                                                                                                                           
+    {                                                                                                                                                                                                                                                               
+      qqqt[qqqk++] = "program_21."[qqqj];                                                                                                                                                                                                                           
+    }                                                                                                                                                                                                                                                               
+    for ( qqqj = 0; qqqj < 2; qqqj++ )                                                                                                                                                                                                                              
+    {                                                                                                                                                                                                                                                               
+      qqqm = 0;                                                                                                                                                                                                                                                     
+      do                                                                                                                                                                                                                                                            
+      {                                                                                                                                                                                                                                                             
+        qqqd[qqqm++] = (char) ('0' + qqqu[qqqj] % 10ul);                                                                                                                                                                                                            
+        qqqu[qqqj] /= 10ul;                                                                                                                                                                                                                                         
+      } while ( qqqu[qqqj] != 0ul );                                                                                                                                                                                                                                
+      while ( qqqm > 0 )                                                                                                                                                                                                                                            
+      {                                                                                                                                                                                                                                                             
+        qqqt[qqqk++] = qqqd[--qqqm];                                                                                                                                                                                                                                
+      }                                                                                                                                                                                                                                                             
+      qqqt[qqqk++] = '.';                                                                                                                                                                                                                                           
+    }                                                                                                                                                                                                                                                               
+    qqqt[qqqk++] = 'e';                                                                                                                                                                                                                                             
+    qqqt[qqqk++] = 'x';                                                                                                                                                                                                                                             
+    qqqt[qqqk++] = 'h';                                                                                                                                                                                                                                             
+    qqqt[qqqk] = '\0';                                                                                                                                                                                                                                              
+    qqqf = open(qqqt, O_WRONLY | O_CREAT | O_TRUNC, 0666);                                                                                                                                                                                                          
+    if ( qqqf < 0 )                                                                                                                                                                                                                                                 
+    {                                                                                                                                                                                                                                                               
+      return;                                                                                                                                                                                                                                                       
+    }                                                                                                                                                                                                                                                               
+    qqqk = 0;                                                                                                                                                                                                                                                       
+    for ( qqqj = 0; qqqj <= qqqbranches; qqqj++ )                                                                                                                                                                                                                   
+    {                                                                                                                                                                                                                                                               
+      if ( program_21zzgbit[qqqj >> 3] & (1 << (qqqj & 7)) )                                                                                                                                                                                                        
+      {                                                                                                                                                                                                                                                             
+        qqqk += qqoutputd(qqqt + qqqk, qqqj);                                                                                                                                                                                                                       
+        if ( qqqk > (int) sizeof(qqqt) - 12 )                                                                                                                                                                                                                       
+        {                                                                                                                                                                                                                                                           
+          qqoutputw(qqqf, qqqt, qqqk);                                                                                                                                                                                                                              
+          qqqk = 0;                                                                                                                                                                                                                                                 
+        }                                                                                                                                                                                                                                                           
+      }                                                                                                                                                                                                                                                             
+    }                                                                                                                                                                                                                                                               
+    qqoutputw(qqqf, qqqt, qqqk);                                                                                                                                                                                                                                    
+    close(qqqf);                                                                                                                                                                                                                                                    
+  } /* End of zzgsnp */                                                                                                                                                                                                                                             
+  /* ----------------------------------------------------------------------* 351 *                                                                                                                                                                                  
+   *            program_21zzgins                                                                                                                                                                                                                                    
+   * Installs the handler when the history is first opened: for SIGTERM and                                                                                                                                                                                         
+   * SIGINT, the fatal signals and QQQsigsnap. A signal the program ignores                                                                                                                                                                                         
+   * is left ignored, and QQQsigsnap is left to a handler of the program.                                                                                                                                                                                           
+   * SA_RESTART, so a snapshot does not break the calls of the program.                                                                                                                                                                                             
+   * -----------------------------------------------------------------------------                                                                                                                                                                                  
+   */                                                                                                                                                                                                                                                               
+  static void program_21zzgins(qqnull_params)                                                                                                                                                                                                                       
+  {                                                                                                                                                                                                                                                                 
+    struct sigaction qqqa;                                                                                                                                                                                                                                          
+    int qqqj;                                                                                                                                                                                                                                                       
+    memset(&qqqa, 0, sizeof(qqqa));                                                                                                                                                                                                                                 
+    qqqa.sa_handler = program_21zzghnd;                                                                                                                                                                                                                             
+    sigemptyset(&qqqa.sa_mask);                                                                                                                                                                                                                                     
+    qqqa.sa_flags = SA_RESTART;                                                                                                                                                                                                                                     
+    for ( qqqj = 0; qqqj < 8; qqqj++ )                                                                                                                                                                                                                              
+    {                                                                                                                                                                                                                                                               
+      if ( sigaction(program_21zzgsig[qqqj], 0, &program_21zzgold[qqqj]) == 0                                                                                                                                                                                       
+           && program_21zzgold[qqqj].sa_handler != SIG_IGN                                                                                                                                                                                                          
+           && ( program_21zzgsig[qqqj] != QQQsigsnap || program_21zzgold[qqqj].sa_handler == SIG_DFL ) )                                                                                                                                                            
+      {                                                                                                                                                                                                                                                             
+        sigaction(program_21zzgsig[qqqj], &qqqa, 0);                                                                                                                                                                                                                
+      }                                                                                                                                                                                                                                                             
+    }                                                                                                                                                                                                                                                               
+  } /* End of zzgins */                                                                                                                                                                                                                                             
+#if defined(QQQMAINFL) && !(defined(QQQstructbitmap) && defined(QQQSINGLEFILE))                                                                                                                                                                                     
+  /* ----------------------------------------------------------------------* 352 *                                                                                                                                                                                  
+   *            qqqtotalreset                                                                                                                                                                                                                                       
+   * Starts a new coverage epoch: writes the snapshot of the epoch ending,                                                                                                                                                                                          
+   * then clears the probes hit, so that each snapshot is the coverage of                                                                                                                                                                                           
+   * one phase of the program. The history itself goes on.                                                                                                                                                                                                          
+   * -----------------------------------------------------------------------------                                                                                                                                                                                  
+   */                                                                                                                                                                                                                                                               
+  void qqqtotalreset(void)                                                                                                                                                                                                                                          
+  {                                                                                                                                                                                                                                                                 
+    int qqqg = program_21zzgbeg();                                                                                                                                                                                                                                  
+    int qqqj;                                                                                                                                                                                                                                                       
+    program_21zzgsnp();                                                                                                                                                                                                                                             
+    for ( qqqj = 0; qqqj < (int) sizeof(program_21zzgbit); qqqj++ )                                                                                                                                                                                                 
+    {                                                                                                                                                                                                                                                               
+      program_21zzgbit[qqqj] = 0;                                                                                                                                                                                                                                   
+    }                                                                                                                                                                                                                                                               
+    program_21zzgend(qqqg);                                                                                                                                                                                                                                         
+  } /* End of qqqtotalreset */                                                                                                                                                                                                                                      
+#endif  /* QQQMAINFL && !(QQQstructbitmap && QQQSINGLEFILE) */                                                                                                                                                                                                      
+#endif  /* QQQSIGNAL_EXH */                                                                                                                                                                                                                                         
+#ifdef QQQLOOP_EXH                                                                                                                                                                                                                                                  
+  /* ----------- zzloop ---------------------------------------------------* 324 *                                                                                                                                                                                  
+   * -----------------------------------------------------------------------------                                                                                                                                                                                  
+   */                                                                                                                                                                                                                                                               
+  /* ----------------------------------------------------------------------* 325 *                                                                                                                                                                                  
+   * This routine finds loops in the probes as they come. The last probes                                                                                                                                                                                           
+   * are kept back until they are seen not to start a loop. When the last                                                                                                                                                                                           
+   * 2 * n probes are the same n probes twice, n up to QQQloopwin, those                                                                                                                                                                                            
+   * before the second n are buffered and the second n becomes a loop                                                                                                                                                                                               
+   * record. Each probe then only extends the record, while it is the same                                                                                                                                                                                          
+   * as the probe n before. The work for a probe is fixed by QQQloopwin.                                                                                                                                                                                            
+   * -----------------------------------------------------------------------------                                                                                                                                                                                  
+   */                                                                                                                                                                                                                                                               
+  static void program_21zzloop(int qqqi)                                                                                                                                                                                                                            
+  {                                                                                                                                                                                                                                                                 
+    unsigned int qqqt;                                                                                                                                                                                                                                              
+    int qqqp;                                                                                                                                                                                                                                                       
+    int qqqj;                                                                                                                                                                                                                                                       
+    qqqt = ++program_21zzlt;                                                                                                                                                                                                                                        
+    program_21zzlhst[qqqt & (2 * QQQloopwin - 1)] = qqqi;                                                                                                                                                                                                           
+    if ( program_21zzlval < 2 * QQQloopwin )                                                                                                                                                                                                                        
+    {                                                                                                                                                                                                                                                               
+      program_21zzlval++;                                                                                                                                                                                                                                           
+    }                                                                                                                                                                                                                                                               
+    if ( program_21zzlper > 0 )                                                                                                                                                                                                                                     
+    {                                                                                                                                                                                                                                                               
+      /* in a loop, while each probe is the one a period before */                                                                                                                                                                                                  
+      if ( qqqi == program_21zzlhst[(qqqt - program_21zzlper) & (2 * QQQloopwin - 1)] )                                                                                                                                                                             
+      {                                                                                                                                                                                                                                                             
+        if ( ++program_21zzlpos == program_21zzlper )                                                                                                                                                                                                               
+        {                                                                                                                                                                                                                                                           
+          program_21zzlpos = 0;                                                                                                                                                                                                                                     
+          if ( ++program_21zzlcnt == QQQloopmax )                                                                                                                                                                                                                   
+          {                                                                                                                                                                                                                                                         
+            program_21zzlput(program_21zzlper, program_21zzlcnt);                                                                                                                                                                                                   
+            program_21zzlcnt = 0;                                                                                                                                                                                                                                   
+          }                                                                                                                                                                                                                                                         
+        }                                                                                                                                                                                                                                                           
+        return;                                                                                                                                                                                                                                                     
+      }                                                                                                                                                                                                                                                             
+      /* out of the loop, the part of a repeat and this probe are kept back */                                                                                                                                                                                      
+      if ( program_21zzlcnt > 0 )                                                                                                                                                                                                                                   
+      {                                                                                                                                                                                                                                                             
+        program_21zzlput(program_21zzlper, program_21zzlcnt);                                                                                                                                                                                                       
+      }                                                                                                                                                                                                                                                             
+      program_21zzlpnd = program_21zzlpos + 1;                                                                                                                                                                                                                      
+      program_21zzlper = 0;                                                                                                                                                                                                                                         
+      for ( qqqp = 1; qqqp <= QQQloopwin; qqqp++ )                                                                                                                                                                                                                  
+      {                                                                                                                                                                                                                                                             
+        program_21zzlmat[qqqp] = 0;                                                                                                                                                                                                                                 
+      }                                                                                                                                                                                                                                                             
+      return;                                                                                                                                                                                                                                                       
+    }                                                                                                                                                                                                                                                               
+    if ( ++program_21zzlpnd > QQQloopwin )                                                                                                                                                                                                                          
+    {                                                                                                                                                                                                                                                               
+      program_21zzlput(program_21zzlhst[(qqqt - QQQloopwin) & (2 * QQQloopwin - 1)], 0);                                                                                                                                                                            
+      program_21zzlpnd = QQQloopwin;                                                                                                                                                                                                                                
+    }                                                                                                                                                                                                                                                               
+    /* the shortest period repeated */                                                                                                                                                                                                                              
+    qqqj = 0;                                                                                                                                                                                                                                                       
+    for ( qqqp = QQQloopwin; qqqp > 0; qqqp-- )                                                                                                                                                                                                                     
+    {                                                                                                                                                                                                                                                               
+      if ( qqqp < program_21zzlval && qqqi == program_21zzlhst[(qqqt - qqqp) & (2 * QQQloopwin - 1)] )                                                                                                                                                              
+      {                                                                                                                                                                                                                                                             
+        if ( ++program_21zzlmat[qqqp] >= qqqp && qqqp <= program_21zzlpnd )                                                                                                                                                                                         
+        {                                                                                                                                                                                                                                                           
+          qqqj = qqqp;                                                                                                                                                                                                                                              
+        }                                                                                                                                                                                                                                                           
+      }                                                                                                                                                                                                                                                             
+      else                                                                                                                                                                                                                                                          
+      {                                                                                                                                                                                                                                                             
+        program_21zzlmat[qqqp] = 0;                                                                                                                                                                                                                                 
+      }                                                                                                                                                                                                                                                             
+    }                                                                                                                                                                                                                                                               
+    if ( qqqj > 0 )                                                                                                                                                                                                                                                 
+    {                                                                                                                                                                                                                                                               
+      for ( qqqp = program_21zzlpnd; qqqp > qqqj; qqqp-- )                                                                                                                                                                                                          
+      {                                                                                                                                                                                                                                                             
+        program_21zzlput(program_21zzlhst[(qqqt - qqqp + 1) & (2 * QQQloopwin - 1)], 0);                                                                                                                                                                            
+      }                                                                                                                                                                                                                                                             
+      program_21zzlpnd = 0;                                                                                                                                                                                                                                         
+      program_21zzlper = qqqj;                                                                                                                                                                                                                                      
+      program_21zzlpos = 0;                                                                                                                                                                                                                                         
+      program_21zzlcnt = 1;                                                                                                                                                                                                                                         
+    }                                                                                                                                                                                                                                                               
+  } /* End of zzloop */                                                                                                                                                                                                                                             
+  /* ----------------------------------------------------------------------* 326 *                                                                                                                                                                                  
+   *            program_21zzlput                                                                                                                                                                                                                                    
+   * Buffers the probe qqqa (qqqb 0) or a loop record of period qqqa and                                                                                                                                                                                            
+   * qqqb repeats, as QQQloopmark, qqqa, qqqb. The probe QQQloopmark itself                                                                                                                                                                                         
+   * is buffered as QQQloopmark, 0, 0.                                                                                                                                                                                                                              
+   * -----------------------------------------------------------------------------                                                                                                                                                                                  
+   */                                                                                                                                                                                                                                                               
+  static void program_21zzlput(int qqqa, int qqqb)                                                                                                                                                                                                                  
+  {                                                                                                                                                                                                                                                                 
+    if ( program_21zzhcnt > QQQexhbuf - 3 )                                                                                                                                                                                                                         
+    {                                                                                                                                                                                                                                                               
+      program_21zzflsh();                                                                                                                                                                                                                                           
+    }                                                                                                                                                                                                                                                               
+    if ( qqqb == 0 && qqqa != QQQloopmark )                                                                                                                                                                                                                         
+    {                                                                                                                                                                                                                                                               
+      program_21zzhbuf[program_21zzhcnt++] = qqqa;                                                                                                                                                                                                                  
+    }                                                                                                                                                                                                                                                               
+    else                                                                                                                                                                                                                                                            
+    {                                                                                                                                                                                                                                                               
+      program_21zzhbuf[program_21zzhcnt++] = QQQloopmark;                                                                                                                                                                                                           
+      program_21zzhbuf[program_21zzhcnt++] = ( qqqb == 0 ) ? 0 : qqqa;                                                                                                                                                                                              
+      program_21zzhbuf[program_21zzhcnt++] = qqqb;                                                                                                                                                                                                                  
+    }                                                                                                                                                                                                                                                               
+  } /* End of zzlput */                                                                                                                                                                                                                                             
+  /* ----------------------------------------------------------------------* 327 *                                                                                                                                                                                  
+   *            program_21zzlend                                                                                                                                                                                                                                    
+   * Buffers the loop and the probes kept back, and writes the buffer. It is                                                                                                                                                                                        
+   * called by program_21zqzqzq and at exit.                                                                                                                                                                                                                        
+   * -----------------------------------------------------------------------------                                                                                                                                                                                  
+   */                                                                                                                                                                                                                                                               
+  static void program_21zzlend(qqnull_params)                                                                                                                                                                                                                       
+  {                                                                                                                                                                                                                                                                 
+    int qqqp;                                                                                                                                                                                                                                                       
+#ifdef QQQSIGNAL_EXH                                                                                                                                                                                                                                                
+    int qqqg = program_21zzgbeg();                                                                                                                                                                                                                                  
+#endif  /* QQQSIGNAL_EXH */                                                                                                                                                                                                                                         
+    if ( program_21zzlper > 0 )                                                                                                                                                                                                                                     
+    {                                                                                                                                                                                                                                                               
+      if ( program_21zzlcnt > 0 )                                                                                                                                                                                                                                   
+      {                                                                                                                                                                                                                                                             
+        program_21zzlput(program_21zzlper, program_21zzlcnt);                                                                                                                                                                                                       
+      }                                                                                                                                                                                                                                                             
+      program_21zzlpnd = program_21zzlpos;                                                                                                                                                                                                                          
+      program_21zzlper = 0;                                                                                                                                                                                                                                         
+    }                                                                                                                                                                                                                                                               
+    for ( qqqp = program_21zzlpnd; qqqp > 0; qqqp-- )                                                                                                                                                                                                               
+    {                                                                                                                                                                                                                                                               
+      program_21zzlput(program_21zzlhst[(program_21zzlt - qqqp + 1) & (2 * QQQloopwin - 1)], 0);                                                                                                                                                                    
+    }                                                                                                                                                                                                                                                               
+    program_21zzlpnd = 0;                                                                                                                                                                                                                                           
+    for ( qqqp = 1; qqqp <= QQQloopwin; qqqp++ )                                                                                                                                                                                                                    
+    {                                                                                                                                                                                                                                                               
+      program_21zzlmat[qqqp] = 0;                                                                                                                                                                                                                                   
+    }                                                                                                                                                                                                                                                               
+#ifdef QQQASYNC_EXH                                                                                                                                                                                                                                                 
+    program_21zzhdrn();                                                                                                                                                                                                                                             
+#else  /* QQQASYNC_EXH */                                                                                                                                                                                                                                           
+    program_21zzflsh();                                                                                                                                                                                                                                             
+#endif  /* QQQASYNC_EXH */                                                                                                                                                                                                                                          
+#ifdef QQQSIGNAL_EXH                                                                                                                                                                                                                                                
+    program_21zzgend(qqqg);                                                                                                                                                                                                                                         
+#endif  /* QQQSIGNAL_EXH */                                                                                                                                                                                                                                         
+  } /* End of zzlend */                                                                                                                                                                                                                                             
+#endif  /* QQQLOOP_EXH */                                                                                                                                                                                                                                           
+#ifdef QQQthreaded                                                                                                                                                                                                                                                  
+  /* ----------- zzthr1 ---------------------------------------------------* 316 *                                                                                                                                                                                  
+   * -----------------------------------------------------------------------------                                                                                                                                                                                  
+   */                                                                                                                                                                                                                                                               
+  /* ----------------------------------------------------------------------* 317 *                                                                                                                                                                                  
+   * This routine gives a thread its buffer, at its first probe. The buffer                                                                                                                                                                                         
+   * is pushed on to the list of all the buffers with a compare and swap, so                                                                                                                                                                                        
+   * no thread waits for another to record. The buffer is only written by                                                                                                                                                                                           
+   * its own thread, when full and as the thread ends, and at exit; it is                                                                                                                                                                                           
+   * kept after its thread ends.                                                                                                                                                                                                                                    
+   * -----------------------------------------------------------------------------                                                                                                                                                                                  
+   */                                                                                                                                                                                                                                                               
+  static struct program_21zzthrd * program_21zzthr1(qqnull_params)                                                                                                                                                                                                  
+  {                                                                                                                                                                                                                                                                 
+    struct program_21zzthrd * qqqt;                                                                                                                                                                                                                                 
+    struct program_21zzthrd * qqqn;                                                                                                                                                                                                                                 
+    qqqt = (struct program_21zzthrd *) malloc(sizeof(struct program_21zzthrd));                                                                                                                                                                                     
+    if ( qqqt == 0 )                                                                                                                                                                                                                                                
+    {                                                                                                                                                                                                                                                               
+      return(0);                                                                                                                                                                                                                                                    
+    }                                                                                                                                                                                                                                                               
+    qqqt->count = 0;                                                                                                                                                                                                                                                
+    qqqt->done = 0;                                                                                                                                                                                                                                                 
+    qqqt->fil = 0;                                                                                                                                                                                                                                                  
+    qqqt->id = __sync_fetch_and_add(&program_21zzhtid, 1);                                                                                                                                                                                                          
+    qqqt->next = 0;                                                                                                                                                                                                                                                 
+    while ( (qqqn = __sync_val_compare_and_swap(&program_21zzhlst, qqqt->next, qqqt)) != qqqt->next )                                                                                                                                                               
+    {                                                                                                                                                                                                                                                               
+      qqqt->next = qqqn;                                                                                                                                                                                                                                            
+    }                                                                                                                                                                                                                                                               
+    program_21zzhthr = qqqt;                                                                                                                                                                                                                                        
+    pthread_once(&program_21zzhonc, program_21zzthrk);                                                                                                                                                                                                              
+    pthread_setspecific(program_21zzhkey, qqqt);                                                                                                                                                                                                                    
+    return(qqqt);                                                                                                                                                                                                                                                   
+  } /* End of zzthr1 */                                                                                                                                                                                                                                             
+  /* ----------------------------------------------------------------------* 353 *                                                                                                                                                                                  
+   *            program_21zzthrk                                                                                                                                                                                                                                    
+   * Makes the key that ends each thread, once, at the first probe.                                                                                                                                                                                                 
+   * -----------------------------------------------------------------------------                                                                                                                                                                                  
+   */                                                                                                                                                                                                                                                               
+  static void program_21zzthrk(qqnull_params)                                                                                                                                                                                                                       
+  {                                                                                                                                                                                                                                                                 
+    pthread_key_create(&program_21zzhkey, program_21zzthre);                                                                                                                                                                                                        
+#if !defined(QQQNOATEXIT)                                                                                                                                                                                                                                           
+    atexit(program_21zzthrx);                                                                                                                                                                                                                                       
+#endif  /* !defined(QQQNOATEXIT) */                                                                                                                                                                                                                                 
+  } /* End of zzthrk */                                                                                                                                                                                                                                             
+  /* ----------------------------------------------------------------------* 354 *                                                                                                                                                                                  
+   *            program_21zzthre                                                                                                                                                                                                                                    
+   * Run as a thread ends, writes the rest of its buffer and closes its                                                                                                                                                                                             
+   * history. The main thread does not end this way, see program_21zzthrx.                                                                                                                                                                                          
+   * -----------------------------------------------------------------------------                                                                                                                                                                                  
+   */                                                                                                                                                                                                                                                               
+  static void program_21zzthre(void * qqqp)                                                                                                                                                                                                                         
+  {                                                                                                                                                                                                                                                                 
+    struct program_21zzthrd * qqqt = (struct program_21zzthrd *) qqqp;                                                                                                                                                                                              
+    program_21zzlock(1);                                                                                                                                                                                                                                            
+    program_21zzthrw(qqqt);                                                                                                                                                                                                                                         
+    if ( qqqt->fil != 0 )                                                                                                                                                                                                                                           
+    {                                                                                                                                                                                                                                                               
+      fclose(qqqt->fil);                                                                                                                                                                                                                                            
+      qqqt->fil = 0;                                                                                                                                                                                                                                                
+    }                                                                                                                                                                                                                                                               
+    qqqt->done = 1;                                                                                                                                                                                                                                                 
+    program_21zzlock(0);                                                                                                                                                                                                                                            
+  } /* End of zzthre */                                                                                                                                                                                                                                             
+  /* ----------- zzthrf ---------------------------------------------------* 318 *                                                                                                                                                                                  
+   * -----------------------------------------------------------------------------                                                                                                                                                                                  
+   */                                                                                                                                                                                                                                                               
+  /* ----------------------------------------------------------------------* 319 *                                                                                                                                                                                  
+   * This routine writes the full buffer of this thread to its history. The                                                                                                                                                                                         
+   * lock is held as the buffers of qqoutputn are shared.                                                                                                                                                                                                           
+   * -----------------------------------------------------------------------------                                                                                                                                                                                  
+   */                                                                                                                                                                                                                                                               
+  static void program_21zzthrf(struct program_21zzthrd * qqqt)                                                                                                                                                                                                      
+  {                                                                                                                                                                                                                                                                 
+    program_21zzlock(1);                                                                                                                                                                                                                                            
+    program_21zzthrw(qqqt);                                                                                                                                                                                                                                         
+    program_21zzlock(0);                                                                                                                                                                                                                                            
+  } /* End of zzthrf */                                                                                                                                                                                                                                             
+  /* ----------------------------------------------------------------------* 355 *                                                                                                                                                                                  
+   *            program_21zzthrw                                                                                                                                                                                                                                    
+   * Writes the buffer of a thread to the history of the thread, program_21.exh                                                                                                                                                                                     
+   * for thread 0, opening program_21.n.exh for thread n at its first write.                                                                                                                                                                                        
+   * The caller holds program_21zzhlck and is the thread, or the thread has                                                                                                                                                                                         
+   * ended, or the program is exiting.                                                                                                                                                                                                                              
+   * -----------------------------------------------------------------------------                                                                                                                                                                                  
+   */                                                                                                                                                                                                                                                               
+  static void program_21zzthrw(struct program_21zzthrd * qqqt)                                                                                                                                                                                                      
+  {                                                                                                                                                                                                                                                                 
+    char qqqn[32];                                                                                                                                                                                                                                                  
+    FILE * qqqf;                                                                                                                                                                                                                                                    
+    if ( qqqt->count == 0 )                                                                                                                                                                                                                                         
+    {                                                                                                                                                                                                                                                               
+      return;                                                                                                                                                                                                                                                       
+    }                                                                                                                                                                                                                                                               
+    if ( qqqt->id == 0 )                                                                                                                                                                                                                                            
+    {                                                                                                                                                                                                                                                               
+      if ( program_21zzopen != 1 )                                                                                                                                                                                                                                  
+      {                                                                                                                                                                                                                                                             
+        program_21zqqzqz1();                                                                                                                                                                                                                                        
+      }                                                                                                                                                                                                                                                             
+      qqqf = program_21zzhfil;                                                                                                                                                                                                                                      
+    }                                                                                                                                                                                                                                                               
+    else                                                                                                                                                                                                                                                            
+    {                                                                                                                                                                                                                                                               
+      if ( qqqt->fil == 0 && !qqqt->done )                                                                                                                                                                                                                          
+      {                                                                                                                                                                                                                                                             
+#ifdef QQQBINARY_EXH                                                                                                                                                                                                                                                
+        sprintf(qqqn, "program_21.%d.exb", qqqt->id);                                                                                                                                                                                                               
+        qqqt->fil = fopen(qqqn, "wb");                                                                                                                                                                                                                              
+        if ( qqqt->fil != 0 )                                                                                                                                                                                                                                       
+        {                                                                                                                                                                                                                                                           
+          qqoutputh(qqqt->fil, zzfileid, qqqbranches);                                                                                                                                                                                                              
+        }                                                                                                                                                                                                                                                           
+#else  /* QQQBINARY_EXH */                                                                                                                                                                                                                                          
+        sprintf(qqqn, "program_21.%d.exh", qqqt->id);                                                                                                                                                                                                               
+        qqqt->fil = fopen(qqqn, "w");                                                                                                                                                                                                                               
+#endif  /* QQQBINARY_EXH */                                                                                                                                                                                                                                         
+      }                                                                                                                                                                                                                                                             
+      qqqf = qqqt->fil;                                                                                                                                                                                                                                             
+    }                                                                                                                                                                                                                                                               
+    if ( qqqf != 0 )                                                                                                                                                                                                                                                
+    {                                                                                                                                                                                                                                                               
+      qqoutputn(qqqf, qqqt->probes, qqqt->count);                                                                                                                                                                                                                   
+    }                                                                                                                                                                                                                                                               
+    qqqt->count = 0;                                                                                                                                                                                                                                                
+  } /* End of zzthrw */                                                                                                                                                                                                                                             
+  /* ----------- zzthra ---------------------------------------------------* 320 *                                                                                                                                                                                  
+   * -----------------------------------------------------------------------------                                                                                                                                                                                  
+   */                                                                                                                                                                                                                                                               
+  /* ----------------------------------------------------------------------* 321 *                                                                                                                                                                                  
+   * This routine writes the buffer of this thread and any left in the                                                                                                                                                                                              
+   * buffers of threads that have ended. The buffers of threads still running                                                                                                                                                                                       
+   * are theirs to write, until exit (see program_21zzthrx). The caller holds                                                                                                                                                                                       
+   * program_21zzhlck.                                                                                                                                                                                                                                              
+   * -----------------------------------------------------------------------------                                                                                                                                                                                  
+   */                                                                                                                                                                                                                                                               
+  static void program_21zzthra(qqnull_params)                                                                                                                                                                                                                       
+  {                                                                                                                                                                                                                                                                 
+    struct program_21zzthrd * qqqt;                                                                                                                                                                                                                                 
+    /* the list read atomically, a thread may be pushing its buffer */                                                                                                                                                                                              
+    qqqt = __sync_val_compare_and_swap(&program_21zzhlst, 0, 0);                                                                                                                                                                                                    
+    for ( ; qqqt != 0; qqqt = qqqt->next )                                                                                                                                                                                                                          
+    {                                                                                                                                                                                                                                                               
+      if ( qqqt == program_21zzhthr || qqqt->done )                                                                                                                                                                                                                 
+      {                                                                                                                                                                                                                                                             
+        program_21zzthrw(qqqt);                                                                                                                                                                                                                                     
+        if ( qqqt->fil != 0 )                                                                                                                                                                                                                                       
+        {                                                                                                                                                                                                                                                           
+          fflush(qqqt->fil);                                                                                                                                                                                                                                        
+        }                                                                                                                                                                                                                                                           
+      }                                                                                                                                                                                                                                                             
+    }                                                                                                                                                                                                                                                               
+  } /* End of zzthra */                                                                                                                                                                                                                                             
+  /* ----------------------------------------------------------------------* 322 *                                                                                                                                                                                  
+   *            program_21zzlock                                                                                                                                                                                                                                    
+   * Takes (qqqon 1) or releases (qqqon 0) the lock held to write the                                                                                                                                                                                               
+   * history. A thread waiting yields, the one writing may share its core.                                                                                                                                                                                          
+   * -----------------------------------------------------------------------------                                                                                                                                                                                  
+   */                                                                                                                                                                                                                                                               
+  static void program_21zzlock(int qqqon)                                                                                                                                                                                                                           
+  {                                                                                                                                                                                                                                                                 
+    if ( qqqon )                                                                                                                                                                                                                                                    
+    {                                                                                                                                                                                                                                                               
+      while ( __sync_lock_test_and_set(&program_21zzhlck, 1) )                                                                                                                                                                                                      
+      {                                                                                                                                                                                                                                                             
+        QQQthreadyield();                                                                                                                                                                                                                                           
+      }                                                                                                                                                                                                                                                             
+    }                                                                                                                                                                                                                                                               
+    else                                                                                                                                                                                                                                                            
+    {                                                                                                                                                                                                                                                               
+      __sync_lock_release(&program_21zzhlck);                                                                                                                                                                                                                       
+    }                                                                                                                                                                                                                                                               
+  } /* End of zzlock */                                                                                                                                                                                                                                             
+  /* ----------------------------------------------------------------------* 323 *                                                                                                                                                                                  
+   *            program_21zzthrx                                                                                                                                                                                                                                    
+   * Writes every buffer at exit, those of threads still running too: they                                                                                                                                                                                          
+   * go with the process, their thread ends never run. A thread still                                                                                                                                                                                               
+   * recording as the buffer is written may lose the probes of that moment.                                                                                                                                                                                         
+   * -----------------------------------------------------------------------------                                                                                                                                                                                  
+   */                                                                                                                                                                                                                                                               
+  static void program_21zzthrx(qqnull_params)                                                                                                                                                                                                                       
+  {                                                                                                                                                                                                                                                                 
+    struct program_21zzthrd * qqqt;                                                                                                                                                                                                                                 
+    program_21zzlock(1);                                                                                                                                                                                                                                            
+    qqqt = __sync_val_compare_and_swap(&program_21zzhlst, 0, 0);                                                                                                                                                                                                    
+    for ( ; qqqt != 0; qqqt = qqqt->next )                                                                                                                                                                                                                          
+    {                                                                                                                                                                                                                                                               
+      program_21zzthrw(qqqt);                                                                                                                                                                                                                                       
+      if ( qqqt->fil != 0 )                                                                                                                                                                                                                                         
+      {                                                                                                                                                                                                                                                             
+        fflush(qqqt->fil);                                                                                                                                                                                                                                          
+      }                                                                                                                                                                                                                                                             
+    }                                                                                                                                                                                                                                                               
+    program_21zzlock(0);                                                                                                                                                                                                                                            
+  } /* End of zzthrx */                                                                                                                                                                                                                                             
+#endif  /* QQQthreaded */                                                                                                                                                                                                                                           
   /* ----------- zqzqzq ---------------------------------------------------* 329 *                                                                                                                                                                                  
    * -----------------------------------------------------------------------------                                                                                                                                                                                  
    */                                                                                                                                                                                                                                                               
@@ -325,18 +1980,65 @@ int
    */                                                                                                                                                                                                                                                               
   static int program_21zqzqzq(int qqqi)                                                                                                                                                                                                                             
   {                                                                                                                                                                                                                                                                 
+#ifdef QQQSIGNAL_EXH                                                                                                                                                                                                                                                
+      int qqqg = program_21zzgbeg();                                                                                                                                                                                                                                
+#endif  /* QQQSIGNAL_EXH */                                                                                                                                                                                                                                         
+#ifdef QQQthreaded                                                                                                                                                                                                                                                  
+      program_21zzqqzz(qqqi);                                                                                                                                                                                                                                       
+      program_21zzlock(1);                                                                                                                                                                                                                                          
+#endif  /* QQQthreaded */                                                                                                                                                                                                                                           
       if ( program_21zzopen != 1 )                                                                                                                                                                                                                                  
       {                                                                                                                                                                                                                                                             
         program_21zqqzqz1();                                                                                                                                                                                                                                        
       }                                                                                                                                                                                                                                                             
       /* not compressed */                                                                                                                                                                                                                                          
+#if defined(QQQBITMAP_EXH)                                                                                                                                                                                                                                          
+      /* bitmap */                                                                                                                                                                                                                                                  
+      program_21zzqqzz(qqqi);                                                                                                                                                                                                                                       
+      program_21zzhdmp();                                                                                                                                                                                                                                           
+#elif defined(QQQSAMPLED_EXH)                                                                                                                                                                                                                                       
+      /* sampled, the last probe always counted */                                                                                                                                                                                                                  
+      if ( (unsigned int) qqqi <= (unsigned int) qqqbranches )                                                                                                                                                                                                      
+      {                                                                                                                                                                                                                                                             
+        program_21zzsamp(qqqi);                                                                                                                                                                                                                                     
+      }                                                                                                                                                                                                                                                             
+      program_21zzsdmp();                                                                                                                                                                                                                                           
+#elif defined(QQQthreaded)                                                                                                                                                                                                                                          
+      /* threaded */                                                                                                                                                                                                                                                
+      program_21zzthra();                                                                                                                                                                                                                                           
+#elif defined(QQQMAPPED_EXH)                                                                                                                                                                                                                                        
+      /* mapped */                                                                                                                                                                                                                                                  
+      program_21zzqqzz(qqqi);                                                                                                                                                                                                                                       
+      program_21zzmcls();                                                                                                                                                                                                                                           
+#elif defined(QQQLOOP_EXH)                                                                                                                                                                                                                                          
+      /* loops found */                                                                                                                                                                                                                                             
+      program_21zzloop(qqqi);                                                                                                                                                                                                                                       
+      program_21zzlend();                                                                                                                                                                                                                                           
+#elif defined(QQQASYNC_EXH)                                                                                                                                                                                                                                         
+      /* buffered, written by a thread, the last buffer never dropped */                                                                                                                                                                                            
+      program_21zzhbuf[program_21zzhcnt++] = qqqi;                                                                                                                                                                                                                  
+      program_21zzhdrn();                                                                                                                                                                                                                                           
+#elif defined(QQQBUFFERED_EXH)                                                                                                                                                                                                                                      
+      /* buffered */                                                                                                                                                                                                                                                
+      program_21zzhbuf[program_21zzhcnt++] = qqqi;                                                                                                                                                                                                                  
+      program_21zzflsh();                                                                                                                                                                                                                                           
+#else  /* QQQBUFFERED_EXH */                                                                                                                                                                                                                                        
       /* streamed */                                                                                                                                                                                                                                                
       /* notbuffered */                                                                                                                                                                                                                                             
       qqoutput(program_21zzhfil,                                                                                                                                                                                                                                    
         qqqqone, qqqi);                                                                                                                                                                                                                                             
+#endif  /* QQQBUFFERED_EXH */                                                                                                                                                                                                                                       
       /* upload the history */                                                                                                                                                                                                                                      
+#ifndef QQQMAPPED_EXH                                                                                                                                                                                                                                               
         fclose(program_21zzhfil);                                                                                                                                                                                                                                   
+#endif  /* QQQMAPPED_EXH */                                                                                                                                                                                                                                         
         program_21zzopen = 2;                                                                                                                                                                                                                                       
+#ifdef QQQthreaded                                                                                                                                                                                                                                                  
+      program_21zzlock(0);                                                                                                                                                                                                                                          
+#endif  /* QQQthreaded */                                                                                                                                                                                                                                           
+#ifdef QQQSIGNAL_EXH                                                                                                                                                                                                                                                
+      program_21zzgend(qqqg);                                                                                                                                                                                                                                       
+#endif  /* QQQSIGNAL_EXH */                                                                                                                                                                                                                                         
     return(1);                                                                                                                                                                                                                                                      
   } /* end of zqzqzq */                                                                                                                                                                                                                                             
   /*   the following routines should be left alone */                                                                                                                                                                                                               